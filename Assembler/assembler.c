@@ -0,0 +1,57 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Assembler library: a source file to object records in memory.
+
+#include <assert.h>
+#include "assembler.h"
+#include "passes.h"
+#include "token.h"
+#include "utils.h"
+
+void init_asm_settings(ASM_SETTINGS* settings) {
+  assert(settings != NULL);
+  settings->case_sensitive = false;
+  settings->max_errors = -1;
+  settings->verbose = false;
+  settings->threads = DEFAULT_THREADS;
+}
+
+typedef struct {
+  SOURCE* src;
+  const Options* opts;
+  PROFILE* profile;
+  STRINGLIST* incbins;
+  OFILE* ofile;
+} ASSEMBLY;
+
+static void assemble_job(void* arg) {
+  ASSEMBLY* a = arg;
+  a->ofile = run_passes(a->src, a->opts, a->profile, a->incbins);
+}
+
+OFILE* assemble_file(const char* source_name, const ASM_SETTINGS* settings, PROFILE* profile,
+                     STRINGLIST* incbins) {
+  assert(source_name != NULL);
+  assert(settings != NULL);
+  assert(profile != NULL);
+
+  init_keywords();
+
+  Options* opts = new_options();
+  opts->case_sensitive = settings->case_sensitive;
+  opts->max_errors = settings->max_errors;
+  opts->verbose = settings->verbose;
+  opts->threads = settings->threads ? settings->threads : 1;
+
+  begin_phase(profile, "load");
+  ASSEMBLY a = { load_source_file(source_name), opts, profile, incbins, NULL };
+  // a resident caller assembles again after errors
+  const bool ok = run_job(assemble_job, &a, error_stream());
+  end_phase(profile);
+
+  delete_source(a.src);
+  delete_options(opts);
+  if (!ok)
+    fail();
+  return a.ofile;
+}
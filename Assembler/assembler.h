@@ -0,0 +1,29 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Assembler library: a source file to object records in memory.
+
+#ifndef ASSEMBLER_H
+#define ASSEMBLER_H
+
+#include <stdbool.h>
+#include "object.h"
+#include "profile.h"
+#include "stringlist.h"
+
+typedef struct {
+  bool case_sensitive;
+  unsigned max_errors;
+  bool verbose;
+  unsigned threads;  // to encode on
+} ASM_SETTINGS;
+
+// The defaults of bas.
+void init_asm_settings(ASM_SETTINGS*);
+
+// Assemble the source file, timing each pass as a phase of the profile,
+// and appending to incbins, if not NULL, the path of each file included by
+// INCBIN, on which the records also depend.
+// Errors are reported on error_stream() and end in fail(): see run_job.
+OFILE* assemble_file(const char* source_name, const ASM_SETTINGS*, PROFILE*, STRINGLIST* incbins);
+
+#endif // ASSEMBLER_H
@@ -5,24 +5,48 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <assert.h>
 #include "options.h"
 #include "source.h"
-#include "ifile.h"
 #include "utils.h"
-#include "sourcepass.h"
-#include "pass1.h"
-#include "resize.h"
-#include "encoding.h"
+#include "passes.h"
 #include "object.h"
-#include "timer.h"
+#include "linker.h"
+#include "format.h"
+#include "profile.h"
+#include "trace.h"
 #include "token.h"
+#include "stringlist.h"
 
 #ifdef UNIT_TEST
 static void RunAllTests(void);
+static int RunAllBenchmarks(const char* baselines);
 #endif
 
-static char* default_object_name(const char* source);
+#if !defined(__STDC_NO_THREADS__) && !defined(__STDC_NO_ATOMICS__)
+#define JOB_THREADS
+#include <threads.h>
+#include <stdatomic.h>
+#endif
+
+// One source file to assemble: the only one, or one of several assembled
+// concurrently. Each job has its own intermediate file, symbol table and
+// object file; the keyword and instruction tables are shared and immutable.
+typedef struct {
+  Options opts;  // a shallow copy, with the job's share of the threads
+  const char* source_name;
+  PROFILE* profile;
+  FILE* errors;  // messages held until the job is reported, or NULL
+  bool ok;
+} JOB;
+
+static void init_job(JOB*, const Options*, const char* source_name, unsigned workers);
+static void assemble(void* job);
+static bool run_jobs(JOB*, unsigned count, unsigned workers);
+static void report_job(JOB*, unsigned count);
+static void write_program(const OFILE*, const JOB*);
+static char* default_output_file(const char* source, const char* ext);
 static void report_memory(Options*);
 static void help(void);
 
@@ -38,6 +62,11 @@ int main(int argc, char* argv[]) {
     report_memory(opts);
     exit(EXIT_SUCCESS); // TODO: return count of failures
   }
+  if (opts->bench) {
+    int failures = RunAllBenchmarks(opts->bench_baselines);
+    delete_options(opts);
+    exit(failures ? EXIT_FAILURE : EXIT_SUCCESS);
+  }
 #endif
 
   if (opts->help)
@@ -45,109 +74,242 @@ int main(int argc, char* argv[]) {
 
   init_keywords();
 
-  assert(opts->source_name != NULL);
-  SOURCE* src = load_source_file(opts->source_name);
+#ifdef TRACE_EVENTS
+  if (opts->trace_name)
+    TRACE_OPEN(opts->trace_name, "bas");
+#endif
+
+  const unsigned count = stringlist_count(opts->sources);
+  assert(count > 0);
+  const unsigned workers = (count < opts->threads) ? count : opts->threads;
+  JOB* jobs = emalloc(count * sizeof jobs[0]);
+  for (unsigned i = 0; i < count; i++)
+    init_job(&jobs[i], opts, stringlist_item(opts->sources, i), workers);
+
+  bool ok = true;
+  if (count == 1) {
+    // errors are reported as they occur, and end the process
+    assemble(&jobs[0]);
+    jobs[0].ok = true;
+  }
+  else
+    ok = run_jobs(jobs, count, workers);
+
+  for (unsigned i = 0; i < count; i++)
+    report_job(&jobs[i], count);
+  efree(jobs);
+
+  TRACE_CLOSE();
+
+  report_memory(opts);
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void init_job(JOB* job, const Options* opts, const char* source_name, unsigned workers) {
+  job->opts = *opts;
+  job->opts.threads = (opts->threads > workers) ? opts->threads / workers : 1;
+  job->source_name = source_name;
+  job->profile = new_profile();
+  job->errors = NULL;
+  job->ok = false;
+}
+
+static void assemble(void* p) {
+  JOB* job = p;
+  const Options* opts = &job->opts;
+  PROFILE* profile = job->profile;
+
+  TRACE_BEGIN("assemble %s", job->source_name);
+
+  begin_phase(profile, "load");
+
+  SOURCE* src = load_source_file(job->source_name);
   assert(src != NULL);
 
   if (opts->print_source) {
     print_source(src);
     delete_source(src);
-    report_memory(opts);
-    exit(EXIT_SUCCESS);
+    end_phase(profile);
+    TRACE_END();
+    return;
   }
 
-  IFILE* ifile = new_ifile(src, opts->case_sensitive);
+  OFILE* ofile = run_passes(src, opts, profile, NULL);
 
-  source_pass(ifile, opts);
-  if (opts->print_intermediate)
-    print_intermediate(ifile, "AFTER SOURCE PASS", PRINT_SOURCE_NAME);
+  if (opts->format)
+    write_program(ofile, job);
+  else {
+    begin_phase(profile, "save");
+    char* output_name = opts->output_name ? estrdup(opts->output_name) : default_output_file(job->source_name, "obj");
+    save_object_file(ofile, output_name);
+    efree(output_name);
+    end_phase(profile);
+  }
+  TRACE_END();
 
-  TIMER timer; // time the passes which involve symbol lookup
+  delete_ofile(ofile);
+  delete_source(src);
+}
 
-  start_timer(&timer);
+// Link the module alone, in memory, and write the program it makes,
+// instead of writing an object file for blink to read back.
+static void write_program(const OFILE* ofile, const JOB* job) {
+  const Options* opts = &job->opts;
+  const int format = format_by_name(opts->format);
+  char* output_name = opts->output_name ? estrdup(opts->output_name) : default_output_file(job->source_name, opts->format);
+
+  LINK_SETTINGS settings;
+  init_link_settings(&settings);
+  settings.case_sensitive = opts->case_sensitive;
+  LINKER* linker = new_linker(output_name, &settings, job->profile);
+  link_module(linker, ofile, job->source_name);
+  link_image(linker);
+  output_program(linker, format, output_name);
+  delete_linker(linker);
+
+  efree(output_name);
+}
 
-  pass1(ifile, opts);
-  if (opts->print_intermediate)
-    print_intermediate(ifile, "AFTER PASS 1", PRINT_SIZE);
+// Each job's errors go to a temporary file, so that they can be
+// reported file by file, in order, when all the jobs have finished.
+static void run(JOB* job) {
+  job->errors = tmpfile();
+  job->ok = run_job(assemble, job, job->errors);
+}
 
-  if (ifile->provisional_sizes) {
-    BOOL resized;
-    do {
-      resized = resize_pass(ifile, opts);
-      if (opts->print_intermediate)
-        print_intermediate(ifile, "AFTER RESIZE PASS", PRINT_SIZE);
-    } while (resized);
-  }
+#ifdef JOB_THREADS
+typedef struct {
+  JOB* jobs;
+  unsigned count;
+  atomic_uint next;
+} POOL;
+
+static int worker(void* p) {
+  POOL* pool = p;
+  TRACE_THREAD("assembler worker");
+  unsigned i;
+  while ((i = atomic_fetch_add(&pool->next, 1)) < pool->count)
+    run(&pool->jobs[i]);
+  return 0;
+}
+#endif
 
-  OFILE* ofile = encoding_pass(ifile, opts);
-  if (opts->print_intermediate)
-    print_intermediate(ifile, "AFTER ENCODING PASS", PRINT_SIZE);
+// True if every job succeeded.
+static bool run_jobs(JOB* jobs, unsigned count, unsigned workers) {
+#ifdef JOB_THREADS
+  POOL pool;
+  pool.jobs = jobs;
+  pool.count = count;
+  atomic_init(&pool.next, 0);
 
-  stop_timer(&timer);
+  thrd_t* thread = emalloc(workers * sizeof thread[0]);
+  bool* started = ecalloc(workers * sizeof started[0]);
+  for (unsigned w = 1; w < workers; w++)
+    started[w] = (thrd_create(&thread[w], worker, &pool) == thrd_success);
 
-  if (opts->report_time)
-    printf("Microseconds elapsed: %lld\n", elapsed_usec(&timer));
+  worker(&pool);
 
-  if (opts->output_name == NULL)
-    opts->output_name = default_object_name(opts->source_name);
-  save_object_file(ofile, opts->output_name);
+  for (unsigned w = 1; w < workers; w++) {
+    if (started[w])
+      thrd_join(thread[w], NULL);
+  }
+  efree(started);
+  efree(thread);
+#else
+  (void) workers;
+  for (unsigned i = 0; i < count; i++)
+    run(&jobs[i]);
+#endif
 
-  if (opts->report_hash_table)
-    report_sym_hash(ifile->st);
+  bool ok = true;
+  for (unsigned i = 0; i < count; i++)
+    ok = ok && jobs[i].ok;
+  return ok;
+}
 
-  delete_ofile(ofile);
-  delete_ifile(ifile);
-  delete_source(src);
+static void report_job(JOB* job, unsigned count) {
+  if (job->errors) {
+    fflush(stdout);
+    rewind(job->errors);
+    int c;
+    while ((c = getc(job->errors)) != EOF)
+      putc(c, stderr);
+    fclose(job->errors);
+    job->errors = NULL;
+  }
 
-  report_memory(opts);
+  if (job->ok && !job->opts.print_source) {
+    if (job->opts.report_time) {
+      if (count > 1)
+        printf("%s:\n", job->source_name);
+      print_profile(job->profile, stdout);
+      printf("Microseconds elapsed: %lld\n", profile_usec(job->profile));
+    }
+    if (job->opts.report_memory)
+      print_memory_profile(job->profile, stdout);
+  }
 
-  return 0;
+  delete_profile(job->profile);
+  job->profile = NULL;
 }
 
-static char* default_object_name(const char* source) {
+// The source name with the given extension instead of .asm, in the same case.
+static char* default_output_file(const char* source, const char* ext) {
   assert(source != NULL);
-  size_t len = strlen(source);
-  if (len > 4 && strcmp(source + len - 4, ".asm") == 0) {
-    char* t = estrdup(source);
-    strcpy(t + len - 3, "obj");
-    return t;
+  assert(ext != NULL);
+  const size_t len = strlen(source);
+  const size_t ext_len = strlen(ext);
+  char* t;
+  if (len > 4 && (strcmp(source + len - 4, ".asm") == 0 || strcmp(source + len - 4, ".ASM") == 0)) {
+    t = emalloc(len - 3 + ext_len + 1);
+    memcpy(t, source, len - 3);
+    strcpy(t + len - 3, ext);
   }
-  if (len > 4 && strcmp(source + len - 4, ".ASM") == 0) {
-    char* t = estrdup(source);
-    strcpy(t + len - 3, "OBJ");
-    return t;
+  else {
+    t = emalloc(2 + ext_len + 1);
+    strcpy(t, "a.");
+    strcat(t, ext);
   }
-  return estrdup("a.obj");
+  const bool upper = (len > 4 && strcmp(source + len - 4, ".ASM") == 0);
+  for (char* p = t + strlen(t) - ext_len; *p; p++)
+    *p = upper ? toupper(*p) : tolower(*p);
+  return t;
 }
 
 static void report_memory(Options* opts) {
   BOOL report = opts->report_memory;
   delete_options(opts);
   if (report) {
-    unsigned long malloc_count, free_count;
-    get_memory_counts(&malloc_count, &free_count);
-    printf("malloc: %10lu\n", malloc_count);
-    printf("free:   %10lu\n", free_count);
+    print_memory_usage(stdout);
   }
 }
 
 static void help(void) {
   puts("Basic Assembler\n");
-  puts("Usage: bas [options] file.asm\n");
+  puts("Usage: bas [options] file.asm ...\n");
 #ifdef UNIT_TEST
   puts("  -unittest  run unit tests and quit");
+  puts("  -bench     run benchmarks and quit (-bench=FILE: check baselines)");
 #endif
+  puts("  -f format  write a com or bin program instead of an object file");
   puts("  -I         print intermediate file");
+  puts("  -j=N       assemble files and encode on up to N threads (default 4)");
   puts("  -S         print source");
   puts("  -m         print memory usage");
   puts("  -me=N      max errors");
-  puts("  -o name    output to file name");
+  puts("  -o name    output to file name (one source only)");
   puts("  -q         quiet");
-  puts("  -t         time assembling");
+  puts("  -t         time and count events in each phase of assembling");
   putchar('\n');
   puts("  --case-sensitive     case-sensitive symbols");
   puts("  --case-insensitive   case-insensitive symbols (default)");
   puts("  --hash               report hash table utilisation");
+  puts("  --tasm-encoding      first instruction form matching, not the shortest");
+  puts("  --cycles             list estimated 8086 and 286 clocks and the costliest loops");
+#ifdef TRACE_EVENTS
+  puts("  --trace FILE         write trace events to FILE (Chrome JSON)");
+#endif
   exit(EXIT_SUCCESS);
 }
 
@@ -156,38 +318,75 @@ static void help(void) {
 #include "CuTest.h"
 
 extern CuSuite* utils_test_suite(void);
+extern CuSuite* batch_test_suite(void);
 extern CuSuite* source_test_suite(void);
 extern CuSuite* token_test_suite(void);
+extern CuSuite* intern_test_suite(void);
 extern CuSuite* symbol_test_suite(void);
 extern CuSuite* lexer_test_suite(void);
 extern CuSuite* ifile_test_suite(void);
 extern CuSuite* sourcepass_test_suite(void);
 extern CuSuite* instable_test_suite(void);
+extern CuSuite* cycles_test_suite(void);
 extern CuSuite* options_test_suite(void);
 extern CuSuite* operand_class_test_suite(void);
 extern CuSuite* parse_test_suite(void);
+extern CuSuite* common_test_suite(void);
 extern CuSuite* encoding_test_suite(void);
+extern CuSuite* profile_test_suite(void);
+
+extern CuBenchSuite* symbol_bench_suite(void);
+extern CuBenchSuite* token_bench_suite(void);
+extern CuBenchSuite* lexer_bench_suite(void);
+extern CuBenchSuite* instable_bench_suite(void);
 
 static void RunAllTests(void) {
   CuString *output = CuStringNew();
   CuSuite* suite = CuSuiteNew();
 
   CuSuiteAddSuite(suite, utils_test_suite());
+  CuSuiteAddSuite(suite, batch_test_suite());
   CuSuiteAddSuite(suite, source_test_suite());
   CuSuiteAddSuite(suite, token_test_suite());
+  CuSuiteAddSuite(suite, intern_test_suite());
   CuSuiteAddSuite(suite, symbol_test_suite());
   CuSuiteAddSuite(suite, lexer_test_suite());
   CuSuiteAddSuite(suite, ifile_test_suite());
   CuSuiteAddSuite(suite, sourcepass_test_suite());
   CuSuiteAddSuite(suite, instable_test_suite());
+  CuSuiteAddSuite(suite, cycles_test_suite());
   CuSuiteAddSuite(suite, options_test_suite());
   CuSuiteAddSuite(suite, operand_class_test_suite());
   CuSuiteAddSuite(suite, parse_test_suite());
+  CuSuiteAddSuite(suite, common_test_suite());
   CuSuiteAddSuite(suite, encoding_test_suite());
+  CuSuiteAddSuite(suite, profile_test_suite());
   CuSuiteRun(suite);
   CuSuiteSummary(suite, output);
   CuSuiteDetails(suite, output);
   printf("%s\n", output->buffer);
 }
 
+static int RunAllBenchmarks(const char* baselines) {
+  CuString *output = CuStringNew();
+  CuBenchSuite* suite = CuBenchSuiteNew();
+
+  CuBenchSuiteAddSuite(suite, symbol_bench_suite());
+  CuBenchSuiteAddSuite(suite, token_bench_suite());
+  CuBenchSuiteAddSuite(suite, lexer_bench_suite());
+  CuBenchSuiteAddSuite(suite, instable_bench_suite());
+
+  const bool record = baselines && !CuBenchSuiteReadBaselines(suite, baselines);
+  CuBenchSuiteRun(suite);
+  CuBenchSuiteDetails(suite, output);
+  printf("%s\n", output->buffer);
+  if (record && !CuBenchSuiteWriteBaselines(suite, baselines))
+    fatal("cannot write benchmark baselines: %s\n", baselines);
+
+  const int failures = suite->failCount;
+  CuBenchSuiteDelete(suite);
+  CuStringDelete(output);
+  return failures;
+}
+
 #endif /* UNIT_TEST */
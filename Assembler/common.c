@@ -6,6 +6,8 @@
 // passes themselves, while common.c is pass processing that happens to be
 // shared.
 
+#include <string.h>
+#include <ctype.h>
 #include <assert.h>
 #include "common.h"
 #include "instable.h"
@@ -18,7 +20,7 @@ void perform_ends(STATE* state, IFILE* ifile, LEX* lex) {
     error2(state, lex, "no segment is open");
 
   if (lex_token(lex) == TOK_LABEL) {
-    SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+    SYMBOL* sym = sym_lookup_id(ifile->st, lex_name(lex));
     if (sym == NULL || sym_type(sym) != SYM_SECTION || sym_section_type(sym) != ST_SEGMENT)
       error2(state, lex, "segment name expected: %s", lex_lexeme(lex));
     else if (state->curseg != NO_SEG && sym_section_ordinal(sym) != state->curseg)
@@ -96,6 +98,89 @@ bool parse_alignment(STATE* state, LEX* lex, unsigned *p2) {
   return true;
 }
 
+static bool incbin_number(STATE*, IFILE*, LEX*, const char* descrip, DWORD*);
+static char* incbin_path(IFILE*, const BYTE* name, size_t len);
+
+bool parse_incbin(STATE* state, IFILE* ifile, LEX* lex, INCBIN_OPERANDS* inc) {
+  assert(state != NULL);
+  assert(ifile != NULL);
+  assert(lex != NULL);
+  assert(inc != NULL);
+
+  inc->path = NULL;
+  inc->offset = 0;
+  inc->length = 0;
+  inc->length_given = false;
+
+  if (lex_token(lex) != TOK_STRING || lex_string_len(lex) == 0) {
+    error2(state, lex, "binary file name expected");
+    lex_discard_line(lex);
+    return false;
+  }
+
+  size_t len;
+  BYTE* name = lex_string_content(lex, &len);
+  lex_next(lex);
+
+  if (lex_token(lex) == ',') {
+    lex_next(lex);
+    if (!incbin_number(state, ifile, lex, "offset", &inc->offset)) {
+      efree(name);
+      return false;
+    }
+    if (lex_token(lex) == ',') {
+      lex_next(lex);
+      if (!incbin_number(state, ifile, lex, "length", &inc->length)) {
+        efree(name);
+        return false;
+      }
+      inc->length_given = true;
+    }
+  }
+
+  inc->path = incbin_path(ifile, name, len);
+  efree(name);
+  return true;
+}
+
+static bool incbin_number(STATE* state, IFILE* ifile, LEX* lex, const char* descrip, DWORD* n) {
+  union value val;
+  switch (expr(state, ifile, lex, &val)) {
+    case ET_ERR:
+      return false;
+    case ET_ABS:
+      if (val.n < 0 || val.n > (DWORD)(-1)) {
+        error2(state, lex, "INCBIN %s out of range", descrip);
+        return false;
+      }
+      *n = (DWORD) val.n;
+      return true;
+  }
+  error2(state, lex, "absolute numeric expression expected for INCBIN %s", descrip);
+  return false;
+}
+
+static bool absolute_path(const char* name) {
+  return name[0] == '/' || name[0] == '\\' || (isalpha((unsigned char) name[0]) && name[1] == ':');
+}
+
+// A relative name is found in the directory of the source file, as an include would be.
+static char* incbin_path(IFILE* ifile, const BYTE* name, size_t len) {
+  const char* source = source_name(ifile->source);
+  size_t dir_len = 0;
+  if (!absolute_path((const char*) name)) {
+    for (size_t i = 0; source[i]; i++) {
+      if (source[i] == '/' || source[i] == '\\')
+        dir_len = i + 1;
+    }
+  }
+  char* path = emalloc(dir_len + len + 1);
+  memcpy(path, source, dir_len);
+  memcpy(path + dir_len, name, len);
+  path[dir_len + len] = '\0';
+  return path;
+}
+
 void select_cpu(STATE* state, int op) {
   switch (op) {
     case TOK_P286N: state->cpu = M_86 | M_87 | M_286N | M_287; break;
@@ -109,7 +194,7 @@ void select_cpu(STATE* state, int op) {
 }
 
 void define_dollar(STATE* state, IFILE* ifile) {
-  SYMBOL* sym = sym_lookup(ifile->st, "$");
+  SYMBOL* sym = ifile->dollar ? ifile->dollar : sym_lookup(ifile->st, "$");
   assert(sym != NULL);
   DWORD pc = (state->curseg == NO_SEG) ? 0 : segment_pc(ifile, state->curseg);
   sym_update_relative(sym, state->curseg, pc);
@@ -237,6 +322,66 @@ unsigned wait_needed(STATE* state, const INSDEF* def) {
   return false;
 }
 
+// Length of the encoding by the table entry, without the repeat and
+// segment override prefixes, which are the same for every matching entry.
+static unsigned form_length(STATE* state, IFILE* ifile, const INSDEF* def,
+                            const OPERAND* oper1, const OPERAND* oper2, RM_DISP_FN* rm_disp_len) {
+  unsigned len = wait_needed(state, def) + def->opcodes;
+
+  switch (def->modrm) {
+    case RMN:
+      if (def->oper1 == OF_INDIR || def->oper2 == OF_INDIR)
+        len += 2;
+      break;
+    case RRM:
+      len += 1 + rm_disp_len(state, ifile, oper2);
+      break;
+    case RMR:
+    case RMC:
+    case MMC:
+      len += 1 + rm_disp_len(state, ifile, oper1);
+      break;
+    default:
+      len += 1;
+      break;
+  }
+
+  return len + def->imm1 + def->imm2 + def->imm3;
+}
+
+const INSDEF* select_instruc(STATE* state, IFILE* ifile, IREC* irec, const OPERAND* oper1, const OPERAND* oper2,
+                             const OPERAND* oper3, RM_DISP_FN* rm_disp_len) {
+  assert(state != NULL);
+  assert(ifile != NULL);
+  assert(irec != NULL);
+  assert(oper1 != NULL && oper2 != NULL && oper3 != NULL);
+  assert(rm_disp_len != NULL);
+
+  irec->shortened = 0;
+
+  const INSDEF* first = find_instruc(irec->op, &oper1->opclass, &oper2->opclass, &oper3->opclass);
+  if (first == NULL || state->tasm_encoding)
+    return first;
+
+  const INSDEF* best = NULL;
+  unsigned best_len = 0;
+  for (const INSDEF* def = first; def; def = find_next_instruc(def, &oper1->opclass, &oper2->opclass, &oper3->opclass)) {
+    if (cpu_enabled(state->cpu, def->cpu)) {
+      const unsigned len = form_length(state, ifile, def, oper1, oper2, rm_disp_len);
+      if (best == NULL || len < best_len) {
+        best = def;
+        best_len = len;
+      }
+    }
+  }
+
+  if (best == NULL)
+    return first;
+  if (best != first && cpu_enabled(state->cpu, first->cpu))
+    irec->shortened = form_length(state, ifile, first, oper1, oper2, rm_disp_len) - best_len;
+  return best;
+}
+
 static unsigned operand_size(const OPERAND*);
 
 // When the instruction table does not specify the size of some operand -
@@ -272,3 +417,156 @@ static unsigned operand_size(const OPERAND* op) {
   fatal("internal error: operand_size: unknown operand type: %d\n", (int) op->opclass.type);
   return 0;
 }
+
+#ifdef UNIT_TEST
+
+#include "CuTest.h"
+#include "sourcepass.h"
+
+// Displacement lengths of memory operands whose displacements are constants.
+static unsigned const_disp_len(STATE* state, IFILE* ifile, const OPERAND* op) {
+  if (op->opclass.type != OT_MEM)
+    return 0;
+  const struct mem * const m = &op->val.mem;
+  if (m->base_reg == NO_REG && m->index_reg == NO_REG)
+    return 2;
+  const unsigned min = (m->base_reg == REG_BP && m->index_reg == NO_REG) ? 1 : 0;
+  if (m->disp_type == NO_DISP || m->disp.sval == 0)
+    return min;
+  return (m->disp.sval >= -0x80 && m->disp.sval < 0x80) ? 1 : 2;
+}
+
+// As if no memory operand had a displacement: then the ModR/M form of
+// MOV AX, [disp] is shorter than the first matching, A1.
+static unsigned no_disp_len(STATE* state, IFILE* ifile, const OPERAND* op) {
+  return 0;
+}
+
+typedef struct {
+  SOURCE* src;
+  IFILE* ifile;
+  LEX* lex;
+  STATE state;
+  OPERAND oper1, oper2, oper3;
+} FORMS;
+
+static void begin_forms(FORMS* f, const char* text) {
+  f->src = load_source_mem(text);
+  f->ifile = new_ifile(f->src, false);
+  f->lex = new_lex(source_name(f->src), f->ifile->st->names);
+  source_pass(f->ifile, NULL);
+  init_state(&f->state, -1);
+}
+
+static void end_forms(FORMS* f) {
+  delete_lex(f->lex);
+  delete_ifile(f->ifile);
+  delete_source(f->src);
+}
+
+static void parse_line(CuTest* tc, FORMS* f, unsigned line) {
+  lex_begin(f->lex, source_text(f->src, line), source_lineno(f->src, line), 0);
+  CuAssertIntEquals(tc, TRUE, parse_operands(&f->state, f->ifile, f->lex, &f->oper1, &f->oper2, &f->oper3));
+}
+
+// The table entry for the operation matching the parsed operands, by its opcode.
+static const INSDEF* matching(FORMS* f, int op, BYTE opcode1) {
+  for (const INSDEF* def = find_instruc(op, &f->oper1.opclass, &f->oper2.opclass, &f->oper3.opclass); def;
+       def = find_next_instruc(def, &f->oper1.opclass, &f->oper2.opclass, &f->oper3.opclass)) {
+    if (def->opcode1 == opcode1)
+      return def;
+  }
+  return NULL;
+}
+
+static unsigned length_of(CuTest* tc, FORMS* f, int op, BYTE opcode1) {
+  const INSDEF* def = matching(f, op, opcode1);
+  CuAssertPtrNotNull(tc, def);
+  return form_length(&f->state, f->ifile, def, &f->oper1, &f->oper2, const_disp_len);
+}
+
+static void test_form_length(CuTest* tc) {
+  static const char text[] =
+    "ax, [1234h]\n"
+    "[1234h], al\n"
+    "bx, 5\n"
+    "dx, [bx+0]\n"
+    "dx, [bp+0]\n"
+    "dx, [bx+si+200h]\n"
+    "[WORD bx]\n"
+    "si, ax\n";
+  FORMS f;
+  begin_forms(&f, text);
+
+  parse_line(tc, &f, 0);
+  CuAssertIntEquals(tc, 3, length_of(tc, &f, TOK_MOV, 0xA1));  // A1 34 12
+  CuAssertIntEquals(tc, 4, length_of(tc, &f, TOK_MOV, 0x8B));  // 8B 06 34 12
+
+  parse_line(tc, &f, 1);
+  CuAssertIntEquals(tc, 3, length_of(tc, &f, TOK_MOV, 0xA2));  // A2 34 12
+  CuAssertIntEquals(tc, 4, length_of(tc, &f, TOK_MOV, 0x88));  // 88 06 34 12
+
+  parse_line(tc, &f, 2);
+  CuAssertIntEquals(tc, 3, length_of(tc, &f, TOK_ADD, 0x83));  // 83 C3 05
+  CuAssertIntEquals(tc, 4, length_of(tc, &f, TOK_ADD, 0x81));  // 81 C3 05 00
+
+  parse_line(tc, &f, 3);
+  CuAssertIntEquals(tc, 2, length_of(tc, &f, TOK_MOV, 0x8B));  // 8B 17
+  parse_line(tc, &f, 4);
+  CuAssertIntEquals(tc, 3, length_of(tc, &f, TOK_MOV, 0x8B));  // 8B 56 00
+  parse_line(tc, &f, 5);
+  CuAssertIntEquals(tc, 4, length_of(tc, &f, TOK_MOV, 0x8B));  // 8B 90 00 02
+
+  parse_line(tc, &f, 6);
+  CuAssertIntEquals(tc, 3, length_of(tc, &f, TOK_FSTSW, 0xDD));   // 9B DD 3F
+  CuAssertIntEquals(tc, 2, length_of(tc, &f, TOK_FNSTSW, 0xDD));  // DD 3F
+  select_cpu(&f.state, TOK_P286N);
+  CuAssertIntEquals(tc, 2, length_of(tc, &f, TOK_FSTSW, 0xDD));   // DD 3F
+  select_cpu(&f.state, TOK_P8086);
+
+  parse_line(tc, &f, 7);
+  CuAssertIntEquals(tc, 1, length_of(tc, &f, TOK_XCHG, 0x90));  // 96
+  CuAssertIntEquals(tc, 2, length_of(tc, &f, TOK_XCHG, 0x87));  // 87 C6
+
+  end_forms(&f);
+}
+
+static void test_select_instruc(CuTest* tc) {
+  static const char text[] = "ax, [1234h]\n";
+  FORMS f;
+  IREC irec;
+  begin_forms(&f, text);
+  parse_line(tc, &f, 0);
+  memset(&irec, 0, sizeof irec);
+  irec.op = TOK_MOV;
+
+  // the first matching is the shortest
+  const INSDEF* def = select_instruc(&f.state, f.ifile, &irec, &f.oper1, &f.oper2, &f.oper3, const_disp_len);
+  CuAssertPtrNotNull(tc, def);
+  CuAssertIntEquals(tc, 0xA1, def->opcode1);
+  CuAssertIntEquals(tc, 0, irec.shortened);
+
+  // a later entry is shorter
+  def = select_instruc(&f.state, f.ifile, &irec, &f.oper1, &f.oper2, &f.oper3, no_disp_len);
+  CuAssertPtrNotNull(tc, def);
+  CuAssertIntEquals(tc, 0x8B, def->opcode1);
+  CuAssertIntEquals(tc, 1, irec.shortened);
+
+  // Turbo Assembler takes the first matching
+  f.state.tasm_encoding = true;
+  def = select_instruc(&f.state, f.ifile, &irec, &f.oper1, &f.oper2, &f.oper3, no_disp_len);
+  CuAssertPtrNotNull(tc, def);
+  CuAssertIntEquals(tc, 0xA1, def->opcode1);
+  CuAssertIntEquals(tc, 0, irec.shortened);
+
+  end_forms(&f);
+}
+
+CuSuite* common_test_suite(void) {
+  CuSuite* suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_form_length);
+  SUITE_ADD_TEST(suite, test_select_instruc);
+  return suite;
+}
+
+#endif // UNIT_TEST
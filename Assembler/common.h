@@ -20,9 +20,34 @@ void perform_udataseg(STATE*, IFILE*, LEX*);
 
 bool parse_alignment(STATE*, LEX*, unsigned *p2);
 
+// The operands of INCBIN 'file' [, offset [, length]].
+typedef struct {
+  char* path;  // relative to the directory of the source file, if not absolute
+  DWORD offset;
+  DWORD length;
+  bool length_given;
+} INCBIN_OPERANDS;
+
+// Parse the operands following INCBIN. False, having reported an error,
+// if they are invalid. Otherwise the caller frees the path.
+bool parse_incbin(STATE*, IFILE*, LEX*, INCBIN_OPERANDS*);
+
 void select_cpu(STATE*, int token);
 unsigned wait_needed(STATE*, const INSDEF*);
 
+// Length of the displacement following the ModR/M byte for the operand,
+// as sized by the pass.
+typedef unsigned RM_DISP_FN(STATE*, IFILE*, const OPERAND*);
+
+// The instruction table entry for irec->op with the operands: the shortest
+// encoding among those matching on the selected processors, the first in
+// table order of equal length; or, if state->tasm_encoding, the first entry
+// matching, as Turbo Assembler. If none matching is on the selected
+// processors, the first, for the caller to report. NULL if none matches.
+// Sets irec->shortened.
+const INSDEF* select_instruc(STATE*, IFILE*, IREC*, const OPERAND* oper1, const OPERAND* oper2,
+                             const OPERAND* oper3, RM_DISP_FN*);
+
 void define_dollar(STATE*, IFILE*);
 
 bool valid_byte_expr(int type);
@@ -21,6 +21,14 @@
 #include "common.h"
 #include "options.h"
 #include "object.h"
+#include "profile.h"
+#include "trace.h"
+#include "utils.h"
+
+#if !defined(__STDC_NO_THREADS__) && !defined(__STDC_NO_ATOMICS__)
+#define ENCODING_THREADS
+#include <threads.h>
+#endif
 
 static void emit_groups(IFILE*, OFILE*);
 static void emit_segments(IFILE*, OFILE*);
@@ -29,6 +37,8 @@ static void emit_publics(SYMTAB*, OFILE*);
 static void process_irec(STATE*, IFILE*, LEX*, OFILE*);
 static void emit_start(IFILE*, OFILE*);
 static void emit_uninit_segments(STATE*, IFILE*, OFILE*);
+static unsigned encoding_ranges(IFILE*, const Options*);
+static bool encode_ranges(STATE*, IFILE*, OFILE*, unsigned ranges);
 
 OFILE* encoding_pass(IFILE* ifile, const Options* options) {
   if (options->verbose)
@@ -48,9 +58,20 @@ OFILE* encoding_pass(IFILE* ifile, const Options* options) {
   emit_externals(ifile->st, ofile);
   emit_publics(ifile->st, ofile);
 
-  LEX* lex = new_lex(source_name(ifile->source));
-  for (ifile->pos = 0; ifile->pos < irec_count(ifile); ifile->pos++)
-    process_irec(&state, ifile, lex, ofile);
+  if (options->list_cycles)
+    state.timing = new_timing();
+
+  LEX* lex = new_lex(source_name(ifile->source), ifile->st->names);
+  // instructions are timed in order
+  unsigned ranges = state.timing ? 1 : encoding_ranges(ifile, options);
+  if (ranges > 1 && encode_ranges(&state, ifile, ofile, ranges)) {
+    if (options->verbose)
+      printf("Encoded in %u ranges\n", ranges);
+  }
+  else {
+    for (ifile->pos = 0; ifile->pos < irec_count(ifile); ifile->pos++)
+      process_irec(&state, ifile, lex, ofile);
+  }
 
   if (ifile->start_label != NULL)
     emit_start(ifile, ofile);
@@ -59,14 +80,270 @@ OFILE* encoding_pass(IFILE* ifile, const Options* options) {
 
   delete_lex(lex);
 
+  if (state.timing) {
+    if (state.errors == 0)
+      print_timing(state.timing, ifile, cpu_enabled(state.cpu, P286N));
+    delete_timing(state.timing);
+  }
+
   if (state.errors > 0) {
-    fprintf(stderr, "Errors: %u\n", state.errors);
-    exit(EXIT_FAILURE);
+    fprintf(error_stream(), "Errors: %u\n", state.errors);
+    delete_ofile(ofile);
+    fail();
   }
 
   return ofile;
 }
 
+// Once sizes are fixed, a quick scan through the file finds the state and
+// location counters at any record without encoding. The records are divided
+// into contiguous ranges, each encoded on its own thread with its own state,
+// lexer, location counters and object records, and the object records are
+// concatenated in order.
+// If any range meets an error, or does not finish in the state in which its
+// successor started, the file is encoded sequentially instead, so that errors
+// are reported in order and exactly as before. A range that fails is ended
+// as a job of its own, its messages kept apart, so that the failure is
+// reported and ends the assembly on the calling thread instead.
+
+#define MAX_RANGES (16)
+#define MIN_RANGE_RECORDS (2048)
+
+typedef struct {
+  const IFILE* ifile;
+  unsigned first;  // first record
+  unsigned end;    // one past last record
+  STATE start_state;
+  STATE end_state;
+  DWORD* start_pc;  // segment location counters
+  DWORD* end_pc;
+  OFILE* ofile;
+  FILE* errors;  // of the job encoding the range, discarded
+  bool failed;
+  unsigned long long counts[PROFILE_COUNTERS];  // profile counts of a worker thread
+} RANGE;
+
+static unsigned encoding_ranges(IFILE* ifile, const Options* options) {
+#ifdef ENCODING_THREADS
+  unsigned ranges = irec_count(ifile) / MIN_RANGE_RECORDS;
+  if (ranges > options->threads)
+    ranges = options->threads;
+  return (ranges < MAX_RANGES) ? ranges : MAX_RANGES;
+#else
+  (void) ifile;
+  (void) options;
+  return 1;
+#endif
+}
+
+static void scan_irec(STATE*, IFILE*, LEX*, OFILE*);
+static void perform_directive(STATE*, IFILE*, IREC*, LEX*, OFILE*);
+static void run_ranges(RANGE*, unsigned ranges);
+static bool same_state(const STATE*, const STATE*);
+
+// TRUE if the records have been encoded into ofile.
+static bool encode_ranges(STATE* state, IFILE* ifile, OFILE* ofile, unsigned ranges) {
+  assert(state != NULL);
+  assert(ifile != NULL);
+  assert(ranges >= 1 && ranges <= MAX_RANGES);
+
+  if (ifile->dollar == NULL)
+    return false;
+
+  const unsigned count = irec_count(ifile);
+  const SEGNO nseg = segment_count(ifile);
+  RANGE range[MAX_RANGES];
+  STATE scan = *state;
+  scan.quiet = true;
+
+  TRACE_BEGIN("scan ranges");
+  LEX* lex = new_lex(source_name(ifile->source), ifile->st->names);
+  OFILE* scratch = new_ofile();
+  unsigned r = 0;
+  for (ifile->pos = 0; ifile->pos < count; ifile->pos++) {
+    if (r < ranges && ifile->pos == (unsigned long long) count * r / ranges) {
+      RANGE* p = &range[r++];
+      p->ifile = ifile;
+      p->first = ifile->pos;
+      p->start_state = scan;
+      p->start_pc = emalloc((nseg + 1) * sizeof p->start_pc[0]);
+      p->end_pc = emalloc((nseg + 1) * sizeof p->end_pc[0]);
+      for (SEGNO seg = 0; seg < nseg; seg++)
+        p->start_pc[seg] = segment_pc(ifile, seg);
+      p->ofile = new_ofile();
+      p->errors = tmpfile();
+      p->failed = false;
+    }
+    scan_irec(&scan, ifile, lex, scratch);
+  }
+  delete_ofile(scratch);
+  delete_lex(lex);
+  TRACE_END();
+
+  assert(r == ranges);
+  for (r = 0; r < ranges; r++)
+    range[r].end = (r + 1 < ranges) ? range[r + 1].first : count;
+
+  bool ok = (scan.errors == 0);
+  for (r = 0; ok && r < ranges; r++)
+    ok = (range[r].errors != NULL);
+  if (ok)
+    run_ranges(range, ranges);
+
+  for (r = 0; ok && r < ranges; r++) {
+    const RANGE* p = &range[r];
+    if (p->failed || p->end_state.errors)
+      ok = false;
+    else if (r + 1 < ranges)
+      ok = same_state(&p->end_state, &range[r + 1].start_state) &&
+           memcmp(p->end_pc, range[r + 1].start_pc, nseg * sizeof p->end_pc[0]) == 0;
+    else {
+      ok = same_state(&p->end_state, &scan);
+      for (SEGNO seg = 0; ok && seg < nseg; seg++)
+        ok = (p->end_pc[seg] == segment_pc(ifile, seg));
+    }
+  }
+
+  for (r = 0; r < ranges; r++) {
+    if (ok)
+      append_object_records(ofile, range[r].ofile);
+    delete_ofile(range[r].ofile);
+    if (range[r].errors)
+      fclose(range[r].errors);
+    efree(range[r].start_pc);
+    efree(range[r].end_pc);
+  }
+
+  if (ok) {
+    // location counters are as at the end of the scan
+    *state = scan;
+    state->quiet = false;
+  }
+  else
+    reset_pc(ifile);
+
+  return ok;
+}
+
+// Advance state and location counters over a record without encoding it.
+static void scan_irec(STATE* state, IFILE* ifile, LEX* lex, OFILE* scratch) {
+  IREC* irec = get_irec(ifile, ifile->pos);
+
+  switch (irec->op) {
+    case TOK_ASSUME:
+    case TOK_CODESEG:
+    case TOK_DATASEG:
+    case TOK_END:
+    case TOK_ENDS:
+    case TOK_JUMPS:
+    case TOK_ORG:
+    case TOK_SEGMENT:
+    case TOK_UDATASEG:
+    case TOK_P286:
+    case TOK_P286N:
+    case TOK_P287:
+    case TOK_P8086:
+    case TOK_P8087:
+    case TOK_PNO87:
+      lex_begin(lex, irec_text(ifile, irec), irec_lineno(ifile, irec), irec->operand_pos);
+      perform_directive(state, ifile, irec, lex, scratch);
+      break;
+    default:
+      if (state->curseg != NO_SEG)
+        inc_segment_pc(ifile, state->curseg, irec->size);
+      break;
+  }
+}
+
+typedef struct {
+  STATE* state;
+  IFILE* ifile;
+  LEX* lex;
+  OFILE* ofile;
+  unsigned end;
+} RANGE_ENCODING;
+
+static void range_job(void* arg) {
+  RANGE_ENCODING* e = arg;
+  for (; e->ifile->pos < e->end; e->ifile->pos++)
+    process_irec(e->state, e->ifile, e->lex, e->ofile);
+}
+
+static void encode_range(RANGE* p) {
+  // a copy of the file has its own location counters and '$'
+  IFILE ifile = *p->ifile;
+  SYMBOL dollar = *ifile.dollar;
+  ifile.dollar = &dollar;
+
+  const SEGNO nseg = segment_count(&ifile);
+  ifile.segments = emalloc((nseg + 1) * sizeof ifile.segments[0]);
+  memcpy(ifile.segments, p->ifile->segments, nseg * sizeof ifile.segments[0]);
+  ifile.segments_allocated = nseg + 1;
+  for (SEGNO seg = 0; seg < nseg; seg++)
+    set_segment_pc(&ifile, seg, p->start_pc[seg]);
+
+  STATE state = p->start_state;
+  LEX* lex = new_lex(source_name(ifile.source), ifile.st->names);
+
+  TRACE_BEGIN("encode records %u-%u", p->first, p->end - 1);
+  ifile.pos = p->first;
+  RANGE_ENCODING e = { &state, &ifile, lex, p->ofile, p->end };
+  p->failed = !run_job(range_job, &e, p->errors);
+  TRACE_END();
+
+  delete_lex(lex);
+
+  p->end_state = state;
+  for (SEGNO seg = 0; seg < nseg; seg++)
+    p->end_pc[seg] = segment_pc(&ifile, seg);
+
+  efree(ifile.segments);
+}
+
+#ifdef ENCODING_THREADS
+static int range_thread(void* p) {
+  RANGE* range = p;
+  TRACE_THREAD("encoding worker");
+  encode_range(range);
+  memcpy(range->counts, profile_counts, sizeof range->counts);
+  return 0;
+}
+#endif
+
+static void run_ranges(RANGE* range, unsigned ranges) {
+#ifdef ENCODING_THREADS
+  thrd_t thread[MAX_RANGES];
+  bool started[MAX_RANGES] = { false };
+
+  for (unsigned r = 1; r < ranges; r++)
+    started[r] = (thrd_create(&thread[r], range_thread, &range[r]) == thrd_success);
+
+  encode_range(&range[0]);
+
+  for (unsigned r = 1; r < ranges; r++) {
+    if (started[r]) {
+      thrd_join(thread[r], NULL);
+      add_profile_counts(range[r].counts);
+    }
+    else
+      encode_range(&range[r]);
+  }
+#else
+  for (unsigned r = 0; r < ranges; r++)
+    encode_range(&range[r]);
+#endif
+}
+
+static bool same_state(const STATE* a, const STATE* b) {
+  if (a->curseg != b->curseg || a->cpu != b->cpu || a->jumps != b->jumps)
+    return false;
+  for (int i = 0; i < N_SREG; i++) {
+    if (a->assume_sym[i] != b->assume_sym[i])
+      return false;
+  }
+  return true;
+}
+
 static void emit_uninit_segments(STATE* state, IFILE* ifile, OFILE* ofile) {
   for (SEGNO segno = 0; segno < segment_count(ifile); segno++) {
     if (segment_uninit(ifile, segno)) {
@@ -74,9 +351,9 @@ static void emit_uninit_segments(STATE* state, IFILE* ifile, OFILE* ofile) {
       if (size > (WORD)(-1))
         error(state, ifile, "uninitialised segment is too large: %s", segment_name(ifile, segno));
       else {
-        emit_object_byte(ofile, OBJ_OPEN_SEGMENT, (BYTE) segno);
+        emit_object_word(ofile, OBJ_OPEN_SEGMENT, (WORD) segno);
         emit_object_word(ofile, OBJ_SPACE, (WORD) size);
-        emit_object_byte(ofile, OBJ_CLOSE_SEGMENT, (BYTE) segno);
+        emit_object_word(ofile, OBJ_CLOSE_SEGMENT, (WORD) segno);
       }
     }
   }
@@ -84,16 +361,16 @@ static void emit_uninit_segments(STATE* state, IFILE* ifile, OFILE* ofile) {
 
 static void emit_segno(OFILE* ofile, SEGNO segno) {
   assert(segno >= 0);
-  if (segno > 0xff)
-    fatal("cannot emit segment number > 255\n");
-  emit_object_byte(ofile, OBJ_SEGNO, (BYTE)segno);
+  if (segno > (WORD)(-1))
+    fatal("cannot emit segment number beyond 64K\n");
+  emit_object_word(ofile, OBJ_SEGNO, (WORD) segno);
 }
 
 static void emit_groupno(OFILE* ofile, GROUPNO group) {
   assert(group >= 0);
-  if (group > 0xff)
-    fatal("cannot emit group number beyond 255\n");
-  emit_object_byte(ofile, OBJ_GROUPNO, (BYTE) group);
+  if (group > (WORD)(-1))
+    fatal("cannot emit group number beyond 64K\n");
+  emit_object_word(ofile, OBJ_GROUPNO, (WORD) group);
 }
 
 static void emit_start(IFILE* ifile, OFILE* ofile) {
@@ -144,9 +421,9 @@ static void emit_segment(IFILE* ifile, SEGNO segno, OFILE* ofile) {
   emit_object_signal(ofile, OBJ_BEGIN_SEGMENT);
 
   assert(segno >= 0);
-  if (segno > 0xff)
-    fatal("cannot emit segment number beyond 255\n");
-  emit_object_byte(ofile, OBJ_ORDINAL, (BYTE) segno);
+  if (segno > (WORD)(-1))
+    fatal("cannot emit segment number beyond 64K\n");
+  emit_object_word(ofile, OBJ_ORDINAL, (WORD) segno);
 
   const char* name = segment_name(ifile, segno);
   emit_string(ofile, OBJ_NAME, name);
@@ -173,9 +450,9 @@ static void emit_group(GROUPNO groupno, const char* name, OFILE* ofile) {
 
   emit_object_signal(ofile, OBJ_BEGIN_GROUP);
 
-  if (groupno > 0xff)
-    fatal("cannot emit group number beyond 255\n");
-  emit_object_byte(ofile, OBJ_ORDINAL, (BYTE) groupno);
+  if (groupno > (WORD)(-1))
+    fatal("cannot emit group number beyond 64K\n");
+  emit_object_word(ofile, OBJ_ORDINAL, (WORD) groupno);
 
   emit_string(ofile, OBJ_NAME, name);
 
@@ -266,6 +543,7 @@ static void do_dataseg(STATE*, IFILE*, LEX*, OFILE*);
 static void do_end(STATE*, IFILE*, IREC*, LEX*, OFILE*);
 static void do_ends(STATE*, IFILE*, IREC*, LEX*, OFILE*);
 static void do_extrn(STATE*, IFILE*, IREC*, LEX*, OFILE*);
+static void do_incbin(STATE*, IFILE*, IREC*, LEX*, OFILE*);
 static void do_org(STATE*, IFILE*, IREC*, LEX*, OFILE*);
 static void do_public(STATE*, IFILE*, IREC*, LEX*, OFILE*);
 static void do_segment(STATE*, IFILE*, IREC*, LEX*, OFILE*);
@@ -304,6 +582,7 @@ static void perform_directive(STATE* state, IFILE* ifile, IREC* irec, LEX* lex,
     case '=': lex_discard_line(lex); break; // already handled
     case TOK_EXTRN: do_extrn(state, ifile, irec, lex, ofile); break;
     case TOK_GROUP: lex_discard_line(lex); break; // already handled
+    case TOK_INCBIN: do_incbin(state, ifile, irec, lex, ofile); break;
     case TOK_JUMPS: state->jumps = true; break;
     case TOK_MODEL: lex_discard_line(lex); break; // already handled
     case TOK_ORG: do_org(state, ifile, irec, lex, ofile); break;
@@ -333,8 +612,8 @@ static void do_end(STATE* state, IFILE* ifile, IREC* irec, LEX* lex, OFILE* ofil
 
   if (state->curseg != NO_SEG) {
     assert(ifile->model_group); // otherwise caught in pass 1
-    assert(state->curseg >= 0 && state->curseg < 0x100);
-    emit_object_byte(ofile, OBJ_CLOSE_SEGMENT, (BYTE) state->curseg);
+    assert(state->curseg >= 0 && state->curseg <= (WORD)(-1));
+    emit_object_word(ofile, OBJ_CLOSE_SEGMENT, (WORD) state->curseg);
     state->curseg = NO_SEG;
   }
 
@@ -360,18 +639,18 @@ static void do_segment(STATE* state, IFILE* ifile, IREC* irec, LEX* lex, OFILE*
   if (state->curseg != NO_SEG)
     error2(state, lex, "segment %s is already open", segment_name(ifile, state->curseg));
 
-  SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+  SYMBOL* sym = sym_lookup_id(ifile->st, lex_name(lex));
   if (sym == NULL || sym_type(sym) != SYM_SECTION || sym_section_type(sym) != ST_SEGMENT) {
     error2(state, lex, "segment name expected: %s", lex_lexeme(lex));
-    exit(EXIT_FAILURE);
+    fail();
   }
 
   state->curseg = sym_section_ordinal(sym);
   assert(state->curseg >= 0);
-  if (state->curseg > 0xff)
-    fatal("cannot emit segment number > 255\n");
+  if (state->curseg > (WORD)(-1))
+    fatal("cannot emit segment number beyond 64K\n");
   if (!segment_uninit(ifile, state->curseg))
-    emit_object_byte(ofile, OBJ_OPEN_SEGMENT, (BYTE) state->curseg);
+    emit_object_word(ofile, OBJ_OPEN_SEGMENT, (WORD) state->curseg);
 
   skip_segment_attributes(lex);
 }
@@ -399,10 +678,10 @@ static void skip_segment_attributes(LEX* lex) {
 
 static void do_ends(STATE* state, IFILE* ifile, IREC* irec, LEX* lex, OFILE* ofile) {
   assert(state != NULL);
-  assert(state->curseg >= 0 && state->curseg < 0x100);
+  assert(state->curseg >= 0 && state->curseg <= (WORD)(-1));
 
   if (!segment_uninit(ifile, state->curseg))
-    emit_object_byte(ofile, OBJ_CLOSE_SEGMENT, (BYTE) state->curseg);
+    emit_object_word(ofile, OBJ_CLOSE_SEGMENT, (WORD) state->curseg);
   perform_ends(state, ifile, lex);
 }
 
@@ -469,10 +748,10 @@ static void assume(STATE* state, IFILE* ifile, LEX* lex) {
     return;
   }
 
-  SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+  SYMBOL* sym = sym_lookup_id(ifile->st, lex_name(lex));
   if (sym == NULL || !sym_defined(sym) || sym_type(sym) != SYM_SECTION) {
     error2(state, lex, "phase error: defined segment or group expected: %s", lex_lexeme(lex));
-    exit(EXIT_FAILURE);
+    fail();
   }
 
   state->assume_sym[reg] = sym;
@@ -482,35 +761,35 @@ static void assume(STATE* state, IFILE* ifile, LEX* lex) {
 
 static void do_codeseg(STATE* state, IFILE* ifile, LEX* lex, OFILE* ofile) {
   if (state->curseg != NO_SEG) {
-    assert(state->curseg >= 0 && state->curseg < 0x100);
-    emit_object_byte(ofile, OBJ_CLOSE_SEGMENT, (BYTE) state->curseg);
+    assert(state->curseg >= 0 && state->curseg <= (WORD)(-1));
+    emit_object_word(ofile, OBJ_CLOSE_SEGMENT, (WORD) state->curseg);
     state->curseg = NO_SEG;
   }
   perform_codeseg(state, ifile, lex);
-  assert(state->curseg >= 0 && state->curseg < 0x100);
-  emit_object_byte(ofile, OBJ_OPEN_SEGMENT, (BYTE) state->curseg);
+  assert(state->curseg >= 0 && state->curseg <= (WORD)(-1));
+  emit_object_word(ofile, OBJ_OPEN_SEGMENT, (WORD) state->curseg);
 }
 
 static void do_dataseg(STATE* state, IFILE* ifile, LEX* lex, OFILE* ofile) {
   if (state->curseg != NO_SEG) {
-    assert(state->curseg >= 0 && state->curseg < 0x100);
-    emit_object_byte(ofile, OBJ_CLOSE_SEGMENT, (BYTE) state->curseg);
+    assert(state->curseg >= 0 && state->curseg <= (WORD)(-1));
+    emit_object_word(ofile, OBJ_CLOSE_SEGMENT, (WORD) state->curseg);
     state->curseg = NO_SEG;
   }
   perform_dataseg(state, ifile, lex);
-  assert(state->curseg >= 0 && state->curseg < 0x100);
-  emit_object_byte(ofile, OBJ_OPEN_SEGMENT, (BYTE) state->curseg);
+  assert(state->curseg >= 0 && state->curseg <= (WORD)(-1));
+  emit_object_word(ofile, OBJ_OPEN_SEGMENT, (WORD) state->curseg);
 }
 
 static void do_udataseg(STATE* state, IFILE* ifile, LEX* lex, OFILE* ofile) {
   if (state->curseg != NO_SEG) {
-    assert(state->curseg >= 0 && state->curseg < 0x100);
-    emit_object_byte(ofile, OBJ_CLOSE_SEGMENT, (BYTE) state->curseg);
+    assert(state->curseg >= 0 && state->curseg <= (WORD)(-1));
+    emit_object_word(ofile, OBJ_CLOSE_SEGMENT, (WORD) state->curseg);
     state->curseg = NO_SEG;
   }
   perform_udataseg(state, ifile, lex);
-  assert(state->curseg >= 0 && state->curseg < 0x100);
-  emit_object_byte(ofile, OBJ_OPEN_SEGMENT, (BYTE) state->curseg);
+  assert(state->curseg >= 0 && state->curseg <= (WORD)(-1));
+  emit_object_word(ofile, OBJ_OPEN_SEGMENT, (WORD) state->curseg);
 }
 
 static void do_align(STATE* state, IFILE* ifile, IREC* irec, LEX* lex, OFILE* ofile) {
@@ -536,6 +815,7 @@ static void do_align(STATE* state, IFILE* ifile, IREC* irec, LEX* lex, OFILE* of
 }
 
 static DWORD generate_data(STATE* state, IFILE* ifile, OFILE* ofile, const DATA_NODE* node, EMIT_EXPR*);
+static void emit_data_image(OFILE*, const DATA_IMAGE*);
 
 static void define_data(STATE* state, IFILE* ifile, IREC* irec, LEX* lex, OFILE* ofile,
                         const char* descrip, bool valid_expr_type(int), EMIT_EXPR* emit_expr) {
@@ -546,6 +826,14 @@ static void define_data(STATE* state, IFILE* ifile, IREC* irec, LEX* lex, OFILE*
     return;
   }
 
+  if (irec->data) {
+    // absolute data encoded in pass 1
+    emit_data_image(ofile, irec->data);
+    inc_segment_pc(ifile, state->curseg, irec->size);
+    lex_discard_line(lex);
+    return;
+  }
+
   struct db_node * root = parse_data_list(state, ifile, lex, valid_expr_type, descrip);
 
   DWORD size = generate_data(state, ifile, ofile, root, emit_expr);
@@ -553,7 +841,7 @@ static void define_data(STATE* state, IFILE* ifile, IREC* irec, LEX* lex, OFILE*
   if (size != irec->size) {
     error(state, ifile, "internal error: data size discrepancy: sized %lu, emitted %lu",
           (unsigned long) irec->size, (unsigned long) size);
-    exit(EXIT_FAILURE);
+    fail();
   }
 
   free_db_node(root);
@@ -583,6 +871,78 @@ static DWORD generate_data(STATE* state, IFILE* ifile, OFILE* ofile, const DATA_
   return size;
 }
 
+// Emit the runs of folded data as strings of bytes, as long as a record allows.
+static void emit_data_image(OFILE* ofile, const DATA_IMAGE* image) {
+  BYTE buf[0xff];
+  unsigned n = 0;
+
+  for (unsigned i = 0; i < image->nrun; i++) {
+    const DATA_RUN* run = &image->runs[i];
+    for (DWORD r = 0; r < run->repeat; r++) {
+      for (unsigned j = 0; j < run->len; j++) {
+        buf[n++] = run->bytes[j];
+        if (n == sizeof buf) {
+          emit_object_data(ofile, OBJ_DS, buf, n);
+          n = 0;
+        }
+      }
+    }
+  }
+
+  if (n)
+    emit_object_data(ofile, OBJ_DS, buf, n);
+}
+
+static void stream_binary(STATE*, IFILE*, const INCBIN_OPERANDS*, DWORD size, OFILE*);
+
+static void do_incbin(STATE* state, IFILE* ifile, IREC* irec, LEX* lex, OFILE* ofile) {
+  assert(state != NULL);
+  assert(ifile != NULL);
+  assert(irec != NULL);
+  assert(irec->op == TOK_INCBIN);
+  assert(lex != NULL);
+
+  if (state->curseg == NO_SEG) {
+    error(state, ifile, "data outside segment");
+    lex_discard_line(lex);
+    return;
+  }
+
+  INCBIN_OPERANDS inc;
+  if (parse_incbin(state, ifile, lex, &inc)) {
+    stream_binary(state, ifile, &inc, irec->size, ofile);
+    efree(inc.path);
+  }
+  inc_segment_pc(ifile, state->curseg, irec->size);
+}
+
+// Copy the bytes sized in pass 1 from the file into records as long as
+// a record allows, holding no more than one record's bytes at a time.
+static void stream_binary(STATE* state, IFILE* ifile, const INCBIN_OPERANDS* inc, DWORD size, OFILE* ofile) {
+  FILE* fp = fopen(inc->path, "rb");
+  if (fp == NULL) {
+    error(state, ifile, "cannot open binary file: %s", inc->path);
+    return;
+  }
+
+  if (inc->offset > LONG_MAX || fseek(fp, (long) inc->offset, SEEK_SET) != 0)
+    error(state, ifile, "cannot seek in binary file: %s", inc->path);
+  else {
+    BYTE buf[0xff];
+    while (size > 0) {
+      const unsigned n = size < sizeof buf ? (unsigned) size : sizeof buf;
+      if (fread(buf, 1, n, fp) != n) {
+        error(state, ifile, "binary file changed during assembly: %s", inc->path);
+        break;
+      }
+      emit_object_data(ofile, OBJ_DS, buf, n);
+      size -= n;
+    }
+  }
+
+  fclose(fp);
+}
+
 static DWORD emit_byte_expr(STATE* state, IFILE* ifile, OFILE* ofile, int type, VALUE* val) {
   DWORD size = 0;
 
@@ -742,7 +1102,7 @@ static void check_public_symbol(STATE* state, IFILE* ifile, LEX* lex) {
     return;
   }
 
-  SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+  SYMBOL* sym = sym_lookup_id(ifile->st, lex_name(lex));
   if (sym == NULL || sym_type(sym) != SYM_RELATIVE || !sym_public(sym))
     error2(state, lex, "phase error: public symbol not set up correctly: %s", lex_lexeme(lex));
   else if (!sym_defined(sym))
@@ -775,7 +1135,7 @@ static void check_external_symbol(STATE* state, IFILE* ifile, LEX* lex) {
     return;
   }
 
-  SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+  SYMBOL* sym = sym_lookup_id(ifile->st, lex_name(lex));
   if (sym == NULL || sym_type(sym) != SYM_RELATIVE || !sym_external(sym))
     error2(state, lex, "phase error: external symbol not set up correctly: %s", lex_lexeme(lex));
 
@@ -837,6 +1197,7 @@ static void add_reloc(RELOC_LIST* p, const RELOC_REQ* req, BOOL jump, DWORD pos)
 
   if (p->count >= MAX_RELOC)
     fatal("too many relocations\n");
+  PROFILE_COUNT(PC_FIXUPS);
   p->relocs[p->count].pos = pos;
   p->relocs[p->count].type = req->type;
   p->relocs[p->count].jump = jump;
@@ -891,7 +1252,7 @@ static void process_instruction(STATE* state, IFILE* ifile, IREC* irec, LEX* lex
     }
     default:
       error2(state, lex, "internal error: CS assume section unresolved to segment or group");
-      exit(EXIT_FAILURE);
+      fail();
   }
 
   OPERAND oper1, oper2, oper3;
@@ -914,7 +1275,7 @@ static void process_instruction(STATE* state, IFILE* ifile, IREC* irec, LEX* lex
   if (encoded != irec->size) {
     error2(state, lex, "internal error: instruction size discrepancy: sized %lu encoded %u",
           (unsigned long) irec->size, encoded);
-    exit(EXIT_FAILURE);
+    fail();
   }
 
   emit_object_data(ofile, OBJ_CODE, buf, irec->size);
@@ -922,6 +1283,10 @@ static void process_instruction(STATE* state, IFILE* ifile, IREC* irec, LEX* lex
   for (unsigned i = 0; i < relocs.count; i++)
     emit_relocation(state, ifile, relocs.relocs + i, ofile);
 
+  if (state->timing)
+    time_instruction(state->timing, ifile, ifile->pos, state->curseg, segment_pc(ifile, state->curseg),
+                     buf, irec->size, relocs.count > 0);
+
   inc_segment_pc(ifile, state->curseg, irec->size);
 }
 
@@ -1771,6 +2136,10 @@ static BYTE encode_modrm(unsigned mod, unsigned reg, unsigned rm) {
 #ifdef UNIT_TEST
 
 #include "CuTest.h"
+#include "sourcepass.h"
+#include "pass1.h"
+#include "resize.h"
+#include "passes.h"
 
 static void test_reloc(CuTest* tc) {
   RELOC_LIST list;
@@ -1790,9 +2159,439 @@ static void test_reloc(CuTest* tc) {
   CuAssertIntEquals(tc, TRUE, list.relocs[0].jump);
 }
 
+static const char ranges_source[] =
+  "  IDEAL\n"
+  "  JUMPS\n"
+  "  SEGMENT DATA\n"
+  "count DW 3\n"
+  "text DB 'hello', 0\n"
+  "table DW count, text, 1234h\n"
+  "  ENDS\n"
+  "  SEGMENT CODE\n"
+  "  ASSUME CS:CODE, DS:DATA\n"
+  "start:\n"
+  "  mov ax, DATA\n"
+  "  mov ds, ax\n"
+  "  mov cx, [count]\n"
+  "again:\n"
+  "  mov si, OFFSET text\n"
+  "  add si, 2\n"
+  "  loop again\n"
+  "  cmp cx, 1\n"
+  "  je done\n"
+  "  DB 200 DUP (90h)\n"
+  "  ALIGN 4\n"
+  "  P286\n"
+  "  push 5\n"
+  "  jmp start\n"
+  "done:\n"
+  "  ret\n"
+  "  ENDS\n"
+  "  SEGMENT DATA\n"
+  "more DB 7\n"
+  "  ENDS\n"
+  "  END start\n";
+
+static IFILE* ranges_ifile(SOURCE* src, Options* opts) {
+  IFILE* ifile = new_ifile(src, false);
+  source_pass(ifile, opts);
+  pass1(ifile, opts);
+  if (ifile->provisional_sizes) {
+    while (resize_pass(ifile, opts))
+      ;
+  }
+  return ifile;
+}
+
+static void test_encode_ranges(CuTest* tc) {
+  Options* opts = new_options();
+  SOURCE* src = load_source_mem(ranges_source);
+  IFILE* ifile = ranges_ifile(src, opts);
+  STATE state;
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
+
+  init_state(&state, opts->max_errors);
+  reset_pc(ifile);
+  OFILE* sequential = new_ofile();
+  for (ifile->pos = 0; ifile->pos < irec_count(ifile); ifile->pos++)
+    process_irec(&state, ifile, lex, sequential);
+  CuAssertIntEquals(tc, 0, state.errors);
+  const STATE end_state = state;
+  const DWORD data_size = segment_pc(ifile, 0);
+  const DWORD code_size = segment_pc(ifile, 1);
+
+  for (unsigned ranges = 1; ranges <= 5; ranges++) {
+    init_state(&state, opts->max_errors);
+    reset_pc(ifile);
+    OFILE* ranged = new_ofile();
+    CuAssertIntEquals(tc, true, encode_ranges(&state, ifile, ranged, ranges));
+    CuAssertIntEquals(tc, true, same_state(&end_state, &state));
+    CuAssertIntEquals(tc, false, state.quiet);
+    CuAssertIntEquals(tc, data_size, segment_pc(ifile, 0));
+    CuAssertIntEquals(tc, code_size, segment_pc(ifile, 1));
+    CuAssertIntEquals(tc, sequential->used, ranged->used);
+    for (unsigned i = 0; i < sequential->used; i++)
+      CuAssertIntEquals(tc, TRUE, same_orec(&sequential->recs[i], &ranged->recs[i]));
+    delete_ofile(ranged);
+  }
+
+  delete_ofile(sequential);
+  delete_lex(lex);
+  delete_ifile(ifile);
+  delete_source(src);
+  delete_options(opts);
+}
+
+static void test_encode_ranges_error(CuTest* tc) {
+  Options* opts = new_options();
+  SOURCE* src = load_source_mem(ranges_source);
+  IFILE* ifile = ranges_ifile(src, opts);
+  STATE state;
+
+  // a phase error: the caller must encode sequentially
+  unsigned i = 0;
+  while (i < irec_count(ifile) && get_irec(ifile, i)->op != TOK_ALIGN)
+    i++;
+  CuAssertTrue(tc, i < irec_count(ifile));
+  get_irec(ifile, i)->size++;
+
+  init_state(&state, opts->max_errors);
+  reset_pc(ifile);
+  OFILE* ofile = new_ofile();
+  CuAssertIntEquals(tc, false, encode_ranges(&state, ifile, ofile, 3));
+  CuAssertIntEquals(tc, 0, ofile->used);
+  CuAssertIntEquals(tc, 0, state.errors);
+  CuAssertIntEquals(tc, 0, segment_pc(ifile, 0));
+
+  delete_ofile(ofile);
+  delete_ifile(ifile);
+  delete_source(src);
+  delete_options(opts);
+}
+
+// A range failing on a worker thread ends only its own job.
+static void test_encode_ranges_failure(CuTest* tc) {
+  Options* opts = new_options();
+  SOURCE* src = load_source_mem(ranges_source);
+  IFILE* ifile = ranges_ifile(src, opts);
+  STATE state;
+
+  // an instruction size discrepancy in the last range
+  unsigned i = irec_count(ifile);
+  while (i > 0 && get_irec(ifile, i - 1)->op != TOK_RET)
+    i--;
+  CuAssertTrue(tc, i > 0);
+  get_irec(ifile, i - 1)->size++;
+
+  init_state(&state, opts->max_errors);
+  reset_pc(ifile);
+  OFILE* ofile = new_ofile();
+  CuAssertIntEquals(tc, false, encode_ranges(&state, ifile, ofile, 3));
+  CuAssertIntEquals(tc, 0, ofile->used);
+  CuAssertIntEquals(tc, 0, state.errors);
+
+  delete_ofile(ofile);
+  delete_ifile(ifile);
+  delete_source(src);
+  delete_options(opts);
+}
+
+static void test_folded_data(CuTest* tc) {
+  static const char source[] =
+    "  IDEAL\n"
+    "  SEGMENT DATA\n"
+    "one DB 1, 2, 'ab'\n"
+    "  DW 1234h, 'c'\n"
+    "  DB 3 DUP (5, 6)\n"
+    "  DB 2 DUP (2 DUP (7), 8)\n"
+    "  DW 0 DUP (1)\n"
+    "  DW one\n"
+    "  ENDS\n"
+    "  END\n";
+  static const BYTE expected[] = {
+    1, 2, 'a', 'b', 0x34, 0x12, 'c', 0, 5, 6, 5, 6, 5, 6, 7, 7, 8, 7, 7, 8
+  };
+  Options* opts = new_options();
+  SOURCE* src = load_source_mem(source);
+  IFILE* ifile = ranges_ifile(src, opts);
+  STATE state;
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
+
+  unsigned folded = 0, parsed = 0;
+  for (unsigned i = 0; i < irec_count(ifile); i++) {
+    const IREC* irec = get_irec(ifile, i);
+    if (irec->op == TOK_DB || irec->op == TOK_DW) {
+      if (irec->data)
+        folded++;
+      else
+        parsed++;
+    }
+  }
+  // all but the label and the empty DUP
+  CuAssertIntEquals(tc, 4, folded);
+  CuAssertIntEquals(tc, 2, parsed);
+
+  init_state(&state, opts->max_errors);
+  reset_pc(ifile);
+  OFILE* ofile = new_ofile();
+  for (ifile->pos = 0; ifile->pos < irec_count(ifile); ifile->pos++)
+    process_irec(&state, ifile, lex, ofile);
+  CuAssertIntEquals(tc, 0, state.errors);
+  CuAssertIntEquals(tc, sizeof expected + 2, segment_pc(ifile, 0));
+
+  BYTE bytes[sizeof expected];
+  unsigned n = 0;
+  for (unsigned i = 0; i < ofile->used && n < sizeof expected; i++) {
+    const OREC* rec = &ofile->recs[i];
+    if (rec->type == OBJ_DS) {
+      CuAssertTrue(tc, n + rec->u.data.size <= sizeof expected);
+      memcpy(bytes + n, rec->u.data.buf, rec->u.data.size);
+      n += rec->u.data.size;
+    }
+  }
+  CuAssertIntEquals(tc, sizeof expected, n);
+  CuAssertTrue(tc, memcmp(bytes, expected, n) == 0);
+
+  delete_ofile(ofile);
+  delete_lex(lex);
+  delete_ifile(ifile);
+  delete_source(src);
+  delete_options(opts);
+}
+
+static void test_incbin(CuTest* tc) {
+  static const char source[] =
+    "  IDEAL\n"
+    "  SEGMENT DATA\n"
+    "table INCBIN 'incbin_test.bin'\n"
+    "  INCBIN 'incbin_test.bin', 10, 3\n"
+    "  INCBIN 'incbin_test.bin', 598\n"
+    "  DB 1\n"
+    "  ENDS\n"
+    "  END\n";
+  const char* const binary = "incbin_test.bin";
+  enum { FILE_SIZE = 600 };
+  BYTE expected[FILE_SIZE + 3 + 2 + 1];
+
+  FILE* fp = efopen(binary, "wb", "writing");
+  for (unsigned i = 0; i < FILE_SIZE; i++) {
+    expected[i] = (BYTE) (i * 7);
+    putc(expected[i], fp);
+  }
+  fclose(fp);
+  memcpy(expected + FILE_SIZE, expected + 10, 3);
+  memcpy(expected + FILE_SIZE + 3, expected + 598, 2);
+  expected[FILE_SIZE + 5] = 1;
+
+  Options* opts = new_options();
+  SOURCE* src = load_source_mem(source);
+  IFILE* ifile = ranges_ifile(src, opts);
+  STATE state;
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
+
+  CuAssertIntEquals(tc, 3, stringlist_count(ifile->incbins));
+  for (unsigned i = 0; i < 3; i++)
+    CuAssertStrEquals(tc, binary, stringlist_item(ifile->incbins, i));
+
+  const SYMBOL* table = sym_lookup(ifile->st, "table");
+  CuAssertPtrNotNull(tc, table);
+  CuAssertIntEquals(tc, 1, sym_data_size(table));
+
+  init_state(&state, opts->max_errors);
+  reset_pc(ifile);
+  OFILE* ofile = new_ofile();
+  for (ifile->pos = 0; ifile->pos < irec_count(ifile); ifile->pos++)
+    process_irec(&state, ifile, lex, ofile);
+  CuAssertIntEquals(tc, 0, state.errors);
+  CuAssertIntEquals(tc, sizeof expected, segment_pc(ifile, 0));
+
+  BYTE bytes[sizeof expected];
+  unsigned n = 0;
+  for (unsigned i = 0; i < ofile->used; i++) {
+    const OREC* rec = &ofile->recs[i];
+    if (rec->type == OBJ_DS) {
+      CuAssertTrue(tc, n + rec->u.data.size <= sizeof expected);
+      memcpy(bytes + n, rec->u.data.buf, rec->u.data.size);
+      n += rec->u.data.size;
+    }
+  }
+  CuAssertIntEquals(tc, sizeof expected, n);
+  CuAssertTrue(tc, memcmp(bytes, expected, n) == 0);
+
+  delete_ofile(ofile);
+  delete_lex(lex);
+  delete_ifile(ifile);
+  delete_source(src);
+  delete_options(opts);
+  remove(binary);
+}
+
+typedef struct {
+  SOURCE* src;
+  const Options* opts;
+  PROFILE* profile;
+} PASSES_ARGS;
+
+static void passes_of(void* arg) {
+  PASSES_ARGS* a = arg;
+  delete_ofile(run_passes(a->src, a->opts, a->profile, NULL));
+}
+
+// Failing passes leave nothing allocated, for a resident caller to go on.
+static void test_failed_passes(CuTest* tc) {
+  static const char source[] =
+    "  IDEAL\n"
+    "  SEGMENT CODE\n"
+    "  mov ax, bl\n"
+    "  ENDS\n"
+    "  END\n";
+  Options* opts = new_options();
+  SOURCE* src = load_source_mem(source);
+  PROFILE* profile = new_profile();
+  PASSES_ARGS args = { src, opts, profile };
+  FILE* errors = tmpfile();
+  CuAssertPtrNotNull(tc, errors);
+
+  unsigned long mallocs, frees, mallocs_after, frees_after;
+  get_memory_counts(&mallocs, &frees);
+  CuAssertIntEquals(tc, false, run_job(passes_of, &args, errors));
+  get_memory_counts(&mallocs_after, &frees_after);
+  CuAssertTrue(tc, mallocs_after - mallocs == frees_after - frees);
+
+  fclose(errors);
+  delete_profile(profile);
+  delete_source(src);
+  delete_options(opts);
+}
+
+static void test_shortest_forms(CuTest* tc) {
+  static const char source[] =
+    "  IDEAL\n"
+    "  SEGMENT CODE\n"
+    "  ASSUME CS:CODE, DS:CODE\n"
+    "v DW 0\n"
+    "  mov ax, [v]\n"
+    "  add bx, 5\n"
+    "  add ax, 5\n"
+    "  cmp [WORD bx], -2\n"
+    "  mov dx, [bx+0]\n"
+    "  mov dx, [bp+0]\n"
+    "  xchg ax, si\n"
+    "  ENDS\n"
+    "  END\n";
+  static const struct {
+    BYTE opcode;
+    MemSize size;
+  } expected[] = {
+    { 0xA1, 3 },
+    { 0x83, 3 },
+    { 0x05, 3 },
+    { 0x83, 3 },
+    { 0x8B, 2 },
+    { 0x8B, 3 },
+    { 0x90, 1 },
+  };
+
+  for (int tasm = 0; tasm < 2; tasm++) {
+    Options* opts = new_options();
+    opts->tasm_encoding = tasm;
+    SOURCE* src = load_source_mem(source);
+    IFILE* ifile = ranges_ifile(src, opts);
+
+    unsigned n = 0;
+    for (unsigned i = 0; i < irec_count(ifile); i++) {
+      const IREC* irec = get_irec(ifile, i);
+      if (irec->def) {
+        CuAssertTrue(tc, n < sizeof expected / sizeof expected[0]);
+        CuAssertIntEquals(tc, expected[n].opcode, irec->def->opcode1);
+        CuAssertIntEquals(tc, expected[n].size, irec->size);
+        CuAssertIntEquals(tc, 0, irec->shortened);
+        n++;
+      }
+    }
+    CuAssertIntEquals(tc, sizeof expected / sizeof expected[0], n);
+
+    delete_ifile(ifile);
+    delete_source(src);
+    delete_options(opts);
+  }
+}
+
+static void test_timing(CuTest* tc) {
+  static const char source[] =
+    "  IDEAL\n"
+    "  SEGMENT CODE\n"
+    "  ASSUME CS:CODE, DS:CODE\n"
+    "v DW 0\n"
+    "start:\n"
+    "  mov cx, 10\n"
+    "again:\n"
+    "  add ax, [v]\n"
+    "  dec cx\n"
+    "  jnz again\n"
+    "  jz done\n"
+    "  jmp start\n"
+    "done:\n"
+    "  ret\n"
+    "  ENDS\n"
+    "  END\n";
+  // 8086, 286: the backward JNZ is taken, the forward JZ not
+  static const unsigned expected[][CYCLE_MODELS] = {
+    { 4, 2 },
+    { 15, 7 },
+    { 2, 2 },
+    { 16, 9 },
+    { 4, 3 },
+    { 15, 9 },
+    { 20, 13 },
+  };
+  const unsigned count = sizeof expected / sizeof expected[0];
+
+  Options* opts = new_options();
+  SOURCE* src = load_source_mem(source);
+  IFILE* ifile = ranges_ifile(src, opts);
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
+  STATE state;
+  OFILE* ofile = new_ofile();
+
+  init_state(&state, opts->max_errors);
+  state.timing = new_timing();
+  reset_pc(ifile);
+  for (ifile->pos = 0; ifile->pos < irec_count(ifile); ifile->pos++)
+    process_irec(&state, ifile, lex, ofile);
+  CuAssertIntEquals(tc, 0, state.errors);
+
+  CuAssertIntEquals(tc, count, timed_count(state.timing));
+  for (unsigned i = 0; i < count; i++) {
+    for (int model = 0; model < CYCLE_MODELS; model++)
+      CuAssertIntEquals(tc, expected[i][model], timed_cycles(state.timing, i, model));
+  }
+  CuAssertIntEquals(tc, 0, loop_cycles(state.timing, 2, CYCLES_8086));
+  CuAssertIntEquals(tc, 0, loop_cycles(state.timing, 4, CYCLES_8086));
+  CuAssertIntEquals(tc, 15 + 2 + 16, loop_cycles(state.timing, 3, CYCLES_8086));
+  CuAssertIntEquals(tc, 7 + 2 + 9, loop_cycles(state.timing, 3, CYCLES_286));
+  CuAssertIntEquals(tc, 4 + 15 + 2 + 16 + 4 + 15, loop_cycles(state.timing, 5, CYCLES_8086));
+  CuAssertIntEquals(tc, 2 + 7 + 2 + 9 + 3 + 9, loop_cycles(state.timing, 5, CYCLES_286));
+
+  delete_timing(state.timing);
+  delete_ofile(ofile);
+  delete_lex(lex);
+  delete_ifile(ifile);
+  delete_source(src);
+  delete_options(opts);
+}
+
 CuSuite* encoding_test_suite(void) {
   CuSuite* suite = CuSuiteNew();
   SUITE_ADD_TEST(suite, test_reloc);
+  SUITE_ADD_TEST(suite, test_encode_ranges);
+  SUITE_ADD_TEST(suite, test_encode_ranges_error);
+  SUITE_ADD_TEST(suite, test_encode_ranges_failure);
+  SUITE_ADD_TEST(suite, test_folded_data);
+  SUITE_ADD_TEST(suite, test_incbin);
+  SUITE_ADD_TEST(suite, test_failed_passes);
+  SUITE_ADD_TEST(suite, test_shortest_forms);
+  SUITE_ADD_TEST(suite, test_timing);
   return suite;
 }
 
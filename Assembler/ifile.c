@@ -20,30 +20,42 @@ IFILE* new_ifile(SOURCE* src, bool case_sensitive) {
   ifile->recs = NULL;
   ifile->allocated = 0;
   ifile->used = 0;
+  ifile->tail = 0;
   ifile->pos = 0;
   ifile->st = new_symbol_table(case_sensitive);
+  ifile->dollar = NULL;
   ifile->start_label = NULL;
   ifile->provisional_sizes = FALSE;
+  ifile->groups = NULL;
   ifile->ngroup = 0;
+  ifile->groups_allocated = 0;
+  ifile->segments = NULL;
   ifile->nseg = 0;
+  ifile->segments_allocated = 0;
   ifile->model_group = NULL;
   ifile->codeseg = NULL;
   ifile->dataseg = NULL;
   ifile->udataseg = NULL;
   ifile->injections = new_source("(injections)");
+  ifile->incbins = new_stringlist();
 
   return ifile;
 }
 
 void delete_ifile(IFILE* ifile) {
   if (ifile) {
+    for (unsigned i = 0; i < irec_count(ifile); i++)
+      delete_data_image(get_irec(ifile, i)->data);
     efree(ifile->recs);
     delete_symbol_table(ifile->st);
     for (unsigned i = 0; i < ifile->nseg; i++)
       efree(ifile->segments[i].name);
+    efree(ifile->segments);
     for (GROUPNO i = 0; i < ifile->ngroup; i++)
       efree(ifile->groups[i]);
+    efree(ifile->groups);
     delete_source(ifile->injections);
+    delete_stringlist(ifile->incbins);
     efree(ifile);
   }
 }
@@ -55,31 +67,62 @@ static void init_irec(IREC* irec) {
   irec->op = TOK_NONE;
   irec->operand_pos = 0;
   irec->near_jump_size = 0;
+  irec->fixed_operands = false;
+  irec->shortened = 0;
   irec->def = NULL;
   irec->size = 0;
+  irec->data = NULL;
 }
 
+void delete_data_image(DATA_IMAGE* image) {
+  if (image) {
+    for (unsigned i = 0; i < image->nrun; i++)
+      efree(image->runs[i].bytes);
+    efree(image->runs);
+    efree(image);
+  }
+}
+
+// Physical position in recs of logical record i.
+static unsigned physical(const IFILE* ifile, unsigned i) {
+  return (i < ifile->used - ifile->tail) ? i : i + (ifile->allocated - ifile->used);
+}
+
+// Ensure the gap has at least one slot, moving the tail to the end of the
+// enlarged buffer.
 static void ensure_slot(IFILE* ifile) {
   assert(ifile->used <= ifile->allocated);
   if (ifile->used == ifile->allocated) {
     unsigned new_allocated = ifile->allocated ? 2 * ifile->allocated : 128;
     if (new_allocated < ifile->allocated)
       fatal("too many intermediate records\n");
+    ifile->recs = tag_memory(erealloc(ifile->recs, (sizeof ifile->recs[0]) * new_allocated), MEM_IRECS);
+    if (ifile->tail)
+      memmove(ifile->recs + new_allocated - ifile->tail, ifile->recs + ifile->allocated - ifile->tail,
+              (sizeof ifile->recs[0]) * ifile->tail);
     ifile->allocated = new_allocated;
-    ifile->recs = erealloc(ifile->recs, (sizeof ifile->recs[0]) * ifile->allocated);
   }
 }
 
-static void spread(IFILE* ifile, unsigned i) {
-  assert(ifile != NULL);
-  assert(ifile->used < ifile->allocated);
-  for (unsigned j = ifile->used; j > i; j--)
-    ifile->recs[j] = ifile->recs[j-1];
-  ifile->used++;
-  init_irec(&ifile->recs[i]);
+// Move the gap so that it begins at logical record i.
+static void move_gap(IFILE* ifile, unsigned i) {
+  const unsigned head = ifile->used - ifile->tail;
+  const unsigned gap = ifile->allocated - ifile->used;
+
+  assert(i <= ifile->used);
+
+  if (i < head) {
+    memmove(ifile->recs + i + gap, ifile->recs + i, (sizeof ifile->recs[0]) * (head - i));
+    ifile->tail += head - i;
+  }
+  else if (i > head) {
+    memmove(ifile->recs + head, ifile->recs + head + gap, (sizeof ifile->recs[0]) * (i - head));
+    ifile->tail -= i - head;
+  }
 }
 
 IREC* new_irec(IFILE* ifile) {
+  move_gap(ifile, ifile->used);
   ensure_slot(ifile);
   assert(ifile->used < ifile->allocated);
   IREC* irec = &ifile->recs[ifile->used++];
@@ -87,15 +130,24 @@ IREC* new_irec(IFILE* ifile) {
   return irec;
 }
 
+// Records after the insertion point move, so pointers to them are invalidated.
 IREC* insert_irec_after(IFILE* ifile, const IREC* p) {
   ptrdiff_t d = p - ifile->recs;
-  unsigned long long i = d;
-  if (d < 0 || i >= ifile->used || i > UINT_MAX || UINT_MAX - i < 1)
+  if (d < 0 || (unsigned long long) d >= ifile->allocated)
     fatal("internal error: insert_irec_after: position out of range\n");
-  unsigned pos = (unsigned) i + 1;
+  unsigned i = (unsigned) d;
+  if (i >= ifile->used - ifile->tail) {
+    if (i < ifile->allocated - ifile->tail)
+      fatal("internal error: insert_irec_after: position out of range\n");
+    i -= ifile->allocated - ifile->used;
+  }
+  unsigned pos = i + 1;
   ensure_slot(ifile);
-  spread(ifile, pos);
-  return &ifile->recs[pos];
+  move_gap(ifile, pos);
+  IREC* irec = &ifile->recs[pos];
+  ifile->used++;
+  init_irec(irec);
+  return irec;
 }
 
 unsigned irec_count(IFILE* ifile) {
@@ -106,13 +158,13 @@ unsigned irec_count(IFILE* ifile) {
 IREC* get_irec(IFILE* ifile, unsigned i) {
   assert(ifile != NULL);
   assert(i < ifile->used);
-  return &ifile->recs[i];
+  return &ifile->recs[physical(ifile, i)];
 }
 
 const IREC* get_irec_const(const IFILE* ifile, unsigned i) {
   assert(ifile != NULL);
   assert(i < ifile->used);
-  return &ifile->recs[i];
+  return &ifile->recs[physical(ifile, i)];
 }
 
 void print_intermediate(const IFILE* ifile, const char* descrip, unsigned options) {
@@ -129,7 +181,8 @@ void print_intermediate(const IFILE* ifile, const char* descrip, unsigned option
     printf("%-4s  ", "SIZE");
   putchar('\n');
 
-  for (i = 0, irec = ifile->recs; i < ifile->used; i++, irec++) {
+  for (i = 0; i < ifile->used; i++) {
+    irec = get_irec_const(ifile, i);
     printf("%4u: ", i);
     if (options & PRINT_SIZE)
       printf("%4lu: ", (unsigned long) irec->size);
@@ -154,6 +207,10 @@ int create_group(IFILE* ifile, const char* name) {
   assert(name != NULL);
   if (ifile->ngroup >= MAX_GROUP)
     fatal("too many groups\n");
+  if (ifile->ngroup == ifile->groups_allocated) {
+    ifile->groups_allocated = ifile->groups_allocated ? 2 * ifile->groups_allocated : 8;
+    ifile->groups = tag_memory(erealloc(ifile->groups, ifile->groups_allocated * sizeof ifile->groups[0]), MEM_SEGMENTS);
+  }
   int group = ifile->ngroup++;
   ifile->groups[group] = estrdup(name);
   return group;
@@ -175,6 +232,10 @@ int create_segment(IFILE* ifile, const char* name) {
   assert(name != NULL);
   if (ifile->nseg >= MAX_SEGMENT)
     fatal("too many segments\n");
+  if (ifile->nseg == ifile->segments_allocated) {
+    ifile->segments_allocated = ifile->segments_allocated ? 2 * ifile->segments_allocated : 8;
+    ifile->segments = tag_memory(erealloc(ifile->segments, ifile->segments_allocated * sizeof ifile->segments[0]), MEM_SEGMENTS);
+  }
   int seg = ifile->nseg++;
   ASM_SEGMENT* p = &ifile->segments[seg];
   p->name = estrdup(name);
@@ -369,8 +430,10 @@ static void test_new_ifile(CuTest* tc) {
   CuAssertPtrEquals(tc, NULL, ifile->recs);
   CuAssertIntEquals(tc, 0, ifile->allocated);
   CuAssertIntEquals(tc, 0, ifile->used);
+  CuAssertIntEquals(tc, 0, ifile->tail);
   CuAssertIntEquals(tc, 0, ifile->pos);
   CuAssertPtrNotNull(tc, ifile->st);
+  CuAssertTrue(tc, ifile->dollar == NULL);
   CuAssertTrue(tc, ifile->start_label == NULL);
   CuAssertIntEquals(tc, FALSE, ifile->provisional_sizes);
   CuAssertIntEquals(tc, 0, ifile->ngroup);
@@ -399,8 +462,11 @@ static void test_new_irec(CuTest* tc) {
   CuAssertIntEquals(tc, TOK_NONE, irec->op);
   CuAssertIntEquals(tc, 0, irec->operand_pos);
   CuAssertIntEquals(tc, 0, irec->near_jump_size);
+  CuAssertIntEquals(tc, false, irec->fixed_operands);
+  CuAssertIntEquals(tc, 0, irec->shortened);
   CuAssertTrue(tc, irec->def == NULL);
   CuAssertSizeEquals(tc, 0, irec->size);
+  CuAssertTrue(tc, irec->data == NULL);
 
   CuAssertPtrNotNull(tc, ifile->recs);
   CuAssertIntEquals(tc, 1, ifile->used);
@@ -418,7 +484,8 @@ static void test_new_irec(CuTest* tc) {
   CuAssertIntEquals(tc, 128, ifile->allocated);
   CuAssertPtrEquals(tc, irec, ifile->recs + 1);
 
-  ifile->used = ifile->allocated;
+  while (ifile->used < ifile->allocated)
+    new_irec(ifile);
   irec = new_irec(ifile);
   CuAssertPtrNotNull(tc, irec);
   CuAssertIntEquals(tc, 0, irec->si);
@@ -430,6 +497,44 @@ static void test_new_irec(CuTest* tc) {
   delete_ifile(ifile);
 }
 
+static void test_insert_irec_after(CuTest* tc) {
+  SOURCE src;
+  IFILE* ifile = new_ifile(&src, false);
+  const unsigned n = 300;
+
+  for (unsigned i = 0; i < n; i++)
+    new_irec(ifile)->size = 2 * i;
+
+  // insert after every record, working forward as the resizing pass does
+  for (unsigned i = 0; i < 2 * n; i += 2) {
+    IREC* irec = insert_irec_after(ifile, get_irec(ifile, i));
+    CuAssertPtrEquals(tc, irec, get_irec(ifile, i + 1));
+    CuAssertIntEquals(tc, 0, irec->si);
+    irec->size = get_irec(ifile, i)->size + 1;
+  }
+  CuAssertIntEquals(tc, 2 * n, irec_count(ifile));
+  for (unsigned i = 0; i < 2 * n; i++)
+    CuAssertIntEquals(tc, i, get_irec(ifile, i)->size);
+
+  // a later pass starting again from the beginning
+  insert_irec_after(ifile, get_irec(ifile, 0))->size = 1000;
+  insert_irec_after(ifile, get_irec(ifile, 2 * n))->size = 2000;
+  CuAssertIntEquals(tc, 2 * n + 2, irec_count(ifile));
+  CuAssertIntEquals(tc, 0, get_irec(ifile, 0)->size);
+  CuAssertIntEquals(tc, 1000, get_irec(ifile, 1)->size);
+  CuAssertIntEquals(tc, 1, get_irec(ifile, 2)->size);
+  CuAssertIntEquals(tc, 2 * n - 1, get_irec(ifile, 2 * n)->size);
+  CuAssertIntEquals(tc, 2000, get_irec(ifile, 2 * n + 1)->size);
+
+  // appending closes the gap
+  new_irec(ifile)->size = 3000;
+  CuAssertIntEquals(tc, 0, ifile->tail);
+  CuAssertIntEquals(tc, 3000, ifile->recs[2 * n + 2].size);
+  CuAssertIntEquals(tc, 2000, ifile->recs[2 * n + 1].size);
+
+  delete_ifile(ifile);
+}
+
 static void test_segments(CuTest* tc) {
   SOURCE src;
   IFILE* ifile = new_ifile(&src, false);
@@ -481,6 +586,32 @@ static void test_segments(CuTest* tc) {
   delete_ifile(ifile);
 }
 
+static void test_many_segments(CuTest* tc) {
+  SOURCE src;
+  IFILE* ifile = new_ifile(&src, false);
+  char name[16];
+
+  for (unsigned i = 0; i < 300; i++) {
+    sprintf(name, "G%u", i);
+    CuAssertIntEquals(tc, i, create_group(ifile, name));
+  }
+  for (unsigned i = 0; i < 1000; i++) {
+    sprintf(name, "S%u", i);
+    CuAssertIntEquals(tc, i, create_segment(ifile, name));
+    set_segment_group(ifile, i, i % 300);
+    set_segment_pc(ifile, i, i);
+  }
+  CuAssertIntEquals(tc, 300, group_count(ifile));
+  CuAssertIntEquals(tc, 1000, segment_count(ifile));
+  CuAssertStrEquals(tc, "G299", group_name(ifile, 299));
+  CuAssertStrEquals(tc, "S999", segment_name(ifile, 999));
+  CuAssertIntEquals(tc, 299, segment_group(ifile, 299));
+  CuAssertIntEquals(tc, 0, segment_group(ifile, 300));
+  CuAssertIntEquals(tc, 777, segment_pc(ifile, 777));
+
+  delete_ifile(ifile);
+}
+
 static void test_injections(CuTest* tc) {
   SOURCE* src = new_source(NULL);
   IFILE* ifile = new_ifile(src, false);
@@ -505,7 +636,9 @@ CuSuite* ifile_test_suite(void) {
   CuSuite* suite = CuSuiteNew();
   SUITE_ADD_TEST(suite, test_new_ifile);
   SUITE_ADD_TEST(suite, test_new_irec);
+  SUITE_ADD_TEST(suite, test_insert_irec_after);
   SUITE_ADD_TEST(suite, test_segments);
+  SUITE_ADD_TEST(suite, test_many_segments);
   SUITE_ADD_TEST(suite, test_injections);
   return suite;
 }
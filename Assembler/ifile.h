@@ -10,6 +10,21 @@
 #include "source.h"
 #include "instable.h"
 #include "symbol.h"
+#include "stringlist.h"
+
+// The bytes of a data directive whose values are all absolute, encoded in
+// pass 1. Each run is emitted repeat times, for DUP. Uninitialised data has
+// no runs: only its size matters.
+typedef struct {
+  DWORD repeat;
+  unsigned len;
+  BYTE* bytes;
+} DATA_RUN;
+
+typedef struct {
+  DATA_RUN* runs;
+  unsigned nrun;
+} DATA_IMAGE;
 
 typedef struct {
   long si; // source index: zero => none, positive => source line, negative => injection
@@ -18,15 +33,19 @@ typedef struct {
   int op;
   unsigned short operand_pos;
   unsigned short near_jump_size;
+  bool fixed_operands; // operands use no symbol which may change: def and size are final after pass 1
+  BYTE shortened; // bytes saved by def over the first table entry matching
   const INSDEF* def;
   MemSize size;
+  DATA_IMAGE* data; // data directive folded in pass 1, or NULL
 } IREC;
 
 #define NO_SEG (-1)
 #define NO_GROUP (-1)
 
-#define MAX_GROUP (8)
-#define MAX_SEGMENT (8)
+// Segment and group numbers are written to object files as words.
+#define MAX_SEGMENT (0x10000)
+#define MAX_GROUP (0x10000)
 
 enum asm_segment_attribute {
   ATTR_PRIVATE = 0x01,
@@ -47,30 +66,40 @@ typedef struct {
   DWORD pc;
 } ASM_SEGMENT;
 
+// Records are held in a gap buffer so that insertion while a pass works
+// forward through the file costs no more than the distance moved.
+// The first used - tail records are at the start of recs, the last tail
+// records at the end, and the gap of allocated - used slots between them.
 typedef struct {
   SOURCE* source;
   IREC* recs;
   unsigned allocated;
   unsigned used;
+  unsigned tail;
   unsigned pos;
   SYMTAB* st;
+  SYMBOL* dollar;  // location counter '$'
   const SYMBOL* start_label;
   BOOL provisional_sizes;
-  char* groups[MAX_GROUP];
+  char* *groups;
   GROUPNO ngroup;
-  ASM_SEGMENT segments[MAX_SEGMENT];
+  GROUPNO groups_allocated;
+  ASM_SEGMENT* segments;
   unsigned nseg;
+  unsigned segments_allocated;
   const SYMBOL* model_group;
   const SYMBOL* codeseg;
   const SYMBOL* dataseg;
   const SYMBOL* udataseg;
   SOURCE* injections;
+  STRINGLIST* incbins;  // paths of the files included by INCBIN, from pass 1
 } IFILE;
 
 IFILE* new_ifile(SOURCE*, bool case_sensitive);
 void delete_ifile(IFILE*);
 
 IREC* new_irec(IFILE*);
+void delete_data_image(DATA_IMAGE*);
 IREC* insert_irec_after(IFILE*, const IREC*);
 
 unsigned irec_count(IFILE*);
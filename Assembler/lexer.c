@@ -4,32 +4,34 @@
 
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
 #include <assert.h>
 #include <limits.h>
-#include <errno.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include "lexer.h"
+#include "profile.h"
 #include "source.h"
 #include "token.h"
 #include "utils.h"
 
 #define MAX_TEXT (4096)  // arbitrary, to avoid 64-bit size_t lengths
 
-static void lex_fatal(LEX*, const char* fmt, ...);
+static _Noreturn void lex_fatal(LEX*, const char* fmt, ...);
 static void lex_error(LEX*, const char* fmt, ...);
 
-LEX* new_lex(const char* source_name) {
+LEX* new_lex(const char* source_name, const INTERN* names) {
   LEX* lex = emalloc(sizeof *lex);
 
   lex->source_name = source_name;
+  lex->names = names;
   lex->text = NULL;
+  lex->len = 0;
   lex->lineno = 0;
   lex->pos = 0;
   lex->token_pos = 0;
   lex->token = TOK_NONE;
   lex->lexeme[0] = '\0';
+  lex->val.name = NO_NAME;
   lex->errors = 0;
 
   return lex;
@@ -60,18 +62,23 @@ const char* lex_text(LEX* lex) {
 void lex_begin(LEX* lex, const char* text, unsigned lineno, unsigned pos) {
   assert(lex != NULL);
   assert(text != NULL);
-  assert(pos <= strlen(text));
 
-  if (strlen(text) > MAX_TEXT) {
-    fprintf(stderr, "Fatal: %s: %u: line too long\n", lex->source_name ? lex->source_name : "-", lineno);
-    exit(EXIT_FAILURE);
+  PROFILE_COUNT(PC_LINES);
+
+  const size_t len = strlen(text);
+  assert(pos <= len);
+  if (len > MAX_TEXT) {
+    fprintf(error_stream(), "Fatal: %s: %u: line too long\n", lex->source_name ? lex->source_name : "-", lineno);
+    fail();
   }
 
   lex->text = text;
+  lex->len = (unsigned) len;
   lex->lineno = lineno;
   lex->pos = pos;
-  lex->token = lex_next(lex);
+  // errors in the first token count against the line
   lex->errors = 0;
+  lex->token = lex_next(lex);
 }
 
 unsigned lex_pos(LEX* lex) {
@@ -99,6 +106,18 @@ const char* lex_lexeme(LEX* lex) {
   return lex->lexeme;
 }
 
+// The interned ID of the current label token, or NO_NAME if the name
+// has not been interned, i.e. there is no symbol of that name.
+NAME_ID lex_name(LEX* lex) {
+  assert(lex != NULL);
+  assert(lex->token == TOK_LABEL);
+
+  // the name may have been interned since it was read
+  if (lex->val.name == NO_NAME && lex->names)
+    lex->val.name = intern_find(lex->names, lex->lexeme);
+  return lex->val.name;
+}
+
 unsigned long lex_val(LEX* lex) {
   assert(lex != NULL);
 
@@ -121,117 +140,135 @@ void lex_discard_line(LEX* lex) {
   assert(lex != NULL);
 
   if (lex->text)
-    lex->pos = (unsigned) strlen(lex->text);
+    lex->pos = lex->len;
   lex->token = TOK_EOL;
 }
 
-static void read_number(LEX*);
-static void convert(LEX*, unsigned pos, int base);
+// Character classes, indexed by unsigned char.
+#define CC_SPACE   (0x01)  // between tokens
+#define CC_END     (0x02)  // end of line: null, newline, or comment
+#define CC_ALPHA   (0x04)  // may begin an identifier
+#define CC_DECIMAL (0x08)
+#define CC_HEX     (0x10)
+#define CC_PUNCT   (0x20)  // single-character token
+#define CC_QUOTE   (0x40)
+
+#define CC_DIGIT   (CC_DECIMAL | CC_HEX)
+#define CC_XALPHA  (CC_ALPHA | CC_HEX)
+#define CC_IDENT   (CC_ALPHA | CC_DECIMAL)
+
+static const unsigned char char_class[256] = {
+  CC_END, 0, 0, 0, 0, 0, 0, 0,  // 00 01 02 03 04 05 06 07
+  0, CC_SPACE, CC_END, 0, 0, 0, 0, 0,  // 08 09 0A 0B 0C 0D 0E 0F
+  0, 0, 0, 0, 0, 0, 0, 0,  // 10 11 12 13 14 15 16 17
+  0, 0, 0, 0, 0, 0, 0, 0,  // 18 19 1A 1B 1C 1D 1E 1F
+  CC_SPACE, 0, CC_QUOTE, 0, 0, 0, 0, CC_QUOTE,  //   ! " # $ % & '
+  CC_PUNCT, CC_PUNCT, CC_PUNCT, CC_PUNCT, CC_PUNCT, CC_PUNCT, 0, CC_PUNCT,  // ( ) * + , - . /
+  CC_DIGIT, CC_DIGIT, CC_DIGIT, CC_DIGIT, CC_DIGIT, CC_DIGIT, CC_DIGIT, CC_DIGIT,  // 0 1 2 3 4 5 6 7
+  CC_DIGIT, CC_DIGIT, CC_PUNCT, CC_END, 0, CC_PUNCT, 0, CC_PUNCT,  // 8 9 : ; < = > ?
+  CC_ALPHA, CC_XALPHA, CC_XALPHA, CC_XALPHA, CC_XALPHA, CC_XALPHA, CC_XALPHA, CC_ALPHA,  // @ A B C D E F G
+  CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA,  // H I J K L M N O
+  CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA,  // P Q R S T U V W
+  CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_PUNCT, 0, CC_PUNCT, 0, CC_ALPHA,  // X Y Z [ \ ] ^ _
+  0, CC_XALPHA, CC_XALPHA, CC_XALPHA, CC_XALPHA, CC_XALPHA, CC_XALPHA, CC_ALPHA,  // ` a b c d e f g
+  CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA,  // h i j k l m n o
+  CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA,  // p q r s t u v w
+  CC_ALPHA, CC_ALPHA, CC_ALPHA, 0, 0, 0, 0, 0,  // x y z { | } ~ 7F
+  // the rest are 0
+};
+
+#define CHAR_CLASS(c) (char_class[(unsigned char) (c)])
+
+// Lower case of a letter; other characters do not become letters.
+#define LOWER(c) ((c) | 0x20)
+
+// A number accumulated in one radix as its digits are read,
+// so that a lexeme which may be in either of two radices is read once.
+typedef struct {
+  unsigned base;
+  unsigned long long limit;  // largest value which may take another digit
+  unsigned long long val;
+  bool digits;    // at least one valid digit
+  bool invalid;   // a digit not in the radix
+  bool overflow;
+} RADIX_NUM;
+
+static void lex_number(LEX*);
 
 int lex_next(LEX* lex) {
   assert(lex != NULL);
   assert(lex->text != NULL);
 
   const char* text = lex->text;
+  unsigned pos = lex->pos;
 
-  while (text[lex->pos] == ' ' || text[lex->pos] == '\t')
-    lex->pos++;
+  while (CHAR_CLASS(text[pos]) & CC_SPACE)
+    pos++;
 
-  lex->token_pos = lex->pos;
+  lex->token_pos = lex->pos = pos;
 
-  int c = text[lex->pos];
-  if (c == '\0' || c == '\n' || c == ';')
+  int c = text[pos];
+  const unsigned cls = CHAR_CLASS(c);
+
+  if (cls & CC_END)
     return lex->token = TOK_EOL;
 
-  if (isalpha(c) || c == '_' || c == '@') {
+  if (cls & CC_ALPHA) {
     unsigned i = 0;
     lex->lexeme[i++] = c;
-    lex->pos++;
-    while (isalnum(c = text[lex->pos]) || c == '_' || c == '@') {
+    pos++;
+    while (CHAR_CLASS(c = text[pos]) & CC_IDENT) {
       if (i >= MAX_LEX - 1) {
         lex->lexeme[i] = '\0';
+        lex->pos = pos;
         lex_fatal(lex, "label too long: %s...\n", lex->lexeme);
       }
       lex->lexeme[i++] = c;
-      lex->pos++;
+      pos++;
     }
     assert(i < MAX_LEX);
     lex->lexeme[i] = '\0';
-    lex->token = register_token(lex->lexeme, &lex->val.reg);
+    lex->pos = pos;
+    // registers are the only two-letter names with their own tokens
+    lex->token = TOK_NONE;
+    if (i == 2)
+      lex->token = register_token(lex->lexeme, &lex->val.reg);
     if (lex->token == TOK_NONE)
       lex->token = identifier_token(lex->lexeme);
+    if (lex->token == TOK_LABEL)
+      lex->val.name = lex->names ? intern_find(lex->names, lex->lexeme) : NO_NAME;
     return lex->token;
   }
 
-  if (c == '$') {
-    strcpy(lex->lexeme, "$");
-    lex->pos++;
-    return lex->token = TOK_LABEL;
+  if (cls & CC_DECIMAL) {
+    lex_number(lex);
+    return lex->token = TOK_NUM;
   }
 
-  if (c == '0') {
+  if (cls & CC_PUNCT) {
     lex->pos++;
-    lex->lexeme[0] = '0';
-    lex->i = 1;
-    switch (tolower(c = text[lex->pos])) {
-      case 'b':
-        read_number(lex);  // including 'b'
-        if (tolower(text[lex->pos]) == 'h') {
-          lex->pos++;
-          convert(lex, 0, 16);
-        }
-        else
-          convert(lex, 2, 2);  // disregard 0b prefix
-        break;
-      case 'o':
-        lex->lexeme[lex->i++] = 'o';
-        lex->pos++;
-        read_number(lex);
-        convert(lex, 2, 8);
-        break;
-      case 'x':
-        lex->lexeme[lex->i++] = 'x';
-        lex->pos++;
-        read_number(lex);
-        convert(lex, 2, 16);
-        break;
-      default:
-        read_number(lex);
-        if (tolower(text[lex->pos]) == 'h') {
-          lex->pos++;
-          convert(lex, 0, 16);
-        }
-        else
-          convert(lex, 0, 10);
-        break;
-    }
-    return lex->token = TOK_NUM;
+    return lex->token = c;
   }
 
-  if (isdigit(c)) {
-    lex->i = 0;
-    read_number(lex);
-    if (tolower(text[lex->pos]) == 'h') {
-      lex->pos++;
-      convert(lex, 0, 16);
-    }
-    else
-      convert(lex, 0, 10);
-    return lex->token = TOK_NUM;
+  if (c == '$') {
+    strcpy(lex->lexeme, "$");
+    lex->val.name = lex->names ? intern_find(lex->names, lex->lexeme) : NO_NAME;
+    lex->pos++;
+    return lex->token = TOK_LABEL;
   }
 
-  if (c == '\'' || c == '\"') {
+  if (cls & CC_QUOTE) {
     const int delim = c;
     unsigned i = 0;
     lex->lexeme[i++] = '\'';
-    lex->pos++;
-    while ((c = text[lex->pos]) != '\0' && c != '\n' && c != delim) {
+    pos++;
+    while ((c = text[pos]) != '\0' && c != '\n' && c != delim) {
       if (i >= MAX_LEX - 2) {
         lex->lexeme[i] = '\0';
         lex_fatal(lex, "string too long: %s...\n", lex->lexeme);
       }
       lex->lexeme[i++] = c;
-      lex->pos++;
+      pos++;
     }
     assert(i < MAX_LEX - 1);
     if (c != delim) {
@@ -240,15 +277,10 @@ int lex_next(LEX* lex) {
     }
     lex->lexeme[i++] = '\'';
     lex->lexeme[i] = '\0';
-    lex->pos++;
+    lex->pos = pos + 1;
     return lex->token = TOK_STRING;
   }
 
-  if (strchr(":+-*/,()[]?=", c)) {
-    lex->pos++;
-    return lex->token = c;
-  }
-
   lex_fatal(lex, "invalid token prefix: '%c'\n", c);
   return lex->token = TOK_NONE;
 }
@@ -261,40 +293,143 @@ static void append_lexeme(LEX* lex, int c, const char* what) {
   lex->lexeme[lex->i++] = c;
 }
 
-// Read a number of zero or more hex digits into lexeme.
+static void init_radix(RADIX_NUM* num, unsigned base) {
+  num->base = base;
+  switch (base) {
+    case 2: num->limit = ULLONG_MAX / 2; break;
+    case 8: num->limit = ULLONG_MAX / 8; break;
+    case 10: num->limit = ULLONG_MAX / 10; break;
+    case 16: num->limit = ULLONG_MAX / 16; break;
+    default: num->limit = ULLONG_MAX / base; break;
+  }
+  num->val = 0;
+  num->digits = false;
+  num->invalid = false;
+  num->overflow = false;
+}
+
+// Add a digit to the number. Digits after an invalid one are disregarded,
+// as by strtoull.
+static void accumulate(RADIX_NUM* num, unsigned digit) {
+  if (num->invalid)
+    return;
+  if (digit >= num->base) {
+    num->invalid = true;
+    return;
+  }
+  num->digits = true;
+  if (num->val > num->limit || (num->val == num->limit && digit > ULLONG_MAX - num->limit * num->base))
+    num->overflow = true;
+  else if (!num->overflow)
+    num->val = num->val * num->base + digit;
+}
+
+static unsigned hex_digit_value(int c) {
+  assert(CHAR_CLASS(c) & CC_HEX);
+  return (c <= '9') ? c - '0' : LOWER(c) - 'a' + 10;
+}
+
+// Read a number of zero or more hex digits into lexeme, accumulating
+// its value in each of the given radices.
 // Invalid digits, and the lack of any digits, are caught at conversion.
 // Allow arbitrary underscore punctuation for readability.
 // On entry: lex->i initialised by caller.
 // On exit: pos -> first non-hex-digit.
-static void read_number(LEX* lex) {
+static void read_number(LEX* lex, RADIX_NUM* num, unsigned radices) {
+  const char* text = lex->text;
+  unsigned pos = lex->pos;
   int c;
 
-  while (isxdigit(c = lex->text[lex->pos])) {
+  while (CHAR_CLASS(c = text[pos]) & CC_HEX) {
     append_lexeme(lex, c, "number");
+    const unsigned digit = hex_digit_value(c);
+    for (unsigned r = 0; r < radices; r++)
+      accumulate(&num[r], digit);
     do {
-      lex->pos++;
-    } while (lex->text[lex->pos] == '_');
+      pos++;
+    } while (text[pos] == '_');
   }
 
+  lex->pos = pos;
   assert(lex->i < MAX_LEX);
   lex->lexeme[lex->i] = '\0';
 }
 
-// Convert number at pos in lexeme according to base, setting lex->val.num.
-// Errors are fatal.
-static void convert(LEX* lex, unsigned pos, int base) {
-  char* end = NULL;
-  lex->val.num = strtoull(lex->lexeme + pos, &end, base);
-  if (lex->val.num == ULLONG_MAX && errno == ERANGE) {
+// Set lex->val.num from the number read, reporting an error
+// if it is out of range or has invalid or no digits.
+static void convert(LEX* lex, const RADIX_NUM* num) {
+  lex->val.num = num->val;
+  if (num->overflow) {
     lex_error(lex, "number out of range: %s", lex->lexeme);
     lex->val.num = 0;
   }
-  if (*end != '\0' || end == lex->lexeme + pos) {
+  if (num->invalid || !num->digits) {
     lex_error(lex, "invalid number: %s", lex->lexeme);
     lex->val.num = 0;
   }
 }
 
+// Convert as hex if an h suffix follows, otherwise in the other radix.
+static void convert_suffixed(LEX* lex, const RADIX_NUM* other, const RADIX_NUM* hex) {
+  if (LOWER(lex->text[lex->pos]) == 'h') {
+    lex->pos++;
+    convert(lex, hex);
+  }
+  else
+    convert(lex, other);
+}
+
+// Read a number beginning with a decimal digit, in one scan whatever its radix:
+// 123, 0AB0h, 0b101, 0o17, 0x1F, with underscores after any digit but a leading 0.
+static void lex_number(LEX* lex) {
+  RADIX_NUM num[2];
+
+  lex->i = 0;
+
+  if (lex->text[lex->pos] == '0') {
+    lex->lexeme[lex->i++] = '0';
+    lex->pos++;
+    switch (LOWER(lex->text[lex->pos])) {
+      case 'b':
+        // binary after the 0b prefix, or hex including it if an h follows
+        init_radix(&num[0], 2);
+        init_radix(&num[1], 16);
+        accumulate(&num[1], 0);
+        append_lexeme(lex, lex->text[lex->pos], "number");
+        accumulate(&num[1], 0xB);
+        do {
+          lex->pos++;
+        } while (lex->text[lex->pos] == '_');
+        read_number(lex, num, 2);
+        convert_suffixed(lex, &num[0], &num[1]);
+        return;
+      case 'o':
+        lex->lexeme[lex->i++] = 'o';
+        lex->pos++;
+        init_radix(&num[0], 8);
+        read_number(lex, num, 1);
+        convert(lex, &num[0]);
+        return;
+      case 'x':
+        lex->lexeme[lex->i++] = 'x';
+        lex->pos++;
+        init_radix(&num[0], 16);
+        read_number(lex, num, 1);
+        convert(lex, &num[0]);
+        return;
+    }
+  }
+
+  init_radix(&num[0], 10);
+  init_radix(&num[1], 16);
+  if (lex->i) {
+    accumulate(&num[0], 0);
+    accumulate(&num[1], 0);
+  }
+  read_number(lex, num, 2);
+  convert_suffixed(lex, &num[0], &num[1]);
+}
+
 size_t lex_string_len(LEX* lex) {
   size_t len;
 
@@ -329,45 +464,49 @@ BYTE* lex_string_content(LEX* lex, size_t *len) {
   return buf;
 }
 
-static void lex_fatal(LEX* lex, const char* fmt, ...) {
+static _Noreturn void lex_fatal(LEX* lex, const char* fmt, ...) {
   assert(lex != NULL);
   assert(fmt != NULL);
 
-  fprintf(stderr, "Fatal: %s: %u: ", lex->source_name ? lex->source_name : "-", lex->lineno);
+  FILE* fp = error_stream();
+
+  fprintf(fp, "Fatal: %s: %u: ", lex->source_name ? lex->source_name : "-", lex->lineno);
 
   va_list ap;
   va_start(ap, fmt);
-  vfprintf(stderr, fmt, ap);
+  vfprintf(fp, fmt, ap);
   va_end(ap);
 
-  exit(EXIT_FAILURE);
+  fail();
 }
 
 static void lex_error(LEX* lex, const char* fmt, ...) {
   assert(lex != NULL);
   assert(fmt != NULL);
 
+  FILE* fp = error_stream();
+
   lex->errors++;
 
-  fprintf(stderr, "Error: %s: %u: ", lex->source_name ? lex->source_name : "-", lex->lineno);
+  fprintf(fp, "Error: %s: %u: ", lex->source_name ? lex->source_name : "-", lex->lineno);
 
   va_list ap;
   va_start(ap, fmt);
-  vfprintf(stderr, fmt, ap);
+  vfprintf(fp, fmt, ap);
   va_end(ap);
 
   if (lex->text) {
-    fputs(":\n", stderr);
+    fputs(":\n", fp);
 
     const unsigned TAB = 4;
 
-    print_notabs(stderr, lex->text, TAB);
-    fputc('\n', stderr);
-    position(stderr, lex->text, lex->token_pos, TAB);
-    fputs("^\n", stderr);
+    print_notabs(fp, lex->text, TAB);
+    fputc('\n', fp);
+    position(fp, lex->text, lex->token_pos, TAB);
+    fputs("^\n", fp);
   }
   else
-    fputc('\n', stderr);
+    fputc('\n', fp);
 }
 
 unsigned lex_errors(const LEX* lex) {
@@ -381,7 +520,7 @@ unsigned lex_errors(const LEX* lex) {
 static void test_new_lex(CuTest* tc) {
   char name[] = "hello.asm";
 
-  LEX* lex = new_lex(name);
+  LEX* lex = new_lex(name, NULL);
   CuAssertPtrNotNull(tc, lex);
   CuAssertTrue(tc, lex->source_name == name);
   CuAssertIntEquals(tc, 0, lex->lineno);
@@ -389,7 +528,7 @@ static void test_new_lex(CuTest* tc) {
   CuAssertIntEquals(tc, TOK_NONE, lex->token);
   delete_lex(lex);
 
-  lex = new_lex(NULL);
+  lex = new_lex(NULL, NULL);
   CuAssertPtrNotNull(tc, lex);
   CuAssertTrue(tc, lex->source_name == NULL);
   CuAssertIntEquals(tc, 0, lex->lineno);
@@ -399,7 +538,7 @@ static void test_new_lex(CuTest* tc) {
 }
 
 static void test_lex_begin(CuTest* tc) {
-  LEX* lex = new_lex(NULL);
+  LEX* lex = new_lex(NULL, NULL);
 
   lex->lineno = 3;
   lex->pos = 23;
@@ -421,7 +560,7 @@ static void test_discard_line(CuTest* tc) {
   static const char text[] = "this is a test string";
   const unsigned LEN = (unsigned) strlen(text);
 
-  LEX* lex = new_lex(NULL);
+  LEX* lex = new_lex(NULL, NULL);
 
   lex_begin(lex, text, 1, 0);
 
@@ -441,7 +580,7 @@ static void test_get_token(CuTest* tc) {
     "123h123+AB0+0AB0hmov ds'sam smith';comment\n"
     "second line";
 
-  LEX* lex = new_lex(NULL);
+  LEX* lex = new_lex(NULL, NULL);
 
   lex_begin(lex, text, 1, 0);
 
@@ -509,7 +648,7 @@ static void test_string(CuTest* tc) {
 
 static void test_error(CuTest* tc) {
   // Null source name
-  LEX* lex = new_lex(NULL);
+  LEX* lex = new_lex(NULL, NULL);
   CuAssertIntEquals(tc, 0, lex->errors);
   // No source line
   lex_error(lex, "dummy error");
@@ -522,7 +661,7 @@ static void test_error(CuTest* tc) {
   delete_lex(lex);
 
   // With source name
-  lex = new_lex("hello.asm");
+  lex = new_lex("hello.asm", NULL);
   // No source line
   lex_error(lex, "dummy error");
   // Begin source line
@@ -553,65 +692,356 @@ static void test_append_lexeme(CuTest* tc) {
 
 static void test_read_number(CuTest* tc) {
   LEX lex;
+  RADIX_NUM num[2];
 
-  lex.text = "...0xFACE123H";
+  lex.text = "...0xFACE123H 1_0_0_0h";
 
   lex.pos = 0;
   lex.i = 0;
-  read_number(&lex);
+  init_radix(&num[0], 16);
+  read_number(&lex, num, 1);
   CuAssertStrEquals(tc, "", lex.lexeme);
   CuAssertIntEquals(tc, 0, lex.pos);
+  CuAssertTrue(tc, !num[0].digits);
 
   lex.pos = 3;
   lex.i = 0;
-  read_number(&lex);
+  init_radix(&num[0], 16);
+  read_number(&lex, num, 1);
   CuAssertStrEquals(tc, "0", lex.lexeme);
   CuAssertIntEquals(tc, 4, lex.pos);
+  CuAssertTrue(tc, num[0].digits);
+  CuAssertLongLongEquals(tc, 0, num[0].val);
 
   lex.pos = 5;
   lex.i = 0;
-  read_number(&lex);
+  init_radix(&num[0], 10);
+  init_radix(&num[1], 16);
+  read_number(&lex, num, 2);
   CuAssertStrEquals(tc, "FACE123", lex.lexeme);
   CuAssertIntEquals(tc, 'H', lex.text[lex.pos]);
+  CuAssertTrue(tc, num[0].invalid);
+  CuAssertTrue(tc, !num[1].invalid);
+  CuAssertLongLongEquals(tc, 0xFACE123, num[1].val);
+
+  lex.pos = 14;
+  lex.i = 0;
+  init_radix(&num[0], 10);
+  init_radix(&num[1], 16);
+  read_number(&lex, num, 2);
+  CuAssertStrEquals(tc, "1000", lex.lexeme);
+  CuAssertIntEquals(tc, 'h', lex.text[lex.pos]);
+  CuAssertLongLongEquals(tc, 1000, num[0].val);
+  CuAssertLongLongEquals(tc, 0x1000, num[1].val);
 }
 
 static void test_convert(CuTest* tc) {
-  LEX* lex = new_lex(NULL);
-
-  lex->text = "0o128,0x1_0000_0000_0000_0000";
-  lex->lineno = 2;
-  lex->pos = 0;
+  LEX* lex = new_lex(NULL, NULL);
+  RADIX_NUM num;
 
-  strcpy(lex->lexeme, "");
-  lex->token_pos = (unsigned) strlen(lex->text);
-  convert(lex, 0, 10);
+  lex_begin(lex, "0x 0o128 0o177 0x1_0000_0000_0000_0000 0xFFFF_FFFF_FFFF_FFFF", 2, 0);
+  CuAssertIntEquals(tc, TOK_NUM, lex_token(lex));
   CuAssertIntEquals(tc, 1, lex->errors);
+  CuAssertLongLongEquals(tc, 0, lex->val.num);
 
-  strcpy(lex->lexeme, "0o128");
-  lex->token_pos = 0;
-  convert(lex, 2, 10);
-  CuAssertIntEquals(tc, 1, lex->errors);
-  CuAssertLongLongEquals(tc, 128, lex->val.num);
+  CuAssertIntEquals(tc, TOK_NUM, lex_next(lex));
+  CuAssertIntEquals(tc, 2, lex->errors);
+  CuAssertLongLongEquals(tc, 0, lex->val.num);
+  CuAssertStrEquals(tc, "0o128", lex->lexeme);
 
-  convert(lex, 2, 8);
+  CuAssertIntEquals(tc, TOK_NUM, lex_next(lex));
   CuAssertIntEquals(tc, 2, lex->errors);
+  CuAssertLongLongEquals(tc, 0177, lex->val.num);
+
+  CuAssertIntEquals(tc, TOK_NUM, lex_next(lex));
+  CuAssertIntEquals(tc, 3, lex->errors);
   CuAssertLongLongEquals(tc, 0, lex->val.num);
+  CuAssertStrEquals(tc, "0x10000000000000000", lex->lexeme);
 
-  const char* p = strchr(lex->text, ',');
-  unsigned i = 0;
-  for (p++; *p && *p != ','; p++) {
-    if (*p != '_')
-      lex->lexeme[i++] = *p;
-  }
-  lex->lexeme[i] = '\0';
-  lex->token_pos = (unsigned) (p+1 - lex->text);
-  convert(lex, 2, 16);
+  CuAssertIntEquals(tc, TOK_NUM, lex_next(lex));
   CuAssertIntEquals(tc, 3, lex->errors);
+  CuAssertTrue(tc, lex->val.num == ULLONG_MAX);
+
+  CuAssertIntEquals(tc, TOK_EOL, lex_next(lex));
+
+  // valid digits before the invalid one
+  strcpy(lex->lexeme, "128");
+  init_radix(&num, 8);
+  accumulate(&num, 1);
+  accumulate(&num, 2);
+  accumulate(&num, 8);
+  CuAssertTrue(tc, num.invalid);
+  CuAssertLongLongEquals(tc, 012, num.val);
+  convert(lex, &num);
+  CuAssertIntEquals(tc, 4, lex->errors);
   CuAssertLongLongEquals(tc, 0, lex->val.num);
 
   delete_lex(lex);
 }
 
+static void test_numbers(CuTest* tc) {
+  static const struct {
+    const char* text;
+    unsigned long long val;
+    unsigned len;
+  } tests[] = {
+    { "0", 0, 1 },
+    { "7", 7, 1 },
+    { "65535", 65535, 5 },
+    { "1_000", 1000, 5 },
+    { "0FFFFh", 0xFFFF, 6 },
+    { "0ffffH", 0xFFFF, 6 },
+    { "0b1010", 10, 6 },
+    { "0B1_010", 10, 7 },
+    { "0b101h", 0xB101, 6 },
+    { "0o17", 017, 4 },
+    { "0O1_7", 017, 5 },
+    { "0x1F", 0x1F, 4 },
+    { "0X1f_ff", 0x1FFF, 7 },
+    { "0_1", 0, 1 },
+    { "18446744073709551615", ULLONG_MAX, 20 },
+    { "0FFFF_FFFF_FFFF_FFFFh", ULLONG_MAX, 21 },
+  };
+
+  LEX* lex = new_lex(NULL, NULL);
+  for (unsigned i = 0; i < sizeof tests / sizeof tests[0]; i++) {
+    lex_begin(lex, tests[i].text, 1, 0);
+    CuAssertIntEquals(tc, TOK_NUM, lex_token(lex));
+    CuAssertIntEquals(tc, 0, lex_errors(lex));
+    CuAssertTrue(tc, tests[i].val == lex_lval(lex));
+    CuAssertIntEquals(tc, tests[i].len, lex_pos(lex));
+  }
+  delete_lex(lex);
+}
+
+// The lexer before the character class table and single-scan numbers,
+// to check that tokens are unchanged and to measure the difference.
+
+#include <ctype.h>
+#include <errno.h>
+
+static void old_read_number(LEX*);
+static void old_convert(LEX*, unsigned pos, int base);
+
+static int old_lex_next(LEX* lex) {
+  const char* text = lex->text;
+
+  while (text[lex->pos] == ' ' || text[lex->pos] == '\t')
+    lex->pos++;
+
+  lex->token_pos = lex->pos;
+
+  int c = text[lex->pos];
+  if (c == '\0' || c == '\n' || c == ';')
+    return lex->token = TOK_EOL;
+
+  if (isalpha(c) || c == '_' || c == '@') {
+    unsigned i = 0;
+    lex->lexeme[i++] = c;
+    lex->pos++;
+    while (isalnum(c = text[lex->pos]) || c == '_' || c == '@') {
+      lex->lexeme[i++] = c;
+      lex->pos++;
+    }
+    lex->lexeme[i] = '\0';
+    lex->token = register_token(lex->lexeme, &lex->val.reg);
+    if (lex->token == TOK_NONE)
+      lex->token = identifier_token(lex->lexeme);
+    if (lex->token == TOK_LABEL)
+      lex->val.name = lex->names ? intern_find(lex->names, lex->lexeme) : NO_NAME;
+    return lex->token;
+  }
+
+  if (c == '$') {
+    strcpy(lex->lexeme, "$");
+    lex->val.name = lex->names ? intern_find(lex->names, lex->lexeme) : NO_NAME;
+    lex->pos++;
+    return lex->token = TOK_LABEL;
+  }
+
+  if (c == '0') {
+    lex->pos++;
+    lex->lexeme[0] = '0';
+    lex->i = 1;
+    switch (tolower(c = text[lex->pos])) {
+      case 'b':
+        old_read_number(lex);
+        if (tolower(text[lex->pos]) == 'h') {
+          lex->pos++;
+          old_convert(lex, 0, 16);
+        }
+        else
+          old_convert(lex, 2, 2);
+        break;
+      case 'o':
+        lex->lexeme[lex->i++] = 'o';
+        lex->pos++;
+        old_read_number(lex);
+        old_convert(lex, 2, 8);
+        break;
+      case 'x':
+        lex->lexeme[lex->i++] = 'x';
+        lex->pos++;
+        old_read_number(lex);
+        old_convert(lex, 2, 16);
+        break;
+      default:
+        old_read_number(lex);
+        if (tolower(text[lex->pos]) == 'h') {
+          lex->pos++;
+          old_convert(lex, 0, 16);
+        }
+        else
+          old_convert(lex, 0, 10);
+        break;
+    }
+    return lex->token = TOK_NUM;
+  }
+
+  if (isdigit(c)) {
+    lex->i = 0;
+    old_read_number(lex);
+    if (tolower(text[lex->pos]) == 'h') {
+      lex->pos++;
+      old_convert(lex, 0, 16);
+    }
+    else
+      old_convert(lex, 0, 10);
+    return lex->token = TOK_NUM;
+  }
+
+  if (c == '\'' || c == '\"') {
+    const int delim = c;
+    unsigned i = 0;
+    lex->lexeme[i++] = '\'';
+    lex->pos++;
+    while ((c = text[lex->pos]) != '\0' && c != '\n' && c != delim) {
+      lex->lexeme[i++] = c;
+      lex->pos++;
+    }
+    lex->lexeme[i++] = '\'';
+    lex->lexeme[i] = '\0';
+    lex->pos++;
+    return lex->token = TOK_STRING;
+  }
+
+  if (strchr(":+-*/,()[]?=", c)) {
+    lex->pos++;
+    return lex->token = c;
+  }
+
+  return lex->token = TOK_NONE;
+}
+
+static void old_read_number(LEX* lex) {
+  int c;
+
+  while (isxdigit(c = lex->text[lex->pos])) {
+    lex->lexeme[lex->i++] = c;
+    do {
+      lex->pos++;
+    } while (lex->text[lex->pos] == '_');
+  }
+  lex->lexeme[lex->i] = '\0';
+}
+
+static void old_convert(LEX* lex, unsigned pos, int base) {
+  char* end = NULL;
+  errno = 0;
+  lex->val.num = strtoull(lex->lexeme + pos, &end, base);
+  if (lex->val.num == ULLONG_MAX && errno == ERANGE) {
+    lex_error(lex, "number out of range: %s", lex->lexeme);
+    lex->val.num = 0;
+  }
+  if (*end != '\0' || end == lex->lexeme + pos) {
+    lex_error(lex, "invalid number: %s", lex->lexeme);
+    lex->val.num = 0;
+  }
+}
+
+static void old_lex_begin(LEX* lex, const char* text, unsigned lineno, unsigned pos) {
+  assert(pos <= strlen(text));
+  if (strlen(text) > MAX_TEXT)
+    fail();
+  lex->text = text;
+  lex->lineno = lineno;
+  lex->pos = pos;
+  lex->token = old_lex_next(lex);
+  lex->errors = 0;
+}
+
+// Lines in the style of the test programs, with every form of number.
+static const char* const corpus[] = {
+  "; 8086 instructions",
+  "\tIDEAL",
+  "\tSEGMENT\tCODE PUBLIC",
+  "\tASSUME\tCS: CODE, DS: DGROUP",
+  "start:\tmov\tax, DGROUP",
+  "\tmov\tds, ax",
+  "\tmov\tdx, 5678h\t; ba 78 56",
+  "\tmov\tax, [1234h]\t; a1 34 12",
+  "\tmov\tWORD [bx+si+12], 0FFFEh",
+  "\tadd\tal, [BYTE es:di-3]",
+  "\tint\t20h\t\t; cd 20",
+  "\tcmp\tcx, 100",
+  "\tshl\tbx, 1",
+  "\tjnz\t@@loop",
+  "\tcall\tFAR PTR far_proc",
+  "@@loop:\tloop\t@@loop",
+  "K_1\tEQU\t1_000",
+  "mask\tEQU\t0b1010_0101",
+  "perms\tEQU\t0o755",
+  "big\tEQU\t0x7FFF_FFFF",
+  "bhex\tEQU\t0b101h",
+  "\tDB\t'Hello, world', 13, 10, \"$\"",
+  "buffer\tDB\t16 DUP (?)",
+  "table\tDW\toffset start, $ - table",
+  "\tDD\t12345678h",
+  "\tDQ\t0FFFF_FFFF_FFFF_FFFFh",
+  "\tENDS",
+  "\tEND\tstart",
+  "",
+};
+
+#define CORPUS_LINES (sizeof corpus / sizeof corpus[0])
+
+static void test_old_lexer(CuTest* tc) {
+  LEX* lex = new_lex(NULL, NULL);
+  LEX* old = new_lex(NULL, NULL);
+
+  for (unsigned i = 0; i < CORPUS_LINES; i++) {
+    lex_begin(lex, corpus[i], i + 1, 0);
+    old_lex_begin(old, corpus[i], i + 1, 0);
+    for (;;) {
+      CuAssertIntEquals(tc, old->token, lex->token);
+      CuAssertIntEquals(tc, old->token_pos, lex->token_pos);
+      CuAssertIntEquals(tc, old->pos, lex->pos);
+      switch (lex->token) {
+        case TOK_LABEL:
+        case TOK_STRING:
+          CuAssertStrEquals(tc, old->lexeme, lex->lexeme);
+          break;
+        case TOK_NUM:
+          CuAssertTrue(tc, old->val.num == lex->val.num);
+          break;
+        case TOK_REG8:
+        case TOK_REG16:
+        case TOK_SREG:
+          CuAssertIntEquals(tc, old->val.reg, lex->val.reg);
+          break;
+      }
+      if (lex->token == TOK_EOL)
+        break;
+      lex_next(lex);
+      old_lex_next(old);
+    }
+    CuAssertIntEquals(tc, 0, lex->errors);
+  }
+
+  delete_lex(old);
+  delete_lex(lex);
+}
+
 CuSuite* lexer_test_suite(void) {
   CuSuite* suite = CuSuiteNew();
   SUITE_ADD_TEST(suite, test_new_lex);
@@ -623,6 +1053,57 @@ CuSuite* lexer_test_suite(void) {
   SUITE_ADD_TEST(suite, test_append_lexeme);
   SUITE_ADD_TEST(suite, test_read_number);
   SUITE_ADD_TEST(suite, test_convert);
+  SUITE_ADD_TEST(suite, test_numbers);
+  SUITE_ADD_TEST(suite, test_old_lexer);
+  return suite;
+}
+
+static void bench_lex_old(CuBench* bc) {
+  LEX* lex = new_lex(NULL, NULL);
+  unsigned long tokens = 0;
+
+  init_keywords();
+
+  CuBenchStart(bc);
+  for (long i = 0; i < bc->n; i++) {
+    old_lex_begin(lex, corpus[i % CORPUS_LINES], 1, 0);
+    while (lex->token != TOK_EOL) {
+      old_lex_next(lex);
+      tokens++;
+    }
+  }
+  CuBenchStop(bc);
+
+  bc->sink = tokens;
+  assert(tokens > 0 || bc->n < (long) CORPUS_LINES);
+  delete_lex(lex);
+}
+
+static void bench_lex(CuBench* bc) {
+  LEX* lex = new_lex(NULL, NULL);
+  unsigned long tokens = 0;
+
+  init_keywords();
+
+  CuBenchStart(bc);
+  for (long i = 0; i < bc->n; i++) {
+    lex_begin(lex, corpus[i % CORPUS_LINES], 1, 0);
+    while (lex->token != TOK_EOL) {
+      lex_next(lex);
+      tokens++;
+    }
+  }
+  CuBenchStop(bc);
+
+  bc->sink = tokens;
+  assert(tokens > 0 || bc->n < (long) CORPUS_LINES);
+  delete_lex(lex);
+}
+
+CuBenchSuite* lexer_bench_suite(void) {
+  CuBenchSuite* suite = CuBenchSuiteNew();
+  SUITE_ADD_BENCH(suite, bench_lex_old);
+  SUITE_ADD_BENCH(suite, bench_lex);
   return suite;
 }
 
@@ -5,6 +5,7 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include "intern.h"
 #include "source.h"
 #include "utils.h"
 
@@ -12,7 +13,9 @@
 
 typedef struct {
   const char* source_name;
+  const INTERN* names;
   const char* text;
+  unsigned len;  // of text, found once per line
   unsigned lineno;
   unsigned pos;
   unsigned token_pos;
@@ -22,11 +25,13 @@ typedef struct {
   struct {
     unsigned long long num;
     int reg;
+    NAME_ID name;
   } val;
   unsigned errors;
 } LEX;
 
-LEX* new_lex(const char* source_name);
+// Identifiers are looked up in the names, if not NULL, to give their IDs.
+LEX* new_lex(const char* source_name, const INTERN* names);
 void delete_lex(LEX*);
 
 // source
@@ -40,6 +45,7 @@ int lex_next(LEX*);
 unsigned lex_pos(LEX*);
 unsigned lex_token_pos(LEX*);
 const char* lex_lexeme(LEX*);
+NAME_ID lex_name(LEX*);
 void lex_discard_line(LEX*);
 unsigned long lex_val(LEX*);
 unsigned long long lex_lval(LEX*);
@@ -12,26 +12,42 @@ Options* new_options(void) {
 
 #ifdef UNIT_TEST
   p->unit_test = FALSE;
+  p->bench = false;
+  p->bench_baselines = NULL;
 #endif
-  p->source_name = NULL;
+  p->sources = new_stringlist();
   p->print_source = FALSE;
   p->print_intermediate = FALSE;
   p->output_name = NULL;
+  p->format = NULL;
   p->verbose = FALSE;
   p->max_errors = -1;
   p->report_memory = FALSE;
   p->report_time = FALSE;
   p->help = FALSE;
   p->case_sensitive = false;
+  p->tasm_encoding = false;
+  p->list_cycles = false;
   p->report_hash_table = false;
+  p->threads = DEFAULT_THREADS;
+#ifdef TRACE_EVENTS
+  p->trace_name = NULL;
+#endif
 
   return p;
 }
 
 void delete_options(Options* p) {
   if (p) {
-    efree(p->source_name);
+    delete_stringlist(p->sources);
     efree(p->output_name);
+    efree(p->format);
+#ifdef UNIT_TEST
+    efree(p->bench_baselines);
+#endif
+#ifdef TRACE_EVENTS
+    efree(p->trace_name);
+#endif
     efree(p);
   }
 }
@@ -45,18 +61,43 @@ void process_argv(int argc, char* argv[], Options* opts) {
       opts->unit_test = TRUE;
       return;
     }
+    if (strcmp(arg, "-bench") == 0 || strncmp(arg, "-bench=", 7) == 0) {
+      opts->bench = true;
+      if (arg[6] == '=')
+        opts->bench_baselines = estrdup(arg + 7);
+      return;
+    }
 #endif
     if (arg[0] == '-') {
       if (strcmp(arg, "-I") == 0)
         opts->print_intermediate = TRUE;
       else if (strcmp(arg, "-S") == 0)
         opts->print_source = TRUE;
+      else if (arg[1] == 'f') {
+        const char* format = NULL;
+        if (arg[2])
+          format = arg + 2;
+        else if (++i < argc)
+          format = argv[i];
+        else
+          fatal("-f: output format missing\n");
+        if (_stricmp(format, "com") != 0 && _stricmp(format, "bin") != 0)
+          fatal("-f: output format must be com or bin: %s\n", format);
+        efree(opts->format);
+        opts->format = estrdup(format);
+      }
       else if (strcmp(arg, "-h") == 0 || strcmp(arg, "-?") == 0 || strcmp(arg, "--help") == 0)
         opts->help = TRUE;
       else if (strcmp(arg, "-m") == 0)
         opts->report_memory = TRUE;
       else if (strncmp(arg, "-me=", 4) == 0)
         opts->max_errors = atoi(arg + 4);
+      else if (strncmp(arg, "-j=", 3) == 0) {
+        int n = atoi(arg + 3);
+        if (n < 1)
+          fatal("invalid thread count: %s\n", arg + 3);
+        opts->threads = n;
+      }
       else if (strcmp(arg, "-o") == 0 && i + 1 < argc)
         opts->output_name = estrdup(argv[++i]);
       else if (strcmp(arg, "-t") == 0)
@@ -67,20 +108,36 @@ void process_argv(int argc, char* argv[], Options* opts) {
         opts->case_sensitive = true;
       else if (strcmp(arg, "--case-insensitive") == 0)
         opts->case_sensitive = false;
+      else if (strcmp(arg, "--tasm-encoding") == 0)
+        opts->tasm_encoding = true;
+      else if (strcmp(arg, "--cycles") == 0)
+        opts->list_cycles = true;
       else if (strcmp(arg, "--hash") == 0)
         opts->report_hash_table = true;
+#ifdef TRACE_EVENTS
+      else if (strcmp(arg, "--trace") == 0) {
+        if (++i >= argc)
+          fatal("trace file name missing\n");
+        efree(opts->trace_name);
+        opts->trace_name = estrdup(argv[i]);
+      }
+#endif
       else
         fatal("invalid option: %s\n", arg);
     }
     else if (strcmp(arg, "/?") == 0)
       opts->help = TRUE;
-    else if (opts->source_name == NULL)
-      opts->source_name = estrdup(arg);
     else
-      fatal("unexpected argument: %s\n", arg);
+      append_string(opts->sources, arg);
   }
-  if (opts->source_name == NULL && !opts->help)
+  if (stringlist_count(opts->sources) == 0 && !opts->help)
     fatal("source file name expected\n");
+  if (stringlist_count(opts->sources) > 1) {
+    if (opts->output_name)
+      fatal("-o requires a single source file\n");
+    if (opts->print_source || opts->print_intermediate || opts->list_cycles)
+      fatal("-S, -I and --cycles require a single source file\n");
+  }
 }
 
 
@@ -94,11 +151,17 @@ static void test_new_options(CuTest* tc) {
   opt = new_options();
   CuAssertPtrNotNull(tc, opt);
   CuAssertIntEquals(tc, FALSE, opt->unit_test);
-  CuAssertTrue(tc, opt->source_name == NULL);
+  CuAssertIntEquals(tc, false, opt->bench);
+  CuAssertTrue(tc, opt->bench_baselines == NULL);
+  CuAssertIntEquals(tc, 0, stringlist_count(opt->sources));
   CuAssertIntEquals(tc, FALSE, opt->print_source);
   CuAssertIntEquals(tc, FALSE, opt->print_intermediate);
   CuAssertTrue(tc, opt->output_name == NULL);
+  CuAssertTrue(tc, opt->format == NULL);
   CuAssertIntEquals(tc, FALSE, opt->verbose);
+  CuAssertIntEquals(tc, false, opt->tasm_encoding);
+  CuAssertIntEquals(tc, false, opt->list_cycles);
+  CuAssertIntEquals(tc, DEFAULT_THREADS, opt->threads);
 
   delete_options(opt);
 }
@@ -108,23 +171,53 @@ static void test_process_argv(CuTest* tc) {
 
   char* argv_unittest[] = { "prog", "-S", "-unittest", "-I", NULL };
 
-  char* argv_print[] = { "prog", "-I", "dangle.asm", NULL };
+  char* argv_print[] = { "prog", "-I", "dangle.asm", "--tasm-encoding", NULL };
+
+  char* argv_bench[] = { "prog", "-bench=bas.base", "dangle.asm", NULL };
+
+  char* argv_many[] = { "prog", "one.asm", "-j=2", "two.asm", "three.asm", NULL };
+
+  char* argv_format[] = { "prog", "-f", "COM", "tiny.asm", "-fbin", "--cycles", NULL };
 
   opt = new_options();
   process_argv(4, argv_unittest, opt);
   CuAssertIntEquals(tc, TRUE, opt->unit_test);
-  CuAssertTrue(tc, opt->source_name == NULL);
+  CuAssertIntEquals(tc, 0, stringlist_count(opt->sources));
   CuAssertIntEquals(tc, TRUE, opt->print_source);
   CuAssertIntEquals(tc, FALSE, opt->print_intermediate);
   delete_options(opt);
 
   opt = new_options();
-  process_argv(3, argv_print, opt);
+  process_argv(4, argv_print, opt);
   CuAssertIntEquals(tc, FALSE, opt->unit_test);
-  CuAssertPtrNotNull(tc, opt->source_name);
-  CuAssertStrEquals(tc, "dangle.asm", opt->source_name);
+  CuAssertIntEquals(tc, 1, stringlist_count(opt->sources));
+  CuAssertStrEquals(tc, "dangle.asm", stringlist_item(opt->sources, 0));
   CuAssertIntEquals(tc, FALSE, opt->print_source);
   CuAssertIntEquals(tc, TRUE, opt->print_intermediate);
+  CuAssertIntEquals(tc, true, opt->tasm_encoding);
+  delete_options(opt);
+
+  opt = new_options();
+  process_argv(3, argv_bench, opt);
+  CuAssertIntEquals(tc, true, opt->bench);
+  CuAssertStrEquals(tc, "bas.base", opt->bench_baselines);
+  CuAssertIntEquals(tc, 0, stringlist_count(opt->sources));
+  delete_options(opt);
+
+  opt = new_options();
+  process_argv(5, argv_many, opt);
+  CuAssertIntEquals(tc, 3, stringlist_count(opt->sources));
+  CuAssertStrEquals(tc, "one.asm", stringlist_item(opt->sources, 0));
+  CuAssertStrEquals(tc, "two.asm", stringlist_item(opt->sources, 1));
+  CuAssertStrEquals(tc, "three.asm", stringlist_item(opt->sources, 2));
+  CuAssertIntEquals(tc, 2, opt->threads);
+  delete_options(opt);
+
+  opt = new_options();
+  process_argv(6, argv_format, opt);
+  CuAssertIntEquals(tc, 1, stringlist_count(opt->sources));
+  CuAssertStrEquals(tc, "bin", opt->format);
+  CuAssertIntEquals(tc, true, opt->list_cycles);
   delete_options(opt);
 }
 
@@ -7,22 +7,34 @@
 
 #include <stdbool.h>
 #include "utils.h"
+#include "stringlist.h"
+
+#define DEFAULT_THREADS (4)
 
 typedef struct {
 #ifdef UNIT_TEST
   BOOL unit_test;
+  bool bench;
+  char* bench_baselines;
 #endif
-  char* source_name;
+  STRINGLIST* sources;  // assembled concurrently if more than one
   BOOL print_source;
   BOOL print_intermediate;
   char* output_name;
+  char* format;  // com or bin: link the module to a program, not an object file
   BOOL verbose;
   unsigned max_errors;
   BOOL report_memory;
   BOOL report_time;
   BOOL help;
   bool case_sensitive;
+  bool tasm_encoding;  // first instruction form matching, not the shortest
+  bool list_cycles;  // list estimated clocks of each instruction and the costliest loops
   bool report_hash_table;
+  unsigned threads;
+#ifdef TRACE_EVENTS
+  char* trace_name;
+#endif
 } Options;
 
 Options* new_options(void);
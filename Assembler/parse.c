@@ -22,6 +22,10 @@ void init_state(STATE* state, unsigned max_errors) {
 
   state->cpu = (1 << P86) | (1 << P87);
   state->jumps = false;
+  state->quiet = false;
+  state->tasm_encoding = false;
+  state->varying_refs = 0;
+  state->timing = NULL;
 }
 
 void error(STATE* state, const IFILE* ifile, const char* fmt, ...) {
@@ -29,21 +33,28 @@ void error(STATE* state, const IFILE* ifile, const char* fmt, ...) {
   assert(ifile != NULL);
   assert(fmt != NULL);
 
-  fprintf(stderr, "Error: %s: ", source_name(ifile->source));
+  FILE* fp = error_stream();
+
+  if (state->quiet) {
+    state->errors++;
+    return;
+  }
+
+  fprintf(fp, "Error: %s: ", source_name(ifile->source));
 
   if (ifile->pos < ifile->used) {
     const IREC* irec = get_irec_const(ifile, ifile->pos);
     unsigned lineno = irec_lineno(ifile, irec);
 
-    fprintf(stderr, "%u: ", lineno);
+    fprintf(fp, "%u: ", lineno);
   }
 
   va_list ap;
   va_start(ap, fmt);
-  vfprintf(stderr, fmt, ap);
+  vfprintf(fp, fmt, ap);
   va_end(ap);
 
-  fputc('\n', stderr);
+  fputc('\n', fp);
 
   state->errors++;
   check_max_errors(state);
@@ -56,20 +67,27 @@ void error2(STATE* state, LEX* lex, const char* fmt, ...) {
   assert(lex != NULL);
   assert(fmt != NULL);
 
-  fprintf(stderr, "Error: %s: %u: ", lex_source_name(lex), lex_lineno(lex));
+  FILE* fp = error_stream();
+
+  if (state->quiet) {
+    state->errors++;
+    return;
+  }
+
+  fprintf(fp, "Error: %s: %u: ", lex_source_name(lex), lex_lineno(lex));
 
   va_start(ap, fmt);
-  vfprintf(stderr, fmt, ap);
+  vfprintf(fp, fmt, ap);
   va_end(ap);
 
-  fputs(":\n", stderr);
+  fputs(":\n", fp);
 
   const unsigned TAB = 4;
 
-  print_notabs(stderr, lex_text(lex), TAB);
-  fputc('\n', stderr);
-  position(stderr, lex_text(lex), lex_token_pos(lex), TAB);
-  fputs("^\n", stderr);
+  print_notabs(fp, lex_text(lex), TAB);
+  fputc('\n', fp);
+  position(fp, lex_text(lex), lex_token_pos(lex), TAB);
+  fputs("^\n", fp);
 
   state->errors++;
   check_max_errors(state);
@@ -80,10 +98,26 @@ void check_max_errors(const STATE* state) {
     fatal("maximum errors reached\n");
 }
 
+// The location counter is looked up through the intermediate file,
+// so that a copy of the file can have its own.
+// Any symbol but a defined absolute one may have a different value or
+// type in a later pass, which the passes track through varying_refs.
+static SYMBOL* lookup_label(STATE* state, IFILE* ifile, LEX* lex) {
+  SYMBOL* sym;
+  if (ifile->dollar != NULL && strcmp(lex_lexeme(lex), "$") == 0)
+    sym = ifile->dollar;
+  else
+    sym = sym_lookup_id(ifile->st, lex_name(lex));
+  if (sym == NULL || !sym_defined(sym) || sym_type(sym) != SYM_ABSOLUTE)
+    state->varying_refs++;
+  return sym;
+}
+
 unsigned token_data_size(int tok) {
   unsigned size = 0;
   switch (tok) {
     case TOK_DB: size = 1; break;
+    case TOK_INCBIN: size = 1; break;
     case TOK_DW: size = 2; break;
     case TOK_DD: size = 4; break;
     case TOK_DQ: size = 8; break;
@@ -262,7 +296,7 @@ static BOOL parse_operand(STATE* state, IFILE* ifile, LEX* lex, OPERAND* op) {
     }
 
     if (lex_token(lex) == TOK_LABEL) {
-      SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+      SYMBOL* sym = lookup_label(state, ifile, lex);
       if (sym == NULL)
         sym = sym_insert_relative(ifile->st, lex_lexeme(lex), lex_lineno(lex));
       lex_next(lex);
@@ -315,7 +349,7 @@ static BOOL parse_operand(STATE* state, IFILE* ifile, LEX* lex, OPERAND* op) {
       }
     }
     else if (lex_token(lex) == TOK_LABEL) {
-      SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+      SYMBOL* sym = lookup_label(state, ifile, lex);
       if (sym == NULL)
         sym = sym_insert_relative(ifile->st, lex_lexeme(lex), lex_lineno(lex));
       lex_next(lex);
@@ -538,7 +572,7 @@ static BOOL parse_disp(STATE* state, IFILE* ifile, LEX* lex, OPERAND* op) {
   }
 
   if (lex_token(lex) == TOK_LABEL) {
-    SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+    SYMBOL* sym = lookup_label(state, ifile, lex);
     if (sym == NULL)
       sym = sym_insert_relative(ifile->st, lex_lexeme(lex), lex_lineno(lex));
 
@@ -632,7 +666,7 @@ int expr(STATE* state, IFILE* ifile, LEX* lex, union value * val) {
 }
 
 AST* new_ast(int kind) {
-  AST* p = ecalloc(sizeof *p);
+  AST* p = tag_memory(ecalloc(sizeof *p), MEM_AST);
   p->kind = kind;
   return p;
 }
@@ -767,7 +801,7 @@ static const SYMBOL* relative_label(STATE* state, IFILE* ifile, LEX* lex, int op
     error2(state, lex, "%s requires symbol", token_name(op));
     return NULL;
   }
-  SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+  SYMBOL* sym = lookup_label(state, ifile, lex);
   if (sym == NULL)
     sym = sym_insert_relative(ifile->st, lex_lexeme(lex), lex_lineno(lex));
   else {
@@ -804,14 +838,14 @@ static AST* primitive_expr(STATE* state, IFILE* ifile, LEX* lex) {
       break;
     case TOK_LABEL:
       node = new_ast(AST_LABEL);
-      node->u.label = sym_lookup(ifile->st, lex_lexeme(lex));
+      node->u.label = lookup_label(state, ifile, lex);
       if (node->u.label == NULL)
         node->u.label = sym_insert_unknown(ifile->st, lex_lexeme(lex), lex_lineno(lex));
       lex_next(lex);
       break;
     case TOK_STRING:
       node = new_ast(AST_STRING);
-      node->u.string.content = lex_string_content(lex, &node->u.string.len);
+      node->u.string.content = tag_memory(lex_string_content(lex, &node->u.string.len), MEM_AST);
       assert(node->u.string.content != NULL || node->u.string.len == 0);
       lex_next(lex);
       break;
@@ -1093,6 +1127,10 @@ static void test_init_state(CuTest* tc) {
   CuAssertTrue(tc, state.assume_sym[SR_DS] == NULL);
   CuAssertTrue(tc, state.assume_sym[SR_ES] == NULL);
   CuAssertTrue(tc, state.assume_sym[SR_SS] == NULL);
+  CuAssertIntEquals(tc, false, state.jumps);
+  CuAssertIntEquals(tc, false, state.quiet);
+  CuAssertIntEquals(tc, 0, state.varying_refs);
+  CuAssertPtrEquals(tc, NULL, state.timing);
 }
 
 static void test_error(CuTest* tc) {
@@ -1297,7 +1335,7 @@ static void test_primitive_expr(CuTest* tc) {
   static const char text[] = "871 0FACEhFred'''cobblers'?+";
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   STATE state;
   AST* ast;
 
@@ -1364,7 +1402,7 @@ static void test_relative_label(CuTest* tc) {
   static const char text[] = "+ Fred Sally Outside Tom:";
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   STATE state;
   const SYMBOL* sym;
 
@@ -1418,7 +1456,7 @@ static void test_component_expr(CuTest* tc) {
   static const char text[] = "SEG addr: SEG 1234: OFFSET addr: OFFSET 9: lavender:";
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   STATE state;
   AST* ast;
   SYMBOL* addr;
@@ -1497,7 +1535,7 @@ static void test_unary_expr(CuTest* tc) {
   static const char text[] = "29: -X: --X:";
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   STATE state;
   AST* ast;
 
@@ -1556,7 +1594,7 @@ static void test_mult_expr(CuTest* tc) {
   static const char text[] = "-3-2*K*7";
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   STATE state;
   AST* ast;
 
@@ -1600,7 +1638,7 @@ static void test_add_expr(CuTest* tc) {
   static const char text[] = "3*K 2+A*7-1";
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   STATE state;
   AST* ast;
 
@@ -1994,7 +2032,7 @@ static void test_parse_disp(CuTest* tc) {
   SOURCE* src = load_source_mem(text);
   STATE state;
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   OPERAND op;
   struct mem * const mem = &op.val.mem;
   BOOL succ;
@@ -2082,7 +2120,7 @@ static void test_parse_mem(CuTest* tc) {
       ;
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   OPERAND op;
   STATE state;
   BOOL succ;
@@ -2237,7 +2275,7 @@ static void test_parse_operand_register(CuTest* tc) {
   static const char text[] = "BH AL SI AX ES";
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   OPERAND op;
   BOOL succ;
 
@@ -2315,7 +2353,7 @@ static void test_parse_operand_immediate(CuTest* tc) {
   static const char text[] = "1234 7FH, -1234, -80H '*' 'AB'";
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   OPERAND op;
   BOOL succ;
 
@@ -2402,7 +2440,7 @@ static void test_parse_operand_label(CuTest* tc) {
   static const char text[] = "ahead behind K TINY newlabel";
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   OPERAND op;
   SYMBOL* ahead_label;
   SYMBOL* behind_label;
@@ -2498,7 +2536,7 @@ static void test_parse_operand_offset(CuTest* tc) {
     ;
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   OPERAND op;
   BOOL succ;
 
@@ -2577,7 +2615,7 @@ static void test_parse_operand_jump(CuTest* tc) {
     ;
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   OPERAND op;
   BOOL succ;
 
@@ -2632,7 +2670,7 @@ static void test_parse_operand_memory(CuTest* tc) {
   static const char text[] = "[bx] [word bp+si-40h]";
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   OPERAND op;
   BOOL succ;
 
@@ -2679,7 +2717,7 @@ static void test_parse_operand_error(CuTest* tc) {
   static const char text[] = "+2";
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   OPERAND op;
   BOOL succ;
 
@@ -2720,7 +2758,7 @@ static void test_parse_operands(CuTest* tc) {
     ;
   SOURCE* src = load_source_mem(mem);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   OPERAND op1, op2, op3;
   BOOL succ;
 
@@ -2837,12 +2875,61 @@ static void test_parse_operands(CuTest* tc) {
   delete_source(src);
 }
 
+static void test_varying_refs(CuTest* tc) {
+  STATE state;
+  static const char mem[] =
+    ";\n"
+    "ax, K\n"
+    "ax, L\n"
+    "[bx+K], 1\n"
+    "[bx+L], 1\n"
+    "cx, $\n"
+    ;
+  SOURCE* src = load_source_mem(mem);
+  IFILE* ifile = new_ifile(src, false);
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
+  OPERAND op1, op2, op3;
+
+  source_pass(ifile, NULL);
+  init_state(&state, -1);
+  sym_define_absolute(sym_insert_absolute(ifile->st, "K", 1), 5);
+
+  // defined absolute symbol
+  lex_begin(lex, source_text(src, 1), source_lineno(src, 1), 0);
+  CuAssertIntEquals(tc, TRUE, parse_operands(&state, ifile, lex, &op1, &op2, &op3));
+  CuAssertIntEquals(tc, 0, state.varying_refs);
+
+  // forward reference
+  lex_begin(lex, source_text(src, 2), source_lineno(src, 2), 0);
+  CuAssertIntEquals(tc, TRUE, parse_operands(&state, ifile, lex, &op1, &op2, &op3));
+  CuAssertIntEquals(tc, 1, state.varying_refs);
+
+  lex_begin(lex, source_text(src, 3), source_lineno(src, 3), 0);
+  CuAssertIntEquals(tc, TRUE, parse_operands(&state, ifile, lex, &op1, &op2, &op3));
+  CuAssertIntEquals(tc, 1, state.varying_refs);
+
+  lex_begin(lex, source_text(src, 4), source_lineno(src, 4), 0);
+  CuAssertIntEquals(tc, TRUE, parse_operands(&state, ifile, lex, &op1, &op2, &op3));
+  CuAssertIntEquals(tc, 2, state.varying_refs);
+
+  // location counter
+  lex_begin(lex, source_text(src, 5), source_lineno(src, 5), 0);
+  CuAssertIntEquals(tc, TRUE, parse_operands(&state, ifile, lex, &op1, &op2, &op3));
+  CuAssertIntEquals(tc, 3, state.varying_refs);
+
+  CuAssertIntEquals(tc, 0, state.errors);
+
+  delete_lex(lex);
+  delete_ifile(ifile);
+  delete_source(src);
+}
+
 static void test_expr(CuTest* tc) {
   STATE state;
   static const char text[] = "-KARR  3+4*2 addr addr+0";
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   union value val;
   int type;
   SYMBOL* sym;
@@ -2884,7 +2971,7 @@ static void test_expr_operand(CuTest* tc) {
   static const char text[] = "-KARR*3";
   SOURCE* src = load_source_mem(text);
   IFILE* ifile = new_ifile(src, false);
-  LEX* lex = new_lex(source_name(src));
+  LEX* lex = new_lex(source_name(src), ifile->st->names);
   OPERAND op;
   SYMBOL* sym;
   BOOL succ;
@@ -2948,6 +3035,7 @@ CuSuite* parse_test_suite(void) {
   SUITE_ADD_TEST(suite, test_parse_operand_memory);
   SUITE_ADD_TEST(suite, test_parse_operand_error);
   SUITE_ADD_TEST(suite, test_parse_operands);
+  SUITE_ADD_TEST(suite, test_varying_refs);
   SUITE_ADD_TEST(suite, test_expr);
   SUITE_ADD_TEST(suite, test_expr_operand);
   return suite;
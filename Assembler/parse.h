@@ -8,6 +8,7 @@
 #include "ifile.h"
 #include "operand.h"
 #include "lexer.h"
+#include "timing.h"
 #include "token.h"
 #include "utils.h"
 
@@ -20,6 +21,10 @@ typedef struct {
   unsigned cpu;  // CPUs (instruction sets) currently active: effect of P286 etc.
   const SYMBOL* assume_sym[N_SREG];  // ASSUME settings.
   bool jumps;  // JUMPS directive: expand out-of-range short jumps to reverse sense and JMP.
+  bool quiet;  // Count errors without reporting them.
+  bool tasm_encoding;  // Select the first instruction form matching, as Turbo Assembler, not the shortest.
+  unsigned varying_refs;  // References to symbols whose values may change between passes.
+  TIMING* timing;  // Clock estimates of instructions encoded, or NULL.
 } STATE;
 
 void init_state(STATE*, unsigned max_errors);
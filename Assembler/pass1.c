@@ -9,6 +9,7 @@
 #include <limits.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <sys/stat.h>
 #include "pass1.h"
 #include "ifile.h"
 #include "lexer.h"
@@ -32,11 +33,12 @@ void pass1(IFILE* ifile, const Options* options) {
     puts("Pass 1");
 
   init_state(&state, options->max_errors);
-  lex = new_lex(source_name(ifile->source));
+  state.tasm_encoding = options->tasm_encoding;
+  lex = new_lex(source_name(ifile->source), ifile->st->names);
 
   if (sym_lookup(ifile->st, "$"))
     fatal("internal error: built-in symbol '$' is already defined\n");
-  sym_insert_relative(ifile->st, "$", 1);
+  ifile->dollar = sym_insert_relative(ifile->st, "$", 1);
 
   for (ifile->pos = 0; ifile->pos < irec_count(ifile); ifile->pos++)
     process_irec(&state, ifile, lex);
@@ -46,8 +48,8 @@ void pass1(IFILE* ifile, const Options* options) {
   delete_lex(lex);
 
   if (state.errors > 0) {
-    fprintf(stderr, "Errors: %u\n", state.errors);
-    exit(EXIT_FAILURE);
+    fprintf(error_stream(), "Errors: %u\n", state.errors);
+    fail();
   }
 
   check_symbols_defined(ifile);
@@ -104,7 +106,7 @@ static BOOL define_label(STATE* state, IFILE* ifile, IREC* irec, LEX* lex) {
   assert(lex != NULL);
   assert(lex_token(lex) == TOK_LABEL);
 
-  irec->label = sym_lookup(ifile->st, lex_lexeme(lex));
+  irec->label = sym_lookup_id(ifile->st, lex_name(lex));
   if (irec->label == NULL) {
     char* name = estrdup(lex_lexeme(lex));
     BOOL colon = FALSE;
@@ -164,15 +166,15 @@ static void check_symbols_defined(IFILE* ifile) {
 
   for (const SYMBOL* sym = sym_first(ifile->st, &find); sym; sym = sym_next(&find)) {
     if (!sym_defined(sym)) {
-      fprintf(stderr, "Error: %s: %u: symbol used but not defined: %s\n",
+      fprintf(error_stream(), "Error: %s: %u: symbol used but not defined: %s\n",
               source_name(ifile->source), sym_lineno(sym), sym_name(sym));
       count++;
     }
   }
 
   if (count > 0) {
-    fprintf(stderr, "Undefined symbols: %u\n", count);
-    exit(EXIT_FAILURE);
+    fprintf(error_stream(), "Undefined symbols: %u\n", count);
+    fail();
   }
 }
 
@@ -186,6 +188,7 @@ static void do_equ(STATE*, IFILE*, LEX*);
 static void do_equate(STATE*, IFILE*, LEX*);
 static void do_extrn(STATE*, IFILE*, LEX*);
 static void do_group(STATE*, IFILE*, LEX*);
+static void do_incbin(STATE*, IFILE*, LEX*);
 static void do_jumps(STATE*, IFILE*, LEX*);
 static void do_model(STATE*, IFILE*, LEX*);
 static void do_org(STATE*, IFILE*, LEX*);
@@ -218,6 +221,7 @@ static void perform_directive(STATE* state, IFILE* ifile, LEX* lex) {
     case '=': do_equate(state, ifile, lex); break;
     case TOK_EXTRN: do_extrn(state, ifile, lex); break;
     case TOK_GROUP: do_group(state, ifile, lex); break;
+    case TOK_INCBIN: do_incbin(state, ifile, lex); break;
     case TOK_JUMPS: do_jumps(state, ifile, lex); break;
     case TOK_MODEL: do_model(state, ifile, lex); break;
     case TOK_ORG: do_org(state, ifile, lex); break;
@@ -323,7 +327,7 @@ static void do_end(STATE* state, IFILE* ifile, LEX* lex) {
     if (ifile->start_label != NULL)
       error2(state, lex, "start label has already been set");
 
-    ifile->start_label = sym_lookup(ifile->st, lex_lexeme(lex));
+    ifile->start_label = sym_lookup_id(ifile->st, lex_name(lex));
     if (ifile->start_label == NULL)
       error2(state, lex, "start label not found: %s", lex_lexeme(lex));
     else if (sym_type(ifile->start_label) != SYM_RELATIVE)
@@ -358,7 +362,7 @@ static void do_segment(STATE* state, IFILE* ifile, LEX* lex) {
   int seg = NO_SEG;
   bool reopen = false;
 
-  SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+  SYMBOL* sym = sym_lookup_id(ifile->st, lex_name(lex));
   if (sym == NULL) {
     sym = sym_insert_section(ifile->st, lex_lexeme(lex), lex_lineno(lex));
     seg = create_segment(ifile, lex_lexeme(lex));
@@ -514,7 +518,7 @@ static void assume(STATE* state, IFILE* ifile, LEX* lex) {
     return;
   }
 
-  SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+  SYMBOL* sym = sym_lookup_id(ifile->st, lex_name(lex));
   if (sym == NULL) {
     sym = sym_insert_section(ifile->st, lex_lexeme(lex), lex_lineno(lex));
     state->assume_sym[reg] = sym;
@@ -559,7 +563,7 @@ static int get_group(STATE* state, IFILE* ifile, LEX* lex) {
     return -1;
   }
 
-  SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+  SYMBOL* sym = sym_lookup_id(ifile->st, lex_name(lex));
   if (sym == NULL) {
     sym = sym_insert_section(ifile->st, lex_lexeme(lex), lex_lineno(lex));
     int group = create_group(ifile, lex_lexeme(lex));
@@ -581,7 +585,7 @@ static void group_segment(STATE* state, IFILE* ifile, LEX* lex, int group) {
     return;
   }
 
-  SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+  SYMBOL* sym = sym_lookup_id(ifile->st, lex_name(lex));
   if (sym == NULL)
     error2(state, lex, "undefined: %s", lex_lexeme(lex));
   else if (sym_type(sym) != SYM_SECTION)
@@ -747,6 +751,50 @@ static void do_org(STATE* state, IFILE* ifile, LEX* lex) {
   lex_next(lex);
 }
 
+// The size of the included bytes is known from the file system now,
+// so that the file is read only when its bytes are encoded.
+static void do_incbin(STATE* state, IFILE* ifile, LEX* lex) {
+  assert(state != NULL);
+  assert(ifile != NULL);
+  assert(lex != NULL);
+  assert(lex_token(lex) == TOK_INCBIN);
+
+  if (state->curseg == NO_SEG) {
+    error2(state, lex, "data outside segment");
+    lex_discard_line(lex);
+    return;
+  }
+
+  if (segment_uninit(ifile, state->curseg)) {
+    error2(state, lex, "INCBIN is not allowed in uninitialised segments");
+    lex_discard_line(lex);
+    return;
+  }
+
+  IREC* irec = get_irec(ifile, ifile->pos);
+  assert(irec->size == 0);
+
+  lex_next(lex);
+  INCBIN_OPERANDS inc;
+  if (!parse_incbin(state, ifile, lex, &inc))
+    return;
+
+  struct stat st;
+  if (stat(inc.path, &st) != 0 || (st.st_mode & S_IFMT) != S_IFREG)
+    error2(state, lex, "binary file not found: %s", inc.path);
+  else if ((unsigned long long) st.st_size > (DWORD)(-1))
+    error2(state, lex, "binary file too large: %s", inc.path);
+  else if (inc.offset > (DWORD) st.st_size)
+    error2(state, lex, "INCBIN offset beyond end of file: %s", inc.path);
+  else if (inc.length_given && inc.length > (DWORD) st.st_size - inc.offset)
+    error2(state, lex, "INCBIN length beyond end of file: %s", inc.path);
+  else
+    irec->size = inc.length_given ? inc.length : (DWORD) st.st_size - inc.offset;
+
+  append_string_pointer(ifile->incbins, inc.path);
+  inc_segment_pc(ifile, state->curseg, irec->size);
+}
+
 static void do_align(STATE* state, IFILE* ifile, LEX* lex) {
   assert(state != NULL);
   assert(ifile != NULL);
@@ -788,7 +836,28 @@ static void check_initialization_consistent(STATE* state, IFILE* ifile, LEX* lex
   }
 }
 
-DataSize data_size(STATE*, IFILE*, LEX*, const char* descrip, EXPR_SIZE_FN*, BOOL *init);
+// Absolute data being encoded in pass 1, so that later passes need not parse it.
+// Values outside DUP are accumulated in bytes, as a run to be emitted once.
+// Each DUP at the top level becomes a run of its content repeated.
+// DUP within DUP is expanded in place, up to MAX_FOLDED bytes.
+typedef struct {
+  bool foldable;  // every value so far absolute
+  bool uninit;
+  unsigned width; // bytes per numeric value
+  unsigned depth; // of DUP nesting
+  DATA_RUN* runs;
+  unsigned nrun;
+  unsigned runs_allocated;
+  BYTE* bytes;
+  unsigned len;
+  unsigned allocated;
+} DATA_FOLD;
+
+#define MAX_FOLDED (0x10000)
+
+static DataSize sized_data(STATE*, IFILE*, LEX*, const char* descrip, EXPR_SIZE_FN*, BOOL *init, DATA_FOLD*);
+static void init_fold(DATA_FOLD*, unsigned width);
+static DATA_IMAGE* folded_image(DATA_FOLD*, DataSize size);
 
 static void define_data(STATE* state, IFILE* ifile, LEX* lex, const char* descrip, EXPR_SIZE_FN* expr_size_fn) {
   assert(state != NULL);
@@ -805,19 +874,32 @@ static void define_data(STATE* state, IFILE* ifile, LEX* lex, const char* descri
 
   IREC* irec = get_irec(ifile, ifile->pos);
   assert(irec->size == 0);
+  assert(irec->data == NULL);
 
   lex_next(lex);
   BOOL init;
-  irec->size = data_size(state, ifile, lex, descrip, expr_size_fn, &init);
+  DATA_FOLD fold;
+  init_fold(&fold, token_data_size(irec->op));
+  const unsigned varying_refs = state->varying_refs;
+  const unsigned errors = state->errors;
+  irec->size = sized_data(state, ifile, lex, descrip, expr_size_fn, &init, &fold);
   if (irec->size)
     check_initialization_consistent(state, ifile, lex, init);
+  fold.foldable = fold.foldable && irec->size && state->varying_refs == varying_refs && state->errors == errors;
+  irec->data = folded_image(&fold, irec->size);
   inc_segment_pc(ifile, state->curseg, irec->size);
 }
 
-static DataSize datum_size(STATE*, IFILE*, LEX*, const char* descrip, EXPR_SIZE_FN*, BOOL *init);
-
+// For resizing passes: size data without folding it.
 DataSize data_size(STATE* state, IFILE* ifile, LEX* lex, const char* descrip, EXPR_SIZE_FN* expr_size_fn, BOOL *init) {
-  DataSize size = datum_size(state, ifile, lex, descrip, expr_size_fn, init);
+  return sized_data(state, ifile, lex, descrip, expr_size_fn, init, NULL);
+}
+
+static DataSize datum_size(STATE*, IFILE*, LEX*, const char* descrip, EXPR_SIZE_FN*, BOOL *init, DATA_FOLD*);
+
+static DataSize sized_data(STATE* state, IFILE* ifile, LEX* lex, const char* descrip, EXPR_SIZE_FN* expr_size_fn,
+                           BOOL *init, DATA_FOLD* fold) {
+  DataSize size = datum_size(state, ifile, lex, descrip, expr_size_fn, init, fold);
 
   bool reported = false;
   bool large = false;
@@ -825,7 +907,7 @@ DataSize data_size(STATE* state, IFILE* ifile, LEX* lex, const char* descrip, EX
   while (lex_token(lex) == ',') {
     lex_next(lex);
     BOOL init2;
-    DataSize size2 = datum_size(state, ifile, lex, descrip, expr_size_fn, &init2);
+    DataSize size2 = datum_size(state, ifile, lex, descrip, expr_size_fn, &init2, fold);
     if (*init != init2 && !reported) {
       error2(state, lex, "mix of initialised and uninitialised data");
       reported = true;
@@ -841,13 +923,15 @@ DataSize data_size(STATE* state, IFILE* ifile, LEX* lex, const char* descrip, EX
   return large ? 0 : size;
 }
 
-static DataSize dup_size(STATE*, IFILE*, LEX*, DataSize count, const char* descrip, EXPR_SIZE_FN* expr_size_fn, BOOL *init);
+static DataSize dup_size(STATE*, IFILE*, LEX*, DataSize count, const char* descrip, EXPR_SIZE_FN* expr_size_fn, BOOL *init, DATA_FOLD*);
+static void fold_value(DATA_FOLD*, int type, const VALUE*);
 
 // Parse expression into value and type.
 // Return the size of the encoded value(s).
 // On error, issue error and return 0.
 // On entry: expr_size_fn == function to evaluate size of data: specific to DB, DW etc.
-static DataSize datum_size(STATE* state, IFILE* ifile, LEX* lex, const char* descrip, EXPR_SIZE_FN* expr_size_fn, BOOL *init) {
+static DataSize datum_size(STATE* state, IFILE* ifile, LEX* lex, const char* descrip, EXPR_SIZE_FN* expr_size_fn,
+                           BOOL *init, DATA_FOLD* fold) {
   assert(state != NULL);
   assert(ifile != NULL);
   assert(lex != NULL);
@@ -872,7 +956,7 @@ static DataSize datum_size(STATE* state, IFILE* ifile, LEX* lex, const char* des
         else
           count = (DataSize) u;
       }
-      return dup_size(state, ifile, lex, count, descrip, expr_size_fn, init);
+      return dup_size(state, ifile, lex, count, descrip, expr_size_fn, init, fold);
     }
     error2(state, lex, "invalid DUP expression");
     lex_discard_line(lex);
@@ -882,18 +966,27 @@ static DataSize datum_size(STATE* state, IFILE* ifile, LEX* lex, const char* des
   DataSize size = expr_size_fn(type, &val, init);
   if (size == 0)
     error2(state, lex, "invalid expression for %s data", descrip);
+  else if (fold)
+    fold_value(fold, type, &val);
   return size;
 }
 
-static DataSize dup_size(STATE* state, IFILE* ifile, LEX* lex, DataSize count, const char* descrip, EXPR_SIZE_FN* expr_size_fn, BOOL *init) {
+static void fold_dup(DATA_FOLD*, unsigned start, DataSize count);
+
+static DataSize dup_size(STATE* state, IFILE* ifile, LEX* lex, DataSize count, const char* descrip, EXPR_SIZE_FN* expr_size_fn,
+                         BOOL *init, DATA_FOLD* fold) {
     if (lex_next(lex) != '(') {
       error2(state, lex, "parentheses required");
       lex_discard_line(lex);
       return 0;
     }
 
+    const unsigned start = fold ? fold->len : 0;
+    if (fold)
+      fold->depth++;
+
     lex_next(lex);
-    DataSize size = data_size(state, ifile, lex, descrip, expr_size_fn, init);
+    DataSize size = sized_data(state, ifile, lex, descrip, expr_size_fn, init, fold);
 
     if (count == 0)
       size = 0;
@@ -904,6 +997,11 @@ static DataSize dup_size(STATE* state, IFILE* ifile, LEX* lex, DataSize count, c
     else
       size *= count;
 
+    if (fold) {
+      fold->depth--;
+      fold_dup(fold, start, count);
+    }
+
     if (lex_token(lex) == ')')
       lex_next(lex);
     else
@@ -912,6 +1010,138 @@ static DataSize dup_size(STATE* state, IFILE* ifile, LEX* lex, DataSize count, c
     return size;
 }
 
+static void init_fold(DATA_FOLD* fold, unsigned width) {
+  assert(width > 0 && width <= 10);
+  fold->foldable = true;
+  fold->uninit = false;
+  fold->width = width;
+  fold->depth = 0;
+  fold->runs = NULL;
+  fold->nrun = 0;
+  fold->runs_allocated = 0;
+  fold->bytes = NULL;
+  fold->len = 0;
+  fold->allocated = 0;
+}
+
+static bool reserve_folded(DATA_FOLD* fold, unsigned n) {
+  if (n > MAX_FOLDED - fold->len) {
+    fold->foldable = false;
+    return false;
+  }
+  if (fold->len + n > fold->allocated) {
+    unsigned allocated = fold->allocated ? fold->allocated : 16;
+    while (allocated < fold->len + n)
+      allocated *= 2;
+    fold->bytes = tag_memory(erealloc(fold->bytes, allocated), MEM_IRECS);
+    fold->allocated = allocated;
+  }
+  return true;
+}
+
+static void fold_value(DATA_FOLD* fold, int type, const VALUE* val) {
+  if (!fold->foldable)
+    return;
+
+  switch (type) {
+    case ET_UNDEF:
+      fold->uninit = true;
+      break;
+    case ET_STR:
+      if (fold->width == 1) {
+        if (reserve_folded(fold, val->string.len)) {
+          memcpy(fold->bytes + fold->len, val->string.content, val->string.len);
+          fold->len += val->string.len;
+        }
+        break;
+      }
+      // otherwise made absolute by the size function
+      // fall through
+    case ET_ABS:
+      if (reserve_folded(fold, fold->width)) {
+        unsigned long long n = val->n;
+        for (unsigned i = 0; i < fold->width; i++) {
+          fold->bytes[fold->len++] = (BYTE) n;
+          n >>= 8;
+        }
+      }
+      break;
+    default:
+      fold->foldable = false;
+      break;
+  }
+}
+
+static void add_run(DATA_FOLD* fold, const BYTE* bytes, unsigned len, DWORD repeat) {
+  if (len == 0 || repeat == 0)
+    return;
+  if (fold->nrun == fold->runs_allocated) {
+    fold->runs_allocated = fold->runs_allocated ? 2 * fold->runs_allocated : 4;
+    fold->runs = tag_memory(erealloc(fold->runs, fold->runs_allocated * sizeof fold->runs[0]), MEM_IRECS);
+  }
+  DATA_RUN* run = &fold->runs[fold->nrun++];
+  run->repeat = repeat;
+  run->len = len;
+  run->bytes = tag_memory(emalloc(len), MEM_IRECS);
+  memcpy(run->bytes, bytes, len);
+}
+
+// The bytes from start are the content of a DUP.
+static void fold_dup(DATA_FOLD* fold, unsigned start, DataSize count) {
+  if (!fold->foldable)
+    return;
+
+  const unsigned len = fold->len - start;
+
+  if (fold->depth == 0) {
+    add_run(fold, fold->bytes, start, 1);
+    add_run(fold, fold->bytes + start, len, count);
+    fold->len = 0;
+  }
+  else if (count == 0)
+    fold->len = start;
+  else if (len > 0) {
+    if ((MAX_FOLDED - fold->len) / len < count - 1)
+      fold->foldable = false;
+    else {
+      reserve_folded(fold, len * (count - 1));
+      for (DataSize i = 1; i < count; i++) {
+        memcpy(fold->bytes + fold->len, fold->bytes + start, len);
+        fold->len += len;
+      }
+    }
+  }
+}
+
+// The folded data, or NULL if it could not be folded. Frees the working storage.
+static DATA_IMAGE* folded_image(DATA_FOLD* fold, DataSize size) {
+  DATA_IMAGE* image = NULL;
+
+  if (fold->foldable) {
+    image = tag_memory(ecalloc(sizeof *image), MEM_IRECS);
+    // uninitialised data has only its size
+    if (!fold->uninit) {
+      add_run(fold, fold->bytes, fold->len, 1);
+      image->runs = fold->runs;
+      image->nrun = fold->nrun;
+      fold->runs = NULL;
+      fold->nrun = 0;
+      DataSize total = 0;
+      for (unsigned i = 0; i < image->nrun; i++)
+        total += image->runs[i].len * image->runs[i].repeat;
+      if (total != size)
+        fatal("internal error: folded data size discrepancy: sized %lu, folded %lu\n",
+              (unsigned long) size, (unsigned long) total);
+    }
+  }
+
+  for (unsigned i = 0; i < fold->nrun; i++)
+    efree(fold->runs[i].bytes);
+  efree(fold->runs);
+  efree(fold->bytes);
+  return image;
+}
+
 static void public_symbol(STATE*, IFILE*, LEX*);
 
 static void do_public(STATE* state, IFILE* ifile, LEX* lex) {
@@ -936,7 +1166,7 @@ static void public_symbol(STATE* state, IFILE* ifile, LEX* lex) {
     return;
   }
 
-  SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+  SYMBOL* sym = sym_lookup_id(ifile->st, lex_name(lex));
   if (sym == NULL) {
     sym = sym_insert_relative(ifile->st, lex_lexeme(lex), lex_lineno(lex));
     sym_set_public(sym);
@@ -988,7 +1218,7 @@ static void external_symbol(STATE* state, IFILE* ifile, LEX* lex) {
     return;
   }
 
-  SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+  SYMBOL* sym = sym_lookup_id(ifile->st, lex_name(lex));
   if (sym != NULL) {
     error2(state, lex, "symbol already %s: %s", sym_defined(sym) ? "defined" : "used", lex_lexeme(lex));
     return;
@@ -1031,6 +1261,7 @@ static void do_jumps(STATE* state, IFILE* ifile, LEX* lex) {
 
 static BOOL direct_near_jump(int op, const OPERAND* oper1, const OPERAND* oper2);
 static unsigned rm_disp_len(STATE*, IFILE*, const OPERAND*, BOOL *provisional);
+static unsigned rm_length(STATE*, IFILE*, const OPERAND*);
 
 static void compute_instruction_segment_override_size(STATE*, IFILE*, IREC*, LEX*,
     const OPERAND* oper1, const OPERAND* oper2);
@@ -1074,6 +1305,8 @@ static void process_instruction(STATE* state, IFILE* ifile, LEX* lex) {
   irec->op = lex_token(lex);
   lex_next(lex);
 
+  const unsigned varying_refs = state->varying_refs;
+
   OPERAND oper1, oper2, oper3;
   if (!parse_operands(state, ifile, lex, &oper1, &oper2, &oper3)) {
     lex_discard_line(lex);
@@ -1090,7 +1323,7 @@ static void process_instruction(STATE* state, IFILE* ifile, LEX* lex) {
     return;
   }
 
-  irec->def = find_instruc(irec->op, &oper1.opclass, &oper2.opclass, &oper3.opclass);
+  irec->def = select_instruc(state, ifile, irec, &oper1, &oper2, &oper3, rm_length);
 
   if (irec->def == NULL) {
     const char* hint = "";
@@ -1157,6 +1390,11 @@ static void process_instruction(STATE* state, IFILE* ifile, LEX* lex) {
   irec->size += irec->def->imm2;
   irec->size += irec->def->imm3;
 
+  // Registers, numbers and defined absolute symbols are the same in every
+  // pass, so later passes need not parse and match them again to size the
+  // instruction. JUMPS may yet expand any conditional jump.
+  irec->fixed_operands = (state->varying_refs == varying_refs && !token_is_jcc_opcode(irec->op));
+
   inc_segment_pc(ifile, state->curseg, irec->size);
 }
 
@@ -1300,6 +1538,12 @@ static unsigned disp_length(long disp, unsigned min) {
   return 2;
 }
 
+// For comparing instruction forms, whose displacements are provisional alike.
+static unsigned rm_length(STATE* state, IFILE* ifile, const OPERAND* op) {
+  BOOL provisional;
+  return rm_disp_len(state, ifile, op, &provisional);
+}
+
 static unsigned rm_disp_len(STATE* state, IFILE* ifile, const OPERAND* op, BOOL *provisional) {
   assert(ifile != NULL);
   assert(op != NULL);
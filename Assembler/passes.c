@@ -0,0 +1,98 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// The passes of assembly, from source to object records.
+
+#include <assert.h>
+#include "passes.h"
+#include "ifile.h"
+#include "sourcepass.h"
+#include "pass1.h"
+#include "resize.h"
+#include "encoding.h"
+#include "utils.h"
+
+static void report_shortened(IFILE*);
+
+typedef struct {
+  IFILE* ifile;
+  const Options* opts;
+  PROFILE* profile;
+  OFILE* ofile;
+} PASSES;
+
+static OFILE* passes(IFILE*, const Options*, PROFILE*);
+
+static void passes_job(void* arg) {
+  PASSES* p = arg;
+  p->ofile = passes(p->ifile, p->opts, p->profile);
+}
+
+OFILE* run_passes(SOURCE* src, const Options* opts, PROFILE* profile, STRINGLIST* incbins) {
+  assert(src != NULL);
+  assert(opts != NULL);
+  assert(profile != NULL);
+
+  PASSES p = { new_ifile(src, opts->case_sensitive), opts, profile, NULL };
+  const bool ok = run_job(passes_job, &p, error_stream());
+  if (ok && incbins) {
+    for (unsigned i = 0; i < stringlist_count(p.ifile->incbins); i++)
+      append_string(incbins, stringlist_item(p.ifile->incbins, i));
+  }
+  delete_ifile(p.ifile);
+  if (!ok)
+    fail();
+  return p.ofile;
+}
+
+static OFILE* passes(IFILE* ifile, const Options* opts, PROFILE* profile) {
+
+  begin_phase(profile, "source pass");
+  source_pass(ifile, opts);
+  if (opts->print_intermediate)
+    print_intermediate(ifile, "AFTER SOURCE PASS", PRINT_SOURCE_NAME);
+
+  begin_phase(profile, "pass 1");
+  pass1(ifile, opts);
+  if (opts->print_intermediate)
+    print_intermediate(ifile, "AFTER PASS 1", PRINT_SIZE);
+
+  if (ifile->provisional_sizes) {
+    BOOL resized;
+    unsigned iteration = 0;
+    do {
+      begin_phase(profile, "resize %u", ++iteration);
+      resized = resize_pass(ifile, opts);
+      if (opts->print_intermediate)
+        print_intermediate(ifile, "AFTER RESIZE PASS", PRINT_SIZE);
+    } while (resized);
+  }
+
+  if (opts->verbose)
+    report_shortened(ifile);
+
+  begin_phase(profile, "encoding");
+  OFILE* ofile = encoding_pass(ifile, opts);
+  if (opts->print_intermediate)
+    print_intermediate(ifile, "AFTER ENCODING PASS", PRINT_SIZE);
+
+  if (opts->report_hash_table)
+    report_sym_hash(ifile->st);
+
+  return ofile;
+}
+
+// Bytes saved by selecting the shortest instruction forms, now sizes are final.
+static void report_shortened(IFILE* ifile) {
+  unsigned instructions = 0;
+  unsigned long bytes = 0;
+
+  for (unsigned i = 0; i < irec_count(ifile); i++) {
+    const IREC* irec = get_irec(ifile, i);
+    if (irec->shortened) {
+      instructions++;
+      bytes += irec->shortened;
+    }
+  }
+
+  printf("Shortest encodings: %u instruction(s), %lu byte(s) saved\n", instructions, bytes);
+}
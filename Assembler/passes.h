@@ -0,0 +1,18 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// The passes of assembly, from source to object records.
+
+#ifndef PASSES_H
+#define PASSES_H
+
+#include "source.h"
+#include "options.h"
+#include "object.h"
+#include "profile.h"
+
+// Assemble the source into object records, timing each pass as a phase,
+// and appending to incbins, if not NULL, the path of each file included
+// by INCBIN. Errors are reported on error_stream() and end in fail().
+OFILE* run_passes(SOURCE*, const Options*, PROFILE*, STRINGLIST* incbins);
+
+#endif // PASSES_H
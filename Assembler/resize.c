@@ -29,7 +29,8 @@ BOOL resize_pass(IFILE* ifile, const Options* options) {
     puts("Resizing pass");
 
   init_state(&state, options->max_errors);
-  lex = new_lex(source_name(ifile->source));
+  state.tasm_encoding = options->tasm_encoding;
+  lex = new_lex(source_name(ifile->source), ifile->st->names);
 
   reset_pc(ifile);
 
@@ -41,8 +42,8 @@ BOOL resize_pass(IFILE* ifile, const Options* options) {
   delete_lex(lex);
 
   if (state.errors > 0) {
-    fprintf(stderr, "Errors: %u\n", state.errors);
-    exit(EXIT_FAILURE);
+    fprintf(error_stream(), "Errors: %u\n", state.errors);
+    fail();
   }
 
   return resized;
@@ -131,6 +132,8 @@ static BOOL perform_directive(STATE* state, IFILE* ifile, IREC* irec, LEX* lex)
     case TOK_DD: define_data(state, ifile, irec, lex, "dword", dword_expr_size); break;
     case TOK_DQ: define_data(state, ifile, irec, lex, "qword", qword_expr_size); break;
     case TOK_DT: define_data(state, ifile, irec, lex, "tbyte", tbyte_expr_size); break;
+    // size known in pass 1
+    case TOK_INCBIN: inc_segment_pc(ifile, state->curseg, irec->size); break;
     // select processor
     case TOK_P286:
     case TOK_P286N:
@@ -167,8 +170,11 @@ static void define_data(STATE* state, IFILE* ifile, IREC* irec, LEX* lex, const
   assert(descrip != NULL);
   assert(expr_size_fn != NULL);
 
-  BOOL init;
-  irec->size = data_size(state, ifile, lex, descrip, expr_size_fn, &init);
+  // absolute data folded in pass 1 has its final size
+  if (irec->data == NULL) {
+    BOOL init;
+    irec->size = data_size(state, ifile, lex, descrip, expr_size_fn, &init);
+  }
   inc_segment_pc(ifile, state->curseg, irec->size);
 }
 
@@ -187,11 +193,11 @@ static void do_segment(STATE* state, IFILE* ifile, IREC* irec, LEX* lex) {
   if (state->curseg != NO_SEG)
     error2(state, lex, "segment %s is already open", segment_name(ifile, state->curseg));
 
-  SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+  SYMBOL* sym = sym_lookup_id(ifile->st, lex_name(lex));
   if (sym == NULL|| !sym_defined(sym) || sym_type(sym) != SYM_SECTION ||
       sym_section_type(sym) != ST_SEGMENT) {
     error2(state, lex, "defined segment name expected: %s", lex_lexeme(lex));
-    exit(EXIT_FAILURE);
+    fail();
   }
 
   state->curseg = sym_section_ordinal(sym);
@@ -298,10 +304,10 @@ static void assume(STATE* state, IFILE* ifile, LEX* lex) {
     return;
   }
 
-  SYMBOL* sym = sym_lookup(ifile->st, lex_lexeme(lex));
+  SYMBOL* sym = sym_lookup_id(ifile->st, lex_name(lex));
   if (sym == NULL || !sym_defined(sym) || sym_type(sym) != SYM_SECTION) {
     error2(state, lex, "defined segment or group expected: %s", lex_lexeme(lex));
-    exit(EXIT_FAILURE);
+    fail();
   }
 
   state->assume_sym[reg] = sym;
@@ -355,7 +361,12 @@ static BOOL process_instruction(STATE* state, IFILE* ifile, IREC* irec, LEX* lex
     }
     default:
       error2(state, lex, "internal error: CS assume section unresolved to segment or group");
-      exit(EXIT_FAILURE);
+      fail();
+  }
+
+  if (irec->fixed_operands) {
+    inc_segment_pc(ifile, state->curseg, irec->size);
+    return FALSE;
   }
 
   OPERAND oper1, oper2, oper3;
@@ -366,6 +377,7 @@ static BOOL process_instruction(STATE* state, IFILE* ifile, IREC* irec, LEX* lex
 
   if (token_is_jcc_opcode(irec->op) && state->jumps) {
     bool resized = expand_short_jump(state, ifile, irec, lex, &oper1, &oper2, &oper3);
+    irec = get_irec(ifile, ifile->pos); // insertion moves records
     inc_segment_pc(ifile, state->curseg, irec->size);
     return resized;
   }
@@ -489,7 +501,7 @@ static bool expand_short_jump(STATE* state, IFILE* ifile, IREC* irec, LEX* lex,
 
   if (irec->size != 2) {
     error2(state, lex, "internal error: unexpected short jump instruction size: %lu\n", (unsigned long) irec->size);
-    exit(EXIT_FAILURE);
+    fail();
   }
 
   const SYMBOL* label = oper1->val.jump.target.label;
@@ -606,7 +618,7 @@ static void size_instruction(STATE* state, IFILE* ifile, IREC* irec, LEX* lex,
   assert(irec != NULL);
   assert(lex != NULL);
 
-  irec->def = find_instruc(irec->op, &oper1->opclass, &oper2->opclass, &oper3->opclass);
+  irec->def = select_instruc(state, ifile, irec, oper1, oper2, oper3, rm_disp_len);
 
   if (irec->def == NULL) {
     error2(state, lex, "instruction not supported with given operands: %s", token_name(irec->op));
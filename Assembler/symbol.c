@@ -7,39 +7,13 @@
 #include <ctype.h>
 #include <assert.h>
 #include "symbol.h"
+#include "profile.h"
 
 #define NO_SEG (-1)
 
-// Aho, Sethi, Ullman, "Compilers: Principle, Techniques, and Tools" (1986) p. 436
-static unsigned hashpjw(const char* s) {
-  unsigned h = 0;
-  for (const char* p = s; *p; p++) {
-    h = (h << 4) + *p;
-    unsigned g = h & 0xf0000000;
-    if (g) {
-      h ^= (g >> 24);
-      h ^= g;
-    }
-  }
-  return h;
-}
-
-static unsigned hashpjw_toupper(const char* s) {
-  unsigned h = 0;
-  for (const char* p = s; *p; p++) {
-    h = (h << 4) + toupper(*p);
-    unsigned g = h & 0xf0000000;
-    if (g) {
-      h ^= (g >> 24);
-      h ^= g;
-    }
-  }
-  return h;
-}
-
 static SYMBOL* new_symbol(const char* name, BYTE type, unsigned lineno) {
-  SYMBOL* sym = emalloc(sizeof *sym);
-  sym->name = estrdup(name);
+  SYMBOL* sym = tag_memory(emalloc(sizeof *sym), MEM_SYMBOLS);
+  sym->name = tag_memory(estrdup(name), MEM_SYMBOLS);
   sym->type = type;
   sym->defined = UNDEFINED;
   sym->lineno = lineno;
@@ -54,14 +28,17 @@ static void delete_symbol(SYMBOL* sym) {
 }
 
 SYMTAB* new_symbol_table(bool case_sensitive) {
-  SYMTAB* st = ecalloc(sizeof *st);
+  SYMTAB* st = tag_memory(ecalloc(sizeof *st), MEM_SYMBOLS);
   st->case_sensitive = case_sensitive;
+  st->names = new_intern(case_sensitive);
   return st;
 }
 
 void delete_symbol_table(SYMTAB* st) {
   if (st) {
     efree(st->externals);
+    efree(st->by_id);
+    delete_intern(st->names);
     for (unsigned i = 0; i < SYMBOL_HASH_SIZE; i++) {
       SYMBOL* next = NULL;
       for (SYMBOL* sym = st->hash[i]; sym; sym = next) {
@@ -76,32 +53,37 @@ void delete_symbol_table(SYMTAB* st) {
 SYMBOL* sym_lookup(SYMTAB* st, const char* name) {
   assert(st != NULL);
   assert(name != NULL);
-  if (st->case_sensitive) {
-    unsigned h = hashpjw(name) % SYMBOL_HASH_SIZE;
-    for (SYMBOL* sym = st->hash[h]; sym; sym = sym->next) {
-      if (strcmp(sym->name, name) == 0)
-        return sym;
-    }
-  }
-  else {
-    unsigned h = hashpjw_toupper(name) % SYMBOL_HASH_SIZE;
-    for (SYMBOL* sym = st->hash[h]; sym; sym = sym->next) {
-      if (_stricmp(sym->name, name) == 0)
-        return sym;
-    }
-  }
-  return NULL;
+  return sym_lookup_id(st, intern_find(st->names, name));
+}
+
+SYMBOL* sym_lookup_id(SYMTAB* st, NAME_ID id) {
+  assert(st != NULL);
+  PROFILE_COUNT(PC_LOOKUPS);
+  if (id < 0 || (unsigned) id >= st->by_id_size)
+    return NULL;
+  return st->by_id[id];
 }
 
 static SYMBOL* insert(SYMTAB* st, const char* name, int type, unsigned lineno) {
   assert(st != NULL);
   assert(name != NULL);
 
-  unsigned h = st->case_sensitive ? hashpjw(name) : hashpjw_toupper(name);
-  h %= SYMBOL_HASH_SIZE;
+  const NAME_ID id = intern(st->names, name);
+  if ((unsigned) id >= st->by_id_size) {
+    const unsigned old_size = st->by_id_size;
+    st->by_id_size = old_size ? 2 * old_size : 128;
+    while ((unsigned) id >= st->by_id_size)
+      st->by_id_size *= 2;
+    st->by_id = tag_memory(erealloc(st->by_id, st->by_id_size * sizeof st->by_id[0]), MEM_SYMBOLS);
+    memset(st->by_id + old_size, 0, (st->by_id_size - old_size) * sizeof st->by_id[0]);
+  }
+
+  unsigned h = interned_hash(st->names, id) % SYMBOL_HASH_SIZE;
   SYMBOL* sym = new_symbol(name, type, lineno);
+  sym->id = id;
   sym->next = st->hash[h];
   st->hash[h] = sym;
+  st->by_id[id] = sym;
   return sym;
 }
 
@@ -134,7 +116,7 @@ SYMBOL* sym_insert_external(SYMTAB* st, const char* name, SEGNO seg, unsigned li
   assert(st->externals_count <= st->externals_size);
   if (st->externals_count == st->externals_size) {
     st->externals_size = st->externals_size ? 2 * st->externals_size : 32;
-    st->externals = erealloc(st->externals, st->externals_size * sizeof st->externals[0]);
+    st->externals = tag_memory(erealloc(st->externals, st->externals_size * sizeof st->externals[0]), MEM_SYMBOLS);
   }
   assert(st->externals_count < st->externals_size);
 
@@ -175,6 +157,11 @@ const char* sym_name(const SYMBOL* sym) {
   return sym->name;
 }
 
+NAME_ID sym_name_id(const SYMBOL* sym) {
+  assert(sym != NULL);
+  return sym->id;
+}
+
 int sym_type(const SYMBOL* sym) {
   assert(sym != NULL);
   return sym->type;
@@ -512,11 +499,42 @@ static void test_find(CuTest* tc) {
 }
 
 static void test_hash(CuTest* tc) {
-  unsigned h1 = hashpjw_toupper("TABULATED");
-  unsigned h2 = hashpjw_toupper("TabuLated");
-  unsigned h3 = hashpjw_toupper("tabulated");
-  CuAssertIntEquals(tc, h1, h2);
-  CuAssertIntEquals(tc, h1, h3);
+  SYMTAB* st = new_symbol_table(false);
+  SYMBOL* sym = sym_insert_relative(st, "TABULATED", 1);
+  const NAME_ID id = sym_name_id(sym);
+  CuAssertIntEquals(tc, id, intern_find(st->names, "TabuLated"));
+  CuAssertIntEquals(tc, id, intern_find(st->names, "tabulated"));
+  CuAssertPtrEquals(tc, sym, sym_lookup(st, "tabulated"));
+  delete_symbol_table(st);
+}
+
+static void test_sym_lookup_id(CuTest* tc) {
+  SYMTAB* st = new_symbol_table(true);
+
+  CuAssertPtrEquals(tc, NULL, sym_lookup_id(st, NO_NAME));
+  CuAssertPtrEquals(tc, NULL, sym_lookup_id(st, 0));
+  SYMBOL* fred = sym_insert_relative(st, "Fred", 1);
+  SYMBOL* FRED = sym_insert_absolute(st, "FRED", 2);
+  CuAssertTrue(tc, sym_name_id(fred) != sym_name_id(FRED));
+  CuAssertPtrEquals(tc, fred, sym_lookup_id(st, sym_name_id(fred)));
+  CuAssertPtrEquals(tc, FRED, sym_lookup_id(st, sym_name_id(FRED)));
+  CuAssertStrEquals(tc, "FRED", interned_name(st->names, sym_name_id(FRED)));
+  // the latest symbol of a name is found
+  SYMBOL* fred2 = sym_insert_relative(st, "Fred", 3);
+  CuAssertIntEquals(tc, sym_name_id(fred), sym_name_id(fred2));
+  CuAssertPtrEquals(tc, fred2, sym_lookup_id(st, sym_name_id(fred)));
+  // many names
+  char name[16];
+  for (unsigned i = 0; i < 1000; i++) {
+    sprintf(name, "Label_%u", i);
+    sym_insert_relative(st, name, i);
+  }
+  SYMBOL* sym = sym_lookup(st, "Label_999");
+  CuAssertPtrNotNull(tc, sym);
+  CuAssertPtrEquals(tc, sym, sym_lookup_id(st, sym_name_id(sym)));
+  CuAssertStrEquals(tc, "Label_999", sym_name(sym));
+
+  delete_symbol_table(st);
 }
 
 static void test_find_externals(CuTest* tc) {
@@ -567,8 +585,60 @@ CuSuite* symbol_test_suite(void) {
   SUITE_ADD_TEST(suite, test_external_id);
   SUITE_ADD_TEST(suite, test_find);
   SUITE_ADD_TEST(suite, test_hash);
+  SUITE_ADD_TEST(suite, test_sym_lookup_id);
   SUITE_ADD_TEST(suite, test_find_externals);
   return suite;
 }
 
+#define BENCH_SYMBOLS (1000)
+
+static void bench_sym_lookup(CuBench* bc) {
+  SYMTAB* st = new_symbol_table(false);
+  char names[BENCH_SYMBOLS][16];
+  unsigned long found = 0;
+
+  for (unsigned i = 0; i < BENCH_SYMBOLS; i++) {
+    sprintf(names[i], "Label_%u", i);
+    sym_insert_relative(st, names[i], i + 1);
+  }
+
+  CuBenchStart(bc);
+  for (long i = 0; i < bc->n; i++)
+    found += sym_lookup(st, names[i % BENCH_SYMBOLS]) != NULL;
+  CuBenchStop(bc);
+
+  bc->sink = found;
+  assert(found == (unsigned long) bc->n);
+  delete_symbol_table(st);
+}
+
+// Look up names already interned, as the lexer gives them.
+static void bench_sym_lookup_id(CuBench* bc) {
+  SYMTAB* st = new_symbol_table(false);
+  NAME_ID ids[BENCH_SYMBOLS];
+  unsigned long found = 0;
+
+  for (unsigned i = 0; i < BENCH_SYMBOLS; i++) {
+    char name[16];
+    sprintf(name, "Label_%u", i);
+    ids[i] = sym_name_id(sym_insert_relative(st, name, i + 1));
+  }
+
+  CuBenchStart(bc);
+  for (long i = 0; i < bc->n; i++)
+    found += sym_lookup_id(st, ids[i % BENCH_SYMBOLS]) != NULL;
+  CuBenchStop(bc);
+
+  bc->sink = found;
+  assert(found == (unsigned long) bc->n);
+  delete_symbol_table(st);
+}
+
+CuBenchSuite* symbol_bench_suite(void) {
+  CuBenchSuite* suite = CuBenchSuiteNew();
+  SUITE_ADD_BENCH(suite, bench_sym_lookup);
+  SUITE_ADD_BENCH(suite, bench_sym_lookup_id);
+  return suite;
+}
+
 #endif // UNIT_TEST
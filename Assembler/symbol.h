@@ -6,12 +6,13 @@
 #define SYMBOL_H
 
 #include <stdbool.h>
+#include "intern.h"
 #include "utils.h"
 
 typedef short SYMBOL_ID;
 
-typedef short SEGNO;
-typedef short GROUPNO;
+typedef int SEGNO;
+typedef int GROUPNO;
 
 enum symbol_type { SYM_UNKNOWN, SYM_RELATIVE, SYM_ABSOLUTE, SYM_SECTION };
 
@@ -23,6 +24,7 @@ enum scope { PRIVATE, PUBLIC };
 
 typedef struct symbol {
   char* name;
+  NAME_ID id;
   BYTE type;
   BYTE defined;
   unsigned lineno;
@@ -39,7 +41,7 @@ typedef struct symbol {
     } abs;
     struct section {
       short type;
-      short ord;
+      int ord;
     } sec;
   } u;
   struct symbol * next;  // next on hash list
@@ -47,8 +49,13 @@ typedef struct symbol {
 
 #define SYMBOL_HASH_SIZE (199)
 
+// Symbols are found by the interned ID of their names. The hash lists
+// give the order in which symbols are listed.
 typedef struct {
   SYMBOL* hash[SYMBOL_HASH_SIZE];
+  INTERN* names;
+  SYMBOL* *by_id;   // latest symbol inserted with each name ID
+  unsigned by_id_size;
   unsigned locals;
   bool case_sensitive;
   SYMBOL* *externals;
@@ -60,6 +67,7 @@ SYMTAB* new_symbol_table(bool case_sensitive);
 void delete_symbol_table(SYMTAB*);
 
 SYMBOL* sym_lookup(SYMTAB*, const char* name);
+SYMBOL* sym_lookup_id(SYMTAB*, NAME_ID);
 SYMBOL* sym_insert_unknown(SYMTAB*, const char* name, unsigned lineno);
 SYMBOL* sym_insert_relative(SYMTAB*, const char* name, unsigned lineno);
 SYMBOL* sym_insert_absolute(SYMTAB*, const char* name, unsigned lineno);
@@ -72,6 +80,7 @@ SYMBOL* sym_insert_local(SYMTAB*, unsigned lineno);
 void sym_init_relative(SYMBOL*);
 
 const char* sym_name(const SYMBOL*);
+NAME_ID sym_name_id(const SYMBOL*);
 int sym_type(const SYMBOL*);
 BOOL sym_defined(const SYMBOL*);
 unsigned sym_lineno(const SYMBOL*);
@@ -0,0 +1,254 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Static timing listing: estimated clocks of each encoded instruction,
+// totals per labelled block, and the loops costliest per iteration.
+// A conditional transfer backward is taken, closing a loop, and one forward
+// is not, so that a loop costs one pass through its body.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <assert.h>
+#include "timing.h"
+#include "instable.h"
+#include "opclass.h"
+#include "token.h"
+#include "symbol.h"
+
+typedef struct {
+  unsigned rec;  // intermediate record
+  const SYMBOL* label;  // nearest relative label since the previous instruction
+  SEGNO seg;
+  DWORD offset;
+  bool backward;  // a transfer within the segment to target
+  DWORD target;
+  unsigned cycles[CYCLE_MODELS];  // 0 if not on the processor
+} TIMED;
+
+struct timing {
+  TIMED* timed;
+  unsigned count;
+  unsigned allocated;
+  unsigned next_rec;  // after the last instruction recorded
+};
+
+#define HOT_LOOPS (5)
+
+TIMING* new_timing(void) {
+  return ecalloc(sizeof(TIMING));
+}
+
+void delete_timing(TIMING* timing) {
+  if (timing) {
+    efree(timing->timed);
+    efree(timing);
+  }
+}
+
+static long displacement(const BYTE* code, unsigned size) {
+  return (size == 1) ? (long) (signed char) code[0] : (long) (short) (code[0] | (code[1] << 8));
+}
+
+static const SYMBOL* nearest_label(const IFILE*, unsigned first, unsigned rec);
+
+void time_instruction(TIMING* timing, const IFILE* ifile, unsigned rec, SEGNO seg, DWORD offset,
+                      const BYTE* code, unsigned len, bool relocated) {
+  assert(timing != NULL);
+  assert(ifile != NULL);
+  assert(rec >= timing->next_rec);
+  assert(code != NULL);
+
+  const IREC* irec = get_irec_const(ifile, rec);
+
+  if (timing->count == timing->allocated) {
+    timing->allocated = timing->allocated ? 2 * timing->allocated : 256;
+    timing->timed = erealloc(timing->timed, timing->allocated * sizeof timing->timed[0]);
+  }
+  TIMED* t = &timing->timed[timing->count++];
+  t->rec = rec;
+  t->label = nearest_label(ifile, timing->next_rec, rec);
+  timing->next_rec = rec + 1;
+  t->seg = seg;
+  t->offset = offset;
+  t->backward = false;
+  t->target = 0;
+
+  // relative transfer: the displacement is the last bytes of the instruction
+  unsigned disp_size = 0;
+  if (irec->near_jump_size)
+    disp_size = irec->near_jump_size;
+  else if (irec->def->oper1 == OF_JUMP && irec->op != TOK_CALL)
+    disp_size = irec->def->imm1;
+
+  if (disp_size && !relocated && len > disp_size) {
+    const long target = (long) offset + len + displacement(code + len - disp_size, disp_size);
+    if (target >= 0 && (DWORD) target <= offset) {
+      t->backward = true;
+      t->target = (DWORD) target;
+    }
+  }
+
+  for (int model = 0; model < CYCLE_MODELS; model++) {
+    t->cycles[model] = irec->near_jump_size ? direct_jump_cycles(model)
+                                            : instruction_cycles(irec->def, code, len, t->backward, model);
+  }
+}
+
+static const SYMBOL* nearest_label(const IFILE* ifile, unsigned first, unsigned rec) {
+  for (unsigned i = rec + 1; i-- > first; ) {
+    const SYMBOL* label = get_irec_const(ifile, i)->label;
+    if (label && sym_type(label) == SYM_RELATIVE)
+      return label;
+  }
+  return NULL;
+}
+
+unsigned timed_count(const TIMING* timing) {
+  assert(timing != NULL);
+  return timing->count;
+}
+
+unsigned timed_cycles(const TIMING* timing, unsigned i, int model) {
+  assert(timing != NULL);
+  assert(i < timing->count);
+  assert(model >= 0 && model < CYCLE_MODELS);
+  return timing->timed[i].cycles[model];
+}
+
+// The first instruction of the loop closed by the backward transfer i.
+static unsigned loop_start(const TIMING* timing, unsigned i) {
+  const TIMED* jump = &timing->timed[i];
+  assert(jump->backward);
+  unsigned first = i;
+  while (first > 0 && timing->timed[first - 1].seg == jump->seg &&
+         timing->timed[first - 1].offset >= jump->target && timing->timed[first - 1].offset < jump->offset)
+    first--;
+  return first;
+}
+
+unsigned long loop_cycles(const TIMING* timing, unsigned i, int model) {
+  assert(timing != NULL);
+  assert(i < timing->count);
+  assert(model >= 0 && model < CYCLE_MODELS);
+
+  if (!timing->timed[i].backward)
+    return 0;
+  unsigned long total = 0;
+  for (unsigned j = loop_start(timing, i); j <= i; j++)
+    total += timing->timed[j].cycles[model];
+  return total;
+}
+
+// The source text of the instruction. A record injected by JUMPS expansion
+// has only its operand text, so its mnemonic is supplied and it is marked.
+static void print_text(const IFILE* ifile, const IREC* irec) {
+  const char* text = irec_text(ifile, irec);
+  if (irec->si < 0) {
+    for (const char* name = token_name(irec->op); *name; name++)
+      putchar(tolower(*name));
+    printf(" %s (expanded)", text);
+    return;
+  }
+  while (*text == ' ' || *text == '\t')
+    text++;
+  fputs(text, stdout);
+}
+
+static void print_cycles(unsigned long cycles) {
+  if (cycles)
+    printf("  %6lu", cycles);
+  else
+    printf("  %6s", "-");
+}
+
+static void print_block_total(const char* name, const unsigned long total[]) {
+  printf("%-17s", "");
+  for (int model = 0; model < CYCLE_MODELS; model++)
+    print_cycles(total[model]);
+  printf("  block %s\n\n", name);
+}
+
+static void print_loops(const TIMING*, const IFILE*, int model);
+
+void print_timing(const TIMING* timing, const IFILE* ifile, bool p286) {
+  assert(timing != NULL);
+  assert(ifile != NULL);
+
+  printf("\nCYCLE ESTIMATES: 8086 and 286 clocks per instruction\n\n");
+  printf("%5s  %-4s  %4s  %6s  %6s  %s\n", "LINE", "SEG", "OFFS", "8086", "286", "SOURCE");
+
+  unsigned long total[CYCLE_MODELS] = { 0 };
+  const char* block = NULL;
+  const TIMED* prev = NULL;
+
+  for (unsigned i = 0; i < timing->count; i++) {
+    const TIMED* t = &timing->timed[i];
+    const IREC* irec = get_irec_const(ifile, t->rec);
+    if (prev == NULL || t->seg != prev->seg || t->label) {
+      if (prev)
+        print_block_total(block, total);
+      for (int model = 0; model < CYCLE_MODELS; model++)
+        total[model] = 0;
+      block = t->label ? sym_name(t->label) : segment_name(ifile, t->seg);
+    }
+    printf("%5u  %-4.4s  %04lX", irec_lineno(ifile, irec), segment_name(ifile, t->seg), (unsigned long) t->offset);
+    for (int model = 0; model < CYCLE_MODELS; model++) {
+      print_cycles(t->cycles[model]);
+      total[model] += t->cycles[model];
+    }
+    fputs("  ", stdout);
+    print_text(ifile, irec);
+    putchar('\n');
+    prev = t;
+  }
+  if (prev)
+    print_block_total(block, total);
+
+  print_loops(timing, ifile, p286 ? CYCLES_286 : CYCLES_8086);
+}
+
+typedef struct {
+  unsigned jump;
+  unsigned long cycles;
+} LOOP;
+
+static void print_loops(const TIMING* timing, const IFILE* ifile, int model) {
+  LOOP hot[HOT_LOOPS];
+  unsigned nhot = 0;
+
+  for (unsigned i = 0; i < timing->count; i++) {
+    const unsigned long cycles = loop_cycles(timing, i, model);
+    if (cycles == 0)
+      continue;
+    // insert in descending order of cost, earlier loops first among equals
+    unsigned j = nhot;
+    while (j > 0 && hot[j - 1].cycles < cycles)
+      j--;
+    if (j == HOT_LOOPS)
+      continue;
+    if (nhot < HOT_LOOPS)
+      nhot++;
+    for (unsigned k = nhot - 1; k > j; k--)
+      hot[k] = hot[k - 1];
+    hot[j].jump = i;
+    hot[j].cycles = cycles;
+  }
+
+  printf("COSTLIEST LOOPS: clocks per iteration, by %s\n\n", model == CYCLES_286 ? "286" : "8086");
+  if (nhot == 0) {
+    puts("No loops\n");
+    return;
+  }
+  printf("%6s  %6s  %-11s  %s\n", "8086", "286", "LINES", "CLOSED BY");
+  for (unsigned i = 0; i < nhot; i++) {
+    const IREC* jump = get_irec_const(ifile, timing->timed[hot[i].jump].rec);
+    const IREC* first = get_irec_const(ifile, timing->timed[loop_start(timing, hot[i].jump)].rec);
+    char lines[32];
+    sprintf(lines, "%u-%u", irec_lineno(ifile, first), irec_lineno(ifile, jump));
+    printf("%6lu  %6lu  %-11s  ", loop_cycles(timing, hot[i].jump, CYCLES_8086),
+           loop_cycles(timing, hot[i].jump, CYCLES_286), lines);
+    print_text(ifile, jump);
+    putchar('\n');
+  }
+  putchar('\n');
+}
@@ -0,0 +1,34 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Static timing listing: estimated clocks of each encoded instruction,
+// totals per labelled block, and the loops costliest per iteration.
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdbool.h>
+#include "ifile.h"
+#include "cycles.h"
+
+typedef struct timing TIMING;
+
+TIMING* new_timing(void);
+void delete_timing(TIMING*);
+
+// Record the instruction of a record as encoded at the offset in the segment.
+// Records are timed in order. A transfer with a relocated displacement is
+// never taken to close a loop.
+void time_instruction(TIMING*, const IFILE*, unsigned rec, SEGNO, DWORD offset,
+                      const BYTE* code, unsigned len, bool relocated);
+
+unsigned timed_count(const TIMING*);
+unsigned timed_cycles(const TIMING*, unsigned i, int model);
+// Clocks per iteration of the loop closed by timed instruction i, from the
+// target of its backward transfer; 0 if it closes no loop.
+unsigned long loop_cycles(const TIMING*, unsigned i, int model);
+
+// Print the listing, ranking loops by 286 clocks if 286 instructions are
+// enabled, otherwise by 8086 clocks.
+void print_timing(const TIMING*, const IFILE*, bool p286);
+
+#endif // TIMING_H
@@ -0,0 +1,209 @@
+# Benchmark bas, blink and bdis on generated programs of several sizes.
+# Python 3.
+# Copyright (c) 2021-24 Nigel Perks
+#
+# Usage: bench.py BIN_DIR WORK_DIR [options]
+#
+#   --genasm PATH     program generator (default BIN_DIR/genasm)
+#   --sizes N,N,...   total source lines of each program
+#   --runs N          time the best of N runs (default 3)
+#   --seed N          generator seed (default 1)
+#   --results FILE    CSV results (default WORK_DIR/benchmark.csv)
+#   --compare FILE    report regressions against the baseline results in FILE;
+#                     if FILE does not exist, the results are written to it
+#   --threshold F     fraction slower or larger which is a regression (default 0.10)
+#
+# Each program is split into modules of at most MODULE_LINES lines. The
+# largest must link within the 640K image limit: about 200,000 lines.
+# The results give, for each tool and size, the best wall time over the runs,
+# throughput in source lines and input bytes per second, and the peak heap
+# bytes reported by the tool's -m option. Exit status 1 means a regression.
+# The baseline is kept apart from the results and never rewritten, so that
+# a regression, or a slow drift, is reported on every run until the
+# baseline is deleted to accept the new figures.
+
+import os
+import re
+import sys
+import csv
+import time
+import subprocess
+
+DEFAULT_SIZES = [10000, 30000, 100000, 200000]
+MODULE_LINES = 10000
+FIELDS = ["tool", "lines", "modules", "runs", "seconds", "lines_per_sec",
+          "bytes", "bytes_per_sec", "peak_bytes"]
+
+PEAK = re.compile(r"^peak:\s+(\d+) bytes", re.MULTILINE)
+
+
+def fatal(msg):
+  print("bench: fatal:", msg, file=sys.stderr)
+  sys.exit(2)
+
+
+def program(bin_dir, name):
+  path = os.path.join(bin_dir, name)
+  if os.name == "nt":
+    path += ".exe"
+  if not os.path.isfile(path):
+    fatal("program not found: " + path)
+  return path
+
+
+# Run a command in a directory, returning elapsed seconds and peak heap bytes.
+def timed(cmd, cwd):
+  start = time.perf_counter()
+  r = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                     universal_newlines=True)
+  elapsed = time.perf_counter() - start
+  if r.returncode != 0:
+    fatal("command failed: %s\n%s" % (" ".join(cmd), r.stderr))
+  m = PEAK.search(r.stdout)
+  return elapsed, int(m.group(1)) if m else 0
+
+
+# Run a job of several commands, taking the best total time of the runs
+# and the highest peak of any command.
+def measure(cmds, cwd, runs):
+  best = None
+  peak = 0
+  for _ in range(runs):
+    total = 0.0
+    for cmd in cmds:
+      seconds, p = timed(cmd, cwd)
+      total += seconds
+      peak = max(peak, p)
+    best = total if best is None else min(best, total)
+  return best, peak
+
+
+def file_bytes(cwd, names):
+  return sum(os.path.getsize(os.path.join(cwd, n)) for n in names)
+
+
+def result(tool, lines, modules, runs, seconds, nbytes, peak):
+  seconds = max(seconds, 1e-9)
+  return { "tool": tool, "lines": lines, "modules": modules, "runs": runs,
+           "seconds": "%.6f" % seconds,
+           "lines_per_sec": "%.0f" % (lines / seconds),
+           "bytes": nbytes,
+           "bytes_per_sec": "%.0f" % (nbytes / seconds),
+           "peak_bytes": peak }
+
+
+def bench_size(tools, genasm, work_dir, lines, runs, seed):
+  modules = (lines + MODULE_LINES - 1) // MODULE_LINES
+  cwd = os.path.join(work_dir, "lines%d" % lines)
+  os.makedirs(cwd, exist_ok=True)
+  subprocess.run([genasm, "-l", str(lines), "-m", str(modules), "-s", str(seed), "-o", "gen"],
+                 cwd=cwd, check=True)
+  sources = ["gen%d.asm" % i for i in range(modules)]
+  objects = ["gen%d.obj" % i for i in range(modules)]
+  results = []
+
+  seconds, peak = measure([[tools["bas"], "-m", s] for s in sources], cwd, runs)
+  results.append(result("bas", lines, modules, runs, seconds, file_bytes(cwd, sources), peak))
+
+  seconds, peak = measure([[tools["blink"], "-m", "-fexe", "-o", "gen.exe"] + objects], cwd, runs)
+  results.append(result("blink", lines, modules, runs, seconds, file_bytes(cwd, objects), peak))
+
+  seconds, peak = measure([[tools["bdis"], "-r", "-m", "gen.exe"]], cwd, runs)
+  results.append(result("bdis", lines, modules, runs, seconds, file_bytes(cwd, ["gen.exe"]), peak))
+
+  return results
+
+
+def write_results(filename, results):
+  with open(filename, "w", newline="") as f:
+    w = csv.DictWriter(f, fieldnames=FIELDS)
+    w.writeheader()
+    for r in results:
+      w.writerow(r)
+
+
+def compare(filename, results, threshold):
+  with open(filename, newline="") as f:
+    old = { (r["tool"], int(r["lines"])): r for r in csv.DictReader(f) }
+  regressions = 0
+  for r in results:
+    o = old.get((r["tool"], r["lines"]))
+    if o is None:
+      continue
+    for field in ("seconds", "peak_bytes"):
+      before = float(o[field])
+      after = float(r[field])
+      if before > 0 and after > before * (1 + threshold):
+        print("REGRESSION: %s %d lines: %s %s -> %s (%+.0f%%)" %
+              (r["tool"], r["lines"], field, o[field], r[field], 100 * (after / before - 1)))
+        regressions += 1
+  return regressions
+
+
+def main(argv):
+  if len(argv) < 3:
+    fatal("usage: bench.py BIN_DIR WORK_DIR [options]")
+  bin_dir = argv[1]
+  work_dir = os.path.abspath(argv[2])
+  genasm = None
+  sizes = DEFAULT_SIZES
+  runs = 3
+  seed = 1
+  results_name = os.path.join(work_dir, "benchmark.csv")
+  compare_name = None
+  threshold = 0.10
+
+  args = argv[3:]
+  while args:
+    opt = args.pop(0)
+    if not args:
+      fatal("value missing for " + opt)
+    val = args.pop(0)
+    if opt == "--genasm":
+      genasm = val
+    elif opt == "--sizes":
+      sizes = [int(n) for n in val.split(",")]
+    elif opt == "--runs":
+      runs = max(1, int(val))
+    elif opt == "--seed":
+      seed = int(val)
+    elif opt == "--results":
+      results_name = val
+    elif opt == "--compare":
+      compare_name = val
+    elif opt == "--threshold":
+      threshold = float(val)
+    else:
+      fatal("invalid option: " + opt)
+
+  tools = { t: program(bin_dir, t) for t in ("bas", "blink", "bdis") }
+  if genasm is None:
+    genasm = program(bin_dir, "genasm")
+  os.makedirs(work_dir, exist_ok=True)
+
+  results = []
+  print("%-6s %8s %8s %10s %12s %14s %12s" %
+        ("tool", "lines", "modules", "seconds", "lines/s", "bytes/s", "peak bytes"))
+  for lines in sizes:
+    for r in bench_size(tools, genasm, work_dir, lines, runs, seed):
+      print("%-6s %8d %8d %10s %12s %14s %12d" %
+            (r["tool"], r["lines"], r["modules"], r["seconds"], r["lines_per_sec"],
+             r["bytes_per_sec"], r["peak_bytes"]))
+      results.append(r)
+
+  write_results(results_name, results)
+  print("Results:", results_name)
+
+  regressions = 0
+  if compare_name:
+    if os.path.isfile(compare_name):
+      regressions = compare(compare_name, results, threshold)
+      print("Baseline:", compare_name, "(%d regressions)" % regressions)
+    else:
+      write_results(compare_name, results)
+      print("Baseline written:", compare_name)
+  return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+  sys.exit(main(sys.argv))
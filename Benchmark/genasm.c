@@ -0,0 +1,290 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Deterministic generator of large assembly programs for benchmarking.
+// Writes N modules, each with EQUs, words and DUP buffers in a public DATA
+// segment in DGROUP, and code segments of labelled instructions with
+// forward conditional jumps, which JUMPS may have to expand. Each module
+// makes public some of its words and refers to those of the next module.
+// The density of each of these is an option.
+// The output depends only on the options, not on the platform.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+
+#define DEFAULT_LINES (10000)
+#define DEFAULT_MODULES (1)
+#define DEFAULT_SEED (1)
+// Code lines per segment, keeping each segment well within 64K after expansion.
+#define DEFAULT_SEGMENT_LINES (2000)
+#define DEFAULT_LABEL_LINES (6)
+#define DEFAULT_JUMP_LABELS (24)
+#define DEFAULT_EQU_LINES (50)
+#define DEFAULT_DUP_LINES (500)
+#define DEFAULT_PUBLICS (8)
+
+// The DATA segments of all modules are combined into one.
+#define MAX_DATA (0xF000)
+
+typedef struct {
+  unsigned lines;
+  unsigned modules;
+  unsigned long seed;
+  const char* prefix;
+  unsigned segment_lines;  // code lines per segment
+  unsigned label_lines;    // code lines per label
+  unsigned jump_labels;    // forward jumps reach up to this many labels ahead; 0 for none
+  unsigned equ_lines;      // source lines per EQU
+  unsigned dup_lines;      // source lines per DUP buffer
+  unsigned publics;        // words of each module public, and external to the one before
+  bool group;              // DATA in DGROUP
+} GENOPTS;
+
+typedef struct {
+  unsigned long state;
+} RANDOM;
+
+// A fixed linear congruential generator, so that output is the same everywhere.
+static unsigned next_random(RANDOM* r, unsigned n) {
+  r->state = (r->state * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+  return (unsigned) ((r->state >> 8) % n);
+}
+
+static void usage(void) {
+  puts("Usage: genasm [options]\n");
+  puts("  -l N       total source lines (default 10000)");
+  puts("  -m N       modules (default 1)");
+  puts("  -o PREFIX  write PREFIX0.asm, PREFIX1.asm, ... (default gen)");
+  puts("  -s N       random seed (default 1)");
+  puts("  -c N       code lines per segment (default 2000)");
+  puts("  -L N       code lines per label (default 6)");
+  puts("  -j N       forward jumps reach up to N labels ahead; 0 for none (default 24)");
+  puts("  -e N       source lines per EQU (default 50)");
+  puts("  -d N       source lines per DUP buffer (default 500)");
+  puts("  -x N       publics of each module, external to the one before (default 8)");
+  puts("  -g N       1 to put DATA in DGROUP, 0 not (default 1)");
+  exit(EXIT_SUCCESS);
+}
+
+static unsigned long number(const char* option, const char* arg) {
+  char* end;
+  unsigned long n = strtoul(arg, &end, 10);
+  if (*arg == '\0' || *end != '\0')
+    fatal("invalid number for %s: %s\n", option, arg);
+  return n;
+}
+
+static void process_argv(int argc, char* argv[], GENOPTS* opt) {
+  opt->lines = DEFAULT_LINES;
+  opt->modules = DEFAULT_MODULES;
+  opt->seed = DEFAULT_SEED;
+  opt->prefix = "gen";
+  opt->segment_lines = DEFAULT_SEGMENT_LINES;
+  opt->label_lines = DEFAULT_LABEL_LINES;
+  opt->jump_labels = DEFAULT_JUMP_LABELS;
+  opt->equ_lines = DEFAULT_EQU_LINES;
+  opt->dup_lines = DEFAULT_DUP_LINES;
+  opt->publics = DEFAULT_PUBLICS;
+  opt->group = true;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    if (strcmp(arg, "-h") == 0 || strcmp(arg, "-?") == 0 || strcmp(arg, "--help") == 0)
+      usage();
+    if (arg[0] != '-' || arg[1] == '\0' || arg[2] != '\0')
+      fatal("invalid option: %s\n", arg);
+    if (i + 1 >= argc)
+      fatal("value missing for %s\n", arg);
+    const char* val = argv[++i];
+    switch (arg[1]) {
+      case 'l': opt->lines = number(arg, val); break;
+      case 'm': opt->modules = number(arg, val); break;
+      case 'o': opt->prefix = val; break;
+      case 's': opt->seed = number(arg, val); break;
+      case 'c': opt->segment_lines = number(arg, val); break;
+      case 'L': opt->label_lines = number(arg, val); break;
+      case 'j': opt->jump_labels = number(arg, val); break;
+      case 'e': opt->equ_lines = number(arg, val); break;
+      case 'd': opt->dup_lines = number(arg, val); break;
+      case 'x': opt->publics = number(arg, val); break;
+      case 'g': opt->group = number(arg, val) != 0; break;
+      default: fatal("invalid option: %s\n", arg);
+    }
+  }
+
+  if (opt->modules == 0)
+    fatal("at least one module required\n");
+  if (opt->lines < 100 * opt->modules)
+    fatal("too few lines for %u modules\n", opt->modules);
+  if (opt->segment_lines == 0 || opt->label_lines == 0 || opt->equ_lines == 0 || opt->dup_lines == 0)
+    fatal("lines per segment, label, EQU and DUP buffer must be at least 1\n");
+}
+
+typedef struct {
+  const GENOPTS* opt;
+  unsigned number;
+  unsigned modules;
+  unsigned equs;
+  unsigned words;
+  unsigned buffers;
+  unsigned code_lines;
+} MODULE;
+
+static void write_data(FILE* fp, const MODULE* m, RANDOM* r) {
+  for (unsigned i = 0; i < m->equs; i++)
+    fprintf(fp, "K%u_%u\tEQU\t%u\n", m->number, i, next_random(r, 0x8000));
+  fputc('\n', fp);
+
+  fprintf(fp, "\tSEGMENT\tDATA PUBLIC\n");
+  if (m->modules > 1) {
+    const unsigned next = (m->number + 1) % m->modules;
+    for (unsigned i = 0; i < m->opt->publics; i++)
+      fprintf(fp, "\tEXTRN\tV%u_%u: WORD\n", next, i);
+  }
+  for (unsigned i = 0; i < m->words; i++)
+    fprintf(fp, "V%u_%u\tDW\t%u\n", m->number, i, next_random(r, 0x10000));
+  for (unsigned i = 0; i < m->buffers; i++)
+    fprintf(fp, "B%u_%u\tDB\t%u DUP (%u)\n", m->number, i, 8 + next_random(r, 9), next_random(r, 256));
+  fprintf(fp, "\tENDS\n\n");
+
+  if (m->opt->publics) {
+    fprintf(fp, "\tPUBLIC\t");
+    for (unsigned i = 0; i < m->opt->publics; i++)
+      fprintf(fp, "%sV%u_%u", i ? ", " : "", m->number, i);
+    fputc('\n', fp);
+  }
+  if (m->opt->group)
+    fprintf(fp, "\tGROUP\tDGROUP DATA\n");
+  fputc('\n', fp);
+}
+
+static void write_instruction(FILE* fp, const MODULE* m, RANDOM* r,
+                              unsigned seg, unsigned label, unsigned labels) {
+  static const char* const regs[] = { "ax", "bx", "cx", "dx", "si", "di" };
+  static const char* const conds[] = { "jz", "jnz", "jc", "jnc", "ja", "jbe", "jl", "jge" };
+  const char* reg = regs[next_random(r, 6)];
+
+  switch (next_random(r, 12)) {
+    case 0:
+      fprintf(fp, "\tmov\t%s, K%u_%u\n", reg, m->number, next_random(r, m->equs));
+      break;
+    case 1:
+      fprintf(fp, "\tadd\t%s, [V%u_%u]\n", reg, m->number, next_random(r, m->words));
+      break;
+    case 2:
+      fprintf(fp, "\tmov\t[V%u_%u], %s\n", m->number, next_random(r, m->words), reg);
+      break;
+    case 3:
+      fprintf(fp, "\tmov\t%s, OFFSET B%u_%u\n", reg, m->number, next_random(r, m->buffers));
+      break;
+    case 4:
+      if (m->modules > 1 && m->opt->publics) {
+        fprintf(fp, "\tmov\t%s, [V%u_%u]\n", reg, (m->number + 1) % m->modules, next_random(r, m->opt->publics));
+        break;
+      }
+      // fall through
+    case 5:
+      fprintf(fp, "\tcmp\t%s, %u\n", reg, next_random(r, 0x100));
+      break;
+    case 6:
+    case 7: {
+      if (m->opt->jump_labels == 0) {
+        fprintf(fp, "\ttest\t%s, %s\n", reg, reg);
+        break;
+      }
+      unsigned target = label + 1 + next_random(r, m->opt->jump_labels);
+      if (target >= labels)
+        target = labels - 1;
+      fprintf(fp, "\t%s\tL%u_%u_%u\n", conds[next_random(r, 8)], m->number, seg, target);
+      break;
+    }
+    case 8:
+      fprintf(fp, "\tcall\tL%u_%u_%u\n", m->number, seg, next_random(r, label + 1));
+      break;
+    case 9:
+      fprintf(fp, "\txor\t%s, %s\n", reg, regs[next_random(r, 6)]);
+      break;
+    case 10:
+      fprintf(fp, "\tshl\t%s, 1\n", reg);
+      break;
+    default:
+      fprintf(fp, "\tinc\t%s\n", reg);
+      break;
+  }
+}
+
+static void write_code(FILE* fp, const MODULE* m, RANDOM* r) {
+  const unsigned segment_lines = m->opt->segment_lines;
+  const unsigned label_lines = m->opt->label_lines;
+  unsigned remaining = m->code_lines;
+
+  for (unsigned seg = 0; remaining > 0; seg++) {
+    const unsigned lines = remaining < segment_lines ? remaining : segment_lines;
+    const unsigned labels = (lines + label_lines - 1) / label_lines + 1;
+    remaining -= lines;
+
+    fprintf(fp, "\tSEGMENT\tC%u_%u PUBLIC\n", m->number, seg);
+    fprintf(fp, "\tASSUME\tCS: C%u_%u, DS: %s\n", m->number, seg, m->opt->group ? "DGROUP" : "DATA");
+    if (m->number == 0 && seg == 0)
+      fprintf(fp, "start:\n");
+    for (unsigned i = 0; i < lines; i++) {
+      if (i % label_lines == 0)
+        fprintf(fp, "L%u_%u_%u:\n", m->number, seg, i / label_lines);
+      write_instruction(fp, m, r, seg, i / label_lines, labels);
+    }
+    fprintf(fp, "L%u_%u_%u:\n", m->number, seg, labels - 1);
+    fprintf(fp, "\tret\n");
+    fprintf(fp, "\tENDS\n\n");
+  }
+}
+
+static void write_module(const GENOPTS* opt, unsigned number) {
+  const unsigned lines = opt->lines / opt->modules;
+  MODULE m;
+  m.opt = opt;
+  m.number = number;
+  m.modules = opt->modules;
+  m.equs = lines / opt->equ_lines + 1;
+  m.words = lines / 80 + opt->publics;
+  m.buffers = lines / opt->dup_lines + 1;
+  if ((2 * m.words + 16 * m.buffers) * opt->modules > MAX_DATA)
+    fatal("too many lines: data would exceed one segment\n");
+  // the rest of the lines are code and labels
+  const unsigned data_lines = m.equs + m.words + m.buffers;
+  m.code_lines = (lines > data_lines) ? (lines - data_lines) * opt->label_lines / (opt->label_lines + 1) : 1;
+
+  RANDOM r;
+  r.state = opt->seed * 7919UL + number;
+
+  char* name = emalloc(strlen(opt->prefix) + 16);
+  sprintf(name, "%s%u.asm", opt->prefix, number);
+  FILE* fp = efopen(name, "w", "writing");
+
+  fprintf(fp, "; Generated by genasm: module %u of %u, seed %lu\n\n", number, opt->modules, opt->seed);
+  fprintf(fp, "\tIDEAL\n\tJUMPS\n\n");
+  write_data(fp, &m, &r);
+  write_code(fp, &m, &r);
+  if (number == 0) {
+    fprintf(fp, "\tSEGMENT\t_STACK STACK\n\tDB\t100h DUP (0)\n\tENDS\n\n");
+    fprintf(fp, "\tEND\tstart\n");
+  }
+  else
+    fprintf(fp, "\tEND\n");
+
+  if (fclose(fp) != 0)
+    fatal("error writing %s\n", name);
+  efree(name);
+}
+
+int main(int argc, char* argv[]) {
+  GENOPTS opt;
+
+  progname = "genasm";
+  process_argv(argc, argv, &opt);
+
+  for (unsigned i = 0; i < opt.modules; i++)
+    write_module(&opt, i);
+
+  return EXIT_SUCCESS;
+}
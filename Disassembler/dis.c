@@ -11,12 +11,16 @@
 #include "fetch.h"
 #include "disassemble.h"
 #include "interact.h"
+#include "traverse.h"
+#include "instats.h"
 
 #ifdef UNIT_TEST
 static void RunAllTests(void);
+static int RunAllBenchmarks(const char* baselines);
 #endif
 
 static void disassemble(const DECODER*, const char* filename, DWORD origin, bool print_hex);
+static void sweep_stats(const DECODER*, const char* filename, INSTATS*);
 static void report_memory(void);
 
 static void help(void);
@@ -25,6 +29,9 @@ int main(int argc, char* argv[]) {
   const char* fileName = NULL;
   bool hex = true;
   bool interactive = false;
+  bool recursive = false;
+  bool stats = false;
+  bool csv = false;
   DWORD origin = 0x100;
   bool memory = false;
 
@@ -40,9 +47,19 @@ int main(int argc, char* argv[]) {
         report_memory();
         exit(EXIT_SUCCESS);
       }
+      if (strcmp(arg, "-bench") == 0 || strncmp(arg, "-bench=", 7) == 0)
+        exit(RunAllBenchmarks(arg[6] == '=' ? arg + 7 : NULL) ? EXIT_FAILURE : EXIT_SUCCESS);
 #endif
       if (strcmp(arg + 1, "-help") == 0)
         help();
+      if (strcmp(arg, "--stats") == 0) {
+        stats = true;
+        continue;
+      }
+      if (strcmp(arg, "--stats=csv") == 0) {
+        stats = csv = true;
+        continue;
+      }
       if (arg[1] == '-')
         fatal("invalid option: %s\n", arg);
       for (const char* p = arg + 1; *p; p++)
@@ -51,6 +68,7 @@ int main(int argc, char* argv[]) {
           case 'h': case '?': help(); break;
           case 'i': interactive = true; break;
           case 'm': memory = true; break;
+          case 'r': recursive = true; break;
           case 's': hex = false; break;
           default: fatal("invalid option: %c\n", *p);
         }
@@ -66,12 +84,23 @@ int main(int argc, char* argv[]) {
   }
 
   if (fileName == NULL)
-    fatal("usage: dis [-is] file\n");
+    fatal("usage: dis [-irs] file\n");
 
   DECODER* dec = build_decoder();
 
-  if (interactive)
+  if (stats) {
+    INSTATS* st = new_instats();
+    if (recursive)
+      traverse(dec, fileName, origin, hex, st);
+    else
+      sweep_stats(dec, fileName, st);
+    print_instats(st, csv);
+    delete_instats(st);
+  }
+  else if (interactive)
     interact(dec, fileName, origin);
+  else if (recursive)
+    traverse(dec, fileName, origin, hex, NULL);
   else
     disassemble(dec, fileName, origin, hex);
 
@@ -88,7 +117,10 @@ static void help(void) {
   puts("bdis [options] file\n");
   puts("  -b  raw binary format, not COM");
   puts("  -i  interactive mode: enter ? for help");
+  puts("  -r  recursive traversal: decode only code reachable from entry (COM or EXE)");
   puts("  -s  omit hex, show disassembly only");
+  puts("  --stats      instruction statistics: per mnemonic, form, prefix, mode, length");
+  puts("  --stats=csv  instruction statistics as CSV");
   exit(EXIT_FAILURE);
 }
 
@@ -142,11 +174,30 @@ static unsigned instruction(const DECODER* decoder, FILE* fp, const DWORD addr,
   return dec.len;
 }
 
+// Linear sweep counting instructions; an undecodable byte is skipped.
+static void sweep_stats(const DECODER* decoder, const char* filename, INSTATS* stats) {
+  FILE* fp = efopen(filename, "rb", "disassembly");
+  FileSize size = file_size(fp, filename);
+  BYTE* image = read_file(fp, size);
+  fclose(fp);
+
+  DECODED dec;
+  for (FileSize i = 0; i < size; ) {
+    if (decode_instruction(decoder, image + i, size - i, &dec) == DECODE_ERR_NONE) {
+      count_instruction(stats, &dec);
+      i += dec.len;
+    }
+    else {
+      count_undecoded(stats, 1);
+      i++;
+    }
+  }
+
+  efree(image);
+}
+
 static void report_memory(void) {
-  unsigned long malloc_count, free_count;
-  get_memory_counts(&malloc_count, &free_count);
-  printf("malloc: %10lu\n", malloc_count);
-  printf("free:   %10lu\n", free_count);
+  print_memory_usage(stdout);
 }
 
 #ifdef UNIT_TEST
@@ -154,16 +205,41 @@ static void report_memory(void) {
 #include "CuTest.h"
 
 CuSuite* decoder_test_suite(void);
+CuSuite* traverse_test_suite(void);
+CuSuite* instats_test_suite(void);
+
+CuBenchSuite* disassemble_bench_suite(void);
 
 static void RunAllTests(void) {
   CuString *output = CuStringNew();
   CuSuite* suite = CuSuiteNew();
 
   CuSuiteAddSuite(suite, decoder_test_suite());
+  CuSuiteAddSuite(suite, traverse_test_suite());
+  CuSuiteAddSuite(suite, instats_test_suite());
   CuSuiteRun(suite);
   CuSuiteSummary(suite, output);
   CuSuiteDetails(suite, output);
   printf("%s\n", output->buffer);
 }
 
+static int RunAllBenchmarks(const char* baselines) {
+  CuString *output = CuStringNew();
+  CuBenchSuite* suite = CuBenchSuiteNew();
+
+  CuBenchSuiteAddSuite(suite, disassemble_bench_suite());
+
+  const bool record = baselines && !CuBenchSuiteReadBaselines(suite, baselines);
+  CuBenchSuiteRun(suite);
+  CuBenchSuiteDetails(suite, output);
+  printf("%s\n", output->buffer);
+  if (record && !CuBenchSuiteWriteBaselines(suite, baselines))
+    fatal("cannot write benchmark baselines: %s\n", baselines);
+
+  const int failures = suite->failCount;
+  CuBenchSuiteDelete(suite);
+  CuStringDelete(output);
+  return failures;
+}
+
 #endif // UNIT_TEST
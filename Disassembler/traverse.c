@@ -0,0 +1,564 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Recursive traversal disassembler.
+// Decode only code reachable from the entry point by following jumps,
+// calls and conditional branches. Unreached bytes are listed as data.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <assert.h>
+#include "traverse.h"
+#include "disassemble.h"
+#include "loadexe.h"
+#include "token.h"
+
+// per-byte analysis flags
+enum {
+  MAP_INSTR = 0x01, // first byte of a decoded instruction
+  MAP_BODY = 0x02,  // subsequent byte of a decoded instruction
+  MAP_LABEL = 0x04, // target of a jump or call
+  MAP_END = 0x08,   // instruction transfers control: ends a basic block
+};
+
+typedef struct {
+  DWORD start; // linear address
+  DWORD end;   // one past the last byte
+  WORD cs;
+  bool label;
+} BLOCK;
+
+struct traversal {
+  const BYTE* image;
+  DWORD origin;
+  DWORD size;
+  bool segmented;
+  BYTE* map;
+  WORD* cs;
+  // basic blocks in ascending address order
+  BLOCK* blocks;
+  unsigned allocated;
+  unsigned used;
+};
+
+typedef struct {
+  WORD cs;
+  WORD ip;
+} TARGET;
+
+typedef struct {
+  TARGET* recs;
+  unsigned allocated;
+  unsigned used;
+} WORKLIST;
+
+static DWORD linear(WORD cs, WORD ip) {
+  return ((DWORD)cs << 4) + ip;
+}
+
+static bool in_image(const TRAVERSAL* t, DWORD addr) {
+  return addr >= t->origin && addr - t->origin < t->size;
+}
+
+static void push_target(TRAVERSAL*, WORKLIST*, WORD cs, WORD ip);
+static void trace_from(const DECODER*, TRAVERSAL*, WORKLIST*, TARGET);
+static void build_blocks(TRAVERSAL*);
+
+TRAVERSAL* traverse_image(const DECODER* decoder, const BYTE* image, DWORD size, DWORD origin,
+                          WORD entry_cs, WORD entry_ip, bool segmented) {
+  assert(decoder != NULL);
+  assert(image != NULL || size == 0);
+
+  TRAVERSAL* t = emalloc(sizeof *t);
+  t->image = image;
+  t->origin = origin;
+  t->size = size;
+  t->segmented = segmented;
+  t->map = ecalloc(size ? size : 1);
+  t->cs = ecalloc((size ? size : 1) * sizeof t->cs[0]);
+  t->blocks = NULL;
+  t->allocated = 0;
+  t->used = 0;
+
+  WORKLIST work = { NULL, 0, 0 };
+  push_target(t, &work, entry_cs, entry_ip);
+  while (work.used) {
+    TARGET target = work.recs[--work.used];
+    trace_from(decoder, t, &work, target);
+  }
+  efree(work.recs);
+
+  build_blocks(t);
+
+  return t;
+}
+
+void delete_traversal(TRAVERSAL* t) {
+  if (t) {
+    efree(t->blocks);
+    efree(t->cs);
+    efree(t->map);
+    efree(t);
+  }
+}
+
+static void push_target(TRAVERSAL* t, WORKLIST* work, WORD cs, WORD ip) {
+  DWORD addr = linear(cs, ip);
+  if (!in_image(t, addr))
+    return;
+
+  t->map[addr - t->origin] |= MAP_LABEL;
+
+  if (work->used == work->allocated) {
+    work->allocated = work->allocated ? 2 * work->allocated : 128;
+    work->recs = erealloc(work->recs, work->allocated * sizeof work->recs[0]);
+  }
+  work->recs[work->used].cs = cs;
+  work->recs[work->used].ip = ip;
+  work->used++;
+}
+
+enum { FLOW_NEXT, FLOW_BRANCH, FLOW_STOP };
+
+// DOS functions of INT 21h which end the program.
+#define DOS_TERMINATE (0x00)
+#define DOS_EXIT (0x4C)
+
+// The value of AH after the instruction, given its value before, or -1
+// if unknown. Only a MOV of an immediate into AH or AX is followed; any
+// other instruction except a MOV to another destination makes it unknown.
+static int ah_after(const DECODED* dec, int ah) {
+  const INSDEF* def = dec->def;
+  if (def->op != TOK_MOV)
+    return -1;
+  bool byte;
+  switch (def->oper1) {
+    case OF_REG8:
+    case OF_RM8:
+      byte = true;
+      break;
+    case OF_REG16:
+    case OF_RM16:
+      byte = false;
+      break;
+    case OF_RM:
+      byte = (def->oper2 == OF_REG8);
+      break;
+    case OF_AX:
+      return -1;
+    default:
+      // memory, AL or a segment register
+      return ah;
+  }
+  // AH is byte register 4, AX word register 0
+  if (dec->oper1.type != OT_REG || dec->oper1.val.reg != (byte ? 4 : 0))
+    return ah;
+  if (def->oper2 != OF_IMM)
+    return -1;
+  // the immediate of the second operand
+  return (int) ((byte ? dec->imm2 : dec->imm2 >> 8) & 0xFF);
+}
+
+// Given the value of AH before the instruction, or -1 if unknown.
+static int control_flow(const DECODED* dec, int ah) {
+  const INSDEF* def = dec->def;
+  switch (def->op) {
+    case TOK_JMP:
+    case TOK_RET:
+    case TOK_RETN:
+    case TOK_RETF:
+    case TOK_IRET:
+    case TOK_IRETW:
+      return FLOW_STOP;
+    case TOK_CALL:
+      return FLOW_BRANCH;
+    case TOK_INT:
+      if (def->oper1 != OF_IMM)
+        return FLOW_NEXT;
+      // DOS program terminate, or a terminating function of INT 21h
+      if (dec->imm1 == 0x20 || (dec->imm1 == 0x21 && (ah == DOS_EXIT || ah == DOS_TERMINATE)))
+        return FLOW_STOP;
+      return FLOW_NEXT;
+  }
+  return def->oper1 == OF_JUMP ? FLOW_BRANCH : FLOW_NEXT;
+}
+
+static bool near_target(const DECODED* dec, WORD ip, WORD *dest) {
+  if (dec->def->oper1 != OF_JUMP)
+    return false;
+  WORD next = ip + dec->len;
+  if (dec->def->imm1 == 1)
+    *dest = next + (SBYTE) dec->imm1;
+  else
+    *dest = next + (SWORD) dec->imm1;
+  return true;
+}
+
+static bool unclaimed(const TRAVERSAL* t, DWORD i, unsigned len) {
+  for (unsigned j = 0; j < len; j++) {
+    if (t->map[i + j] & (MAP_INSTR | MAP_BODY))
+      return false;
+  }
+  return true;
+}
+
+// Decode sequentially from the target until control is transferred
+// unconditionally, or the code runs into bytes already decoded or undecodable.
+// AH is followed within a block, to find the DOS exit function.
+static void trace_from(const DECODER* decoder, TRAVERSAL* t, WORKLIST* work, TARGET target) {
+  const WORD cs = target.cs;
+  WORD ip = target.ip;
+  int ah = -1;
+
+  for (;;) {
+    DWORD addr = linear(cs, ip);
+    if (!in_image(t, addr))
+      return;
+
+    DWORD i = addr - t->origin;
+    if (t->map[i] & (MAP_INSTR | MAP_BODY))
+      return;
+
+    DECODED dec;
+    if (decode_instruction(decoder, t->image + i, t->size - i, &dec))
+      return;
+    assert(dec.len > 0 && dec.len <= t->size - i);
+    if (!unclaimed(t, i, dec.len))
+      return;
+
+    t->map[i] |= MAP_INSTR;
+    for (unsigned j = 1; j < dec.len; j++)
+      t->map[i + j] |= MAP_BODY;
+    t->cs[i] = cs;
+
+    WORD dest;
+    if (near_target(&dec, ip, &dest))
+      push_target(t, work, cs, dest);
+    else if (dec.def->oper1 == OF_FAR && t->segmented)
+      push_target(t, work, (WORD)(dec.imm1 >> 16), (WORD)(dec.imm1 & 0xFFFF));
+
+    // control can reach a label with any AH
+    if (t->map[i] & MAP_LABEL)
+      ah = -1;
+    int flow = control_flow(&dec, ah);
+    ah = ah_after(&dec, ah);
+    if (flow != FLOW_NEXT)
+      t->map[i] |= MAP_END;
+    if (flow == FLOW_STOP)
+      return;
+
+    ip += dec.len;
+  }
+}
+
+static BLOCK* new_block(TRAVERSAL*, DWORD start, bool label, WORD cs);
+
+// Scan the byte map in address order, so the block list is sorted.
+static void build_blocks(TRAVERSAL* t) {
+  BLOCK* block = NULL;
+  DWORD i = 0;
+
+  while (i < t->size) {
+    const BYTE flags = t->map[i];
+    if ((flags & MAP_INSTR) == 0) {
+      block = NULL;
+      i++;
+      continue;
+    }
+    if (block == NULL || (flags & MAP_LABEL) || t->cs[i] != block->cs)
+      block = new_block(t, t->origin + i, (flags & MAP_LABEL) != 0, t->cs[i]);
+    do
+      i++;
+    while (i < t->size && (t->map[i] & MAP_BODY));
+    block->end = t->origin + i;
+    if (flags & MAP_END)
+      block = NULL;
+  }
+}
+
+static BLOCK* new_block(TRAVERSAL* t, DWORD start, bool label, WORD cs) {
+  if (t->used == t->allocated) {
+    t->allocated = t->allocated ? 2 * t->allocated : 128;
+    t->blocks = erealloc(t->blocks, t->allocated * sizeof t->blocks[0]);
+  }
+  BLOCK* block = &t->blocks[t->used++];
+  block->start = start;
+  block->end = start;
+  block->cs = cs;
+  block->label = label;
+  return block;
+}
+
+static void print_block(const DECODER*, const TRAVERSAL*, const BLOCK*, bool print_hex);
+static void print_data(const TRAVERSAL*, DWORD start, DWORD end, bool print_hex);
+
+void print_traversal(const DECODER* decoder, const TRAVERSAL* t, bool print_hex) {
+  assert(t != NULL);
+
+  DWORD addr = t->origin;
+  for (unsigned b = 0; b < t->used; b++) {
+    const BLOCK* block = &t->blocks[b];
+    assert(block->start >= addr);
+    if (addr < block->start)
+      print_data(t, addr, block->start, print_hex);
+    print_block(decoder, t, block, print_hex);
+    addr = block->end;
+  }
+  if (addr < t->origin + t->size)
+    print_data(t, addr, t->origin + t->size, print_hex);
+}
+
+static void print_block(const DECODER* decoder, const TRAVERSAL* t, const BLOCK* block, bool print_hex) {
+  const DWORD base = linear(block->cs, 0);
+
+  if (block->label) {
+    WORD ip = (WORD)(block->start - base);
+    putchar('\n');
+    if (t->segmented)
+      printf("L%04X_%04X:\n", (unsigned) block->cs, (unsigned) ip);
+    else
+      printf("L%04X:\n", (unsigned) ip);
+  }
+
+  DECODED dec;
+  for (DWORD addr = block->start; addr < block->end; addr += dec.len) {
+    const DWORD i = addr - t->origin;
+    const WORD ip = (WORD)(addr - base);
+
+    int err = decode_instruction(decoder, t->image + i, block->end - addr, &dec);
+    if (err)
+      fatal("error decoding instruction: %s\n", decoding_error(err));
+
+    if (print_hex) {
+      if (t->segmented)
+        printf("%04x:%04x: ", (unsigned) block->cs, (unsigned) ip);
+      else
+        printf("%04x: ", (unsigned) ip);
+      for (unsigned j = 0; j < dec.len; j++)
+        printf("%02x ", t->image[i + j]);
+      for (unsigned j = dec.len; j < 8; j++)
+        fputs("   ", stdout);
+    }
+    print_assembly(ip, &dec);
+    putchar('\n');
+  }
+}
+
+// Count each reachable instruction; unreached bytes are undecoded.
+void count_traversal(const DECODER* decoder, const TRAVERSAL* t, INSTATS* stats) {
+  assert(t != NULL);
+  assert(stats != NULL);
+
+  DWORD addr = t->origin;
+  for (unsigned b = 0; b < t->used; b++) {
+    const BLOCK* block = &t->blocks[b];
+    count_undecoded(stats, block->start - addr);
+    DECODED dec;
+    for (addr = block->start; addr < block->end; addr += dec.len) {
+      int err = decode_instruction(decoder, t->image + (addr - t->origin), block->end - addr, &dec);
+      if (err)
+        fatal("error decoding instruction: %s\n", decoding_error(err));
+      count_instruction(stats, &dec);
+    }
+  }
+  count_undecoded(stats, t->origin + t->size - addr);
+}
+
+#define DATA_LINE (8)
+
+static void print_byte(BYTE b) {
+  char buf[4];
+  sprintf(buf, "%X", b);
+  printf("%s%sh", isdigit(buf[0]) ? "" : "0", buf);
+}
+
+static void print_data(const TRAVERSAL* t, DWORD start, DWORD end, bool print_hex) {
+  assert(start < end);
+
+  putchar('\n');
+  for (DWORD addr = start; addr < end; ) {
+    const BYTE* p = t->image + (addr - t->origin);
+    unsigned n = (end - addr < DATA_LINE) ? end - addr : DATA_LINE;
+
+    if (print_hex) {
+      printf(t->segmented ? "%05lx: " : "%04lx: ", (unsigned long) addr);
+      for (unsigned j = 0; j < n; j++)
+        printf("%02x ", p[j]);
+      for (unsigned j = n; j < 8; j++)
+        fputs("   ", stdout);
+    }
+    fputs("DB ", stdout);
+    for (unsigned j = 0; j < n; j++) {
+      if (j)
+        fputs(", ", stdout);
+      print_byte(p[j]);
+    }
+    putchar('\n');
+
+    addr += n;
+  }
+}
+
+static bool exe_signature(const char* filename);
+
+static void report(const DECODER*, const TRAVERSAL*, bool print_hex, INSTATS*);
+
+void traverse(const DECODER* decoder, const char* filename, DWORD origin, bool print_hex, INSTATS* stats) {
+  // An origin of zero selects raw binary format.
+  if (origin && exe_signature(filename)) {
+    LOADEXE* exe = load_exe(filename);
+    TRAVERSAL* t = traverse_image(decoder, exe->image, exe->image_size, 0,
+                                  exe->header->exInitCS, exe->header->exInitIP, true);
+    report(decoder, t, print_hex, stats);
+    delete_traversal(t);
+    delete_loadexe(exe);
+    return;
+  }
+
+  FILE* fp = efopen(filename, "rb", "disassembly");
+  FileSize size = file_size(fp, filename);
+  BYTE* image = read_file(fp, size);
+  fclose(fp);
+
+  TRAVERSAL* t = traverse_image(decoder, image, size, origin, 0, (WORD) origin, false);
+  report(decoder, t, print_hex, stats);
+  delete_traversal(t);
+  efree(image);
+}
+
+static void report(const DECODER* decoder, const TRAVERSAL* t, bool print_hex, INSTATS* stats) {
+  if (stats)
+    count_traversal(decoder, t, stats);
+  else
+    print_traversal(decoder, t, print_hex);
+}
+
+static bool exe_signature(const char* filename) {
+  FILE* fp = efopen(filename, "rb", "disassembly");
+  BYTE sig[2];
+  bool exe = fread(sig, 1, sizeof sig, fp) == sizeof sig && sig[0] == 'M' && sig[1] == 'Z';
+  fclose(fp);
+  return exe;
+}
+
+#ifdef UNIT_TEST
+
+#include "CuTest.h"
+
+static void check_block(CuTest* tc, const TRAVERSAL* t, unsigned b, DWORD start, DWORD end, bool label) {
+  CuAssertTrue(tc, b < t->used);
+  CuAssertIntEquals(tc, start, t->blocks[b].start);
+  CuAssertIntEquals(tc, end, t->blocks[b].end);
+  CuAssertIntEquals(tc, label, t->blocks[b].label);
+}
+
+static void test_skip_data(CuTest* tc) {
+  // JMP SHORT 104h; data; RET
+  static const BYTE code[] = { 0xEB, 0x02, 0xFF, 0xFF, 0xC3 };
+  DECODER* dec = build_decoder();
+  TRAVERSAL* t = traverse_image(dec, code, sizeof code, 0x100, 0, 0x100, false);
+
+  CuAssertIntEquals(tc, 2, t->used);
+  check_block(tc, t, 0, 0x100, 0x102, true);
+  check_block(tc, t, 1, 0x104, 0x105, true);
+  CuAssertIntEquals(tc, 0, t->map[2]);
+  CuAssertIntEquals(tc, 0, t->map[3]);
+
+  delete_traversal(t);
+  delete_decoder(dec);
+}
+
+static void test_branch_and_call(CuTest* tc) {
+  // 100: JE SHORT 103h
+  // 102: NOP
+  // 103: CALL NEAR 107h
+  // 106: RET
+  // 107: RET
+  static const BYTE code[] = { 0x74, 0x01, 0x90, 0xE8, 0x01, 0x00, 0xC3, 0xC3 };
+  DECODER* dec = build_decoder();
+  TRAVERSAL* t = traverse_image(dec, code, sizeof code, 0x100, 0, 0x100, false);
+
+  CuAssertIntEquals(tc, 5, t->used);
+  check_block(tc, t, 0, 0x100, 0x102, true);
+  check_block(tc, t, 1, 0x102, 0x103, false);
+  check_block(tc, t, 2, 0x103, 0x106, true);
+  check_block(tc, t, 3, 0x106, 0x107, false);
+  check_block(tc, t, 4, 0x107, 0x108, true);
+
+  delete_traversal(t);
+  delete_decoder(dec);
+}
+
+static void test_far_segmented(CuTest* tc) {
+  // 0000:0000: JMP FAR 0001:0002
+  // 0005: data
+  // 0012: RET
+  static const BYTE code[] = {
+    0xEA, 0x02, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xC3
+  };
+  DECODER* dec = build_decoder();
+
+  TRAVERSAL* t = traverse_image(dec, code, sizeof code, 0, 0, 0, true);
+  CuAssertIntEquals(tc, 2, t->used);
+  check_block(tc, t, 0, 0x00, 0x05, true);
+  check_block(tc, t, 1, 0x12, 0x13, true);
+  CuAssertIntEquals(tc, 1, t->blocks[1].cs);
+  delete_traversal(t);
+
+  // far targets are not followed in an unsegmented image
+  t = traverse_image(dec, code, sizeof code, 0, 0, 0, false);
+  CuAssertIntEquals(tc, 1, t->used);
+  delete_traversal(t);
+
+  delete_decoder(dec);
+}
+
+static void test_dos_exit(CuTest* tc) {
+  // MOV AX, 4C00h; INT 21h; msg DB 'Hi', 0FFh, 0FFh, '$'
+  static const BYTE exit_ax[] = { 0xB8, 0x00, 0x4C, 0xCD, 0x21, 'H', 'i', 0xFF, 0xFF, '$' };
+  // MOV AH, 4Ch; MOV AL, 1; MOV [0200h], AL; INT 21h; data
+  static const BYTE exit_ah[] = { 0xB4, 0x4C, 0xB0, 0x01, 0xA2, 0x00, 0x02, 0xCD, 0x21, 0xFF, 0xFF };
+  // MOV AH, 9; INT 21h; RET
+  static const BYTE print[] = { 0xB4, 0x09, 0xCD, 0x21, 0xC3 };
+  // MOV AH, 4Ch; MOV AX, [0200h]; INT 21h; RET
+  static const BYTE unknown[] = { 0xB4, 0x4C, 0xA1, 0x00, 0x02, 0xCD, 0x21, 0xC3 };
+  DECODER* dec = build_decoder();
+
+  TRAVERSAL* t = traverse_image(dec, exit_ax, sizeof exit_ax, 0x100, 0, 0x100, false);
+  CuAssertIntEquals(tc, 1, t->used);
+  check_block(tc, t, 0, 0x100, 0x105, true);
+  for (unsigned i = 5; i < sizeof exit_ax; i++)
+    CuAssertIntEquals(tc, 0, t->map[i]);
+  delete_traversal(t);
+
+  t = traverse_image(dec, exit_ah, sizeof exit_ah, 0x100, 0, 0x100, false);
+  CuAssertIntEquals(tc, 1, t->used);
+  check_block(tc, t, 0, 0x100, 0x109, true);
+  delete_traversal(t);
+
+  t = traverse_image(dec, print, sizeof print, 0x100, 0, 0x100, false);
+  CuAssertIntEquals(tc, 1, t->used);
+  check_block(tc, t, 0, 0x100, 0x105, true);
+  delete_traversal(t);
+
+  t = traverse_image(dec, unknown, sizeof unknown, 0x100, 0, 0x100, false);
+  CuAssertIntEquals(tc, 1, t->used);
+  check_block(tc, t, 0, 0x100, 0x108, true);
+  delete_traversal(t);
+
+  delete_decoder(dec);
+}
+
+CuSuite* traverse_test_suite(void) {
+  CuSuite* suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_skip_data);
+  SUITE_ADD_TEST(suite, test_branch_and_call);
+  SUITE_ADD_TEST(suite, test_far_segmented);
+  SUITE_ADD_TEST(suite, test_dos_exit);
+  return suite;
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,29 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Recursive traversal disassembler.
+
+#ifndef TRAVERSE_H
+#define TRAVERSE_H
+
+#include <stdbool.h>
+#include "decoder.h"
+#include "instats.h"
+#include "utils.h"
+
+typedef struct traversal TRAVERSAL;
+
+// Follow control flow from the entry point CS:IP through an image occupying
+// linear addresses [origin, origin + size), recording reachable basic blocks.
+// Far targets are followed only in a segmented (EXE) image.
+TRAVERSAL* traverse_image(const DECODER*, const BYTE* image, DWORD size, DWORD origin,
+                          WORD entry_cs, WORD entry_ip, bool segmented);
+void delete_traversal(TRAVERSAL*);
+
+void print_traversal(const DECODER*, const TRAVERSAL*, bool print_hex);
+void count_traversal(const DECODER*, const TRAVERSAL*, INSTATS*);
+
+// Disassemble a COM or raw binary file, or an EXE file identified by its signature.
+// If stats is not NULL, count the reachable instructions instead of listing them.
+void traverse(const DECODER*, const char* filename, DWORD origin, bool print_hex, INSTATS* stats);
+
+#endif // TRAVERSE_H
@@ -8,6 +8,13 @@
 #include <assert.h>
 #include "options.h"
 #include "estring.h"
+#include "assembler.h"
+#include "cache.h"
+#include "linker.h"
+#include "format.h"
+#include "timer.h"
+#include "trace.h"
+#include "watcher.h"
 #include "utils.h"
 
 #ifdef UNIT_TEST
@@ -16,11 +23,13 @@ void RunAllTests(void);
 
 static void report_memory(OPTIONS*);
 
+static void build(const OPTIONS*);
+static void watch(const OPTIONS*);
 static STRINGLIST* obtain_objects(const OPTIONS*);
 static void link(const OPTIONS*, const STRINGLIST* objects);
 
 int main(int argc, char* argv[]) {
-  OPTIONS* opt = process_argv(argc, argv);
+  OPTIONS* opt = process_driver_argv(argc, argv);
 
 #ifdef UNIT_TEST
   if (opt->unit_test) {
@@ -31,9 +40,25 @@ int main(int argc, char* argv[]) {
   }
 #endif
 
-  STRINGLIST* objects = obtain_objects(opt);
-  link(opt, objects);
-  delete_stringlist(objects);
+#ifdef TRACE_EVENTS
+  if (opt->trace_name)
+    TRACE_OPEN(opt->trace_name, "basl");
+#endif
+  TRACE_BEGIN("build");
+
+  if (opt->watch)
+    watch(opt);
+  else if (opt->spawn) {
+    STRINGLIST* objects = obtain_objects(opt);
+    if (!opt->assemble_only)
+      link(opt, objects);
+    delete_stringlist(objects);
+  }
+  else
+    build(opt);
+
+  TRACE_END();
+  TRACE_CLOSE();
 
   report_memory(opt);
   return 0;
@@ -41,12 +66,9 @@ int main(int argc, char* argv[]) {
 
 static void report_memory(OPTIONS* opt) {
   bool report = opt->report_memory;
-  delete_options(opt);
+  delete_driver_options(opt);
   if (report) {
-    unsigned long malloc_count, free_count;
-    get_memory_counts(&malloc_count, &free_count);
-    printf("malloc: %10lu\n", malloc_count);
-    printf("free:   %10lu\n", free_count);
+    print_memory_usage(stdout);
   }
 }
 
@@ -54,6 +76,265 @@ static bool asm_file(const char* name);
 static bool obj_file(const char* name);
 static char* obj_name(const char* name);
 static char* assemble(const OPTIONS*, const char* name);
+static char* child_trace(const OPTIONS*, ESTRING* command);
+static void merge_child_trace(char* name);
+
+static void init_asm_options(const OPTIONS* opt, ASM_SETTINGS* settings) {
+  init_asm_settings(settings);
+  settings->case_sensitive = opt->case_sensitive;
+  if (opt->max_errors_set)
+    settings->max_errors = opt->max_errors;
+  settings->verbose = (opt->verbose >= 2);
+}
+
+static void init_link_options(const OPTIONS* opt, LINK_SETTINGS* settings) {
+  init_link_settings(settings);
+  settings->case_sensitive = opt->case_sensitive;
+  settings->verbose = (opt->verbose >= 2);
+  settings->mapfile = opt->mapfile;
+}
+
+// The object records of a source, from the cache if it has them under the key,
+// otherwise assembled, and cached if there is a cache; appending to incbins
+// the files the source includes by INCBIN.
+static OFILE* assemble_module(const OPTIONS* opt, CACHE* cache, const char* key, const char* name,
+                              const ASM_SETTINGS* settings, PROFILE* profile, STRINGLIST* incbins) {
+  OFILE* ofile = cache ? cache_lookup(cache, key, incbins) : NULL;
+  if (ofile) {
+    if (opt->verbose)
+      printf("Cached %s\n", name);
+    return ofile;
+  }
+  if (opt->verbose)
+    printf("Assemble %s\n", name);
+  TRACE_BEGIN("assemble %s", name);
+  ofile = assemble_file(name, settings, profile, incbins);
+  TRACE_END();
+  if (cache)
+    cache_store(cache, key, ofile, incbins);
+  return ofile;
+}
+
+static void report_cache(const CACHE* cache) {
+  const unsigned hits = cache_hits(cache);
+  const unsigned misses = cache_misses(cache);
+  printf("Cache: %u hit%s, %u miss%s\n", hits, hits == 1 ? "" : "s", misses, misses == 1 ? "" : "es");
+}
+
+// Assemble and link in this process, with object records in memory.
+// Only an assemble-only build writes object files, apart from the cache.
+static void build(const OPTIONS* opt) {
+  PROFILE* profile = new_profile();
+
+  ASM_SETTINGS asm_settings;
+  init_asm_options(opt, &asm_settings);
+
+  const int format = opt->format ? format_by_name(opt->format) : COM_FORMAT;
+  const char* output_name = opt->output_name ? opt->output_name : default_output_name(format);
+  CACHE* cache = opt->cache_dir ? new_cache(opt->cache_dir) : NULL;
+  LINKER* linker = NULL;
+  if (!opt->assemble_only) {
+    LINK_SETTINGS link_settings;
+    init_link_options(opt, &link_settings);
+    linker = new_linker(output_name, &link_settings, profile);
+  }
+
+  for (unsigned i = 0; i < stringlist_count(opt->sources); i++) {
+    const char* s = stringlist_item(opt->sources, i);
+    OFILE* ofile = NULL;
+    if (asm_file(s)) {
+      char* key = cache ? cache_key(s, &asm_settings) : NULL;
+      STRINGLIST* incbins = new_stringlist();
+      ofile = assemble_module(opt, cache, key, s, &asm_settings, profile, incbins);
+      delete_stringlist(incbins);
+      efree(key);
+      if (opt->assemble_only) {
+        char* obj = opt->output_name ? estrdup(opt->output_name) : obj_name(s);
+        save_object_file(ofile, obj);
+        efree(obj);
+      }
+    }
+    else if (obj_file(s)) {
+      if (linker)
+        ofile = load_object_file(s);
+    }
+    else
+      fatal("unexpected file type: %s\n", s);
+
+    if (linker && ofile)
+      link_module(linker, ofile, s);
+    delete_ofile(ofile);
+  }
+
+  if (cache) {
+    report_cache(cache);
+    delete_cache(cache);
+  }
+
+  if (linker) {
+    if (opt->verbose)
+      printf("Link %s\n", output_name);
+    TRACE_BEGIN("link");
+    link_image(linker);
+    output_program(linker, format, output_name);
+    TRACE_END();
+    delete_linker(linker);
+  }
+
+  delete_profile(profile);
+}
+
+// An input of --watch, with its object records kept between builds.
+typedef struct {
+  const char* name;
+  char* key;      // of the content the records are from, or NULL if none yet
+  OFILE* ofile;
+  STRINGLIST* incbins;  // files included by INCBIN in the records
+  char* incbins_key;    // of their content
+} MODULE;
+
+typedef struct {
+  const OPTIONS* opt;
+  ASM_SETTINGS asm_settings;
+  LINK_SETTINGS link_settings;
+  int format;
+  const char* output_name;
+  CACHE* cache;
+  MODULE* modules;
+  unsigned count;
+  WATCHER* watcher;
+  unsigned changed;  // modules reloaded by the last build
+  bool stale;        // program not output since modules were reloaded
+  // of the build in progress, freed after it even if it fails
+  PROFILE* profile;
+  char* key;
+  STRINGLIST* incbins;
+  LINKER* linker;
+} WATCH;
+
+// Whether the source and the files it includes by INCBIN have the content
+// the module's records are from, given the key of the source.
+static bool unchanged(const MODULE* m, const char* key) {
+  if (m->key == NULL || strcmp(key, m->key) != 0)
+    return false;
+  char* incbins_key = cache_files_key(m->incbins);
+  const bool same = strcmp(incbins_key, m->incbins_key) == 0;
+  efree(incbins_key);
+  return same;
+}
+
+// Reload the modules whose content has changed, and relink if any has,
+// or if the program has not been output since one did.
+// Run as a job, so that an error ends only this build.
+static void rebuild(void* arg) {
+  WATCH* w = arg;
+  const OPTIONS* opt = w->opt;
+  w->profile = new_profile();
+
+  for (unsigned i = 0; i < w->count; i++) {
+    MODULE* m = &w->modules[i];
+    w->key = cache_key(m->name, &w->asm_settings);
+    if (unchanged(m, w->key)) {
+      efree(w->key);
+      w->key = NULL;
+      continue;
+    }
+    w->incbins = new_stringlist();
+    OFILE* ofile;
+    if (asm_file(m->name))
+      ofile = assemble_module(opt, w->cache, w->key, m->name, &w->asm_settings, w->profile, w->incbins);
+    else {
+      if (opt->verbose)
+        printf("Load %s\n", m->name);
+      ofile = load_object_file(m->name);
+    }
+    delete_ofile(m->ofile);
+    m->ofile = ofile;
+    efree(m->key);
+    m->key = w->key;
+    w->key = NULL;
+    delete_stringlist(m->incbins);
+    m->incbins = w->incbins;
+    w->incbins = NULL;
+    efree(m->incbins_key);
+    m->incbins_key = cache_files_key(m->incbins);
+    watch_files(w->watcher, m->incbins);
+    w->changed++;
+    w->stale = true;
+  }
+
+  if (w->stale) {
+    if (opt->verbose)
+      printf("Link %s\n", w->output_name);
+    w->linker = new_linker(w->output_name, &w->link_settings, w->profile);
+    for (unsigned i = 0; i < w->count; i++)
+      link_module(w->linker, w->modules[i].ofile, w->modules[i].name);
+    link_image(w->linker);
+    output_program(w->linker, w->format, w->output_name);
+    w->stale = false;
+  }
+}
+
+static void end_build(WATCH* w) {
+  delete_linker(w->linker);
+  w->linker = NULL;
+  efree(w->key);
+  w->key = NULL;
+  delete_stringlist(w->incbins);
+  w->incbins = NULL;
+  delete_profile(w->profile);
+  w->profile = NULL;
+}
+
+// Build, then rebuild whenever an input is written, until interrupted.
+// The object records of unchanged modules are kept in memory, and the
+// keyword and instruction tables are initialised once for all builds.
+static void watch(const OPTIONS* opt) {
+  WATCH w;
+  w.opt = opt;
+  init_asm_options(opt, &w.asm_settings);
+  init_link_options(opt, &w.link_settings);
+  w.format = opt->format ? format_by_name(opt->format) : COM_FORMAT;
+  w.output_name = opt->output_name ? opt->output_name : default_output_name(w.format);
+  w.cache = opt->cache_dir ? new_cache(opt->cache_dir) : NULL;
+  w.count = stringlist_count(opt->sources);
+  w.modules = ecalloc(w.count * sizeof w.modules[0]);
+  w.stale = false;
+  w.profile = NULL;
+  w.key = NULL;
+  w.incbins = NULL;
+  w.linker = NULL;
+  for (unsigned i = 0; i < w.count; i++) {
+    const char* s = stringlist_item(opt->sources, i);
+    if (!asm_file(s) && !obj_file(s))
+      fatal("unexpected file type: %s\n", s);
+    w.modules[i].name = s;
+  }
+
+  // watching from before the first build, so that no change is missed;
+  // the files included by INCBIN are watched once they are known
+  w.watcher = new_watcher(opt->sources);
+
+  for (;;) {
+    TIMER timer;
+    start_timer(&timer);
+    w.changed = 0;
+    // after a failure the modules not reloaded, or the program, are built again
+    const bool relink = w.stale;
+    const bool ok = run_job(rebuild, &w, NULL);
+    end_build(&w);
+    stop_timer(&timer);
+    if (!ok)
+      printf("Build failed\n");
+    else if (w.changed || relink)
+      printf("Built %s: %u module%s reloaded in %lld ms\n", w.output_name,
+             w.changed, w.changed == 1 ? "" : "s", elapsed_usec(&timer) / 1000);
+    if (w.cache && (!ok || w.changed))
+      report_cache(w.cache);
+    fflush(stdout);
+    wait_for_change(w.watcher);
+  }
+}
 
 static STRINGLIST* obtain_objects(const OPTIONS* opt) {
   STRINGLIST* objects = new_stringlist();
@@ -114,7 +395,11 @@ static char* assemble(const OPTIONS* opt, const char* name) {
   if (opt->case_sensitive)
     extend_string(&str, " --case-sensitive");
 
+  char* trace = child_trace(opt, &str);
+  TRACE_BEGIN("assemble %s", name);
   int r = system(estring_text(&str));
+  merge_child_trace(trace);
+  TRACE_END();
   if (opt->verbose)
     printf("Exit code: %d\n", r);
   if (r)
@@ -160,7 +445,11 @@ static void link(const OPTIONS* opt, const STRINGLIST* objects) {
   if (opt->case_sensitive)
     extend_string(&str, " --case-sensitive");
 
+  char* trace = child_trace(opt, &str);
+  TRACE_BEGIN("link");
   int r = system(estring_text(&str));
+  merge_child_trace(trace);
+  TRACE_END();
   if (opt->verbose)
     printf("Exit code: %d\n", r);
   if (r)
@@ -169,6 +458,32 @@ static void link(const OPTIONS* opt, const STRINGLIST* objects) {
   deinit_estring(&str);
 }
 
+// If tracing, ask the tool to write a trace of its own, returning its name.
+static char* child_trace(const OPTIONS* opt, ESTRING* command) {
+#ifdef TRACE_EVENTS
+  static unsigned jobs;
+  if (opt->trace_name) {
+    char* name = emalloc(strlen(opt->trace_name) + 16);
+    sprintf(name, "%s.%u", opt->trace_name, ++jobs);
+    extend_string(command, " --trace ");
+    extend_string(command, name);
+    return name;
+  }
+#else
+  (void) opt;
+  (void) command;
+#endif
+  return NULL;
+}
+
+// Add the events of a tool's trace to our own.
+static void merge_child_trace(char* name) {
+  if (name) {
+    TRACE_MERGE(name);
+    efree(name);
+  }
+}
+
 static bool file_type(const char* name, const char* ext3, const char* ext1) {
   assert(name != NULL);
   const size_t len = strlen(name);
@@ -267,15 +582,23 @@ CuSuite* basl_test_suite(void) {
 }
 
 extern CuSuite* estring_test_suite(void);
-extern CuSuite* options_test_suite(void);
+extern CuSuite* driver_options_test_suite(void);
+extern CuSuite* cache_test_suite(void);
+#ifdef TRACE_EVENTS
+extern CuSuite* trace_test_suite(void);
+#endif
 
 void RunAllTests(void) {
   CuString *output = CuStringNew();
   CuSuite* suite = CuSuiteNew();
 
   CuSuiteAddSuite(suite, estring_test_suite());
-  CuSuiteAddSuite(suite, options_test_suite());
+  CuSuiteAddSuite(suite, driver_options_test_suite());
   CuSuiteAddSuite(suite, basl_test_suite());
+  CuSuiteAddSuite(suite, cache_test_suite());
+#ifdef TRACE_EVENTS
+  CuSuiteAddSuite(suite, trace_test_suite());
+#endif
 
   CuSuiteRun(suite);
   CuSuiteSummary(suite, output);
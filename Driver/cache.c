@@ -0,0 +1,406 @@
+// Basic Assembler
+// Copyright (c) 2022-24 Nigel Perks
+// Build cache: object records of sources assembled before, by content hash.
+// Each entry is an object file named by its key, with a list of the files
+// the source includes by INCBIN and the hash of their contents, which must
+// match on lookup. Each file is written under a temporary name and then
+// renamed, the object file last, and the object file of an entry replaced
+// is removed first, so that an interrupted build cannot leave a partial
+// entry, or records with another list, to be found by a later one.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#define mkdir(dir, mode) _mkdir(dir)
+#define rmdir _rmdir
+#else
+#include <unistd.h>
+#endif
+#include "buildid.h"
+#include "cache.h"
+#include "dirlist.h"
+#include "utils.h"
+
+// Changed when the key or the entries change meaning.
+#define CACHE_FORMAT "basl cache 2"
+
+#define KEY_DIGITS (16)
+
+struct cache {
+  char* dir;
+  unsigned hits;
+  unsigned misses;
+};
+
+CACHE* new_cache(const char* dir) {
+  assert(dir != NULL);
+  if (!is_directory(dir) && mkdir(dir, 0777) != 0 && !is_directory(dir))
+    fatal("cannot create cache directory: %s\n", dir);
+  CACHE* cache = ecalloc(sizeof *cache);
+  cache->dir = estrdup(dir);
+  return cache;
+}
+
+void delete_cache(CACHE* cache) {
+  if (cache) {
+    efree(cache->dir);
+    efree(cache);
+  }
+}
+
+// 64-bit FNV-1a.
+#define FNV_OFFSET (0xcbf29ce484222325ULL)
+#define FNV_PRIME (0x100000001b3ULL)
+
+static QWORD hash_bytes(QWORD h, const void* p, size_t size) {
+  const BYTE* b = p;
+  for (size_t i = 0; i < size; i++) {
+    h ^= b[i];
+    h *= FNV_PRIME;
+  }
+  return h;
+}
+
+// Strings are hashed with their terminators, so that adjacent ones cannot run together.
+static QWORD hash_string(QWORD h, const char* s) {
+  return hash_bytes(h, s, strlen(s) + 1);
+}
+
+static QWORD hash_unsigned(QWORD h, unsigned long n) {
+  char buf[32];
+  sprintf(buf, "%lu", n);
+  return hash_string(h, buf);
+}
+
+static QWORD hash_stream(QWORD h, FILE* fp, const char* name) {
+  BYTE buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof buf, fp)) > 0)
+    h = hash_bytes(h, buf, n);
+  if (ferror(fp))
+    fatal("error reading %s\n", name);
+  return h;
+}
+
+static char* key_text(QWORD h) {
+  char* key = emalloc(KEY_DIGITS + 1);
+  sprintf(key, "%016llx", h);
+  return key;
+}
+
+// Length of the directory part of the path, with its final separator.
+static size_t dir_length(const char* path) {
+  size_t len = 0;
+  for (size_t i = 0; path[i]; i++) {
+    if (path[i] == '/' || path[i] == '\\')
+      len = i + 1;
+  }
+  return len;
+}
+
+char* cache_key(const char* source_name, const ASM_SETTINGS* settings) {
+  assert(source_name != NULL);
+  assert(settings != NULL);
+
+  QWORD h = FNV_OFFSET;
+  h = hash_string(h, CACHE_FORMAT);
+  h = hash_string(h, BASM_BUILD_ID);
+  h = hash_unsigned(h, OBJECT_FORMAT_VERSION);
+  h = hash_unsigned(h, settings->case_sensitive);
+  h = hash_unsigned(h, settings->max_errors);
+  // INCBIN paths are found from the directory of the source
+  h = hash_bytes(hash_bytes(h, source_name, dir_length(source_name)), "", 1);
+
+  FILE* fp = efopen(source_name, "rb", "reading source");
+  h = hash_stream(h, fp, source_name);
+  fclose(fp);
+
+  return key_text(h);
+}
+
+char* cache_files_key(const STRINGLIST* files) {
+  assert(files != NULL);
+
+  QWORD h = FNV_OFFSET;
+  for (unsigned i = 0; i < stringlist_count(files); i++) {
+    const char* name = stringlist_item(files, i);
+    h = hash_string(h, name);
+    FILE* fp = fopen(name, "rb");
+    if (fp) {
+      h = hash_string(hash_stream(h, fp, name), "present");
+      fclose(fp);
+    }
+    else
+      h = hash_string(h, "missing");
+  }
+  return key_text(h);
+}
+
+static char* entry_name(const CACHE* cache, const char* key, const char* ext) {
+  const size_t len = strlen(cache->dir);
+  char* name = emalloc(len + 1 + strlen(key) + strlen(ext) + 1);
+  strcpy(name, cache->dir);
+  if (len > 0 && cache->dir[len - 1] != '/' && cache->dir[len - 1] != '\\')
+    strcat(name, "/");
+  strcat(name, key);
+  strcat(name, ext);
+  return name;
+}
+
+// The files listed by the entry, if their contents have the hash stored with them.
+static bool read_incbins(const char* name, STRINGLIST* files) {
+  FILE* fp = fopen(name, "r");
+  if (fp == NULL)
+    return false;
+
+  char key[KEY_DIGITS + 2];
+  char line[4096];
+  bool valid = fgets(key, sizeof key, fp) && strlen(key) == KEY_DIGITS + 1 && key[KEY_DIGITS] == '\n';
+  while (valid && fgets(line, sizeof line, fp)) {
+    const size_t len = strlen(line);
+    // a line too long for the buffer was not written by us
+    valid = len > 1 && line[len - 1] == '\n';
+    line[len - 1] = '\0';
+    append_string(files, line);
+  }
+  if (ferror(fp))
+    valid = false;
+  fclose(fp);
+
+  if (valid) {
+    key[KEY_DIGITS] = '\0';
+    char* current = cache_files_key(files);
+    valid = strcmp(key, current) == 0;
+    efree(current);
+  }
+  return valid;
+}
+
+OFILE* cache_lookup(CACHE* cache, const char* key, STRINGLIST* incbins) {
+  assert(cache != NULL);
+  assert(key != NULL);
+  assert(incbins != NULL);
+
+  char* name = entry_name(cache, key, ".obj");
+  char* list = entry_name(cache, key, ".inc");
+  STRINGLIST* files = new_stringlist();
+  OFILE* ofile = NULL;
+  const bool valid = read_incbins(list, files);
+  efree(list);
+  FILE* fp = valid ? fopen(name, "rb") : NULL;
+  if (fp) {
+    fclose(fp);
+    for (unsigned i = 0; i < stringlist_count(files); i++)
+      append_string(incbins, stringlist_item(files, i));
+    delete_stringlist(files);
+    ofile = load_object_file(name);
+    cache->hits++;
+  }
+  else {
+    delete_stringlist(files);
+    cache->misses++;
+  }
+  efree(name);
+  return ofile;
+}
+
+static void write_incbins(const char* name, const STRINGLIST* files) {
+  FILE* fp = efopen(name, "w", "writing");
+  char* key = cache_files_key(files);
+  fprintf(fp, "%s\n", key);
+  efree(key);
+  for (unsigned i = 0; i < stringlist_count(files); i++)
+    fprintf(fp, "%s\n", stringlist_item(files, i));
+  if (fclose(fp) != 0)
+    fatal("error writing %s\n", name);
+}
+
+static void replace_file(const char* temp, const char* name) {
+  // rename does not replace an existing file everywhere
+  remove(name);
+  if (rename(temp, name) != 0)
+    fatal("cannot write cache entry: %s\n", name);
+}
+
+void cache_store(CACHE* cache, const char* key, const OFILE* ofile, const STRINGLIST* incbins) {
+  assert(cache != NULL);
+  assert(key != NULL);
+  assert(ofile != NULL);
+  assert(incbins != NULL);
+
+  char* temp = entry_name(cache, key, ".tmp");
+  char* name = entry_name(cache, key, ".obj");
+  char* list = entry_name(cache, key, ".inc");
+  remove(name);
+  write_incbins(temp, incbins);
+  replace_file(temp, list);
+  save_object_file(ofile, temp);
+  replace_file(temp, name);
+  efree(list);
+  efree(name);
+  efree(temp);
+}
+
+unsigned cache_hits(const CACHE* cache) {
+  assert(cache != NULL);
+  return cache->hits;
+}
+
+unsigned cache_misses(const CACHE* cache) {
+  assert(cache != NULL);
+  return cache->misses;
+}
+
+#ifdef UNIT_TEST
+
+#include "CuTest.h"
+
+static void write_file(const char* name, const char* text) {
+  FILE* fp = efopen(name, "wb", "writing");
+  fputs(text, fp);
+  fclose(fp);
+}
+
+static void test_cache_key(CuTest* tc) {
+  const char* const source = "cache_test.asm";
+  ASM_SETTINGS settings;
+  init_asm_settings(&settings);
+
+  write_file(source, "\tIDEAL\n\tEND\n");
+  char* key1 = cache_key(source, &settings);
+  CuAssertIntEquals(tc, KEY_DIGITS, strlen(key1));
+  char* key2 = cache_key(source, &settings);
+  CuAssertStrEquals(tc, key1, key2);
+  efree(key2);
+
+  settings.case_sensitive = true;
+  key2 = cache_key(source, &settings);
+  CuAssertTrue(tc, strcmp(key1, key2) != 0);
+  efree(key2);
+
+  init_asm_settings(&settings);
+  settings.max_errors = 5;
+  key2 = cache_key(source, &settings);
+  CuAssertTrue(tc, strcmp(key1, key2) != 0);
+  efree(key2);
+
+  init_asm_settings(&settings);
+  write_file(source, "\tIDEAL\n\tEND \n");
+  key2 = cache_key(source, &settings);
+  CuAssertTrue(tc, strcmp(key1, key2) != 0);
+  efree(key2);
+
+  // the same source in another directory includes other files
+  const char* const other = "cache_test_dir/cache_test.asm";
+  mkdir("cache_test_dir", 0777);
+  write_file(source, "\tIDEAL\n\tEND\n");
+  write_file(other, "\tIDEAL\n\tEND\n");
+  key2 = cache_key(other, &settings);
+  CuAssertTrue(tc, strcmp(key1, key2) != 0);
+  efree(key2);
+  remove(other);
+  rmdir("cache_test_dir");
+
+  efree(key1);
+  remove(source);
+}
+
+static void test_cache_store(CuTest* tc) {
+  const char* const dir = "cache_test_dir";
+  const char* const key = "0123456789abcdef";
+  CACHE* cache = new_cache(dir);
+  STRINGLIST* incbins = new_stringlist();
+
+  CuAssertPtrEquals(tc, NULL, cache_lookup(cache, key, incbins));
+  CuAssertIntEquals(tc, 0, cache_hits(cache));
+  CuAssertIntEquals(tc, 1, cache_misses(cache));
+
+  OFILE* ofile = new_ofile();
+  emit_object_signal(ofile, OBJ_BEGIN_SEGMENT);
+  emit_object_word(ofile, OBJ_ORDINAL, 0);
+  emit_object_data(ofile, OBJ_NAME, (const BYTE*) "CODE", 4);
+  emit_object_signal(ofile, OBJ_END_SEGMENT);
+  cache_store(cache, key, ofile, incbins);
+  // replacing an entry
+  cache_store(cache, key, ofile, incbins);
+
+  OFILE* cached = cache_lookup(cache, key, incbins);
+  CuAssertPtrNotNull(tc, cached);
+  CuAssertIntEquals(tc, 1, cache_hits(cache));
+  CuAssertIntEquals(tc, 1, cache_misses(cache));
+  CuAssertIntEquals(tc, 0, stringlist_count(incbins));
+  CuAssertIntEquals(tc, ofile->used, cached->used);
+  for (unsigned i = 0; i < ofile->used; i++)
+    CuAssertTrue(tc, same_orec(ofile->recs + i, cached->recs + i));
+  delete_ofile(cached);
+  delete_ofile(ofile);
+  delete_stringlist(incbins);
+
+  char* name = entry_name(cache, key, ".obj");
+  remove(name);
+  efree(name);
+  name = entry_name(cache, key, ".inc");
+  remove(name);
+  efree(name);
+  delete_cache(cache);
+  rmdir(dir);
+}
+
+// An entry is found only while the files included by INCBIN are unchanged.
+static void test_cache_incbins(CuTest* tc) {
+  const char* const dir = "cache_test_dir";
+  const char* const key = "0123456789abcdef";
+  const char* const bin = "cache_test.bin";
+  CACHE* cache = new_cache(dir);
+  STRINGLIST* incbins = new_stringlist();
+
+  write_file(bin, "ABC");
+  append_string(incbins, bin);
+  OFILE* ofile = new_ofile();
+  emit_object_signal(ofile, OBJ_BEGIN_SEGMENT);
+  emit_object_signal(ofile, OBJ_END_SEGMENT);
+  cache_store(cache, key, ofile, incbins);
+  delete_ofile(ofile);
+  delete_stringlist(incbins);
+
+  incbins = new_stringlist();
+  ofile = cache_lookup(cache, key, incbins);
+  CuAssertPtrNotNull(tc, ofile);
+  CuAssertIntEquals(tc, 1, stringlist_count(incbins));
+  CuAssertStrEquals(tc, bin, stringlist_item(incbins, 0));
+  delete_ofile(ofile);
+  delete_stringlist(incbins);
+
+  write_file(bin, "ABD");
+  incbins = new_stringlist();
+  CuAssertPtrEquals(tc, NULL, cache_lookup(cache, key, incbins));
+  CuAssertIntEquals(tc, 0, stringlist_count(incbins));
+  remove(bin);
+  CuAssertPtrEquals(tc, NULL, cache_lookup(cache, key, incbins));
+  CuAssertIntEquals(tc, 1, cache_hits(cache));
+  CuAssertIntEquals(tc, 2, cache_misses(cache));
+  delete_stringlist(incbins);
+
+  char* name = entry_name(cache, key, ".obj");
+  remove(name);
+  efree(name);
+  name = entry_name(cache, key, ".inc");
+  remove(name);
+  efree(name);
+  delete_cache(cache);
+  rmdir(dir);
+}
+
+CuSuite* cache_test_suite(void) {
+  CuSuite* suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_cache_key);
+  SUITE_ADD_TEST(suite, test_cache_store);
+  SUITE_ADD_TEST(suite, test_cache_incbins);
+  return suite;
+}
+
+#endif // UNIT_TEST
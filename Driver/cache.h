@@ -0,0 +1,36 @@
+// Basic Assembler
+// Copyright (c) 2022-24 Nigel Perks
+// Build cache: object records of sources assembled before, by content hash.
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "assembler.h"
+#include "object.h"
+#include "stringlist.h"
+
+typedef struct cache CACHE;
+
+// Use the directory, creating it if necessary.
+CACHE* new_cache(const char* dir);
+void delete_cache(CACHE*);
+
+// Hash of the source bytes and directory, the settings affecting its object
+// records, the object format and the build of the assembler sources, as 16
+// hex digits, which the caller frees.
+char* cache_key(const char* source_name, const ASM_SETTINGS*);
+
+// Hash of the names and contents of the files, a missing one counted as such,
+// as 16 hex digits, which the caller frees.
+char* cache_files_key(const STRINGLIST* files);
+
+// The object records cached under the key, appending to incbins the files
+// included by INCBIN that they were assembled from; or NULL, if there are
+// none or the content of one of those files has changed.
+OFILE* cache_lookup(CACHE*, const char* key, STRINGLIST* incbins);
+void cache_store(CACHE*, const char* key, const OFILE*, const STRINGLIST* incbins);
+
+unsigned cache_hits(const CACHE*);
+unsigned cache_misses(const CACHE*);
+
+#endif // CACHE_H
@@ -0,0 +1,71 @@
+// Basic Assembler
+// Copyright (c) 2022-24 Nigel Perks
+// Build-time generator of the build identifier: a hash of the sources of
+// the assembler, so that cached object records are not reused from a build
+// which could have produced different ones.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "utils.h"
+
+// 64-bit FNV-1a, as the cache keys.
+#define FNV_OFFSET (0xcbf29ce484222325ULL)
+#define FNV_PRIME (0x100000001b3ULL)
+
+static QWORD hash_bytes(QWORD h, const BYTE* b, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    h ^= b[i];
+    h *= FNV_PRIME;
+  }
+  return h;
+}
+
+// The content of the file, followed by its size, so that the contents of
+// files in turn cannot run together.
+static QWORD hash_file(QWORD h, const char* name) {
+  FILE* fp = fopen(name, "rb");
+  if (fp == NULL)
+    fatal("cannot open %s\n", name);
+  BYTE buf[4096];
+  size_t n;
+  unsigned long size = 0;
+  while ((n = fread(buf, 1, sizeof buf, fp)) > 0) {
+    h = hash_bytes(h, buf, n);
+    size += (unsigned long) n;
+  }
+  if (ferror(fp))
+    fatal("error reading %s\n", name);
+  fclose(fp);
+
+  char text[32];
+  const int len = sprintf(text, "%lu", size);
+  return hash_bytes(h, (const BYTE*) text, len + 1);
+}
+
+int main(int argc, char* argv[]) {
+  progname = "genbuildid";
+
+  if (argc < 3) {
+    fprintf(stderr, "usage: genbuildid output-header source...\n");
+    return EXIT_FAILURE;
+  }
+
+  QWORD h = FNV_OFFSET;
+  for (int i = 2; i < argc; i++)
+    h = hash_file(h, argv[i]);
+
+  FILE* fp = fopen(argv[1], "w");
+  if (fp == NULL)
+    fatal("cannot open %s\n", argv[1]);
+
+  fprintf(fp, "// Generated by genbuildid from the assembler sources: do not edit.\n\n"
+              "#ifndef BUILDID_H\n"
+              "#define BUILDID_H\n\n"
+              "#define BASM_BUILD_ID \"%016llx\"\n\n"
+              "#endif // BUILDID_H\n", h);
+
+  if (fclose(fp) != 0)
+    fatal("error writing %s\n", argv[1]);
+
+  return EXIT_SUCCESS;
+}
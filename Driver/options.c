@@ -8,13 +8,13 @@
 #include "options.h"
 #include "utils.h"
 
-OPTIONS* new_options(void) {
+OPTIONS* new_driver_options(void) {
   OPTIONS* opt = ecalloc(sizeof *opt);
   opt->sources = new_stringlist();
   return opt;
 }
 
-void delete_options(OPTIONS* opt) {
+void delete_driver_options(OPTIONS* opt) {
   if (opt) {
     efree(opt->program_dir);
     delete_stringlist(opt->sources);
@@ -36,14 +36,20 @@ static void usage(void) {
 #endif
   puts("  -v         verbose");
   putchar('\n');
+  puts("  --cache DIR    reuse object records of unchanged sources, cached in DIR");
   puts("  --case-sensitive");
+  puts("  --spawn        run bas and blink as programs, through object files");
+  puts("  --watch        rebuild when inputs change, reassembling only those changed");
+#ifdef TRACE_EVENTS
+  puts("  --trace FILE   write trace events of all jobs to FILE (Chrome JSON)");
+#endif
   exit(EXIT_SUCCESS);
 }
 
 static char* file_dir(const char* path);
 
-OPTIONS* process_argv(int argc, char* argv[]) {
-  OPTIONS* opt = new_options();
+OPTIONS* process_driver_argv(int argc, char* argv[]) {
+  OPTIONS* opt = new_driver_options();
   opt->program_dir = file_dir(argv[0]);
   int i;
   for (i = 1; i < argc; i++) {
@@ -58,10 +64,28 @@ OPTIONS* process_argv(int argc, char* argv[]) {
       if (strcmp(arg, "-?") == 0 || strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0)
         usage();
       else if (arg[1] == '-') {
-        if (strcmp(arg+2, "case-sensitive") == 0)
+        if (strcmp(arg+2, "cache") == 0) {
+          if (++i < argc)
+            opt->cache_dir = argv[i];
+          else
+            fatal("cache directory name missing\n");
+        }
+        else if (strcmp(arg+2, "case-sensitive") == 0)
           opt->case_sensitive = true;
         else if (strcmp(arg+2, "case-insensitive") == 0)
           opt->case_sensitive = false;
+        else if (strcmp(arg+2, "spawn") == 0)
+          opt->spawn = true;
+        else if (strcmp(arg+2, "watch") == 0)
+          opt->watch = true;
+#ifdef TRACE_EVENTS
+        else if (strcmp(arg+2, "trace") == 0) {
+          if (++i < argc)
+            opt->trace_name = argv[i];
+          else
+            fatal("trace file name missing\n");
+        }
+#endif
         else
           fatal("unknown option: %s\n", arg);
       }
@@ -105,6 +129,14 @@ OPTIONS* process_argv(int argc, char* argv[]) {
     fatal("source file name expected\n");
   if (opt->assemble_only && opt->output_name && stringlist_count(opt->sources) > 1)
     fatal("attempt to assemble multiple source files to one object file\n");
+  if (opt->spawn && opt->cache_dir)
+    fatal("--cache cannot be used with --spawn\n");
+  if (opt->watch && (opt->spawn || opt->assemble_only))
+    fatal("--watch cannot be used with --spawn or -s\n");
+#ifdef TRACE_EVENTS
+  if (opt->watch && opt->trace_name)
+    fatal("--watch cannot be used with --trace\n");
+#endif
   return opt;
 }
 
@@ -148,7 +180,7 @@ static void test_file_dir(CuTest* tc) {
   efree(t);
 }
 
-CuSuite* options_test_suite(void) {
+CuSuite* driver_options_test_suite(void) {
   CuSuite* suite = CuSuiteNew();
   SUITE_ADD_TEST(suite, test_file_dir);
   return suite;
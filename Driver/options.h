@@ -23,11 +23,17 @@ typedef struct {
   bool report_memory;
   unsigned verbose;
   bool case_sensitive;
+  bool spawn;  // run bas and blink, through object files on disk
+  const char* cache_dir;  // of object records by source content, if any
+  bool watch;  // rebuild when inputs change, until interrupted
+#ifdef TRACE_EVENTS
+  const char* trace_name;
+#endif
 } OPTIONS;
 
-OPTIONS* new_options(void);
-void delete_options(OPTIONS*);
+OPTIONS* new_driver_options(void);
+void delete_driver_options(OPTIONS*);
 
-OPTIONS* process_argv(int argc, char* argv[]);
+OPTIONS* process_driver_argv(int argc, char* argv[]);
 
 #endif // OPTIONS_H
@@ -0,0 +1,244 @@
+// Basic Assembler
+// Copyright (c) 2022-24 Nigel Perks
+// Waiting for input files to change: with inotify on Linux, otherwise by
+// polling their sizes and modification times. Under inotify the directories
+// of the files are watched, because editors often save a file by writing
+// a new one and renaming it over the old.
+
+#if !defined(_WIN32) && !defined(__linux__)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#ifdef __linux__
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#else
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <time.h>
+#endif
+#endif
+#include "watcher.h"
+#include "utils.h"
+
+// Time for the writes of one save to settle.
+#define SETTLE_MSEC (50)
+
+#ifdef __linux__
+
+typedef struct {
+  int wd;       // of the directory
+  char* name;   // within the directory
+} WATCHED;
+
+struct watcher {
+  int fd;
+  unsigned count;
+  WATCHED* files;
+};
+
+WATCHER* new_watcher(const STRINGLIST* files) {
+  assert(files != NULL);
+
+  WATCHER* w = ecalloc(sizeof *w);
+  w->fd = inotify_init1(IN_CLOEXEC);
+  if (w->fd < 0)
+    fatal("cannot watch files: %s\n", strerror(errno));
+  watch_files(w, files);
+  return w;
+}
+
+static bool watching(const WATCHER* w, int wd, const char* name) {
+  for (unsigned i = 0; i < w->count; i++) {
+    if (w->files[i].wd == wd && strcmp(w->files[i].name, name) == 0)
+      return true;
+  }
+  return false;
+}
+
+void watch_files(WATCHER* w, const STRINGLIST* files) {
+  assert(w != NULL);
+  assert(files != NULL);
+
+  for (unsigned i = 0; i < stringlist_count(files); i++) {
+    const char* path = stringlist_item(files, i);
+    const char* slash = strrchr(path, '/');
+    const char* name = slash ? slash + 1 : path;
+    char* dir = slash ? estrdup(path) : estrdup(".");
+    if (slash)
+      dir[slash == path ? 1 : slash - path] = '\0';
+    // a directory already watched has the same descriptor
+    const int wd = inotify_add_watch(w->fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0)
+      fatal("cannot watch directory: %s: %s\n", dir, strerror(errno));
+    efree(dir);
+    if (!watching(w, wd, name)) {
+      w->files = erealloc(w->files, (w->count + 1) * sizeof w->files[0]);
+      w->files[w->count].wd = wd;
+      w->files[w->count].name = estrdup(name);
+      w->count++;
+    }
+  }
+}
+
+void delete_watcher(WATCHER* w) {
+  if (w) {
+    close(w->fd);
+    for (unsigned i = 0; i < w->count; i++)
+      efree(w->files[i].name);
+    efree(w->files);
+    efree(w);
+  }
+}
+
+static bool watched(const WATCHER* w, const struct inotify_event* ev) {
+  if (ev->len == 0)
+    return false;
+  for (unsigned i = 0; i < w->count; i++) {
+    if (w->files[i].wd == ev->wd && strcmp(w->files[i].name, ev->name) == 0)
+      return true;
+  }
+  return false;
+}
+
+static bool events_ready(const WATCHER* w, int msec) {
+  struct pollfd p = { w->fd, POLLIN, 0 };
+  return poll(&p, 1, msec) > 0;
+}
+
+void wait_for_change(WATCHER* w) {
+  assert(w != NULL);
+
+  _Alignas(struct inotify_event) char buf[4096];
+  bool changed = false;
+
+  while (!changed || events_ready(w, SETTLE_MSEC)) {
+    const ssize_t len = read(w->fd, buf, sizeof buf);
+    if (len < 0) {
+      if (errno == EINTR)
+        continue;
+      fatal("error watching files: %s\n", strerror(errno));
+    }
+    for (const char* p = buf; p < buf + len; ) {
+      const struct inotify_event* ev = (const struct inotify_event*) p;
+      if (watched(w, ev))
+        changed = true;
+      p += sizeof *ev + ev->len;
+    }
+  }
+}
+
+#else
+
+#define POLL_MSEC (250)
+
+typedef struct {
+  bool exists;
+  time_t mtime;
+  long long size;
+} STAMP;
+
+struct watcher {
+  unsigned count;
+  char** names;
+  STAMP* stamps;
+};
+
+static STAMP stamp(const char* name) {
+  STAMP s = { false, 0, 0 };
+  struct stat st;
+  if (stat(name, &st) == 0) {
+    s.exists = true;
+    s.mtime = st.st_mtime;
+    s.size = st.st_size;
+  }
+  return s;
+}
+
+static bool same_stamp(const STAMP* s, const STAMP* t) {
+  return s->exists == t->exists && s->mtime == t->mtime && s->size == t->size;
+}
+
+WATCHER* new_watcher(const STRINGLIST* files) {
+  assert(files != NULL);
+
+  WATCHER* w = ecalloc(sizeof *w);
+  watch_files(w, files);
+  return w;
+}
+
+static bool watching(const WATCHER* w, const char* name) {
+  for (unsigned i = 0; i < w->count; i++) {
+    if (strcmp(w->names[i], name) == 0)
+      return true;
+  }
+  return false;
+}
+
+void watch_files(WATCHER* w, const STRINGLIST* files) {
+  assert(w != NULL);
+  assert(files != NULL);
+
+  for (unsigned i = 0; i < stringlist_count(files); i++) {
+    const char* name = stringlist_item(files, i);
+    if (!watching(w, name)) {
+      w->names = erealloc(w->names, (w->count + 1) * sizeof w->names[0]);
+      w->stamps = erealloc(w->stamps, (w->count + 1) * sizeof w->stamps[0]);
+      w->names[w->count] = estrdup(name);
+      w->stamps[w->count] = stamp(name);
+      w->count++;
+    }
+  }
+}
+
+void delete_watcher(WATCHER* w) {
+  if (w) {
+    for (unsigned i = 0; i < w->count; i++)
+      efree(w->names[i]);
+    efree(w->names);
+    efree(w->stamps);
+    efree(w);
+  }
+}
+
+static void sleep_msec(unsigned msec) {
+#ifdef _WIN32
+  Sleep(msec);
+#else
+  struct timespec t = { msec / 1000, (msec % 1000) * 1000000L };
+  nanosleep(&t, NULL);
+#endif
+}
+
+// Take new stamps, returning whether any file has changed.
+static bool restamp(WATCHER* w) {
+  bool changed = false;
+  for (unsigned i = 0; i < w->count; i++) {
+    const STAMP s = stamp(w->names[i]);
+    if (!same_stamp(&s, &w->stamps[i])) {
+      w->stamps[i] = s;
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+void wait_for_change(WATCHER* w) {
+  assert(w != NULL);
+
+  while (!restamp(w))
+    sleep_msec(POLL_MSEC);
+
+  do {
+    sleep_msec(SETTLE_MSEC);
+  } while (restamp(w));
+}
+
+#endif
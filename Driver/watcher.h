@@ -0,0 +1,23 @@
+// Basic Assembler
+// Copyright (c) 2022-24 Nigel Perks
+// Waiting for input files to change.
+
+#ifndef WATCHER_H
+#define WATCHER_H
+
+#include "stringlist.h"
+
+typedef struct watcher WATCHER;
+
+// Changes from the time of creation are seen.
+WATCHER* new_watcher(const STRINGLIST* files);
+void delete_watcher(WATCHER*);
+
+// Watch the files too, those not already watched, from now on.
+void watch_files(WATCHER*, const STRINGLIST* files);
+
+// Block until at least one of the files has been written or replaced.
+// Writes following closely are taken as part of the same change.
+void wait_for_change(WATCHER*);
+
+#endif // WATCHER_H
@@ -10,13 +10,22 @@
 #include "utils.h"
 #include "exeheader.h"
 #include "options.h"
-#include "fileutil.h"
 #include "dump.h"
 #include "loadexe.h"
 #include "interact.h"
+#include "dirlist.h"
+#include "batch.h"
+
+// The whole of an EXE file, read once; each part is dumped from the buffer.
+typedef struct {
+    BYTE* data;
+    FileSize size;
+} EXEFILE;
 
 static void help(void);
-static void dump_exe(const OPTIONS*);
+static bool dump_files(const OPTIONS*);
+static void* load_exe_file(const char* file_name);
+static FileSize dump_exe(const OPTIONS*, const EXEFILE*);
 static void compare_exe(const OPTIONS*);
 
 int main(int argc, char* argv[])
@@ -24,6 +33,7 @@ int main(int argc, char* argv[])
     progname = "exetool";
 
     OPTIONS* opt = parse_options(argc, argv);
+    int status = 0;
 
     if (opt->help)
       help();
@@ -32,14 +42,16 @@ int main(int argc, char* argv[])
       compare_exe(opt);
     else if (opt->interactive)
       interact(opt->file_name);
-    else
-      dump_exe(opt);
+    else if (!dump_files(opt))
+      status = EXIT_FAILURE;
+
+    delete_options(opt);
 
-    return 0;
+    return status;
 }
 
 static void help(void) {
-  puts("Usage: exetool [options] file");
+  puts("Usage: exetool [options] file|directory...");
   puts("       exetool -c file1 file2");
   putchar('\n');
   puts("  -?   help");
@@ -57,7 +69,118 @@ static void help(void) {
   exit(EXIT_FAILURE);
 }
 
-static void dump_exe(const OPTIONS* opt)
+typedef struct {
+    const OPTIONS* opt;
+    const EXEFILE* exe;
+    FileSize image_size;
+} DUMPING;
+
+static void dump_job(void* arg)
+{
+    DUMPING* d = arg;
+    d->image_size = dump_exe(d->opt, d->exe);
+}
+
+// Dump each named file, and each .exe file in each named directory, in order,
+// the files being read concurrently. A file that cannot be read or dumped is
+// reported and the batch goes on. A batch of several files is followed by a
+// summary. False if any file failed.
+static bool dump_files(const OPTIONS* opt)
+{
+    STRINGLIST* files = new_stringlist();
+    for (unsigned i = 0; i < stringlist_count(opt->files); i++)
+        append_files(files, stringlist_item(opt->files, i), ".exe");
+
+    const unsigned count = stringlist_count(files);
+    FileSize* image_sizes = emalloc((count ? count : 1) * sizeof image_sizes[0]);
+    bool* ok = emalloc((count ? count : 1) * sizeof ok[0]);
+    unsigned failed = 0;
+
+    for (unsigned first = 0; first < count; first += BATCH_CHUNK)
+    {
+        BATCH_FILE chunk[BATCH_CHUNK];
+        const unsigned n = load_batch(chunk, files, first, load_exe_file);
+        for (unsigned j = 0; j < n; j++)
+        {
+            const unsigned i = first + j;
+            if (count > 1)
+                printf("%sFILE: %s\n\n", i ? "\n" : "", chunk[j].name);
+            EXEFILE* exe = batch_result(&chunk[j]);
+            ok[i] = false;
+            if (exe)
+            {
+                DUMPING d = { opt, exe, 0 };
+                ok[i] = run_job(dump_job, &d, NULL);
+                image_sizes[i] = d.image_size;
+                efree(exe->data);
+                efree(exe);
+            }
+            if (!ok[i])
+                failed++;
+        }
+    }
+
+    if (count > 1)
+    {
+        puts("\nSUMMARY:");
+        for (unsigned i = 0; i < count; i++)
+        {
+            if (ok[i])
+                printf("%8lu image bytes  %s\n", image_sizes[i], stringlist_item(files, i));
+            else
+                printf("%20s  %s\n", "failed", stringlist_item(files, i));
+        }
+        printf("%u files", count);
+        if (failed)
+            printf(", %u failed", failed);
+        putchar('\n');
+    }
+
+    efree(ok);
+    efree(image_sizes);
+    delete_stringlist(files);
+    return failed == 0;
+}
+
+typedef struct {
+    const char* file_name;
+    FILE* fp;  // closed after the job
+    EXEFILE exe;
+} READING;
+
+static void read_job(void* arg)
+{
+    READING* r = arg;
+    r->exe.size = file_size(r->fp, r->file_name);
+    if (r->exe.size < sizeof (EXEHEADER))
+        fatal("file too small for EXE header\n");
+    r->exe.data = read_file(r->fp, r->exe.size);
+}
+
+static void* load_exe_file(const char* file_name)
+{
+    READING r = { file_name, fopen(file_name, "rb"), { NULL, 0 } };
+    if (r.fp == NULL)
+        fatal("cannot open file %s\n", file_name);
+    const bool ok = run_job(read_job, &r, error_stream());
+    fclose(r.fp);
+    if (!ok)
+        fail();
+
+    if (((const EXEHEADER*) r.exe.data)->exSignature != 0x5A4D)
+    {
+        efree(r.exe.data);
+        fatal("EXE signature not found\n");
+    }
+
+    EXEFILE* exe = emalloc(sizeof *exe);
+    *exe = r.exe;
+    return exe;
+}
+
+static void check_available(FileSize offset, FileSize size, FileSize actual_size);
+
+static FileSize dump_exe(const OPTIONS* opt, const EXEFILE* exe)
 {
     unsigned long header_padding_offset = 0;
     unsigned long relocations_offset = 0;
@@ -67,65 +190,54 @@ static void dump_exe(const OPTIONS* opt)
 
     unsigned long total_size = 0;
 
-    FILE* fp = fopen(opt->file_name, "rb");
-    if (fp == NULL)
-        fatal("cannot open file %s\n", opt->file_name);
-
-    FileSize actual_size = file_size(fp, opt->file_name);
-
-    EXEHEADER header;
-    fseek(fp, 0, SEEK_SET);
-    FileSize count = (FileSize) fread(&header, 1, sizeof header, fp);
-    if (count != sizeof header)
-        fatal("file too small for EXE header\n");
-    FileSize total_read = count;
-
-    if (header.exSignature != 0x5A4D)
-        fatal("EXE signature not found\n");
+    BYTE* const file = exe->data;
+    const FileSize actual_size = exe->size;
+    const EXEHEADER* header = (const EXEHEADER*) file;
+    FileSize total_read = sizeof *header;
 
-    print_exe_header(&header);
+    print_exe_header(header);
     putchar('\n');
 
     header_padding_offset = total_read;
-    if (header.exRelocItems > 0)
+    if (header->exRelocItems > 0)
     {
-        if (total_read < header.exRelocTable)
+        if (total_read < header->exRelocTable)
         {
             puts("PADDING BEFORE RELOCATION TABLE:");
-            const FileSize padding_size = header.exRelocTable - total_read;
-            BYTE* padding = read_file(fp, padding_size);
+            const FileSize padding_size = header->exRelocTable - total_read;
+            check_available(total_read, padding_size, actual_size);
+            dump_mem(file + total_read, header_padding_offset, padding_size);
             total_read += padding_size;
-            dump_mem(padding, header_padding_offset, padding_size);
             putchar('\n');
             putchar('\n');
-            efree(padding);
         }
 
         relocations_offset = total_read;
         puts("RELOCATION TABLE:");
-        for (unsigned i = 0; i < header.exRelocItems; i++)
+        check_available(total_read, header->exRelocItems * 4ul, actual_size);
+        for (unsigned i = 0; i < header->exRelocItems; i++)
         {
-            WORD w1 = getword(fp);
-            WORD w2 = getword(fp);
+            WORD w1 = read_word_le(file + total_read);
+            WORD w2 = read_word_le(file + total_read + 2);
             total_read += 4;
             printf("%04x:%04x\n", w2, w1);
         }
         putchar('\n');
     }
 
-    FileSize header_size = header.exHeaderSize * 16;
+    FileSize header_size = header->exHeaderSize * 16;
     if (total_read < header_size)
     {
         puts("REST OF HEADER:");
         FileSize sz = header_size - total_read;
-        BYTE* rest = read_file(fp, sz);
-        dump_mem(rest, total_read, sz);
+        check_available(total_read, sz, actual_size);
+        dump_mem(file + total_read, total_read, sz);
         putchar('\n');
         total_read += sz;
     }
 
     image_offset = total_read;
-    total_size = (header.exPages - 1) * 512 + header.exExtraBytes;
+    total_size = (header->exPages - 1) * 512 + header->exExtraBytes;
     if (image_offset > total_size)
         fatal("beyond total file size in header\n");
     image_size = total_size - image_offset;
@@ -134,9 +246,10 @@ static void dump_exe(const OPTIONS* opt)
 
     if (opt->image)
     {
-        BYTE* buf = read_file(fp, image_size);
+        check_available(total_read, image_size, actual_size);
+        const BYTE* buf = file + total_read;
         total_read += image_size;
-        count = dump_mem(buf, image_offset, image_size);
+        dump_mem(buf, image_offset, image_size);
         if (opt->extract_image)
         {
             FILE* img = fopen("IMAGE___.BIN", "wb");
@@ -147,13 +260,9 @@ static void dump_exe(const OPTIONS* opt)
                 fwrite(buf + 0x100, 1, image_size - 0x100, img);
             fclose(img);
         }
-        efree(buf);
     }
     else
-    {
-        fseek(fp, image_size, SEEK_CUR);
         total_read += image_size;
-    }
     putchar('\n');
 
     after_image_offset = total_read;
@@ -162,22 +271,26 @@ static void dump_exe(const OPTIONS* opt)
         puts("AFTER PROGRAM IMAGE:");
         assert(total_read <= actual_size);
         if (total_read < actual_size)
-        {
-            FileSize sz = actual_size - total_read;
-            BYTE* buf = read_file(fp, sz);
-            dump_mem(buf, total_read, sz);
-            efree(buf);
-        }
+            dump_mem(file + total_read, total_read, actual_size - total_read);
     }
 
-    fclose(fp);
-
     putchar('\n');
     printf("Actual file size:       %lxh = %lu\n", actual_size, actual_size);
     printf("Total size from header: %lxh = %lu\n", total_size, total_size);
     printf("Size of program image:  %lxh = %lu\n", image_size, image_size);
+
+    return image_size;
+}
+
+static void check_available(FileSize offset, FileSize size, FileSize actual_size)
+{
+    FileSize available = (offset < actual_size) ? actual_size - offset : 0;
+    if (size > available)
+        fatal("file out of data: reading %lu bytes, got %lu bytes\n", size, available);
 }
 
+static BOOL compare_images(const LOADEXE*, const LOADEXE*);
+
 static void compare_exe(const OPTIONS* opt)
 {
     assert(opt != NULL);
@@ -190,7 +303,7 @@ static void compare_exe(const OPTIONS* opt)
 
     BOOL fail = FALSE;
 
-    if (memcmp(&file1->header, &file2->header, sizeof file1->header) != 0) {
+    if (memcmp(file1->header, file2->header, sizeof *file1->header) != 0) {
         fail = TRUE;
         fprintf(stderr, "EXE headers mismatch\n");
     }
@@ -207,12 +320,12 @@ static void compare_exe(const OPTIONS* opt)
         fprintf(stderr, "%s has relocation table, %s has no relocation table\n", opt->file_name, opt->second_file_name);
       }
       else {
-        assert(file1->header.exRelocItems == file2->header.exRelocItems);
-        if (memcmp(file1->reloc_table, file2->reloc_table, file1->header.exRelocItems * sizeof file1->reloc_table[0]) != 0) {
+        assert(file1->header->exRelocItems == file2->header->exRelocItems);
+        if (memcmp(file1->reloc_table, file2->reloc_table, file1->header->exRelocItems * sizeof file1->reloc_table[0]) != 0) {
           fprintf(stderr, "Note: unsorted relocation tables differ\n");
-          RELOC_ITEM* sorted1 = sorted_reloc_table(file1->reloc_table, file1->header.exRelocItems);
-          RELOC_ITEM* sorted2 = sorted_reloc_table(file2->reloc_table, file2->header.exRelocItems);
-          if (memcmp(sorted1, sorted2, file1->header.exRelocItems * sizeof file1->reloc_table[0]) != 0) {
+          RELOC_ITEM* sorted1 = sorted_reloc_table(file1->reloc_table, file1->header->exRelocItems);
+          RELOC_ITEM* sorted2 = sorted_reloc_table(file2->reloc_table, file2->header->exRelocItems);
+          if (memcmp(sorted1, sorted2, file1->header->exRelocItems * sizeof file1->reloc_table[0]) != 0) {
             fail = TRUE;
             fprintf(stderr, "Sorted relocation tables mismatch\n");
           }
@@ -225,10 +338,8 @@ static void compare_exe(const OPTIONS* opt)
         fprintf(stderr, "EXE images have different sizes\n");
     }
 
-    if (memcmp(file1->image, file2->image, file1->image_size) != 0) {
+    if (!compare_images(file1, file2))
         fail = TRUE;
-        fprintf(stderr, "EXE images mismatch\n");
-    }
 
     if (fail)
         fatal("EXE mismatch: %s, %s\n", opt->file_name, opt->second_file_name);
@@ -236,3 +347,43 @@ static void compare_exe(const OPTIONS* opt)
     delete_loadexe(file1);
     delete_loadexe(file2);
 }
+
+// Differences separated by fewer equal bytes than this are reported as one range.
+#define COALESCE_GAP (8)
+#define MAX_REPORTED_RANGES (16)
+
+// Compare the common part of two images, reporting coalesced ranges of difference.
+static BOOL compare_images(const LOADEXE* exe1, const LOADEXE* exe2)
+{
+    const BYTE* p = exe1->image;
+    const BYTE* q = exe2->image;
+    const DWORD size = (exe1->image_size < exe2->image_size) ? exe1->image_size : exe2->image_size;
+
+    DWORD pos = (DWORD) first_difference(p, q, size);
+    if (pos == size)
+        return TRUE;
+
+    fprintf(stderr, "EXE images mismatch\n");
+
+    unsigned long ranges = 0;
+    while (pos < size)
+    {
+        const DWORD start = pos;
+        DWORD end;
+        do
+        {
+            end = pos + (DWORD) first_agreement(p + pos, q + pos, size - pos);
+            pos = end + (DWORD) first_difference(p + end, q + end, size - end);
+        } while (pos < size && pos - end < COALESCE_GAP);
+
+        if (ranges < MAX_REPORTED_RANGES)
+            fprintf(stderr, "  %05lx-%05lx (%lu bytes)\n", (unsigned long) start, (unsigned long) end - 1, (unsigned long) (end - start));
+        ranges++;
+    }
+
+    if (ranges > MAX_REPORTED_RANGES)
+        fprintf(stderr, "  ... %lu more\n", ranges - MAX_REPORTED_RANGES);
+    fprintf(stderr, "Differing ranges: %lu\n", ranges);
+
+    return FALSE;
+}
@@ -35,15 +35,15 @@ void interact(const char* fileName) {
   STATE state;
   state.decoder = build_decoder();
   state.exe = load_exe(fileName);
-  state.reloc_list = sorted_reloc_list(state.exe->reloc_table, state.exe->header.exRelocItems);
+  state.reloc_list = sorted_reloc_list(state.exe->reloc_table, state.exe->header->exRelocItems);
   state.rp = 0;
-  state.cs = state.exe->header.exInitCS;
-  state.ip = state.exe->header.exInitIP;
+  state.cs = state.exe->header->exInitCS;
+  state.ip = state.exe->header->exInitIP;
   state.mode = IDLE;
   state.rc = 0;
   state.waiting = false;
 
-  print_exe_header(&state.exe->header);
+  print_exe_header(state.exe->header);
 
   char input[128];
   while (fputs("$ ", stdout), fflush(stdout), fgets(input, sizeof input, stdin))
@@ -85,7 +85,7 @@ static void interpret(STATE* state, const char* input) {
         puts("?");
       break;
     case 'h':
-      print_exe_header(&state->exe->header);
+      print_exe_header(state->exe->header);
       state->mode = IDLE;
       break;
     case 'q':
@@ -177,7 +177,7 @@ static const char* skip_ws(const char* inp) {
 static void print_reloc(unsigned index, const RELOC_ITEM*);
 
 static void print_reloc_items(STATE* state) {
-  for (unsigned i = 0; i < state->exe->header.exRelocItems; i++)
+  for (unsigned i = 0; i < state->exe->header->exRelocItems; i++)
     print_reloc(i, state->exe->reloc_table + i);
 }
 
@@ -192,7 +192,7 @@ static void insert(WORD* list, unsigned *count, WORD seg);
 static void list_segments(STATE* state) {
   WORD list[MAX_LIST];
   unsigned count = 0;
-  for (unsigned i = 0; i < state->exe->header.exRelocItems; i++) {
+  for (unsigned i = 0; i < state->exe->header->exRelocItems; i++) {
     const RELOC_ITEM* p = &state->exe->reloc_table[i];
     DWORD addr = ((DWORD) p->segment << 4) + p->offset;
     WORD seg = state->exe->image[addr] + (state->exe->image[addr+1] << 8);
@@ -280,9 +280,9 @@ static bool disassemble_one_instruction(STATE* state) {
 static void indicate_relocation(STATE* state, unsigned len) {
   // Move relocation pointer over all relocation addresses before this instruction
   const DWORD addr = (state->cs << 4) + state->ip;
-  while (state->rp < state->exe->header.exRelocItems && state->reloc_list[state->rp] < addr)
+  while (state->rp < state->exe->header->exRelocItems && state->reloc_list[state->rp] < addr)
     state->rp++;
-  if (state->rp < state->exe->header.exRelocItems) {
+  if (state->rp < state->exe->header->exRelocItems) {
     DWORD r = state->reloc_list[state->rp];
     if (r >= addr && r < addr + len) {
       fputs("* ", stdout);
@@ -340,7 +340,7 @@ static bool dump_one_line(STATE* state) {
 }
 
 static void dump_byte(STATE* state, DWORD addr, BYTE val) {
-  if (bsearch(&addr, state->reloc_list, state->exe->header.exRelocItems, sizeof state->reloc_list[0], compare_dword)) {
+  if (bsearch(&addr, state->reloc_list, state->exe->header->exRelocItems, sizeof state->reloc_list[0], compare_dword)) {
     putchar('[');
     state->rc = 2;
   }
@@ -8,45 +8,43 @@
 #include <ctype.h>
 #include <assert.h>
 #include "loadexe.h"
-#include "fileutil.h"
 
 static unsigned long calculated_size(const EXEHEADER*);
-static RELOC_ITEM* load_reloc_table(FILE*, const EXEHEADER*);
+static void view_reloc_table(LOADEXE*, const char* file_name);
 
 LOADEXE* load_exe(const char* file_name) {
   LOADEXE* exe = emalloc(sizeof *exe);
 
   FILE* fp = efopen(file_name, "rb", "reading");
   FileSize actual_size = file_size(fp, file_name);
-
-  size_t count = fread(&exe->header, 1, sizeof exe->header, fp);
-  if (count != sizeof exe->header)
+  if (actual_size < sizeof (EXEHEADER))
     fatal("file too small for EXE header: %s\n", file_name);
+  exe->file = read_file(fp, actual_size);
+  exe->file_size = actual_size;
+  fclose(fp);
+
+  exe->header = (const EXEHEADER*) exe->file;
 
-  if (exe->header.exSignature != 0x5A4D)
+  if (exe->header->exSignature != 0x5A4D)
     fatal("EXE signature not found: %s\n", file_name);
 
-  long specified_size = calculated_size(&exe->header);
+  long specified_size = calculated_size(exe->header);
   if (specified_size != actual_size) {
-    fprintf(stderr, "%s: exPages = %u\n", file_name, (unsigned)exe->header.exPages);
-    fprintf(stderr, "%s: exExtraBytes = %u\n", file_name, (unsigned)exe->header.exExtraBytes);
+    fprintf(stderr, "%s: exPages = %u\n", file_name, (unsigned)exe->header->exPages);
+    fprintf(stderr, "%s: exExtraBytes = %u\n", file_name, (unsigned)exe->header->exExtraBytes);
     fprintf(stderr, "%s: calculated size: %ld\n", file_name, specified_size);
     fprintf(stderr, "%s: actual size:     %ld\n", file_name, actual_size);
     fatal("file size discrepancy: %s\n", file_name);
   }
 
-  if (exe->header.exRelocItems == 0)
-    exe->reloc_table = NULL;
-  else
-    exe->reloc_table = load_reloc_table(fp, &exe->header);
+  view_reloc_table(exe, file_name);
 
-  FileSize image_start = (FileSize)exe->header.exHeaderSize * 16;
+  FileSize image_start = (FileSize)exe->header->exHeaderSize * 16;
   if (image_start > actual_size)
     fatal("calculated image start beyond actual file size: %s\n", file_name);
 
   exe->image_size = specified_size - image_start;
-  fseek(fp, image_start, SEEK_SET);
-  exe->image = read_file(fp, exe->image_size);
+  exe->image = exe->file + image_start;
 
   return exe;
 }
@@ -57,31 +55,40 @@ static unsigned long calculated_size(const EXEHEADER* h) {
 
 void delete_loadexe(LOADEXE* exe) {
   if (exe) {
-    efree(exe->image);
+    efree(exe->reloc_copy);
+    efree(exe->file);
     efree(exe);
   }
 }
 
-static RELOC_ITEM* load_reloc_table(FILE* fp, const EXEHEADER* header) {
-  assert(fp != NULL);
-  assert(header != NULL);
-  assert(header->exRelocItems > 0);
+static void view_reloc_table(LOADEXE* exe, const char* file_name) {
+  assert(exe != NULL);
+  assert(exe->header != NULL);
 
-  RELOC_ITEM* items = emalloc(sizeof items[0] * header->exRelocItems);
+  exe->reloc_table = NULL;
+  exe->reloc_copy = NULL;
 
-  fseek(fp, header->exRelocTable, SEEK_SET);
+  const unsigned items = exe->header->exRelocItems;
+  if (items == 0)
+    return;
 
-  for (unsigned i = 0; i < header->exRelocItems; i++) {
-    items[i].offset = getword(fp);
-    items[i].segment = getword(fp);
-  }
+  const FileSize offset = exe->header->exRelocTable;
+  const FileSize size = items * sizeof (RELOC_ITEM);
+  if (offset > exe->file_size || size > exe->file_size - offset)
+    fatal("relocation table beyond end of file: %s\n", file_name);
 
-  return items;
+  if (offset % sizeof (WORD) == 0)
+    exe->reloc_table = (const RELOC_ITEM*) (exe->file + offset);
+  else {
+    exe->reloc_copy = emalloc(size);
+    memcpy(exe->reloc_copy, exe->file + offset, size);
+    exe->reloc_table = exe->reloc_copy;
+  }
 }
 
 static void sort_reloc_table(RELOC_ITEM* table, unsigned elements);
 
-RELOC_ITEM* sorted_reloc_table(RELOC_ITEM* rt, unsigned elements) {
+RELOC_ITEM* sorted_reloc_table(const RELOC_ITEM* rt, unsigned elements) {
   unsigned size = elements * sizeof rt[0];
   RELOC_ITEM* sorted = emalloc(size);
   memcpy(sorted, rt, size);
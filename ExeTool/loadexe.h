@@ -7,17 +7,22 @@
 
 #include "exeheader.h"
 
+// The file is read whole into one buffer; the header, relocation table
+// and image are views into it.
 typedef struct {
-  EXEHEADER header;
-  RELOC_ITEM* reloc_table;
-  BYTE* image;
+  BYTE* file;
+  FileSize file_size;
+  const EXEHEADER* header;
+  const RELOC_ITEM* reloc_table;
+  const BYTE* image;
   DWORD image_size;
+  RELOC_ITEM* reloc_copy; // if the table is not word-aligned in the file
 } LOADEXE;
 
 LOADEXE* load_exe(const char* file_name);
 void delete_loadexe(LOADEXE*);
 
-RELOC_ITEM* sorted_reloc_table(RELOC_ITEM* table, unsigned elements);
+RELOC_ITEM* sorted_reloc_table(const RELOC_ITEM* table, unsigned elements);
 DWORD* sorted_reloc_list(const RELOC_ITEM* table, unsigned elements);
 
 int compare_dword(const void*, const void*);
@@ -9,6 +9,7 @@
 static void init_options(OPTIONS* opt) {
   opt->help = FALSE;
   opt->compare = FALSE;
+  opt->files = new_stringlist();
   opt->file_name = NULL;
   opt->second_file_name = NULL;
   opt->image = TRUE;
@@ -18,7 +19,10 @@ static void init_options(OPTIONS* opt) {
 }
 
 void delete_options(OPTIONS* opt) {
-  efree(opt);
+  if (opt) {
+    delete_stringlist(opt->files);
+    efree(opt);
+  }
 }
 
 OPTIONS* parse_options(int argc, char* argv[]) {
@@ -58,24 +62,27 @@ OPTIONS* parse_options(int argc, char* argv[]) {
         opt->help = TRUE;
         return opt;
       }
-      if (opt->file_name == NULL)
-        opt->file_name = argv[i];
-      else if (opt->second_file_name == NULL)
-        opt->second_file_name = argv[i];
-      else
-        fatal("unexpected argument: %s\n", argv[i]);
+      append_string(opt->files, argv[i]);
     }
   }
 
-  if (opt->file_name == NULL)
+  const unsigned count = stringlist_count(opt->files);
+
+  if (count == 0)
     fatal(".EXE file name expected\n");
 
+  opt->file_name = stringlist_item(opt->files, 0);
+
+  // Several files, or directories, are dumped in a batch.
   if (opt->compare) {
-    if (opt->second_file_name == NULL)
+    if (count < 2)
       fatal("second .EXE file name expected\n");
+    if (count > 2)
+      fatal("unexpected argument: %s\n", stringlist_item(opt->files, 2));
+    opt->second_file_name = stringlist_item(opt->files, 1);
   }
-  else {
-    if (opt->second_file_name != NULL)
+  else if (opt->interactive) {
+    if (count > 1)
       fatal("second file name unexpected\n");
   }
 
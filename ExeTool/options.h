@@ -8,10 +8,12 @@
 // ExeTool options
 
 #include "utils.h"
+#include "stringlist.h"
 
 typedef struct {
   BOOL help;
   BOOL compare;
+  STRINGLIST* files;
   const char* file_name;
   const char* second_file_name;
   BOOL image;
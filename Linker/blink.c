@@ -8,25 +8,20 @@
 #include <assert.h>
 #include "utils.h"
 #include "object.h"
-#include "module.h"
-#include "combine.h"
-#include "consolidate.h"
-#include "resolve.h"
-#include "image.h"
+#include "linker.h"
 #include "format.h"
-#include "exefile.h"
-#include "comfile.h"
-#include "binfile.h"
+#include "symbol.h"
 #include "stringlist.h"
-#include "timer.h"
+#include "profile.h"
+#include "trace.h"
 
 #ifdef UNIT_TEST
 void RunAllTests(void);
+static int RunAllBenchmarks(const char* baselines);
 #endif
 
 static void help(void);
 static void report_memory(void);
-static void check_no_fixups(const SEGMENTED* segmented_program, const char* format);
 
 int main(int argc, char* argv[]) {
   STRINGLIST* files = new_stringlist();
@@ -37,6 +32,9 @@ int main(int argc, char* argv[]) {
   bool report_mem = false;
   bool report_time = false;
   const char* mapfile = NULL;
+#ifdef TRACE_EVENTS
+  const char* trace_name = NULL;
+#endif
 
   progname = "blink";
 
@@ -52,12 +50,24 @@ int main(int argc, char* argv[]) {
         report_memory();
         exit(EXIT_SUCCESS); // TODO: return count of failures
       }
+      if (strcmp(arg, "-bench") == 0 || strncmp(arg, "-bench=", 7) == 0) {
+        delete_stringlist(files);
+        exit(RunAllBenchmarks(arg[6] == '=' ? arg + 7 : NULL) ? EXIT_FAILURE : EXIT_SUCCESS);
+      }
 #endif
       if (arg[1] == '-') {
         if (strcmp(arg+2, "help") == 0)
           help();
         if (strcmp(arg+2, "case-sensitive") == 0)
           case_sensitivity = CASE_SENSITIVE;
+#ifdef TRACE_EVENTS
+        else if (strcmp(arg+2, "trace") == 0) {
+          if (++i < argc)
+            trace_name = argv[i];
+          else
+            fatal("trace file name missing\n");
+        }
+#endif
         else
           fatal("unknown option: %s\n", arg);
       }
@@ -107,73 +117,46 @@ int main(int argc, char* argv[]) {
   if (output_name == NULL)
     output_name = default_output_name(format);
 
-  TIMER timer;
+#ifdef TRACE_EVENTS
+  if (trace_name)
+    TRACE_OPEN(trace_name, "blink");
+#endif
+  TRACE_BEGIN("link %s", output_name);
+
+  PROFILE* profile = new_profile();
 
-  start_timer(&timer);
+  LINK_SETTINGS settings;
+  init_link_settings(&settings);
+  settings.case_sensitive = (case_sensitivity == CASE_SENSITIVE);
+  settings.verbose = verbose;
+  settings.mapfile = mapfile;
 
-  SEGMENTED* segmented_program = new_segmented(output_name, case_sensitivity);
+  LINKER* linker = new_linker(output_name, &settings, profile);
 
-  // Load object files into the SEGMENTED program structure.
+  // Load object files and link them into the program.
   for (unsigned i = 0; i < stringlist_count(files); i++) {
     if (verbose)
       printf("Load object file: %s\n", stringlist_item(files, i));
+    begin_phase(profile, "load");
     OFILE* ofile = load_object_file(stringlist_item(files, i));
-
-    // Process the object file records into a SEGMENTED structure for the module.
-    SEGMENTED* module_segments = build_module_segments(ofile, case_sensitivity, verbose, stringlist_item(files, i));
-
-    // Add private segments, and combine public segments, in the module, into program segments,
-    // modifying the module's fixups appropriately and adding them to the program's fixups.
-    incorporate_module(segmented_program, module_segments, verbose);
-
-    delete_segmented(module_segments);
+    link_module(linker, ofile, stringlist_item(files, i));
     delete_ofile(ofile);
   }
 
-  // Consolidate segments into groups.
-  consolidate_groups_and_stack(segmented_program, verbose);
-
-  // Resolve external symbol values, checking all have been defined.
-  // Convert absolute jump offsets in groups to PC-relative displacements.
-  resolve_fixups(segmented_program, verbose);
-
-  // Build a program image from the distinct segments and groups,
-  // writing a map file if required.
-  IMAGE* image = build_image(segmented_program, mapfile, verbose);
-
-  if (verbose)
-    printf("Output %s file: %s\n", format_name(format), output_name);
-
-  switch (format) {
-    case BIN_FORMAT:
-      // Check that there are no segment address fixups to be performed at load time.
-      // A raw binary file does not support that.
-      check_no_fixups(segmented_program, "BIN");
-      output_bin(image, output_name);
-      break;
-    case COM_FORMAT:
-      // Check that there are no segment address fixups to be performed at load time.
-      // A bare COM file does not support that.
-      check_no_fixups(segmented_program, "COM");
-      output_com(image, output_name);
-      break;
-    case EXE_FORMAT: {
-      BUILDEXE* exe = build_exe(segmented_program, image);
-      output_exe(exe, output_name);
-      delete_buildexe(exe);
-      break;
-    }
-    default:
-      fatal("output format known but unimplemented: %s\n", format_name(format));
-  }
-
-  stop_timer(&timer);
+  link_image(linker);
+  output_program(linker, format, output_name);
 
-  if (report_time)
-    printf("Microseconds elapsed: %lld\n", elapsed_usec(&timer));
+  if (report_time) {
+    print_profile(profile, stdout);
+    printf("Microseconds elapsed: %lld\n", profile_usec(profile));
+  }
+  if (report_mem)
+    print_memory_profile(profile, stdout);
+  delete_profile(profile);
+  TRACE_END();
+  TRACE_CLOSE();
 
-  delete_image(image);
-  delete_segmented(segmented_program);
+  delete_linker(linker);
   delete_stringlist(files);
 
   if (report_mem)
@@ -190,32 +173,27 @@ static void help(void) {
   puts("  -m          report memory usage");
   puts("  -o FILE     output file");
   puts("  -p FILE     map file");
-  puts("  -t          time linking");
+  puts("  -t          time and count events in each phase of linking");
 #ifdef UNIT_TEST
   puts("  -unittest   run unit tests");
+  puts("  -bench      run benchmarks (-bench=FILE: check baselines)");
 #endif
   puts("  -vvvv       1-4 verbosity levels");
+#ifdef TRACE_EVENTS
+  puts("  --trace FILE  write trace events to FILE (Chrome JSON)");
+#endif
   exit(EXIT_FAILURE);
 }
 
 static void report_memory(void) {
-  unsigned long malloc_count, free_count;
-  get_memory_counts(&malloc_count, &free_count);
-  printf("malloc: %10lu\n", malloc_count);
-  printf("free:   %10lu\n", free_count);
-}
-
-static void check_no_fixups(const SEGMENTED* segmented_program, const char* format) {
-  unsigned long n = segment_and_group_fixups(segmented_program->fixups);
-  if (n)
-    fatal("cannot produce %s file: segment fixups: %lu\n", format, n);
+  print_memory_usage(stdout);
 }
 
 #ifdef UNIT_TEST
 
 #include "CuTest.h"
 
-extern CuSuite* symbol_test_suite(void);
+extern CuSuite* symtab_test_suite(void);
 extern CuSuite* fixup_test_suite(void);
 extern CuSuite* segment_test_suite(void);
 extern CuSuite* segment_list_test_suite(void);
@@ -225,12 +203,16 @@ extern CuSuite* consolidate_test_suite(void);
 extern CuSuite* resolve_test_suite(void);
 extern CuSuite* image_test_suite(void);
 extern CuSuite* segmented_test_suite(void);
+extern CuSuite* object_test_suite(void);
+
+extern CuBenchSuite* object_bench_suite(void);
+extern CuBenchSuite* segment_bench_suite(void);
 
 void RunAllTests(void) {
   CuString *output = CuStringNew();
   CuSuite* suite = CuSuiteNew();
 
-  CuSuiteAddSuite(suite, symbol_test_suite());
+  CuSuiteAddSuite(suite, symtab_test_suite());
   CuSuiteAddSuite(suite, fixup_test_suite());
   CuSuiteAddSuite(suite, segment_test_suite());
   CuSuiteAddSuite(suite, segment_list_test_suite());
@@ -240,6 +222,7 @@ void RunAllTests(void) {
   CuSuiteAddSuite(suite, resolve_test_suite());
   CuSuiteAddSuite(suite, image_test_suite());
   CuSuiteAddSuite(suite, segmented_test_suite());
+  CuSuiteAddSuite(suite, object_test_suite());
 
   CuSuiteRun(suite);
   CuSuiteSummary(suite, output);
@@ -247,4 +230,24 @@ void RunAllTests(void) {
   printf("%s\n", output->buffer);
 }
 
+static int RunAllBenchmarks(const char* baselines) {
+  CuString *output = CuStringNew();
+  CuBenchSuite* suite = CuBenchSuiteNew();
+
+  CuBenchSuiteAddSuite(suite, object_bench_suite());
+  CuBenchSuiteAddSuite(suite, segment_bench_suite());
+
+  const bool record = baselines && !CuBenchSuiteReadBaselines(suite, baselines);
+  CuBenchSuiteRun(suite);
+  CuBenchSuiteDetails(suite, output);
+  printf("%s\n", output->buffer);
+  if (record && !CuBenchSuiteWriteBaselines(suite, baselines))
+    fatal("cannot write benchmark baselines: %s\n", baselines);
+
+  const int failures = suite->failCount;
+  CuBenchSuiteDelete(suite);
+  CuStringDelete(output);
+  return failures;
+}
+
 #endif /* UNIT_TEST */
@@ -117,7 +117,7 @@ static void define_start(START* prog_start, START* module_start, SEGMENT_MAP* mo
     prog_start->offset = module_to_program_seg_map->map[module_start->segno].addr + module_start->offset;
     if (verbose >= 2)
       printf("Define start address: program segment %d: %s; offset 0x%04x\n",
-          (int)prog_start->segno, segment_name(prog_segs, prog_start->segno), (unsigned)prog_start->offset);
+          (int)prog_start->segno, seglist_name(prog_segs, prog_start->segno), (unsigned)prog_start->offset);
   }
 }
 
@@ -130,7 +130,7 @@ static VECTOR* add_module_groups_to_program(GROUP_LIST* program_groups, GROUP_LI
   VECTOR* map = new_vector(group_list_count(module_groups));
 
   for (GROUPNO i = 0; i < group_list_count(module_groups); i++) {
-    const char* name = group_name(module_groups, i);
+    const char* name = grouplist_name(module_groups, i);
     unsigned group = group_index(program_groups, name);
     if (group == NO_GROUP) {
       group = add_group(program_groups, name);
@@ -224,11 +224,11 @@ static SEGNO add_public_segment(
     psegno = add_program_segment(program_segs, module_seg, program_group, module_name, verbose);
   else {
     if (verbose >= 2)
-      printf("Found public segment %d: %s\n", (int)psegno, segment_name(program_segs, psegno));
-    GROUPNO prev_group = segment_group(program_segs, psegno);
+      printf("Found public segment %d: %s\n", (int)psegno, seglist_name(program_segs, psegno));
+    GROUPNO prev_group = seglist_group(program_segs, psegno);
     if (prev_group != program_group) {
-      const char* prev_group_name = (prev_group == NO_GROUP) ? "none" : group_name(program_groups, prev_group);
-      const char* dest_group_name = (program_group == NO_GROUP) ? "none" : group_name(program_groups, program_group);
+      const char* prev_group_name = (prev_group == NO_GROUP) ? "none" : grouplist_name(program_groups, prev_group);
+      const char* dest_group_name = (program_group == NO_GROUP) ? "none" : grouplist_name(program_groups, program_group);
       fatal("Conflicting groups for public segment %s: %s, %s\n",
             seg_name(module_seg), prev_group_name, dest_group_name);
     }
@@ -248,11 +248,11 @@ static SEGNO add_stack_segment(
     psegno = add_program_segment(program_segs, module_seg, program_group, module_name, verbose);
   else {
     if (verbose >= 2)
-      printf("Found stack segment %d: %s\n", (int)psegno, segment_name(program_segs, psegno));
-    GROUPNO prev_group = segment_group(program_segs, psegno);
+      printf("Found stack segment %d: %s\n", (int)psegno, seglist_name(program_segs, psegno));
+    GROUPNO prev_group = seglist_group(program_segs, psegno);
     if (prev_group != program_group) {
-      const char* prev_group_name = (prev_group == NO_GROUP) ? "none" : group_name(program_groups, prev_group);
-      const char* dest_group_name = (program_group == NO_GROUP) ? "none" : group_name(program_groups, program_group);
+      const char* prev_group_name = (prev_group == NO_GROUP) ? "none" : grouplist_name(program_groups, prev_group);
+      const char* dest_group_name = (program_group == NO_GROUP) ? "none" : grouplist_name(program_groups, program_group);
       fatal("Conflicting groups for stack segment %s: %s, %s\n",
             seg_name(module_seg), prev_group_name, dest_group_name);
     }
@@ -265,10 +265,10 @@ static SEGNO add_program_segment(SEGMENT_LIST* program, const SEGMENT* seg, GROU
   if (seg_public(seg) && seg_stack(seg))
     fatal("segment is both PUBLIC and STACK: %s\n", seg_name(seg));
   SEGNO psegno = add_segment(program, seg_name(seg), seg_public(seg), seg_stack(seg), group);
-  set_segment_p2align(program, psegno, seg_p2align(seg));
+  set_seglist_p2align(program, psegno, seg_p2align(seg));
   const char* type = seg_public(seg) ? "public" : (seg_stack(seg) ? "stack" : "private");
   if (verbose >= 2)
-    printf("Add %s segment %d: %s\n", type, (int)psegno, segment_name(program, psegno));
+    printf("Add %s segment %d: %s\n", type, (int)psegno, seglist_name(program, psegno));
   return psegno;
 }
 
@@ -291,8 +291,8 @@ static SYMBOL_ID add_module_symbol_to_program(SYMTAB* prog_st, const SYMTAB* mod
 // Return a mapping from module symbol ID to the symbol's ID in the program symbol table.
 static VECTOR* add_module_symbols_to_program(SYMTAB* prog_st, const SYMTAB* module_st,
     SEGMENT_LIST* prog_segs, SEGMENT_MAP* module_to_program_seg_map, int verbose) {
-  VECTOR* sym_map = new_vector(sym_count(module_st));
-  for (SYMBOL_ID id = 0; id < sym_count(module_st); id++) {
+  VECTOR* sym_map = new_vector(symtab_count(module_st));
+  for (SYMBOL_ID id = 0; id < symtab_count(module_st); id++) {
     sym_map->val[id] = add_module_symbol_to_program(prog_st, module_st, id, prog_segs, module_to_program_seg_map, verbose);
   }
   return sym_map;
@@ -325,26 +325,26 @@ static SYMBOL_ID add_module_symbol_to_program(SYMTAB* prog_st, const SYMTAB* mod
   if (new_offset > (WORD)(-1))
     fatal("offset out of 16-bit range (C): %s: 0x%06lx\n", module_sym->name, (unsigned long)new_offset);
 
-  SYMBOL_ID prog_id = sym_lookup(prog_st, module_sym->name);
+  SYMBOL_ID prog_id = symtab_lookup(prog_st, module_sym->name);
 
   if (prog_id == NO_SYM) {
     if (module_sym->defined)
-      prog_id = sym_insert_public(prog_st, module_sym->name, new_segno, (WORD)new_offset);
+      prog_id = symtab_insert_public(prog_st, module_sym->name, new_segno, (WORD)new_offset);
     else
-      prog_id = sym_insert_extern(prog_st, module_sym->name, new_segno);
+      prog_id = symtab_insert_extern(prog_st, module_sym->name, new_segno);
   }
   else {
-    const prog_segno = sym_seg(prog_st, prog_id);
+    const SEGNO prog_segno = symtab_seg(prog_st, prog_id);
     if (prog_segno != new_segno)
       fatal("in different segments: %s: %s, %s\n",
-          module_sym->name, segment_name(prog_segs, prog_segno), segment_name(prog_segs, new_segno));
-    if (sym_defined(prog_st, prog_id)) {
+          module_sym->name, seglist_name(prog_segs, prog_segno), seglist_name(prog_segs, new_segno));
+    if (symtab_defined(prog_st, prog_id)) {
       if (module_sym->defined)
         fatal("multiply defined: %s\n", module_sym->name);   // TODO: decent message
     }
     else {
       if (module_sym->defined)
-        sym_define(prog_st, prog_id, new_offset);
+        symtab_define(prog_st, prog_id, new_offset);
     }
   }
 
@@ -390,7 +390,7 @@ static void retarget_module_fixups_to_program(FIXUPS* module_fixups,
           assert(module_groups != NULL);
           assert(module_to_program_group_map != NULL);
           assert(i->u.groupno < group_list_count(module_groups));
-          printf(" group %d: %s", (int)i->u.groupno, group_name(module_groups, i->u.groupno));
+          printf(" group %d: %s", (int)i->u.groupno, grouplist_name(module_groups, i->u.groupno));
           break;
         case FT_SEGMENT:
           printf(" addressing module seg %d", (int) i->u.seg.addressed_segno);
@@ -434,10 +434,10 @@ static void retarget_module_fixups_to_program(FIXUPS* module_fixups,
         // when segments are at their final location.
         // Meanwhile the stored offset value should be zero.
         if (offset_value != 0) {
-          fprintf(stderr, "Location of external reference does not hold 0: "
-                          "seg %d, offset 0x%04x, value 0x%04x\n",
+          fprintf(error_stream(), "Location of external reference does not hold 0: "
+                                  "seg %d, offset 0x%04x, value 0x%04x\n",
               (int) i->holding_seg, (unsigned) i->holding_offset, (unsigned) offset_value);
-          exit(EXIT_FAILURE);
+          fail();
         }
         break;
       case FT_GROUP_ABSOLUTE_JUMP:
@@ -451,10 +451,10 @@ static void retarget_module_fixups_to_program(FIXUPS* module_fixups,
         // when the program image is built, and finalised at load time.
         // Meanwhile the stored value should be zero.
         if (offset_value != 0) {
-          fprintf(stderr, "Location of segment reference does not hold 0: "
-                          "seg %d, offset 0x%04x, value 0x%04x\n",
+          fprintf(error_stream(), "Location of segment reference does not hold 0: "
+                                  "seg %d, offset 0x%04x, value 0x%04x\n",
               (int) i->holding_seg, (unsigned) i->holding_offset, (unsigned) offset_value);
-          exit(EXIT_FAILURE);
+          fail();
         }
         // TODO: check if we need the following code as in consolidate.c
 #if 0
@@ -469,10 +469,10 @@ static void retarget_module_fixups_to_program(FIXUPS* module_fixups,
         // when the program image is built, and finalised at load time.
         // Meanwhile the stored value should be zero.
         if (offset_value != 0) {
-          fprintf(stderr, "Location of group reference does not hold 0: "
-                          "seg %d, offset 0x%04x, value 0x%04x\n",
+          fprintf(error_stream(), "Location of group reference does not hold 0: "
+                                  "seg %d, offset 0x%04x, value 0x%04x\n",
               (int) i->holding_seg, (unsigned) i->holding_offset, (unsigned) offset_value);
-          exit(EXIT_FAILURE);
+          fail();
         }
         break;
       default:
@@ -633,15 +633,15 @@ static void test_add_groups_non_empty(CuTest* tc) {
   CuAssertIntEquals(tc, 3, map->val[2]);
 
   CuAssertIntEquals(tc, 4, group_list_count(dest));
-  CuAssertStrEquals(tc, "CABBAGE", group_name(dest, 0));
-  CuAssertStrEquals(tc, "SWINE", group_name(dest, 1));
-  CuAssertStrEquals(tc, "Liver", group_name(dest, 2));
-  CuAssertStrEquals(tc, "Turnip", group_name(dest, 3));
+  CuAssertStrEquals(tc, "CABBAGE", grouplist_name(dest, 0));
+  CuAssertStrEquals(tc, "SWINE", grouplist_name(dest, 1));
+  CuAssertStrEquals(tc, "Liver", grouplist_name(dest, 2));
+  CuAssertStrEquals(tc, "Turnip", grouplist_name(dest, 3));
 
   CuAssertIntEquals(tc, 3, group_list_count(src));
-  CuAssertStrEquals(tc, "Liver", group_name(src, 0));
-  CuAssertStrEquals(tc, "Cabbage", group_name(src, 1));
-  CuAssertStrEquals(tc, "Turnip", group_name(src, 2));
+  CuAssertStrEquals(tc, "Liver", grouplist_name(src, 0));
+  CuAssertStrEquals(tc, "Cabbage", grouplist_name(src, 1));
+  CuAssertStrEquals(tc, "Turnip", grouplist_name(src, 2));
 
   delete_vector(map);
 
@@ -700,25 +700,25 @@ static void test_add_segments_no_groups(CuTest* tc) {
 
   CuAssertIntEquals(tc, 5, segment_list_count(program));
 
-  CuAssertStrEquals(tc, "CODE", segment_name(program, 0));
-  CuAssertIntEquals(tc, TRUE, segment_public(program, 0));
-  CuAssertIntEquals(tc, NO_GROUP, segment_group(program, 0));
+  CuAssertStrEquals(tc, "CODE", seglist_name(program, 0));
+  CuAssertIntEquals(tc, TRUE, seglist_public(program, 0));
+  CuAssertIntEquals(tc, NO_GROUP, seglist_group(program, 0));
 
-  CuAssertStrEquals(tc, "DATA", segment_name(program, 1));
-  CuAssertIntEquals(tc, FALSE, segment_public(program, 1));
-  CuAssertIntEquals(tc, NO_GROUP, segment_group(program, 1));
+  CuAssertStrEquals(tc, "DATA", seglist_name(program, 1));
+  CuAssertIntEquals(tc, FALSE, seglist_public(program, 1));
+  CuAssertIntEquals(tc, NO_GROUP, seglist_group(program, 1));
 
-  CuAssertStrEquals(tc, "SHARED", segment_name(program, 2));
-  CuAssertIntEquals(tc, TRUE, segment_public(program, 2));
-  CuAssertIntEquals(tc, NO_GROUP, segment_group(program, 2));
+  CuAssertStrEquals(tc, "SHARED", seglist_name(program, 2));
+  CuAssertIntEquals(tc, TRUE, seglist_public(program, 2));
+  CuAssertIntEquals(tc, NO_GROUP, seglist_group(program, 2));
 
-  CuAssertStrEquals(tc, "CODE", segment_name(program, 3));
-  CuAssertIntEquals(tc, FALSE, segment_public(program, 3));
-  CuAssertIntEquals(tc, NO_GROUP, segment_group(program, 3));
+  CuAssertStrEquals(tc, "CODE", seglist_name(program, 3));
+  CuAssertIntEquals(tc, FALSE, seglist_public(program, 3));
+  CuAssertIntEquals(tc, NO_GROUP, seglist_group(program, 3));
 
-  CuAssertStrEquals(tc, "DATA", segment_name(program, 4));
-  CuAssertIntEquals(tc, TRUE, segment_public(program, 4));
-  CuAssertIntEquals(tc, NO_GROUP, segment_group(program, 4));
+  CuAssertStrEquals(tc, "DATA", seglist_name(program, 4));
+  CuAssertIntEquals(tc, TRUE, seglist_public(program, 4));
+  CuAssertIntEquals(tc, NO_GROUP, seglist_group(program, 4));
 
   CuAssertIntEquals(tc, 3, segment_list_count(module));
 
@@ -765,25 +765,25 @@ static void test_add_segments_with_groups(CuTest* tc) {
 
   CuAssertIntEquals(tc, 5, segment_list_count(program));
 
-  CuAssertStrEquals(tc, "CODE", segment_name(program, 0));
-  CuAssertIntEquals(tc, TRUE, segment_public(program, 0));
-  CuAssertIntEquals(tc, 1, segment_group(program, 0));
+  CuAssertStrEquals(tc, "CODE", seglist_name(program, 0));
+  CuAssertIntEquals(tc, TRUE, seglist_public(program, 0));
+  CuAssertIntEquals(tc, 1, seglist_group(program, 0));
 
-  CuAssertStrEquals(tc, "DATA", segment_name(program, 1));
-  CuAssertIntEquals(tc, FALSE, segment_public(program, 1));
-  CuAssertIntEquals(tc, NO_GROUP, segment_group(program, 1));
+  CuAssertStrEquals(tc, "DATA", seglist_name(program, 1));
+  CuAssertIntEquals(tc, FALSE, seglist_public(program, 1));
+  CuAssertIntEquals(tc, NO_GROUP, seglist_group(program, 1));
 
-  CuAssertStrEquals(tc, "SHARED", segment_name(program, 2));
-  CuAssertIntEquals(tc, TRUE, segment_public(program, 2));
-  CuAssertIntEquals(tc, 0, segment_group(program, 2));
+  CuAssertStrEquals(tc, "SHARED", seglist_name(program, 2));
+  CuAssertIntEquals(tc, TRUE, seglist_public(program, 2));
+  CuAssertIntEquals(tc, 0, seglist_group(program, 2));
 
-  CuAssertStrEquals(tc, "CODE", segment_name(program, 3));
-  CuAssertIntEquals(tc, FALSE, segment_public(program, 3));
-  CuAssertIntEquals(tc, 2, segment_group(program, 3));
+  CuAssertStrEquals(tc, "CODE", seglist_name(program, 3));
+  CuAssertIntEquals(tc, FALSE, seglist_public(program, 3));
+  CuAssertIntEquals(tc, 2, seglist_group(program, 3));
 
-  CuAssertStrEquals(tc, "DATA", segment_name(program, 4));
-  CuAssertIntEquals(tc, TRUE, segment_public(program, 4));
-  CuAssertIntEquals(tc, NO_GROUP, segment_group(program, 4));
+  CuAssertStrEquals(tc, "DATA", seglist_name(program, 4));
+  CuAssertIntEquals(tc, TRUE, seglist_public(program, 4));
+  CuAssertIntEquals(tc, NO_GROUP, seglist_group(program, 4));
 
   CuAssertIntEquals(tc, 3, segment_list_count(module));
 
@@ -795,8 +795,8 @@ static void test_add_segments_with_groups(CuTest* tc) {
 }
 
 static void test_add_symbols_empty(CuTest* tc) {
-  SYMTAB* prog_st = new_symbol_table(CASE_INSENSITIVE);
-  SYMTAB* module_st = new_symbol_table(CASE_INSENSITIVE);
+  SYMTAB* prog_st = new_symtab(CASE_INSENSITIVE);
+  SYMTAB* module_st = new_symtab(CASE_INSENSITIVE);
   SEGMENT_LIST* prog_segs = new_segment_list(CASE_INSENSITIVE);
   SEGMENT_MAP* seg_map = new_segment_map(0);
 
@@ -807,13 +807,13 @@ static void test_add_symbols_empty(CuTest* tc) {
 
   delete_segment_map(seg_map);
   delete_segment_list(prog_segs);
-  delete_symbol_table(module_st);
-  delete_symbol_table(prog_st);
+  delete_symtab(module_st);
+  delete_symtab(prog_st);
 }
 
 static void test_add_symbols(CuTest* tc) {
-  SYMTAB* prog_st = new_symbol_table(CASE_INSENSITIVE);
-  SYMTAB* module_st = new_symbol_table(CASE_INSENSITIVE);
+  SYMTAB* prog_st = new_symtab(CASE_INSENSITIVE);
+  SYMTAB* module_st = new_symtab(CASE_INSENSITIVE);
   SEGMENT_LIST* prog_segs = new_segment_list(CASE_INSENSITIVE);
 
   // seg name    prog seg    module seg    symbols
@@ -836,17 +836,17 @@ static void test_add_symbols(CuTest* tc) {
   add_segment(prog_segs, "SEG2", TRUE, FALSE, NO_GROUP);
   add_segment(prog_segs, "SEG3", TRUE, FALSE, NO_GROUP);
 
-  sym_insert_public(prog_st, "AAA", 0, 0x120);  // defined in program, declared in module
-  sym_insert_extern(prog_st, "BBB", 1);         // declared in program, defined in module
-  sym_insert_public(prog_st, "CCC", 1, 0x200);  // defined in program, not in module
-  sym_insert_extern(prog_st, "DDD", 2);         // declared in program, declared in module
-  sym_insert_extern(prog_st, "EEE", 2);         // declared in program, not in module
+  symtab_insert_public(prog_st, "AAA", 0, 0x120);  // defined in program, declared in module
+  symtab_insert_extern(prog_st, "BBB", 1);         // declared in program, defined in module
+  symtab_insert_public(prog_st, "CCC", 1, 0x200);  // defined in program, not in module
+  symtab_insert_extern(prog_st, "DDD", 2);         // declared in program, declared in module
+  symtab_insert_extern(prog_st, "EEE", 2);         // declared in program, not in module
 
-  sym_insert_public(module_st, "bbb", 2, 0x400);   // declared in program, defined in module
-  sym_insert_extern(module_st, "aaa", 1);          // defined in program, declared in module
-  sym_insert_extern(module_st, "ddd", 3);          // declared in program, declared in module
-  sym_insert_extern(module_st, "fff", 0);          // not in program, declared in module
-  sym_insert_public(module_st, "ggg", 0, 0x300);   // not in program, defined in module
+  symtab_insert_public(module_st, "bbb", 2, 0x400);   // declared in program, defined in module
+  symtab_insert_extern(module_st, "aaa", 1);          // defined in program, declared in module
+  symtab_insert_extern(module_st, "ddd", 3);          // declared in program, declared in module
+  symtab_insert_extern(module_st, "fff", 0);          // not in program, declared in module
+  symtab_insert_public(module_st, "ggg", 0, 0x300);   // not in program, defined in module
 
   SEGMENT_MAP* seg_map = new_segment_map(4);
   CuAssertPtrNotNull(tc, seg_map);
@@ -868,52 +868,52 @@ static void test_add_symbols(CuTest* tc) {
   CuAssertIntEquals(tc, 5, sym_map->val[3]);
   CuAssertIntEquals(tc, 6, sym_map->val[4]);
 
-  CuAssertIntEquals(tc, 7, sym_count(prog_st));
+  CuAssertIntEquals(tc, 7, symtab_count(prog_st));
 
-  CuAssertStrEquals(tc, "AAA", sym_name(prog_st, 0));
-  CuAssertIntEquals(tc, TRUE, sym_defined(prog_st, 0));
-  CuAssertIntEquals(tc, 0, sym_seg(prog_st, 0));
-  CuAssertIntEquals(tc, 0x120, sym_offset(prog_st, 0));
+  CuAssertStrEquals(tc, "AAA", symtab_name(prog_st, 0));
+  CuAssertIntEquals(tc, TRUE, symtab_defined(prog_st, 0));
+  CuAssertIntEquals(tc, 0, symtab_seg(prog_st, 0));
+  CuAssertIntEquals(tc, 0x120, symtab_offset(prog_st, 0));
 
-  CuAssertStrEquals(tc, "BBB", sym_name(prog_st, 1));
-  CuAssertIntEquals(tc, TRUE, sym_defined(prog_st, 1));
-  CuAssertIntEquals(tc, 1, sym_seg(prog_st, 1));
-  CuAssertIntEquals(tc, 0x1200 + 0x400, sym_offset(prog_st, 1));
+  CuAssertStrEquals(tc, "BBB", symtab_name(prog_st, 1));
+  CuAssertIntEquals(tc, TRUE, symtab_defined(prog_st, 1));
+  CuAssertIntEquals(tc, 1, symtab_seg(prog_st, 1));
+  CuAssertIntEquals(tc, 0x1200 + 0x400, symtab_offset(prog_st, 1));
 
-  CuAssertStrEquals(tc, "CCC", sym_name(prog_st, 2));
-  CuAssertIntEquals(tc, TRUE, sym_defined(prog_st, 2));
-  CuAssertIntEquals(tc, 1, sym_seg(prog_st, 2));
-  CuAssertIntEquals(tc, 0x200, sym_offset(prog_st, 2));
+  CuAssertStrEquals(tc, "CCC", symtab_name(prog_st, 2));
+  CuAssertIntEquals(tc, TRUE, symtab_defined(prog_st, 2));
+  CuAssertIntEquals(tc, 1, symtab_seg(prog_st, 2));
+  CuAssertIntEquals(tc, 0x200, symtab_offset(prog_st, 2));
 
-  CuAssertStrEquals(tc, "DDD", sym_name(prog_st, 3));
-  CuAssertIntEquals(tc, FALSE, sym_defined(prog_st, 3));
-  CuAssertIntEquals(tc, 2, sym_seg(prog_st, 3));
-  CuAssertIntEquals(tc, 0, sym_offset(prog_st, 3));
+  CuAssertStrEquals(tc, "DDD", symtab_name(prog_st, 3));
+  CuAssertIntEquals(tc, FALSE, symtab_defined(prog_st, 3));
+  CuAssertIntEquals(tc, 2, symtab_seg(prog_st, 3));
+  CuAssertIntEquals(tc, 0, symtab_offset(prog_st, 3));
 
-  CuAssertStrEquals(tc, "EEE", sym_name(prog_st, 4));
-  CuAssertIntEquals(tc, FALSE, sym_defined(prog_st, 4));
-  CuAssertIntEquals(tc, 2, sym_seg(prog_st, 4));
-  CuAssertIntEquals(tc, 0, sym_offset(prog_st, 4));
+  CuAssertStrEquals(tc, "EEE", symtab_name(prog_st, 4));
+  CuAssertIntEquals(tc, FALSE, symtab_defined(prog_st, 4));
+  CuAssertIntEquals(tc, 2, symtab_seg(prog_st, 4));
+  CuAssertIntEquals(tc, 0, symtab_offset(prog_st, 4));
 
-  CuAssertStrEquals(tc, "fff", sym_name(prog_st, 5));
-  CuAssertIntEquals(tc, FALSE, sym_defined(prog_st, 5));
-  CuAssertIntEquals(tc, 3, sym_seg(prog_st, 5));
-  CuAssertIntEquals(tc, 0, sym_offset(prog_st, 5));
+  CuAssertStrEquals(tc, "fff", symtab_name(prog_st, 5));
+  CuAssertIntEquals(tc, FALSE, symtab_defined(prog_st, 5));
+  CuAssertIntEquals(tc, 3, symtab_seg(prog_st, 5));
+  CuAssertIntEquals(tc, 0, symtab_offset(prog_st, 5));
 
-  CuAssertStrEquals(tc, "ggg", sym_name(prog_st, 6));
-  CuAssertIntEquals(tc, TRUE, sym_defined(prog_st, 6));
-  CuAssertIntEquals(tc, 3, sym_seg(prog_st, 6));
-  CuAssertIntEquals(tc, 0x1000 + 0x300, sym_offset(prog_st, 6));
+  CuAssertStrEquals(tc, "ggg", symtab_name(prog_st, 6));
+  CuAssertIntEquals(tc, TRUE, symtab_defined(prog_st, 6));
+  CuAssertIntEquals(tc, 3, symtab_seg(prog_st, 6));
+  CuAssertIntEquals(tc, 0x1000 + 0x300, symtab_offset(prog_st, 6));
 
-  CuAssertIntEquals(tc, 5, sym_count(module_st));
+  CuAssertIntEquals(tc, 5, symtab_count(module_st));
 
   // Clean up
 
   delete_vector(sym_map);
   delete_segment_map(seg_map);
   delete_segment_list(prog_segs);
-  delete_symbol_table(module_st);
-  delete_symbol_table(prog_st);
+  delete_symtab(module_st);
+  delete_symtab(prog_st);
 }
 
 static void test_update_offsets(CuTest* tc) {
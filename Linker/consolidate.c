@@ -52,7 +52,7 @@ static void set_stack(SEGMENTED* prog, SEGNO segno, const SEGMENT* seg, int verb
 
   if (verbose >= 2)
     printf("Set image stack segment: program segment %d: %s; offset 0x%04x, size 0x%04x\n",
-           (int)prog->stack.segno, segment_name(prog->segs, prog->stack.segno), (unsigned)prog->stack.offset, (unsigned)prog->stack.size);
+           (int)prog->stack.segno, seglist_name(prog->segs, prog->stack.segno), (unsigned)prog->stack.offset, (unsigned)prog->stack.size);
 }
 
 static void join_segments(SEGMENTED*, SEGNO destno, SEGMENT* dest, SEGNO sourceno, SEGMENT* source, int verbose);
@@ -69,7 +69,7 @@ static void build_group(SEGMENTED* prog, SEGNO first_segno, SEGMENT* first_seg,
   assert(groupno < group_list_count(prog->groups));
 
   if (verbose) {
-    printf("Build group %d: %s\n", (int)groupno, group_name(prog->groups, groupno));
+    printf("Build group %d: %s\n", (int)groupno, grouplist_name(prog->groups, groupno));
     printf("Initial segment in group: %d: %s\n", (int)first_segno, seg_name(first_seg));
   }
 
@@ -201,7 +201,7 @@ static void update_fixups(SEGMENTED* prog, SEGNO source_segno, SEGNO dest_segno,
           printf(", %s", i->u.ext.jump ? "jump displacement" : "data offset");
           break;
         case FT_GROUP_ABSOLUTE_JUMP:
-          printf(" group %d: %s", (int)i->u.groupno, group_name(prog->groups, i->u.groupno));
+          printf(" group %d: %s", (int)i->u.groupno, grouplist_name(prog->groups, i->u.groupno));
           break;
         case FT_SEGMENT:
           printf(" addressing seg %d", (int) i->u.seg.addressed_segno);
@@ -242,10 +242,10 @@ static void update_fixups(SEGMENTED* prog, SEGNO source_segno, SEGNO dest_segno,
         // when segments are at their final location.
         // Meanwhile the stored offset value should be zero.
         if (offset_value != 0) {
-          fprintf(stderr, "Location of external reference does not hold 0: "
-                          "seg %d, offset 0x%04x, value 0x%04x\n",
+          fprintf(error_stream(), "Location of external reference does not hold 0: "
+                                  "seg %d, offset 0x%04x, value 0x%04x\n",
               (int) i->holding_seg, (unsigned) i->holding_offset, (unsigned) offset_value);
-          exit(EXIT_FAILURE);
+          fail();
         }
         break;
       case FT_GROUP_ABSOLUTE_JUMP:
@@ -259,10 +259,10 @@ static void update_fixups(SEGMENTED* prog, SEGNO source_segno, SEGNO dest_segno,
         // when the program image is built, and finalised at load time.
         // Meanwhile the stored value should be zero.
         if (offset_value != 0) {
-          fprintf(stderr, "Location of segment reference does not hold 0: "
-                          "seg %d, offset 0x%04x, value 0x%04x\n",
+          fprintf(error_stream(), "Location of segment reference does not hold 0: "
+                                  "seg %d, offset 0x%04x, value 0x%04x\n",
               (int) i->holding_seg, (unsigned) i->holding_offset, (unsigned) offset_value);
-          exit(EXIT_FAILURE);
+          fail();
         }
         if (i->u.seg.addressed_segno == source_segno) {
           i->u.seg.addressed_segno = dest_segno;
@@ -274,10 +274,10 @@ static void update_fixups(SEGMENTED* prog, SEGNO source_segno, SEGNO dest_segno,
         // when the program image is built, and finalised at load time.
         // Meanwhile the stored value should be zero.
         if (offset_value != 0) {
-          fprintf(stderr, "Location of group reference does not hold 0: "
-                          "seg %d, offset 0x%04x, value 0x%04x\n",
+          fprintf(error_stream(), "Location of group reference does not hold 0: "
+                                  "seg %d, offset 0x%04x, value 0x%04x\n",
               (int) i->holding_seg, (unsigned) i->holding_offset, (unsigned) offset_value);
-          exit(EXIT_FAILURE);
+          fail();
         }
         break;
       default:
@@ -310,7 +310,7 @@ static void update_fixups(SEGMENTED* prog, SEGNO source_segno, SEGNO dest_segno,
 // Change a label in the source segment into one in the consolidated group main segment.
 static void update_symbol_definitions_for_new_segment_number_and_base(
     SYMTAB* st, SEGNO source_segno, SEGNO dest_segno, DWORD base) {
-  for (SYMBOL_ID i = 0; i < sym_count(st); i++) {
+  for (SYMBOL_ID i = 0; i < symtab_count(st); i++) {
     SYMBOL* sym = symbol(st, i);
     if (sym->seg == source_segno) {
       sym->seg = dest_segno;
@@ -448,33 +448,33 @@ static void test_update_externals(CuTest* tc) {
 }
 
 static void test_update_symbols(CuTest* tc) {
-  SYMTAB* st = new_symbol_table(CASE_INSENSITIVE);
+  SYMTAB* st = new_symtab(CASE_INSENSITIVE);
 
-  // sym_insert_public(st, name, segno, offset)
-  sym_insert_public(st, "AAA", 0, 0x3000);
-  sym_insert_public(st, "BBB", 1, 0x4000);
-  sym_insert_extern(st, "CCC", 0);
+  // symtab_insert_public(st, name, segno, offset)
+  symtab_insert_public(st, "AAA", 0, 0x3000);
+  symtab_insert_public(st, "BBB", 1, 0x4000);
+  symtab_insert_extern(st, "CCC", 0);
 
   const WORD BASE = 0x100;
 
   update_symbol_definitions_for_new_segment_number_and_base(st, 1, 0, BASE);
 
   // AAA stays in seg 0 at 0x3000
-  CuAssertIntEquals(tc, TRUE, sym_defined(st, 0));
-  CuAssertIntEquals(tc, 0, sym_seg(st, 0));
-  CuAssertIntEquals(tc, 0x3000, sym_offset(st, 0));
+  CuAssertIntEquals(tc, TRUE, symtab_defined(st, 0));
+  CuAssertIntEquals(tc, 0, symtab_seg(st, 0));
+  CuAssertIntEquals(tc, 0x3000, symtab_offset(st, 0));
 
   // BBB moves to seg 0 at 0x4000 from new base
-  CuAssertIntEquals(tc, TRUE, sym_defined(st, 1));
-  CuAssertIntEquals(tc, 0, sym_seg(st, 1));
-  CuAssertIntEquals(tc, BASE + 0x4000, sym_offset(st, 1));
+  CuAssertIntEquals(tc, TRUE, symtab_defined(st, 1));
+  CuAssertIntEquals(tc, 0, symtab_seg(st, 1));
+  CuAssertIntEquals(tc, BASE + 0x4000, symtab_offset(st, 1));
 
   // CCC is still an undefined external
-  CuAssertIntEquals(tc, FALSE, sym_defined(st, 2));
-  CuAssertIntEquals(tc, 0, sym_seg(st, 2));
-  CuAssertIntEquals(tc, 0, sym_offset(st, 2));
+  CuAssertIntEquals(tc, FALSE, symtab_defined(st, 2));
+  CuAssertIntEquals(tc, 0, symtab_seg(st, 2));
+  CuAssertIntEquals(tc, 0, symtab_offset(st, 2));
 
-  delete_symbol_table(st);
+  delete_symtab(st);
 }
 
 CuSuite* consolidate_test_suite(void) {
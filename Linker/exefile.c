@@ -17,8 +17,7 @@ void delete_buildexe(BUILDEXE* exe) {
 #define PAGE_SIZE (512)
 
 #define HEADER_PARAGRAPHS (0x20)    // Turbo compatible
-#define HEADER_SIZE (HEADER_PARAGRAPHS * PARA_SIZE)
-#define HEADER_PAGES (HEADER_SIZE / PAGE_SIZE)
+#define RELOC_TABLE_POS (0x3e)      // Turbo compatible
 
 static RELOC_ITEM* build_reloc_table(const WORD exRelocItems, FIXUPS*);
 
@@ -31,17 +30,10 @@ BUILDEXE* build_exe(SEGMENTED* prog, IMAGE* image) {
   if (!image->start.set)
     fatal("no start address for EXE\n");
 
-  if (image->hi / PAGE_SIZE > (unsigned)((WORD)(-1) - HEADER_PAGES - 2))
-    fatal("image too large for EXE\n");
-
   BUILDEXE* exe = emalloc(sizeof *exe);
 
   exe->image = image;
 
-  exe->header.exSignature = 0x5A4D;
-  exe->header.exExtraBytes = image->hi % PAGE_SIZE;
-  exe->header.exPages = HEADER_PAGES + (WORD)(image->hi / PAGE_SIZE) + (image->hi % PAGE_SIZE != 0);
-
   size_t n = segment_and_group_fixups(prog->fixups);
   if (n) {
     if (n > (WORD)(-1))
@@ -54,7 +46,18 @@ BUILDEXE* build_exe(SEGMENTED* prog, IMAGE* image) {
     exe->reloc_table = NULL;
   }
 
-  exe->header.exHeaderSize = HEADER_PARAGRAPHS;
+  // The header grows beyond the usual size only to hold a long relocation table.
+  const DWORD reloc_end = RELOC_TABLE_POS + 4 * (DWORD) exe->header.exRelocItems;
+  const DWORD header_paragraphs = (reloc_end + PARA_SIZE - 1) / PARA_SIZE;
+  exe->header.exHeaderSize = (header_paragraphs > HEADER_PARAGRAPHS) ? (WORD) header_paragraphs : HEADER_PARAGRAPHS;
+
+  const DWORD file_size = exe->header.exHeaderSize * PARA_SIZE + image->hi;
+  if (file_size / PAGE_SIZE >= (WORD)(-1))
+    fatal("image too large for EXE\n");
+  exe->header.exSignature = 0x5A4D;
+  exe->header.exExtraBytes = file_size % PAGE_SIZE;
+  exe->header.exPages = (WORD)(file_size / PAGE_SIZE) + (file_size % PAGE_SIZE != 0);
+
   exe->header.exMinAlloc = (WORD) (image->space / 16 + (image->space % 16 != 0));
   exe->header.exMaxAlloc = 0xffff; // Turbo compatible
   if (image->stack.set) {
@@ -64,7 +67,7 @@ BUILDEXE* build_exe(SEGMENTED* prog, IMAGE* image) {
   else {
     exe->header.exInitSS = 0;
     exe->header.exInitSP = 0;
-    fprintf(stderr, "Warning: no stack\n");
+    fprintf(error_stream(), "Warning: no stack\n");
   }
   exe->header.exCheckSum = 0;
   if (image->start.set) {
@@ -73,7 +76,7 @@ BUILDEXE* build_exe(SEGMENTED* prog, IMAGE* image) {
   }
   else
     fatal("cannot build EXE: no start address\n");
-  exe->header.exRelocTable = 0x3e; // Turbo compatible
+  exe->header.exRelocTable = RELOC_TABLE_POS;
   exe->header.exOverlay = 0;
 
   return exe;
@@ -125,7 +128,7 @@ void output_exe(BUILDEXE* exe, const char* output_name) {
     }
   }
 
-  for ( ; written < HEADER_SIZE; written++)
+  for ( ; written < exe->header.exHeaderSize * PARA_SIZE; written++)
     fputc(0, fp);
 
   fwrite(exe->image->data, 1, exe->image->hi, fp);
@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include "fixup.h"
+#include "profile.h"
 
 const char* fixup_type_name(int t) {
   const char* s = "???";
@@ -44,6 +45,7 @@ DWORD fixups_count(const FIXUPS* p) {
 FIXUP* fixup(FIXUPS* p, DWORD i) {
   assert(p != NULL);
   assert(i < p->used);
+  PROFILE_COUNT(PC_FIXUPS);
   return &p->offsets[i];
 }
 
@@ -91,6 +93,7 @@ void append_fixups(FIXUPS* dest, FIXUPS* source) {
 }
 
 static unsigned insert(FIXUPS* p, short type, SEGNO holding_seg, WORD holding_offset) {
+  PROFILE_COUNT(PC_FIXUPS);
   expand(p, 1);
   assert(p->used < p->allocated);
   unsigned i = p->used++;
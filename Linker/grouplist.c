@@ -31,7 +31,7 @@ GROUPNO group_list_count(const GROUP_LIST* list) {
   return list->used;
 }
 
-const char* group_name(const GROUP_LIST* list, unsigned index) {
+const char* grouplist_name(const GROUP_LIST* list, unsigned index) {
   assert(list != NULL);
   assert(index < list->used);
   return list->groups[index].name;
@@ -111,7 +111,7 @@ static void test_group_list(CuTest* tc) {
   CuAssertIntEquals(tc, 1, list->used);
   CuAssertIntEquals(tc, TRUE, group_defined(list, "Norg"));
   CuAssertIntEquals(tc, 1, group_list_count(list));
-  CuAssertStrEquals(tc, "norg", group_name(list, 0));
+  CuAssertStrEquals(tc, "norg", grouplist_name(list, 0));
   CuAssertIntEquals(tc, 0, group_index(list, "NORG"));
   CuAssertIntEquals(tc, NO_GROUP, group_index(list, "BORG"));
 
@@ -32,7 +32,7 @@ GROUPNO group_list_count(const GROUP_LIST*);
 BOOL group_defined(GROUP_LIST*, const char* name);
 unsigned group_index(GROUP_LIST*, const char* name);
 unsigned add_group(GROUP_LIST*, const char* name);
-const char* group_name(const GROUP_LIST*, unsigned index);
+const char* grouplist_name(const GROUP_LIST*, unsigned index);
 SEGNO group_main_segno(const GROUP_LIST*, unsigned index);
 void set_group_main_segno(const GROUP_LIST*, unsigned index, SEGNO);
 
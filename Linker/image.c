@@ -156,7 +156,7 @@ static void fprint_map(FILE* fp, const SEGMENTED* prog, DWORD addr, const SEGMEN
     type = "SEGMENT";
   }
   else {
-    name = group_name(prog->groups, seg_group(seg));
+    name = grouplist_name(prog->groups, seg_group(seg));
     type = "GROUP";
   }
 
@@ -281,7 +281,7 @@ static void resolve_group_fixup(IMAGE* image, FIXUP* p, unsigned i, VECTOR* base
   assert(groupno != NO_GROUP);
   SEGNO segno = group_main_segno(groups, groupno);
   if (segno < 0 || (unsigned)segno >= bases->size)
-    fatal("group has no valid segment: %d: %s\n", (int)groupno, group_name(groups, groupno));
+    fatal("group has no valid segment: %d: %s\n", (int)groupno, grouplist_name(groups, groupno));
   DWORD addressed_base = bases->val[segno];
   assert(addressed_base % 16 == 0);
   DWORD addressed_seg_addr = addressed_base / 16;
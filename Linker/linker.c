@@ -0,0 +1,157 @@
+// Basic Linker
+// Copyright (c) 2021-24 Nigel Perks
+// Linker library: object records in memory to a program image.
+
+#include <stdio.h>
+#include <assert.h>
+#include "linker.h"
+#include "module.h"
+#include "combine.h"
+#include "consolidate.h"
+#include "resolve.h"
+#include "format.h"
+#include "exefile.h"
+#include "comfile.h"
+#include "binfile.h"
+#include "trace.h"
+#include "utils.h"
+
+struct linker {
+  LINK_SETTINGS settings;
+  int case_sensitivity;
+  PROFILE* profile;
+  SEGMENTED* program;
+  IMAGE* image;
+};
+
+void init_link_settings(LINK_SETTINGS* settings) {
+  assert(settings != NULL);
+  settings->case_sensitive = false;
+  settings->verbose = 0;
+  settings->mapfile = NULL;
+}
+
+LINKER* new_linker(const char* program_name, const LINK_SETTINGS* settings, PROFILE* profile) {
+  assert(program_name != NULL);
+  assert(settings != NULL);
+  assert(profile != NULL);
+
+  LINKER* linker = emalloc(sizeof *linker);
+  linker->settings = *settings;
+  linker->case_sensitivity = settings->case_sensitive ? CASE_SENSITIVE : CASE_INSENSITIVE;
+  linker->profile = profile;
+  linker->program = new_segmented(program_name, linker->case_sensitivity);
+  linker->image = NULL;
+  return linker;
+}
+
+void delete_linker(LINKER* linker) {
+  if (linker) {
+    delete_image(linker->image);
+    delete_segmented(linker->program);
+    efree(linker);
+  }
+}
+
+typedef struct {
+  SEGMENTED* program;
+  SEGMENTED* module;
+  int verbose;
+} INCORPORATION;
+
+static void incorporate_job(void* arg) {
+  INCORPORATION* inc = arg;
+  incorporate_module(inc->program, inc->module, inc->verbose);
+}
+
+void link_module(LINKER* linker, const OFILE* ofile, const char* module_name) {
+  assert(linker != NULL);
+  assert(ofile != NULL);
+  assert(module_name != NULL);
+  assert(linker->image == NULL);
+
+  const int verbose = linker->settings.verbose;
+
+  TRACE_BEGIN("module %s", module_name);
+
+  // Process the object file records into a SEGMENTED structure for the module.
+  begin_phase(linker->profile, "load");
+  SEGMENTED* module_segments = build_module_segments(ofile, linker->case_sensitivity, verbose, module_name);
+
+  // Add private segments, and combine public segments, in the module, into program segments,
+  // modifying the module's fixups appropriately and adding them to the program's fixups.
+  // The module is deleted even if it conflicts with the program, for a resident caller.
+  begin_phase(linker->profile, "combine");
+  INCORPORATION inc = { linker->program, module_segments, verbose };
+  const bool ok = run_job(incorporate_job, &inc, error_stream());
+
+  delete_segmented(module_segments);
+  end_phase(linker->profile);
+  TRACE_END();
+  if (!ok)
+    fail();
+}
+
+const IMAGE* link_image(LINKER* linker) {
+  assert(linker != NULL);
+  assert(linker->image == NULL);
+
+  const int verbose = linker->settings.verbose;
+
+  // Consolidate segments into groups.
+  begin_phase(linker->profile, "consolidate");
+  consolidate_groups_and_stack(linker->program, verbose);
+
+  // Resolve external symbol values, checking all have been defined.
+  // Convert absolute jump offsets in groups to PC-relative displacements.
+  begin_phase(linker->profile, "resolve");
+  resolve_fixups(linker->program, verbose);
+
+  // Build a program image from the distinct segments and groups,
+  // writing a map file if required.
+  begin_phase(linker->profile, "image");
+  linker->image = build_image(linker->program, linker->settings.mapfile, verbose);
+  end_phase(linker->profile);
+
+  return linker->image;
+}
+
+static void check_no_fixups(const SEGMENTED* segmented_program, const char* format) {
+  unsigned long n = segment_and_group_fixups(segmented_program->fixups);
+  if (n)
+    fatal("cannot produce %s file: segment fixups: %lu\n", format, n);
+}
+
+void output_program(LINKER* linker, int format, const char* output_name) {
+  assert(linker != NULL);
+  assert(linker->image != NULL);
+  assert(output_name != NULL);
+
+  if (linker->settings.verbose)
+    printf("Output %s file: %s\n", format_name(format), output_name);
+
+  begin_phase(linker->profile, "output");
+  switch (format) {
+    case BIN_FORMAT:
+      // Check that there are no segment address fixups to be performed at load time.
+      // A raw binary file does not support that.
+      check_no_fixups(linker->program, "BIN");
+      output_bin(linker->image, output_name);
+      break;
+    case COM_FORMAT:
+      // Check that there are no segment address fixups to be performed at load time.
+      // A bare COM file does not support that.
+      check_no_fixups(linker->program, "COM");
+      output_com(linker->image, output_name);
+      break;
+    case EXE_FORMAT: {
+      BUILDEXE* exe = build_exe(linker->program, linker->image);
+      output_exe(exe, output_name);
+      delete_buildexe(exe);
+      break;
+    }
+    default:
+      fatal("output format known but unimplemented: %s\n", format_name(format));
+  }
+  end_phase(linker->profile);
+}
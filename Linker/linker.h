@@ -0,0 +1,40 @@
+// Basic Linker
+// Copyright (c) 2021-24 Nigel Perks
+// Linker library: object records in memory to a program image.
+
+#ifndef LINKER_H
+#define LINKER_H
+
+#include <stdbool.h>
+#include "object.h"
+#include "image.h"
+#include "profile.h"
+
+typedef struct {
+  bool case_sensitive;
+  int verbose;
+  const char* mapfile;  // written when the image is built, if not NULL
+} LINK_SETTINGS;
+
+// The defaults of blink.
+void init_link_settings(LINK_SETTINGS*);
+
+typedef struct linker LINKER;
+
+// Errors are reported on error_stream() and end in fail(): see run_job.
+// Each step is timed as a phase of the profile.
+LINKER* new_linker(const char* program_name, const LINK_SETTINGS*, PROFILE*);
+void delete_linker(LINKER*);
+
+// Combine the segments of an object module into the program.
+// The object records are not kept.
+void link_module(LINKER*, const OFILE*, const char* module_name);
+
+// Once all modules are linked: consolidate groups, resolve fixups
+// and build the image, which belongs to the linker.
+const IMAGE* link_image(LINKER*);
+
+// Write the image in a format from format.h.
+void output_program(LINKER*, int format, const char* output_name);
+
+#endif // LINKER_H
@@ -9,14 +9,14 @@ OBJECT MODULE STRUCTURE
 -----------------------
 
 OBJ_BEGIN_GROUP         ; begin group definition
-    OBJ_ORDINAL byte    ; group number
+    OBJ_ORDINAL word    ; group number
     NAME string         ; group name
 OBJ_END_GROUP           ; end group definition
 
 OBJ_BEGIN_SEGMENT       ; begin segment definition
-    OBJ_ORDINAL byte    ; segment number
+    OBJ_ORDINAL word    ; segment number
     OBJ_NAME string     ; segment name
-    OBJ_GROUPNO byte    ; (optional) segment's group number
+    OBJ_GROUPNO word    ; (optional) segment's group number
     OBJ_PUBLIC          ; (optional) the segment is public
     OBJ_STACK           ; (optional) the segment is a stack segment
     OBJ_P2ALIGN byte    ; (optional) alignment of segment in image
@@ -37,7 +37,7 @@ OBJ_OPEN_SEGMENT        ; open segment to add code and data to it
 
     OBJ_BEGIN_OFFSET        ; begin offset fixup
         OBJ_POS word        ; position in segment of offset to be fixed up
-        OBJ_SEGNO byte      ; segment to which the offset belongs
+        OBJ_SEGNO word      ; segment to which the offset belongs
     OBJ_END_OFFSET          ; end offset fixup
 
     OBJ_BEGIN_EXTRN_USE     ; EXTRN requirement
@@ -48,17 +48,17 @@ OBJ_OPEN_SEGMENT        ; open segment to add code and data to it
 
     OBJ_BEGIN_GROUP_ABS_JUMP    ; begin fixup of jump to numeric offset in group
         OBJ_POS word            ; position in segment of jump offset to be fixed up
-        OBJ_GROUPNO byte        ; group to which the offset belongs
+        OBJ_GROUPNO word        ; group to which the offset belongs
     OBJ_END_GROUP_ABS_JUMP      ; end absolute group jump fixup
 
     OBJ_BEGIN_SEG_ADDR      ; begin fixup of segment address of segment
         OBJ_POS word        ; position in segment where segment address should be placed
-        OBJ_SEGNO byte      ; segment number whose segment address to use
+        OBJ_SEGNO word      ; segment number whose segment address to use
     OBJ_END_SEG_ADDR        ; end fixup of segment address
 
     OBJ_BEGIN_GROUP_ADDR    ; begin fixup of segment address of group
         OBJ_POS word        ; position in segment where segment address should be placed
-        OBJ_GROUPNO byte    ; group number whose segment address to use
+        OBJ_GROUPNO word    ; group number whose segment address to use
     OBJ_END_GROUP_ADDR      ; end fixup of group segment address
 
 OBJ_CLOSE_SEGMENT       ; close segment
@@ -68,17 +68,17 @@ OBJ_CASED               ; (optional) indicate case-sensitive symbols
 OBJ_BEGIN_EXTRN_DEF     ; begin definition of external symbol to be imported
     OBJ_ID word         ; external symbol ID
     OBJ_NAME string     ; symbol name
-    OBJ_SEGNO byte      ; segment to which symbol belongs
+    OBJ_SEGNO word      ; segment to which symbol belongs
 OBJ_END_EXTRN_DEF       ; end definition of external symbol to be imported
 
 OBJ_BEGIN_PUBLIC        ; begin public symbol (public symbol table entry)
     OBJ_NAME string     ; symbol name
-    OBJ_SEGNO byte      ; segment containing the label
+    OBJ_SEGNO word      ; segment containing the label
     OBJ_OFFSET word     ; offset in segment: value of label
 OBJ_END_PUBLIC          ; end public symbol
 
 OBJ_BEGIN_START         ; begin specification of program start (entry point)
-    OBJ_SEGNO byte      ; starting segment
+    OBJ_SEGNO word      ; starting segment
     OBJ_OFFSET word     ; starting offset
 OBJ_END_START           ; end specification of program start
 
@@ -221,7 +221,7 @@ static void define_group(STATE* state, const OFILE* ofile, SEGMENTED* segs, int
         return;
       }
       case OBJ_ORDINAL:
-        groupno = (GROUPNO) objbyte(rec);
+        groupno = (GROUPNO) objword(rec);
         break;
       case OBJ_NAME:
         if (rec->u.data.size > sizeof name - 1)
@@ -268,7 +268,7 @@ static void define_segment(STATE* state, const OFILE* ofile, SEGMENTED* segs, in
         if (segno < 0)
           fatal("segment definition segno = %d < 0\n", (int)segno);
         if (segno < segment_list_count(segs->segs))
-          fatal("segment %d: %s redefined as %s\n", (int)segno, segment_name(segs->segs, segno), name[0] ? name : "(no name)");
+          fatal("segment %d: %s redefined as %s\n", (int)segno, seglist_name(segs->segs, segno), name[0] ? name : "(no name)");
         if (segno != segment_list_count(segs->segs))
           fatal("unexpected ordinal in segment definition\n");
         if (name[0] == '\0')
@@ -278,11 +278,11 @@ static void define_segment(STATE* state, const OFILE* ofile, SEGMENTED* segs, in
         if (groupno != NO_GROUP && groupno >= group_list_count(segs->groups))
           fatal("segment: %s: group number out of range: %u\n", name, groupno);
         add_segment(segs->segs, name, public, stack, groupno);
-        set_segment_p2align(segs->segs, segno, p2align);
+        set_seglist_p2align(segs->segs, segno, p2align);
         return;
       }
       case OBJ_ORDINAL:
-        segno = (SEGNO) objbyte(rec);
+        segno = (SEGNO) objword(rec);
         break;
       case OBJ_NAME:
         if (rec->u.data.size > sizeof name - 1)
@@ -291,7 +291,7 @@ static void define_segment(STATE* state, const OFILE* ofile, SEGMENTED* segs, in
         name[rec->u.data.size] = '\0';
         break;
       case OBJ_GROUPNO:
-        groupno = (GROUPNO) objbyte(rec);
+        groupno = (GROUPNO) objword(rec);
         break;
       case OBJ_PUBLIC:
         public = TRUE;
@@ -335,9 +335,9 @@ static void process_segment_fragment(STATE* state, const OFILE* ofile, SEGMENTED
 
   const OREC* rec = ofile->recs + state->pos;
   assert(rec->type == OBJ_OPEN_SEGMENT);
-  if (objbyte(rec) >= segment_list_count(segs->segs))
-    fatal("invalid ordinal segment number: %u\n", objbyte(rec));
-  state->segno = objbyte(rec);
+  if (objword(rec) >= segment_list_count(segs->segs))
+    fatal("invalid ordinal segment number: %u\n", objword(rec));
+  state->segno = objword(rec);
   state->seg = get_segment(segs->segs, state->segno);
 
   for (state->pos++; state->pos < ofile->used; state->pos++) {
@@ -348,7 +348,7 @@ static void process_segment_fragment(STATE* state, const OFILE* ofile, SEGMENTED
 
     switch (rec->type) {
       case OBJ_CLOSE_SEGMENT:
-        if (objbyte(rec) != state->segno)
+        if (objword(rec) != state->segno)
           fatal("open/close segment number mismatch\n");
         if (seg_hi(state->seg) && seg_space(state->seg))
           fatal("segment has both initialised and uninitialised data: %u %s\n",
@@ -461,7 +461,7 @@ static void process_offset_info(STATE* state, const OFILE* ofile, SEGMENTED* seg
         have_pos = TRUE;
         break;
       case OBJ_SEGNO:
-        offset_segno = objbyte(rec);
+        offset_segno = objword(rec);
         if (offset_segno < 0 || offset_segno >= segment_list_count(segs->segs))
           fatal("undefined segment number: %d\n", (int)offset_segno);
         break;
@@ -505,7 +505,7 @@ static void process_extern_use(STATE* state, const OFILE* ofile, SEGMENTED* segs
           fatal("external use does not specify position\n");
         if (ext_id == NO_SYM)
           fatal("external use does not specify symbol ID\n");
-        if (ext_id < 0 || ext_id >= (int) sym_count(segs->st))
+        if (ext_id < 0 || ext_id >= (int) symtab_count(segs->st))
           fatal("external use ID out of range\n");
         add_external_fixup(segs->fixups, state->segno, offset_pos, ext_id, jump);
         return;
@@ -555,13 +555,13 @@ static void define_external(STATE* state, const OFILE* ofile, SEGMENTED* segs, i
           fatal("%s: external symbol definition lacks ID\n", state->module_name);
         if (name[0] == '\0')
           fatal("%s: external symbol definition lacks name\n", state->module_name);
-        if (sym_lookup(segs->st, name) != NO_SYM)
+        if (symtab_lookup(segs->st, name) != NO_SYM)
           fatal("%s: duplicate external symbol: %s\n", state->module_name, name);
-        if (sym_next_id(segs->st) != id)
+        if (symtab_next_id(segs->st) != id)
           fatal("%s: external symbol out of sequence: %s\n", state->module_name, name);
         if (segno == NO_SEG)
           fatal("%s: external symbol definition lacks segment\n", state->module_name);
-        sym_insert_extern(segs->st, name, segno);
+        symtab_insert_extern(segs->st, name, segno);
         return;
       }
       case OBJ_ID:
@@ -574,7 +574,7 @@ static void define_external(STATE* state, const OFILE* ofile, SEGMENTED* segs, i
         name[rec->u.data.size] = '\0';
         break;
       case OBJ_SEGNO:
-        segno = objbyte(rec);
+        segno = objword(rec);
         if (segno >= segment_list_count(segs->segs))
           fatal("undefined segment number: %u\n", (unsigned) segno);
         break;
@@ -618,9 +618,9 @@ static void define_public(STATE* state, const OFILE* ofile, SEGMENTED* segs, int
           fatal("%s: public symbol definition lacks segment\n", state->module_name);
         if (!have_offset)
           fatal("%s: public symbol definition lacks offset\n", state->module_name);
-        if (sym_lookup(segs->st, name) != NO_SYM)
+        if (symtab_lookup(segs->st, name) != NO_SYM)
           fatal("%s: duplicate public symbol: %s\n", state->module_name, name);
-        sym_insert_public(segs->st, name, segno, offset);
+        symtab_insert_public(segs->st, name, segno, offset);
         return;
       }
       case OBJ_NAME:
@@ -630,7 +630,7 @@ static void define_public(STATE* state, const OFILE* ofile, SEGMENTED* segs, int
         name[rec->u.data.size] = '\0';
         break;
       case OBJ_SEGNO:
-        segno = objbyte(rec);
+        segno = objword(rec);
         if (segno >= segment_list_count(segs->segs))
           fatal("undefined segment number: %u\n", (unsigned) segno);
         break;
@@ -679,7 +679,7 @@ static void define_start(STATE* state, const OFILE* ofile, SEGMENTED* segs, int
         return;
       }
       case OBJ_SEGNO:
-        segno = objbyte(rec);
+        segno = objword(rec);
         if (segno >= segment_list_count(segs->segs))
           fatal("undefined segment number: %u\n", (unsigned) segno);
         break;
@@ -738,7 +738,7 @@ static void process_group_absolute_jump(STATE* state, const OFILE* ofile, SEGMEN
         have_pos = TRUE;
         break;
       case OBJ_GROUPNO:
-        groupno = objbyte(rec);
+        groupno = objword(rec);
         break;
       default:
         fatal("invalid object record type in group absolute jump: %d\n", rec->type);
@@ -785,9 +785,9 @@ static void process_segment_address_use(STATE* state, const OFILE* ofile, SEGMEN
         have_pos = TRUE;
         break;
       case OBJ_SEGNO:
-        if (objbyte(rec) >= segment_list_count(segs->segs))
-          fatal("undefined segment number: %u\n", (unsigned)objbyte(rec));
-        segno = objbyte(rec);
+        if (objword(rec) >= segment_list_count(segs->segs))
+          fatal("undefined segment number: %u\n", (unsigned)objword(rec));
+        segno = objword(rec);
         break;
       default:
         fatal("invalid object record type in segment address use: %d\n", rec->type);
@@ -834,9 +834,9 @@ static void process_group_address_use(STATE* state, const OFILE* ofile, SEGMENTE
         have_pos = TRUE;
         break;
       case OBJ_GROUPNO:
-        if (objbyte(rec) >= group_list_count(segs->groups))
-          fatal("undefined group number: %u\n", (unsigned)objbyte(rec));
-        groupno = objbyte(rec);
+        if (objword(rec) >= group_list_count(segs->groups))
+          fatal("undefined group number: %u\n", (unsigned)objword(rec));
+        groupno = objword(rec);
         break;
       default:
         fatal("invalid object record type in group address use: %d\n", rec->type);
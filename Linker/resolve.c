@@ -46,9 +46,9 @@ void resolve_fixups(SEGMENTED* segs, int verbose) {
 
 static unsigned report_undefined_symbols(SYMTAB* st) {
   unsigned errors = 0;
-  for (SYMBOL_ID i = 0; i < sym_count(st); i++) {
-    if (!sym_defined(st, i)) {
-      fprintf(stderr, "Unresolved external: %s\n", sym_name(st, i));
+  for (SYMBOL_ID i = 0; i < symtab_count(st); i++) {
+    if (!symtab_defined(st, i)) {
+      fprintf(error_stream(), "Unresolved external: %s\n", symtab_name(st, i));
       errors++;
     }
   }
@@ -67,17 +67,17 @@ static BOOL resolve_external(unsigned i, const FIXUP* e, SYMTAB* st, SEGMENT_LIS
     printf("EXTUSE %u: in seg %u at 0x%04x: symbol %d: %s: value 0x%04x\n",
         i,
         (unsigned) e->holding_seg, (unsigned) e->holding_offset,
-        (int) e->u.ext.id, sym_name(st, e->u.ext.id), (unsigned) sym_offset(st, e->u.ext.id));
+        (int) e->u.ext.id, symtab_name(st, e->u.ext.id), (unsigned) symtab_offset(st, e->u.ext.id));
 
   SEGMENT* seg = get_segment(segs, e->holding_seg);
   if (seg->hi < 2 || e->holding_offset > seg->hi - 2) {
-    fprintf(stderr, "External reference offset beyond segment: %s\n", sym_name(st, e->u.ext.id));
+    fprintf(error_stream(), "External reference offset beyond segment: %s\n", symtab_name(st, e->u.ext.id));
     return FALSE;
   }
 
   WORD w = read_word_le(seg->data + e->holding_offset);
   if (w) {
-    fprintf(stderr, "Location of external reference does not hold 0: seg %d, offset 0x%04x, value 0x%04x\n",
+    fprintf(error_stream(), "Location of external reference does not hold 0: seg %d, offset 0x%04x, value 0x%04x\n",
         (int) e->holding_seg, (unsigned) e->holding_offset, (unsigned) w);
     return FALSE;
   }
@@ -88,22 +88,22 @@ static BOOL resolve_external(unsigned i, const FIXUP* e, SYMTAB* st, SEGMENT_LIS
     // This fixup is not for inter-segment jumps,
     // only for a 16-bit signed displacement within a segment.
     // TODO: check that inter-segment jumps are handled elsewhere.
-    if (sym_seg(st, e->u.ext.id) != e->holding_seg) {
-      fprintf(stderr, "Relative jump inter-segment fixup: %s\n", sym_name(st, e->u.ext.id));
+    if (symtab_seg(st, e->u.ext.id) != e->holding_seg) {
+      fprintf(error_stream(), "Relative jump inter-segment fixup: %s\n", symtab_name(st, e->u.ext.id));
       return FALSE;
     }
 
     DWORD instr_end = e->holding_offset + 2; // 16-bit displacement at end of instruction
-    long disp = (long)sym_offset(st, e->u.ext.id) - (long)instr_end;
+    long disp = (long)symtab_offset(st, e->u.ext.id) - (long)instr_end;
     WORD val = (WORD) disp;
     if (verbose >= 3)
       printf("EXTUSE %u: displacement from 0x%04x to symbol 0x%04x = %ld => 0x%04x\n",
-           i, (unsigned)instr_end, (unsigned)sym_offset(st, e->u.ext.id), disp, (unsigned)val);
+           i, (unsigned)instr_end, (unsigned)symtab_offset(st, e->u.ext.id), disp, (unsigned)val);
     write_word_le(seg->data + e->holding_offset, val);
   }
   else {
     // The stored offset is relative to start of segment, not PC-relative.
-    WORD val = (WORD) sym_offset(st, e->u.ext.id);
+    WORD val = (WORD) symtab_offset(st, e->u.ext.id);
     if (verbose >= 3)
       printf("EXTUSE %u: symbol 0x%04x\n", i, (unsigned) val);
     write_word_le(seg->data + e->holding_offset, val);
@@ -122,7 +122,7 @@ static BOOL resolve_group_absolute_jump(unsigned j, const FIXUP* fix, SEGMENT_LI
   WORD target = read_word_le(seg_data(holding_seg) + fix->holding_offset);
   long disp = (long)target - (long)(fix->holding_offset + 2);
   if (disp <= -10000L || disp >= 10000L) {
-    fprintf(stderr, "displacement to group absolute offset is out of 16-bit range\n");
+    fprintf(error_stream(), "displacement to group absolute offset is out of 16-bit range\n");
     return FALSE;
   }
   WORD disp_code = (WORD) disp;
@@ -137,22 +137,22 @@ static BOOL resolve_group_absolute_jump(unsigned j, const FIXUP* fix, SEGMENT_LI
 #include "CuTest.h"
 
 static void test_report_undefined_symbols(CuTest* tc) {
-  SYMTAB* st = new_symbol_table(CASE_INSENSITIVE);
+  SYMTAB* st = new_symtab(CASE_INSENSITIVE);
 
-  sym_insert_extern(st, "AAA", 0);
-  sym_insert_public(st, "BBB", 0, 0);
-  sym_insert_extern(st, "CCC", 1);
-  sym_insert_public(st, "BBB", 1, 0x100);
+  symtab_insert_extern(st, "AAA", 0);
+  symtab_insert_public(st, "BBB", 0, 0);
+  symtab_insert_extern(st, "CCC", 1);
+  symtab_insert_public(st, "BBB", 1, 0x100);
 
   unsigned errors = report_undefined_symbols(st);
   CuAssertIntEquals(tc, 2, errors);
 
-  delete_symbol_table(st);
+  delete_symtab(st);
 }
 
 static void test_resolve_external(CuTest* tc) {
   FIXUPS* ext = new_fixups();
-  SYMTAB* st = new_symbol_table(CASE_INSENSITIVE);
+  SYMTAB* st = new_symtab(CASE_INSENSITIVE);
   SEGMENT_LIST* segs = new_segment_list(CASE_INSENSITIVE);
 
   SEGNO s0 = add_segment(segs, "SEG0", FALSE, FALSE, NO_GROUP);
@@ -167,13 +167,13 @@ static void test_resolve_external(CuTest* tc) {
   BOOL succ;
 
   // Inter-segment data fixup
-  int data0_sym = sym_insert_public(st, "AAA", s0, 0x1234);
+  int data0_sym = symtab_insert_public(st, "AAA", s0, 0x1234);
   int ext_interseg_data = add_external_fixup(ext, s1, 0x08, data0_sym, FALSE);
   succ = resolve_external(ext_interseg_data, fixup(ext, ext_interseg_data), st, segs, verbose);
   CuAssertIntEquals(tc, FALSE, succ);
 
   // Inter-segment jump fixup
-  int jump0_sym = sym_insert_public(st, "BBB", s0, 0x567d);
+  int jump0_sym = symtab_insert_public(st, "BBB", s0, 0x567d);
   int ext_interseg_jump = add_external_fixup(ext, s1, 0x10, jump0_sym, TRUE);
   succ = resolve_external(ext_interseg_jump, fixup(ext, ext_interseg_jump), st, segs, verbose);
   CuAssertIntEquals(tc, FALSE, succ);
@@ -209,7 +209,7 @@ static void test_resolve_external(CuTest* tc) {
   CuAssertIntEquals(tc, 0x70, seg0->data[11]);
 
   delete_segment_list(segs);
-  delete_symbol_table(st);
+  delete_symtab(st);
   delete_fixups(ext);
 }
 
@@ -100,19 +100,19 @@ BOOL segment_defined(const SEGMENT_LIST* list, const char* name) {
   return find_segment(list, name) != NO_SEG;
 }
 
-const char* segment_name(const SEGMENT_LIST* list, SEGNO i) {
+const char* seglist_name(const SEGMENT_LIST* list, SEGNO i) {
   assert(list != NULL);
   assert(i >= 0 && i < list->used);
   return list->seg[i]->name;
 }
 
-BOOL segment_public(const SEGMENT_LIST* list, SEGNO i) {
+BOOL seglist_public(const SEGMENT_LIST* list, SEGNO i) {
   assert(list != NULL);
   assert(i >= 0 && i < list->used);
   return list->seg[i]->public;
 }
 
-GROUPNO segment_group(const SEGMENT_LIST* list, SEGNO i) {
+GROUPNO seglist_group(const SEGMENT_LIST* list, SEGNO i) {
   assert(list != NULL);
   assert(i >= 0 && i < list->used);
   return list->seg[i]->group;
@@ -154,13 +154,13 @@ void remove_segment(SEGMENT_LIST* list, SEGNO index) {
   list->seg[index] = NULL;
 }
 
-void set_segment_p2align(SEGMENT_LIST* list, SEGNO i, unsigned p2align) {
+void set_seglist_p2align(SEGMENT_LIST* list, SEGNO i, unsigned p2align) {
   assert(list != NULL);
   assert(i < list->used);
   list->seg[i]->p2align = (p2align > MAX_SEGMENT_P2ALIGN) ? MAX_SEGMENT_P2ALIGN : p2align;
 }
 
-unsigned segment_p2align(const SEGMENT_LIST* list, SEGNO i) {
+unsigned seglist_p2align(const SEGMENT_LIST* list, SEGNO i) {
   assert(list != NULL);
   assert(i < list->used);
   return list->seg[i]->p2align;
@@ -229,7 +229,7 @@ static void test_segment_list(CuTest* tc) {
   CuAssertTrue(tc, list->allocated >= 1);
   CuAssertIntEquals(tc, 1, list->used);
   CuAssertIntEquals(tc, TRUE, segment_defined(list, "Norg"));
-  CuAssertIntEquals(tc, FALSE, segment_public(list, i));
+  CuAssertIntEquals(tc, FALSE, seglist_public(list, i));
   CuAssertIntEquals(tc, 1, segment_list_count(list));
 
   CuAssertPtrEquals(tc, seg, get_segment(list, 0));
@@ -248,9 +248,9 @@ static void test_segment_list(CuTest* tc) {
   seg = new_segment("Harry", TRUE, FALSE, 3);
   set_segment(list, 0, seg);
   CuAssertPtrEquals(tc, seg, get_segment(list, 0));
-  CuAssertStrEquals(tc, "Harry", segment_name(list, 0));
-  CuAssertIntEquals(tc, 3, segment_group(list, 0));
-  CuAssertIntEquals(tc, TRUE, segment_public(list, 0));
+  CuAssertStrEquals(tc, "Harry", seglist_name(list, 0));
+  CuAssertIntEquals(tc, 3, seglist_group(list, 0));
+  CuAssertIntEquals(tc, TRUE, seglist_public(list, 0));
   CuAssertIntEquals(tc, TRUE, segment_defined(list, "Harry"));
 
   CuAssertIntEquals(tc, 2, list->used);
@@ -21,17 +21,17 @@ SEGNO segment_list_count(SEGMENT_LIST*);
 SEGMENT* get_segment(SEGMENT_LIST*, SEGNO);
 const SEGMENT* get_segment_const(const SEGMENT_LIST*, SEGNO);
 void set_segment(SEGMENT_LIST*, SEGNO, SEGMENT*);
-const char* segment_name(const SEGMENT_LIST*, SEGNO);
-BOOL segment_public(const SEGMENT_LIST*, SEGNO);
-GROUPNO segment_group(const SEGMENT_LIST*, SEGNO);
+const char* seglist_name(const SEGMENT_LIST*, SEGNO);
+BOOL seglist_public(const SEGMENT_LIST*, SEGNO);
+GROUPNO seglist_group(const SEGMENT_LIST*, SEGNO);
 BOOL segment_defined(const SEGMENT_LIST*, const char* name);
 
 SEGNO add_segment(SEGMENT_LIST*, const char* name, BOOL public, BOOL stack, GROUPNO);
 SEGNO reserve_segment(SEGMENT_LIST*);
 void remove_segment(SEGMENT_LIST*, SEGNO);
 
-unsigned segment_p2align(const SEGMENT_LIST*, SEGNO);
-void set_segment_p2align(SEGMENT_LIST*, SEGNO, unsigned p2align);
+unsigned seglist_p2align(const SEGMENT_LIST*, SEGNO);
+void set_seglist_p2align(SEGMENT_LIST*, SEGNO, unsigned p2align);
 
 SEGNO find_public_segment(const SEGMENT_LIST*, const char* name);
 SEGNO find_stack_segment(const SEGMENT_LIST*, const char* name);
@@ -127,7 +127,7 @@ static void ensure_writeable(SEGMENT* seg, MemSize offset, MemSize size) {
     }
     assert(allocate % ALLOCATION_UNIT == 0);
     assert(allocate >= offset + size);
-    BYTE* data = ecalloc(allocate);
+    BYTE* data = tag_memory(ecalloc(allocate), MEM_SEGMENTS);
     if (seg->data != NULL && seg->allocated > 0)
       memcpy(data, seg->data, seg->allocated);
     efree(seg->data);
@@ -515,6 +515,28 @@ static void test_append_segment(CuTest* tc) {
   efree(buf2);
 }
 
+static void test_append_segment_layout(CuTest* tc) {
+  SEGMENT* src = new_segment("CODE", TRUE, FALSE, NO_GROUP);
+  SEGMENT* dest = new_segment("CODE", TRUE, FALSE, NO_GROUP);
+  BYTE buf[16];
+
+  memset(buf, 0x90, sizeof buf);
+  load_segment_data(src, buf, sizeof buf);
+  initial_segment_layout(src, "module");
+
+  for (unsigned m = 0; m < 300; m++)
+    append_segment(dest, src);
+
+  CuAssertIntEquals(tc, 300, dest->layout.count);
+  CuAssertTrue(tc, dest->layout.allocated >= 300);
+  CuAssertStrEquals(tc, "module", dest->layout.entries[299].module_name);
+  CuAssertIntEquals(tc, 299 * sizeof buf, dest->layout.entries[299].addr);
+  CuAssertIntEquals(tc, sizeof buf, dest->layout.entries[299].size);
+
+  delete_segment(src);
+  delete_segment(dest);
+}
+
 static void test_aligning(CuTest* tc) {
   SEGMENT* seg = new_segment("TEST", TRUE, FALSE, 1);
 
@@ -564,8 +586,39 @@ CuSuite* segment_test_suite(void) {
   SUITE_ADD_TEST(suite, test_load_segment_data);
   SUITE_ADD_TEST(suite, test_load_segment_space);
   SUITE_ADD_TEST(suite, test_append_segment);
+  SUITE_ADD_TEST(suite, test_append_segment_layout);
   SUITE_ADD_TEST(suite, test_aligning);
   return suite;
 }
 
+#define BENCH_MODULES (64)
+
+// Combine a public segment from many modules, as the linker does.
+static void bench_append_segment(CuBench* bc) {
+  SEGMENT* src = new_segment("CODE", TRUE, FALSE, NO_GROUP);
+  BYTE buf[256];
+
+  memset(buf, 0x90, sizeof buf);
+  load_segment_data(src, buf, sizeof buf);
+  initial_segment_layout(src, "module");
+
+  CuBenchStart(bc);
+  for (long i = 0; i < bc->n; i++) {
+    SEGMENT* dest = new_segment("CODE", TRUE, FALSE, NO_GROUP);
+    for (unsigned m = 0; m < BENCH_MODULES; m++)
+      append_segment(dest, src);
+    assert(dest->hi == BENCH_MODULES * sizeof buf);
+    delete_segment(dest);
+  }
+  CuBenchStop(bc);
+
+  delete_segment(src);
+}
+
+CuBenchSuite* segment_bench_suite(void) {
+  CuBenchSuite* suite = CuBenchSuiteNew();
+  SUITE_ADD_BENCH(suite, bench_append_segment);
+  return suite;
+}
+
 #endif // UNIT_TEST
\ No newline at end of file
@@ -7,7 +7,9 @@
 
 // Initialise an unused segment layout.
 void init_segment_layout(struct segment_layout * layout) {
+  layout->entries = NULL;
   layout->count = 0;
+  layout->allocated = 0;
 }
 
 // Clear existing segment layout information, freeing its memory.
@@ -17,14 +19,17 @@ void clear_segment_layout(struct segment_layout * layout) {
     efree(layout->entries[i].segment_name);
     efree(layout->entries[i].module_name);
   }
-  layout->count = 0;
+  efree(layout->entries);
+  init_segment_layout(layout);
 }
 
 // Add an entry describing a constituent segment to the layout information of a segment or group.
 void add_segment_layout_entry(struct segment_layout * layout, const char* segment_name, const char* module_name, DWORD addr, DWORD size) {
   assert(layout != NULL);
-  if (layout->count >= MAX_SEGMENT_MAP)
-    fatal("internal error: segment map full\n");
+  if (layout->count == layout->allocated) {
+    layout->allocated = layout->allocated ? 2 * layout->allocated : 4;
+    layout->entries = erealloc(layout->entries, layout->allocated * sizeof layout->entries[0]);
+  }
   struct layout_entry * e = layout->entries + layout->count++;
   e->segment_name = estrdup(segment_name ? segment_name : "");
   e->module_name = estrdup(module_name ? module_name : "");
@@ -15,12 +15,11 @@ struct layout_entry {
   DWORD size;
 };
 
-#define MAX_SEGMENT_MAP (64) // TODO: extendable
-
 // The layout of a segment, listing the constituent segments loaded from object files.
 struct segment_layout {
-  struct layout_entry entries[MAX_SEGMENT_MAP];
+  struct layout_entry * entries;
   unsigned count;
+  unsigned allocated;
 };
 
 void init_segment_layout(struct segment_layout *);
@@ -10,7 +10,7 @@ SEGMENTED* new_segmented(const char* name, int case_sensitivity) {
   segs->name = estrdup(name);
   segs->segs = new_segment_list(case_sensitivity);
   segs->groups = new_group_list(case_sensitivity);
-  segs->st = new_symbol_table(case_sensitivity);
+  segs->st = new_symtab(case_sensitivity);
   segs->fixups = new_fixups();
   segs->start.segno = NO_SEG;
   segs->start.offset = 0;
@@ -24,7 +24,7 @@ void delete_segmented(SEGMENTED* segs) {
     efree(segs->name);
     delete_segment_list(segs->segs);
     delete_group_list(segs->groups);
-    delete_symbol_table(segs->st);
+    delete_symtab(segs->st);
     delete_fixups(segs->fixups);
     efree(segs);
   }
@@ -6,8 +6,9 @@
 #include <string.h>
 #include <assert.h>
 #include "symbol.h"
+#include "profile.h"
 
-SYMTAB* new_symbol_table(int case_sensitivity) {
+SYMTAB* new_symtab(int case_sensitivity) {
   SYMTAB* st = emalloc(sizeof *st);
   st->symbols = NULL;
   st->msym = 0;
@@ -16,7 +17,7 @@ SYMTAB* new_symbol_table(int case_sensitivity) {
   return st;
 }
 
-void delete_symbol_table(SYMTAB* st) {
+void delete_symtab(SYMTAB* st) {
   if (st) {
     for (SYMBOL_ID i = 0; i < st->nsym; i++)
       efree(st->symbols[i].name);
@@ -25,12 +26,12 @@ void delete_symbol_table(SYMTAB* st) {
   }
 }
 
-SYMBOL_ID sym_next_id(SYMTAB* st) {
+SYMBOL_ID symtab_next_id(SYMTAB* st) {
   assert(st != NULL);
   return st->nsym;
 }
 
-SYMBOL_ID sym_count(const SYMTAB* st) {
+SYMBOL_ID symtab_count(const SYMTAB* st) {
   assert(st != NULL);
   return st->nsym;
 }
@@ -47,25 +48,25 @@ const SYMBOL* const_symbol(const SYMTAB* st, SYMBOL_ID id) {
   return st->symbols + id;
 }
 
-const char* sym_name(SYMTAB* st, SYMBOL_ID id) {
+const char* symtab_name(SYMTAB* st, SYMBOL_ID id) {
   assert(st != NULL);
   assert(id >= 0 && id < st->nsym);
   return st->symbols[id].name;
 }
 
-BOOL sym_defined(SYMTAB* st, SYMBOL_ID id) {
+BOOL symtab_defined(SYMTAB* st, SYMBOL_ID id) {
   assert(st != NULL);
   assert(id >= 0 && id < (int) st->nsym);
   return st->symbols[id].defined;
 }
 
-SEGNO sym_seg(SYMTAB* st, SYMBOL_ID id) {
+SEGNO symtab_seg(SYMTAB* st, SYMBOL_ID id) {
   assert(st != NULL);
   assert(id >= 0 && id < (int) st->nsym);
   return st->symbols[id].seg;
 }
 
-DWORD sym_offset(SYMTAB* st, SYMBOL_ID id) {
+DWORD symtab_offset(SYMTAB* st, SYMBOL_ID id) {
   assert(st != NULL);
   assert(id >= 0 && id < (int) st->nsym);
   return st->symbols[id].offset;
@@ -80,26 +81,26 @@ static SYMBOL_ID insert(SYMTAB* st, const char* name, BOOL defined, SEGNO segno,
   assert(st->nsym <= st->msym);
   if (st->nsym == st->msym) {
     st->msym = st->msym ? 2 * st->msym : 32;
-    st->symbols = erealloc(st->symbols, st->msym * sizeof st->symbols[0]);
+    st->symbols = tag_memory(erealloc(st->symbols, st->msym * sizeof st->symbols[0]), MEM_SYMBOLS);
   }
 
   assert(st->nsym < st->msym);
-  st->symbols[st->nsym].name = estrdup(name);
+  st->symbols[st->nsym].name = tag_memory(estrdup(name), MEM_SYMBOLS);
   st->symbols[st->nsym].defined = defined;
   st->symbols[st->nsym].seg = segno;
   st->symbols[st->nsym].offset = offset;
   return st->nsym++;
 }
 
-SYMBOL_ID sym_insert_extern(SYMTAB* st, const char* name, SEGNO segno) {
+SYMBOL_ID symtab_insert_extern(SYMTAB* st, const char* name, SEGNO segno) {
   return insert(st, name, FALSE, segno, 0);
 }
 
-SYMBOL_ID sym_insert_public(SYMTAB* st, const char* name, SEGNO segno, WORD offset) {
+SYMBOL_ID symtab_insert_public(SYMTAB* st, const char* name, SEGNO segno, WORD offset) {
   return insert(st, name, TRUE, segno, offset);
 }
 
-SYMBOL_ID sym_insert_copy(SYMTAB* dest, const SYMTAB* src, SYMBOL_ID src_id) {
+SYMBOL_ID symtab_insert_copy(SYMTAB* dest, const SYMTAB* src, SYMBOL_ID src_id) {
   assert(dest != NULL);
   assert(src != NULL);
   assert(src_id < src->nsym);
@@ -107,7 +108,7 @@ SYMBOL_ID sym_insert_copy(SYMTAB* dest, const SYMTAB* src, SYMBOL_ID src_id) {
   return insert(dest, sym->name, sym->defined, sym->seg, sym->offset);
 }
 
-void sym_define(SYMTAB* st, SYMBOL_ID id, DWORD offset) {
+void symtab_define(SYMTAB* st, SYMBOL_ID id, DWORD offset) {
   assert(st != NULL);
   assert(id >= 0 && id < st->nsym);
   SYMBOL* sym = st->symbols + id;
@@ -117,9 +118,10 @@ void sym_define(SYMTAB* st, SYMBOL_ID id, DWORD offset) {
   sym->offset = offset;
 }
 
-SYMBOL_ID sym_lookup(SYMTAB* st, const char* name) {
+SYMBOL_ID symtab_lookup(SYMTAB* st, const char* name) {
   assert(st != NULL);
   assert(name != NULL);
+  PROFILE_COUNT(PC_LOOKUPS);
   int (*compare)(const char*, const char*) = st->case_sensitivity ? _stricmp : strcmp;
   for (SYMBOL_ID i = 0; i < st->nsym; i++) {
     if (compare(st->symbols[i].name, name) == 0)
@@ -135,7 +137,7 @@ SYMBOL_ID sym_lookup(SYMTAB* st, const char* name) {
 static void test_new_symbol_table(CuTest* tc) {
   SYMTAB* st;
 
-  st = new_symbol_table(CASE_INSENSITIVE);
+  st = new_symtab(CASE_INSENSITIVE);
 
   CuAssertPtrNotNull(tc, st);
   CuAssertPtrEquals(tc, NULL, st->symbols);
@@ -143,20 +145,20 @@ static void test_new_symbol_table(CuTest* tc) {
   CuAssertIntEquals(tc, 0, st->nsym);
   CuAssertIntEquals(tc, CASE_INSENSITIVE, st->case_sensitivity);
 
-  CuAssertIntEquals(tc, 0, sym_next_id(st));
-  CuAssertIntEquals(tc, 0, sym_count(st));
+  CuAssertIntEquals(tc, 0, symtab_next_id(st));
+  CuAssertIntEquals(tc, 0, symtab_count(st));
 
-  delete_symbol_table(st);
+  delete_symtab(st);
 }
 
 static void test_insert(CuTest* tc) {
-  SYMTAB* st = new_symbol_table(CASE_SENSITIVE);
+  SYMTAB* st = new_symtab(CASE_SENSITIVE);
   SYMBOL_ID id;
 
-  id = sym_lookup(st, "FRED");
+  id = symtab_lookup(st, "FRED");
   CuAssertIntEquals(tc, NO_SYM, id);
 
-  id = sym_insert_extern(st, "FRED", 1);
+  id = symtab_insert_extern(st, "FRED", 1);
   CuAssertIntEquals(tc, 0, id);
   CuAssertPtrNotNull(tc, st->symbols);
   CuAssertIntEquals(tc, 1, st->nsym);
@@ -166,15 +168,15 @@ static void test_insert(CuTest* tc) {
   CuAssertIntEquals(tc, 1, st->symbols[0].seg);
   CuAssertIntEquals(tc, 0, st->symbols[0].offset);
 
-  CuAssertStrEquals(tc, "FRED", sym_name(st, id));
-  CuAssertIntEquals(tc, FALSE, sym_defined(st, id));
-  CuAssertIntEquals(tc, 1, sym_seg(st, id));
-  CuAssertIntEquals(tc, 0, sym_offset(st, id));
+  CuAssertStrEquals(tc, "FRED", symtab_name(st, id));
+  CuAssertIntEquals(tc, FALSE, symtab_defined(st, id));
+  CuAssertIntEquals(tc, 1, symtab_seg(st, id));
+  CuAssertIntEquals(tc, 0, symtab_offset(st, id));
 
-  id = sym_lookup(st, "FRED");
+  id = symtab_lookup(st, "FRED");
   CuAssertIntEquals(tc, 0, id);
 
-  id = sym_insert_public(st, "Scalar", 3, 0xDEAD);
+  id = symtab_insert_public(st, "Scalar", 3, 0xDEAD);
   CuAssertIntEquals(tc, 1, id);
   CuAssertIntEquals(tc, 2, st->nsym);
   CuAssertStrEquals(tc, "Scalar", st->symbols[id].name);
@@ -182,13 +184,13 @@ static void test_insert(CuTest* tc) {
   CuAssertIntEquals(tc, 3, st->symbols[id].seg);
   CuAssertIntEquals(tc, 0xDEAD, st->symbols[id].offset);
 
-  CuAssertStrEquals(tc, "Scalar", sym_name(st, id));
-  CuAssertIntEquals(tc, TRUE, sym_defined(st, id));
-  CuAssertIntEquals(tc, 3, sym_seg(st, id));
-  CuAssertIntEquals(tc, 0xDEAD, sym_offset(st, id));
+  CuAssertStrEquals(tc, "Scalar", symtab_name(st, id));
+  CuAssertIntEquals(tc, TRUE, symtab_defined(st, id));
+  CuAssertIntEquals(tc, 3, symtab_seg(st, id));
+  CuAssertIntEquals(tc, 0xDEAD, symtab_offset(st, id));
 
-  SYMTAB* st2 = new_symbol_table(CASE_INSENSITIVE);
-  id = sym_insert_copy(st2, st, 1);
+  SYMTAB* st2 = new_symtab(CASE_INSENSITIVE);
+  id = symtab_insert_copy(st2, st, 1);
   CuAssertPtrNotNull(tc, st2->symbols);
   CuAssertIntEquals(tc, 1, st2->nsym);
   CuAssertTrue(tc, st2->msym >= 1);
@@ -197,62 +199,62 @@ static void test_insert(CuTest* tc) {
   CuAssertIntEquals(tc, TRUE, st2->symbols[id].defined);
   CuAssertIntEquals(tc, 3, st2->symbols[id].seg);
   CuAssertIntEquals(tc, 0xDEAD, st2->symbols[id].offset);
-  delete_symbol_table(st2);
+  delete_symtab(st2);
 
-  delete_symbol_table(st);
+  delete_symtab(st);
 }
 
 static void test_case_sensitive(CuTest* tc) {
-  SYMTAB* st = new_symbol_table(CASE_SENSITIVE);
+  SYMTAB* st = new_symtab(CASE_SENSITIVE);
 
-  CuAssertIntEquals(tc, NO_SYM, sym_lookup(st, "FRED"));
-  CuAssertIntEquals(tc, NO_SYM, sym_lookup(st, "Fred"));
+  CuAssertIntEquals(tc, NO_SYM, symtab_lookup(st, "FRED"));
+  CuAssertIntEquals(tc, NO_SYM, symtab_lookup(st, "Fred"));
 
-  sym_insert_extern(st, "FRED", 0);
-  CuAssertIntEquals(tc, 0, sym_lookup(st, "FRED"));
-  CuAssertIntEquals(tc, NO_SYM, sym_lookup(st, "Fred"));
+  symtab_insert_extern(st, "FRED", 0);
+  CuAssertIntEquals(tc, 0, symtab_lookup(st, "FRED"));
+  CuAssertIntEquals(tc, NO_SYM, symtab_lookup(st, "Fred"));
 
-  sym_insert_extern(st, "Fred", 0);
-  CuAssertIntEquals(tc, 0, sym_lookup(st, "FRED"));
-  CuAssertIntEquals(tc, 1, sym_lookup(st, "Fred"));
+  symtab_insert_extern(st, "Fred", 0);
+  CuAssertIntEquals(tc, 0, symtab_lookup(st, "FRED"));
+  CuAssertIntEquals(tc, 1, symtab_lookup(st, "Fred"));
 
-  delete_symbol_table(st);
+  delete_symtab(st);
 }
 
 static void test_case_insensitive(CuTest* tc) {
-  SYMTAB* st = new_symbol_table(CASE_INSENSITIVE);
+  SYMTAB* st = new_symtab(CASE_INSENSITIVE);
 
-  CuAssertIntEquals(tc, NO_SYM, sym_lookup(st, "FRED"));
-  CuAssertIntEquals(tc, NO_SYM, sym_lookup(st, "Fred"));
+  CuAssertIntEquals(tc, NO_SYM, symtab_lookup(st, "FRED"));
+  CuAssertIntEquals(tc, NO_SYM, symtab_lookup(st, "Fred"));
 
-  sym_insert_extern(st, "FRED", 0);
-  CuAssertIntEquals(tc, 0, sym_lookup(st, "FRED"));
-  CuAssertIntEquals(tc, 0, sym_lookup(st, "Fred"));
+  symtab_insert_extern(st, "FRED", 0);
+  CuAssertIntEquals(tc, 0, symtab_lookup(st, "FRED"));
+  CuAssertIntEquals(tc, 0, symtab_lookup(st, "Fred"));
 
-  delete_symbol_table(st);
+  delete_symtab(st);
 }
 
 static void test_define(CuTest* tc) {
-  SYMTAB* st = new_symbol_table(CASE_SENSITIVE);
+  SYMTAB* st = new_symtab(CASE_SENSITIVE);
   SYMBOL_ID id;
 
-  id = sym_insert_extern(st, "FRED", 2);
+  id = symtab_insert_extern(st, "FRED", 2);
   CuAssertIntEquals(tc, 0, id);
-  CuAssertStrEquals(tc, "FRED", sym_name(st, id));
-  CuAssertIntEquals(tc, FALSE, sym_defined(st, id));
-  CuAssertIntEquals(tc, 2, sym_seg(st, id));
-  CuAssertIntEquals(tc, 0, sym_offset(st, id));
-
-  sym_define(st, id, 0x1234);
-  CuAssertStrEquals(tc, "FRED", sym_name(st, id));
-  CuAssertIntEquals(tc, TRUE, sym_defined(st, id));
-  CuAssertIntEquals(tc, 2, sym_seg(st, id));
-  CuAssertIntEquals(tc, 0x1234, sym_offset(st, id));
-
-  delete_symbol_table(st);
+  CuAssertStrEquals(tc, "FRED", symtab_name(st, id));
+  CuAssertIntEquals(tc, FALSE, symtab_defined(st, id));
+  CuAssertIntEquals(tc, 2, symtab_seg(st, id));
+  CuAssertIntEquals(tc, 0, symtab_offset(st, id));
+
+  symtab_define(st, id, 0x1234);
+  CuAssertStrEquals(tc, "FRED", symtab_name(st, id));
+  CuAssertIntEquals(tc, TRUE, symtab_defined(st, id));
+  CuAssertIntEquals(tc, 2, symtab_seg(st, id));
+  CuAssertIntEquals(tc, 0x1234, symtab_offset(st, id));
+
+  delete_symtab(st);
 }
 
-CuSuite* symbol_test_suite(void) {
+CuSuite* symtab_test_suite(void) {
   CuSuite* suite = CuSuiteNew();
   SUITE_ADD_TEST(suite, test_new_symbol_table);
   SUITE_ADD_TEST(suite, test_insert);
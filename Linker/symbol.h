@@ -10,8 +10,8 @@
 // Linker symbol table
 
 typedef short SYMBOL_ID;
-typedef short SEGNO;
-typedef short GROUPNO;
+typedef int SEGNO;
+typedef int GROUPNO;
 
 #define NO_SYM (-1)
 #define NO_SEG (-1)
@@ -34,24 +34,24 @@ typedef struct {
 
 enum case_sensitivity { CASE_SENSITIVE, CASE_INSENSITIVE };
 
-SYMTAB* new_symbol_table(int case_sensitivity);
-void delete_symbol_table(SYMTAB*);
+SYMTAB* new_symtab(int case_sensitivity);
+void delete_symtab(SYMTAB*);
 
-SYMBOL_ID sym_count(const SYMTAB*);
+SYMBOL_ID symtab_count(const SYMTAB*);
 SYMBOL* symbol(SYMTAB*, SYMBOL_ID);
 const SYMBOL* const_symbol(const SYMTAB* st, SYMBOL_ID);
 
-SYMBOL_ID sym_next_id(SYMTAB*);
-SYMBOL_ID sym_insert_extern(SYMTAB*, const char* name, SEGNO);
-SYMBOL_ID sym_insert_public(SYMTAB*, const char* name, SEGNO, WORD offset);
-SYMBOL_ID sym_insert_copy(SYMTAB*, const SYMTAB*, SYMBOL_ID);
-SYMBOL_ID sym_lookup(SYMTAB*, const char* name);
+SYMBOL_ID symtab_next_id(SYMTAB*);
+SYMBOL_ID symtab_insert_extern(SYMTAB*, const char* name, SEGNO);
+SYMBOL_ID symtab_insert_public(SYMTAB*, const char* name, SEGNO, WORD offset);
+SYMBOL_ID symtab_insert_copy(SYMTAB*, const SYMTAB*, SYMBOL_ID);
+SYMBOL_ID symtab_lookup(SYMTAB*, const char* name);
 
-void sym_define(SYMTAB*, SYMBOL_ID, DWORD offset);
+void symtab_define(SYMTAB*, SYMBOL_ID, DWORD offset);
 
-const char* sym_name(SYMTAB*, SYMBOL_ID);
-SEGNO sym_seg(SYMTAB*, SYMBOL_ID);
-BOOL sym_defined(SYMTAB*, SYMBOL_ID);
-DWORD sym_offset(SYMTAB*, SYMBOL_ID);
+const char* symtab_name(SYMTAB*, SYMBOL_ID);
+SEGNO symtab_seg(SYMTAB*, SYMBOL_ID);
+BOOL symtab_defined(SYMTAB*, SYMBOL_ID);
+DWORD symtab_offset(SYMTAB*, SYMBOL_ID);
 
 #endif // SYMBOL_H
\ No newline at end of file
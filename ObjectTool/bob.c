@@ -3,79 +3,161 @@
 // Dump the object files of custom format.
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include "object.h"
 #include "disassemble.h"
+#include "dirlist.h"
+#include "batch.h"
+#include "instats.h"
 #include "utils.h"
 
 static const char NAME[] = "bob";
 
-static void dump_file(const char* filename);
+static void* load_file(const char* filename);
+static bool dump_file(const DECODER*, const OFILE*);
+static bool count_file(const DECODER*, const OFILE*, INSTATS*);
 
+// Several files, or a directory of .obj files, are loaded concurrently and
+// dumped in turn with one decoder, followed by a summary. A file that cannot
+// be read or dumped is reported and the batch goes on.
 int main(int argc, char* argv[]) {
-  if (argc != 2)
-    fatal("usage: %s file\n", NAME);
   progname = NAME;
-  dump_file(argv[1]);
-  return 0;
+
+  STRINGLIST* files = new_stringlist();
+  bool stats = false;
+  bool csv = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--stats") == 0)
+      stats = true;
+    else if (strcmp(argv[i], "--stats=csv") == 0)
+      stats = csv = true;
+    else
+      append_files(files, argv[i], ".obj");
+  }
+
+  const unsigned count = stringlist_count(files);
+  if (count == 0)
+    fatal("usage: %s [--stats[=csv]] file|directory...\n", NAME);
+
+  DECODER* decoder = build_decoder();
+  // Instruction statistics for the code in all the files together.
+  INSTATS* st = stats ? new_instats() : NULL;
+  unsigned* records = emalloc(count * sizeof records[0]);
+  bool* ok = emalloc(count * sizeof ok[0]);
+  unsigned failed = 0;
+
+  for (unsigned first = 0; first < count; first += BATCH_CHUNK) {
+    BATCH_FILE chunk[BATCH_CHUNK];
+    const unsigned n = load_batch(chunk, files, first, load_file);
+    for (unsigned j = 0; j < n; j++) {
+      const unsigned i = first + j;
+      if (count > 1 && !stats)
+        printf("%sFILE: %s\n\n", i ? "\n" : "", chunk[j].name);
+      OFILE* ofile = batch_result(&chunk[j]);
+      ok[i] = false;
+      if (ofile) {
+        ok[i] = stats ? count_file(decoder, ofile, st) : dump_file(decoder, ofile);
+        records[i] = ofile->used;
+        delete_ofile(ofile);
+      }
+      if (!ok[i])
+        failed++;
+    }
+  }
+
+  if (stats)
+    print_instats(st, csv);
+  else if (count > 1) {
+    puts("\nSUMMARY:");
+    for (unsigned i = 0; i < count; i++) {
+      if (ok[i])
+        printf("%6u records  %s\n", records[i], stringlist_item(files, i));
+      else
+        printf("%14s  %s\n", "failed", stringlist_item(files, i));
+    }
+    printf("%u files", count);
+    if (failed)
+      printf(", %u failed", failed);
+    putchar('\n');
+  }
+
+  delete_instats(st);
+  delete_decoder(decoder);
+  efree(ok);
+  efree(records);
+  delete_stringlist(files);
+  return failed ? EXIT_FAILURE : 0;
 }
 
-#define MAX_SEGMENTS (16)  // quick & dirty
+static void* load_file(const char* filename) {
+  return load_object_file(filename);
+}
 
 static void decode_record(const DECODER*, const OREC*, DWORD pc);
 
-static void dump_file(const char* filename) {
-  const DECODER* decoder = build_decoder();
-  OFILE* ofile = load_object_file(filename);
+typedef struct {
+  const DECODER* decoder;
+  const OFILE* ofile;
+  INSTATS* stats;
+  DWORD* pc;  // location counter of each segment, freed after the job
+} DUMPING;
+
+static void dump_job(void* arg) {
+  DUMPING* d = arg;
+  const DECODER* const decoder = d->decoder;
+  const OFILE* const ofile = d->ofile;
   const OREC* orec = ofile->recs;
-  unsigned errors = 0;
-  unsigned decoded = 0;
   unsigned segno = -1;
-  DWORD pc[MAX_SEGMENTS];
-
-  memset(&pc, 0, sizeof pc);
+  unsigned nseg = 0;
 
   for (unsigned i = 0; i < ofile->used; i++, orec++) {
     printf("%6u  ", i);
     dump_orec(orec);
     switch (orec->type) {
       case OBJ_CODE:
-        if (segno >= 0 && segno < MAX_SEGMENTS) {
-          decode_record(decoder, orec, pc[segno]);
-          pc[segno] += orec->u.data.size;
+        if (segno < nseg) {
+          decode_record(decoder, orec, d->pc[segno]);
+          d->pc[segno] += orec->u.data.size;
         }
         break;
       case OBJ_DS:
-        if (segno >= 0 && segno < MAX_SEGMENTS)
-          pc[segno] += orec->u.data.size;
+        if (segno < nseg)
+          d->pc[segno] += orec->u.data.size;
         break;
       case OBJ_DB:
-        if (segno >= 0 && segno < MAX_SEGMENTS)
-          pc[segno] += 1;
+        if (segno < nseg)
+          d->pc[segno] += 1;
         break;
       case OBJ_DW:
-        if (segno >= 0 && segno < MAX_SEGMENTS)
-          pc[segno] += 2;
+        if (segno < nseg)
+          d->pc[segno] += 2;
         break;
       case OBJ_DD:
-        if (segno >= 0 && segno < MAX_SEGMENTS)
-          pc[segno] += 4;
+        if (segno < nseg)
+          d->pc[segno] += 4;
         break;
       case OBJ_DQ:
-        if (segno >= 0 && segno < MAX_SEGMENTS)
-          pc[segno] += 8;
+        if (segno < nseg)
+          d->pc[segno] += 8;
         break;
       case OBJ_DT:
-        if (segno >= 0 && segno < MAX_SEGMENTS)
-          pc[segno] += 10;
+        if (segno < nseg)
+          d->pc[segno] += 10;
         break;
       case OBJ_ORG:
-        if (segno >= 0 && segno < MAX_SEGMENTS)
-          pc[segno] = objword(orec);
+        if (segno < nseg)
+          d->pc[segno] = objword(orec);
         break;
       case OBJ_OPEN_SEGMENT:
-        segno = objbyte(orec);
+        segno = objword(orec);
+        if (segno >= nseg) {
+          d->pc = erealloc(d->pc, (segno + 1) * sizeof d->pc[0]);
+          memset(d->pc + nseg, 0, (segno + 1 - nseg) * sizeof d->pc[0]);
+          nseg = segno + 1;
+        }
         break;
       case OBJ_CLOSE_SEGMENT:
         segno = -1;
@@ -83,7 +165,14 @@ static void dump_file(const char* filename) {
     }
     putchar('\n');
   }
-  delete_ofile(ofile);
+}
+
+// False if the dump failed, having been reported.
+static bool dump_file(const DECODER* decoder, const OFILE* ofile) {
+  DUMPING d = { decoder, ofile, NULL, NULL };
+  const bool ok = run_job(dump_job, &d, NULL);
+  efree(d.pc);
+  return ok;
 }
 
 static void decode_record(const DECODER* decoder, const OREC* orec, DWORD pc) {
@@ -95,3 +184,32 @@ static void decode_record(const DECODER* decoder, const OREC* orec, DWORD pc) {
     print_assembly(pc, &dec);
   }
 }
+
+static void count_job(void* arg) {
+  const DUMPING* d = arg;
+  const DECODER* const decoder = d->decoder;
+  const OFILE* const ofile = d->ofile;
+  INSTATS* const stats = d->stats;
+
+  for (unsigned i = 0; i < ofile->used; i++) {
+    const OREC* orec = &ofile->recs[i];
+    if (orec->type != OBJ_CODE)
+      continue;
+    DECODED dec;
+    unsigned count = 0;
+    while (count < orec->u.data.size) {
+      if (decode_instruction(decoder, orec->u.data.buf + count, orec->u.data.size - count, &dec) != DECODE_ERR_NONE) {
+        count_undecoded(stats, orec->u.data.size - count);
+        break;
+      }
+      count_instruction(stats, &dec);
+      count += dec.len;
+    }
+  }
+}
+
+// False if counting failed, having been reported.
+static bool count_file(const DECODER* decoder, const OFILE* ofile, INSTATS* stats) {
+  DUMPING d = { decoder, ofile, stats, NULL };
+  return run_job(count_job, &d, NULL);
+}
@@ -10,6 +10,12 @@
 
 #include "CuTest.h"
 
+/* NIGEL PERKS MODIFICATION BEGINS */
+#include <limits.h>
+#include "timer.h"
+#include "utils.h"
+/* NIGEL PERKS MODIFICATION ENDS */
+
 /*-------------------------------------------------------------------------*
  * CuStr
  *-------------------------------------------------------------------------*/
@@ -361,3 +367,202 @@ void CuSuiteDetails(CuSuite* testSuite, CuString* details)
 		CuStringAppendFormat(details, "Fails: %d\n",  testSuite->failCount);
 	}
 }
+
+
+/* NIGEL PERKS MODIFICATION BEGINS */
+
+/*-------------------------------------------------------------------------*
+ * CuBench
+ *-------------------------------------------------------------------------*/
+
+void CuBenchInit(CuBench* bc, const char* name, BenchFunction function)
+{
+	memset(bc, 0, sizeof *bc);
+	bc->name = CuStrCopy(name);
+	bc->function = function;
+}
+
+CuBench* CuBenchNew(const char* name, BenchFunction function)
+{
+	CuBench* bc = CU_ALLOC(CuBench);
+	CuBenchInit(bc, name, function);
+	return bc;
+}
+
+void CuBenchDelete(CuBench* bc)
+{
+	if (!bc) return;
+	free(bc->name);
+	free(bc);
+}
+
+static unsigned long CuBenchAllocs(void)
+{
+	unsigned long mallocs, frees;
+	get_memory_counts(&mallocs, &frees);
+	return mallocs;
+}
+
+void CuBenchStart(CuBench* bc)
+{
+	bc->startAllocs = CuBenchAllocs();
+	bc->startUsec = timer_usec();
+}
+
+void CuBenchStop(CuBench* bc)
+{
+	bc->elapsedUsec = timer_usec() - bc->startUsec;
+	bc->allocs = CuBenchAllocs() - bc->startAllocs;
+}
+
+static void CuBenchRunOnce(CuBench* bc, long n)
+{
+	bc->n = n;
+	bc->elapsedUsec = 0;
+	bc->allocs = 0;
+	bc->function(bc);
+}
+
+void CuBenchRun(CuBench* bc)
+{
+	long n = 1;
+	long long best;
+	unsigned long allocs;
+	int i;
+
+	/* warm up, finding how many operations take long enough to time */
+	for (;;)
+	{
+		CuBenchRunOnce(bc, n);
+		if (bc->elapsedUsec >= BENCH_RUN_USEC || n > LONG_MAX / 2) break;
+		n *= 2;
+	}
+
+	best = bc->elapsedUsec;
+	allocs = bc->allocs;
+	for (i = 0 ; i < BENCH_REPEATS ; ++i)
+	{
+		CuBenchRunOnce(bc, n);
+		if (bc->elapsedUsec < best)
+		{
+			best = bc->elapsedUsec;
+			allocs = bc->allocs;
+		}
+	}
+
+	bc->n = n;
+	bc->nsPerOp = best * 1000.0 / n;
+	bc->allocsPerOp = (double) allocs / n;
+	bc->failed = bc->baseline &&
+		(bc->nsPerOp > bc->baselineNsPerOp * (1 + BENCH_TOLERANCE) ||
+		 bc->allocsPerOp > bc->baselineAllocsPerOp * (1 + BENCH_TOLERANCE) + 0.01);
+}
+
+/*-------------------------------------------------------------------------*
+ * CuBenchSuite
+ *-------------------------------------------------------------------------*/
+
+CuBenchSuite* CuBenchSuiteNew(void)
+{
+	CuBenchSuite* suite = CU_ALLOC(CuBenchSuite);
+	memset(suite, 0, sizeof *suite);
+	return suite;
+}
+
+void CuBenchSuiteDelete(CuBenchSuite* suite)
+{
+	int i;
+	for (i = 0 ; i < suite->count ; ++i)
+		CuBenchDelete(suite->list[i]);
+	free(suite);
+}
+
+void CuBenchSuiteAdd(CuBenchSuite* suite, CuBench* bc)
+{
+	assert(suite->count < MAX_BENCH_CASES);
+	suite->list[suite->count] = bc;
+	suite->count++;
+}
+
+void CuBenchSuiteAddSuite(CuBenchSuite* suite, CuBenchSuite* suite2)
+{
+	int i;
+	for (i = 0 ; i < suite2->count ; ++i)
+		CuBenchSuiteAdd(suite, suite2->list[i]);
+	/* the cases now belong to the first suite */
+	free(suite2);
+}
+
+int CuBenchSuiteReadBaselines(CuBenchSuite* suite, const char* path)
+{
+	char name[STRING_MAX];
+	double ns, allocs;
+	int i;
+	FILE* fp = fopen(path, "r");
+	if (fp == NULL) return 0;
+	while (fscanf(fp, "%255s %lf %lf", name, &ns, &allocs) == 3)
+	{
+		for (i = 0 ; i < suite->count ; ++i)
+		{
+			CuBench* bc = suite->list[i];
+			if (strcmp(bc->name, name) == 0)
+			{
+				bc->baseline = 1;
+				bc->baselineNsPerOp = ns;
+				bc->baselineAllocsPerOp = allocs;
+			}
+		}
+	}
+	fclose(fp);
+	return 1;
+}
+
+int CuBenchSuiteWriteBaselines(CuBenchSuite* suite, const char* path)
+{
+	int i;
+	FILE* fp = fopen(path, "w");
+	if (fp == NULL) return 0;
+	for (i = 0 ; i < suite->count ; ++i)
+	{
+		CuBench* bc = suite->list[i];
+		fprintf(fp, "%s %.2f %.4f\n", bc->name, bc->nsPerOp, bc->allocsPerOp);
+	}
+	return fclose(fp) == 0;
+}
+
+void CuBenchSuiteRun(CuBenchSuite* suite)
+{
+	int i;
+	for (i = 0 ; i < suite->count ; ++i)
+	{
+		CuBench* bc = suite->list[i];
+		CuBenchRun(bc);
+		if (bc->failed) { suite->failCount += 1; }
+	}
+}
+
+void CuBenchSuiteDetails(CuBenchSuite* suite, CuString* details)
+{
+	int i;
+
+	CuStringAppendFormat(details, "%-32s %10s %12s %10s %14s\n",
+		"Benchmark", "ops", "ns/op", "allocs/op", "baseline ns/op");
+	for (i = 0 ; i < suite->count ; ++i)
+	{
+		CuBench* bc = suite->list[i];
+		CuStringAppendFormat(details, "%-32s %10ld %12.1f %10.2f",
+			bc->name, bc->n, bc->nsPerOp, bc->allocsPerOp);
+		if (bc->baseline)
+			CuStringAppendFormat(details, " %14.1f", bc->baselineNsPerOp);
+		if (bc->failed)
+			CuStringAppend(details, "  WORSE THAN BASELINE");
+		CuStringAppend(details, "\n");
+	}
+
+	if (suite->failCount == 0)
+		CuStringAppendFormat(details, "\nOK (%d benchmarks)\n", suite->count);
+	else
+		CuStringAppendFormat(details, "\nFAILED (%d of %d benchmarks)\n", suite->failCount, suite->count);
+}
+
+/* NIGEL PERKS MODIFICATION ENDS */
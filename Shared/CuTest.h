@@ -133,4 +133,69 @@ void CuSuiteRun(CuSuite* testSuite);
 void CuSuiteSummary(CuSuite* testSuite, CuString* summary);
 void CuSuiteDetails(CuSuite* testSuite, CuString* details);
 
+/* NIGEL PERKS MODIFICATION BEGINS */
+/* CuBench: timed benchmark cases */
+
+#define MAX_BENCH_CASES	64
+
+/* Each case is warmed up, doubling its operation count until a run takes at least
+   BENCH_RUN_USEC; then timed BENCH_REPEATS times, the fastest run counting. */
+#define BENCH_RUN_USEC	20000
+#define BENCH_REPEATS	5
+/* A case fails if it is this fraction slower than its baseline. */
+#define BENCH_TOLERANCE	0.5
+
+typedef struct CuBench CuBench;
+
+typedef void (*BenchFunction)(CuBench *);
+
+/* The function does any setup, then calls CuBenchStart, performs bc->n operations,
+   and calls CuBenchStop before cleaning up. Only the operations are measured.
+   A result of the operations used only in asserts is stored in sink, so that
+   a build without asserts cannot optimise the operations away. */
+struct CuBench
+{
+	char* name;
+	BenchFunction function;
+	long n;
+	long long startUsec;
+	long long elapsedUsec;
+	unsigned long startAllocs;
+	unsigned long allocs;
+	double nsPerOp;
+	double allocsPerOp;
+	int baseline;		/* a baseline was found */
+	double baselineNsPerOp;
+	double baselineAllocsPerOp;
+	int failed;
+	unsigned long sink;
+};
+
+void CuBenchInit(CuBench* bc, const char* name, BenchFunction function);
+CuBench* CuBenchNew(const char* name, BenchFunction function);
+void CuBenchDelete(CuBench* bc);
+void CuBenchStart(CuBench* bc);
+void CuBenchStop(CuBench* bc);
+void CuBenchRun(CuBench* bc);
+
+#define SUITE_ADD_BENCH(SUITE,BENCH)	CuBenchSuiteAdd(SUITE, CuBenchNew(#BENCH, BENCH))
+
+typedef struct
+{
+	int count;
+	CuBench* list[MAX_BENCH_CASES];
+	int failCount;
+} CuBenchSuite;
+
+CuBenchSuite* CuBenchSuiteNew(void);
+void CuBenchSuiteDelete(CuBenchSuite* suite);
+void CuBenchSuiteAdd(CuBenchSuite* suite, CuBench* bc);
+void CuBenchSuiteAddSuite(CuBenchSuite* suite, CuBenchSuite* suite2);
+/* Baselines are lines "name ns/op allocs/op". Return 0 if the file cannot be read. */
+int CuBenchSuiteReadBaselines(CuBenchSuite* suite, const char* path);
+int CuBenchSuiteWriteBaselines(CuBenchSuite* suite, const char* path);
+void CuBenchSuiteRun(CuBenchSuite* suite);
+void CuBenchSuiteDetails(CuBenchSuite* suite, CuString* details);
+/* NIGEL PERKS MODIFICATION ENDS */
+
 #endif /* CU_TEST_H */
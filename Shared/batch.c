@@ -0,0 +1,162 @@
+// Basic Assembler
+// Copyright (c) 2022-24 Nigel Perks
+// Batch processing: files loaded concurrently, then processed in order.
+
+#include <stdio.h>
+#include <assert.h>
+#include "batch.h"
+#include "utils.h"
+
+#if !defined(__STDC_NO_THREADS__) && !defined(__STDC_NO_ATOMICS__)
+#define BATCH_THREADS
+#include <threads.h>
+#include <stdatomic.h>
+#endif
+
+static void load_job(void* p) {
+  BATCH_FILE* file = p;
+  file->loaded = file->load(file->name);
+}
+
+// Each load's errors go to a temporary file, so that they can be reported
+// when the file is reached in order.
+static void load(BATCH_FILE* file) {
+  file->errors = tmpfile();
+  if (!run_job(load_job, file, file->errors))
+    file->loaded = NULL;
+}
+
+#ifdef BATCH_THREADS
+typedef struct {
+  BATCH_FILE* files;
+  unsigned count;
+  atomic_uint next;
+} POOL;
+
+static int worker(void* p) {
+  POOL* pool = p;
+  unsigned i;
+  while ((i = atomic_fetch_add(&pool->next, 1)) < pool->count)
+    load(&pool->files[i]);
+  return 0;
+}
+#endif
+
+unsigned load_batch(BATCH_FILE chunk[], const STRINGLIST* files, unsigned first, BATCH_LOAD fn) {
+  assert(chunk != NULL);
+  assert(files != NULL);
+  assert(first < stringlist_count(files));
+  assert(fn != NULL);
+
+  unsigned count = stringlist_count(files) - first;
+  if (count > BATCH_CHUNK)
+    count = BATCH_CHUNK;
+  for (unsigned i = 0; i < count; i++) {
+    chunk[i].name = stringlist_item(files, first + i);
+    chunk[i].load = fn;
+    chunk[i].loaded = NULL;
+    chunk[i].errors = NULL;
+  }
+
+#ifdef BATCH_THREADS
+  POOL pool;
+  pool.files = chunk;
+  pool.count = count;
+  atomic_init(&pool.next, 0);
+
+  const unsigned workers = (count < BATCH_WORKERS) ? count : BATCH_WORKERS;
+  thrd_t thread[BATCH_WORKERS];
+  bool started[BATCH_WORKERS] = { false };
+  for (unsigned w = 1; w < workers; w++)
+    started[w] = (thrd_create(&thread[w], worker, &pool) == thrd_success);
+
+  worker(&pool);
+
+  for (unsigned w = 1; w < workers; w++) {
+    if (started[w])
+      thrd_join(thread[w], NULL);
+  }
+#else
+  for (unsigned i = 0; i < count; i++)
+    load(&chunk[i]);
+#endif
+
+  return count;
+}
+
+void* batch_result(BATCH_FILE* file) {
+  assert(file != NULL);
+
+  if (file->errors) {
+    fflush(stdout);
+    rewind(file->errors);
+    int c;
+    while ((c = getc(file->errors)) != EOF)
+      putc(c, stderr);
+    fclose(file->errors);
+    file->errors = NULL;
+  }
+  return file->loaded;
+}
+
+#ifdef UNIT_TEST
+
+#include <string.h>
+#include "CuTest.h"
+
+static void* load_name(const char* name) {
+  if (name[0] == 'b')
+    fatal("cannot load %s\n", name);
+  return estrdup(name);
+}
+
+// A failed load ends only its own job, and its messages are held for it.
+static void test_load_batch(CuTest* tc) {
+  const char* const saved_progname = progname;
+  progname = NULL;
+  STRINGLIST* files = new_stringlist();
+  for (unsigned i = 0; i < BATCH_CHUNK + 4; i++) {
+    char name[16];
+    sprintf(name, "%s%u", (i == 3 || i == BATCH_CHUNK + 1) ? "bad" : "good", i);
+    append_string(files, name);
+  }
+
+  for (unsigned first = 0; first < stringlist_count(files); first += BATCH_CHUNK) {
+    BATCH_FILE chunk[BATCH_CHUNK];
+    const unsigned n = load_batch(chunk, files, first, load_name);
+    CuAssertIntEquals(tc, first ? 4 : BATCH_CHUNK, n);
+    for (unsigned j = 0; j < n; j++) {
+      const char* name = stringlist_item(files, first + j);
+      CuAssertStrEquals(tc, name, chunk[j].name);
+      CuAssertPtrNotNull(tc, chunk[j].errors);
+      char buf[40];
+      rewind(chunk[j].errors);
+      if (name[0] == 'b') {
+        CuAssertPtrNotNull(tc, fgets(buf, sizeof buf, chunk[j].errors));
+        CuAssertTrue(tc, strstr(buf, name) != NULL);
+      }
+      else
+        CuAssertTrue(tc, fgets(buf, sizeof buf, chunk[j].errors) == NULL);
+      fclose(chunk[j].errors);
+      chunk[j].errors = NULL;
+
+      char* loaded = batch_result(&chunk[j]);
+      if (name[0] == 'b')
+        CuAssertPtrEquals(tc, NULL, loaded);
+      else
+        CuAssertStrEquals(tc, name, loaded);
+      efree(loaded);
+    }
+  }
+
+  delete_stringlist(files);
+  progname = saved_progname;
+}
+
+CuSuite* batch_test_suite(void) {
+  CuSuite* suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_load_batch);
+  return suite;
+}
+
+#endif // UNIT_TEST
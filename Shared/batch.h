@@ -0,0 +1,33 @@
+// Basic Assembler
+// Copyright (c) 2022-24 Nigel Perks
+// Batch processing: files loaded concurrently, then processed in order.
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "stringlist.h"
+
+// Worker threads loading a batch, and files loaded at once.
+#define BATCH_WORKERS (4)
+#define BATCH_CHUNK (16)
+
+typedef void* (*BATCH_LOAD)(const char* name);
+
+typedef struct {
+  const char* name;
+  BATCH_LOAD load;
+  void* loaded;  // NULL if the load failed
+  FILE* errors;  // messages of the load, held until it is reported, or NULL
+} BATCH_FILE;
+
+// Load the files from first, up to BATCH_CHUNK of them, each as a job of its
+// own on a pool of worker threads, so that a failure ends only that load.
+// Returns the number of files in the chunk.
+unsigned load_batch(BATCH_FILE chunk[], const STRINGLIST* files, unsigned first, BATCH_LOAD);
+
+// Write the messages of the load to stderr, and return what it loaded, or NULL.
+void* batch_result(BATCH_FILE*);
+
+#endif // BATCH_H
@@ -0,0 +1,218 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Static estimates of 8086 and 80286 instruction clocks.
+// Counts are the typical ones of the Intel manuals, with words aligned.
+// On the 286 a transfer costs m = 2 more for the instruction at its target,
+// which is included in the table; a shift by an immediate or CL counts 1 bit.
+
+#include <assert.h>
+#include "cycles.h"
+
+#define SEGMENT_OVERRIDE_8086 (2)
+#define WAIT_PREFIX (3)
+
+static const unsigned rep_prefix[CYCLE_MODELS] = { 9, 5 };
+
+// 8086 effective address: mod 00 by r/m, and mod 01 or 10 by r/m.
+static const BYTE ea_8086[2][8] = {
+  // [BX+SI] [BX+DI] [BP+SI] [BP+DI] [SI] [DI] disp [BX]
+  { 7, 8, 8, 7, 5, 5, 6, 5 },
+  // ... + disp
+  { 11, 12, 12, 11, 9, 9, 9, 9 },
+};
+
+unsigned ea_cycles(BYTE modrm, int model) {
+  assert(model == CYCLES_8086 || model == CYCLES_286);
+
+  const unsigned mod = modrm >> 6;
+  const unsigned rm = modrm & 7;
+
+  if (mod == 3)
+    return 0;
+  if (model == CYCLES_8086)
+    return ea_8086[mod != 0][rm];
+  // 286: base + index + displacement costs one more
+  return (mod != 0 && rm < 4) ? 1 : 0;
+}
+
+static bool available(const INSDEF* def, int model) {
+  switch (def->cpu) {
+    case P86:
+    case P87:
+      return true;
+    default:
+      return model == CYCLES_286;
+  }
+}
+
+static bool has_modrm(const INSDEF* def) {
+  switch (def->modrm) {
+    case RRM:
+    case RMR:
+    case RMC:
+    case MMC:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static bool prefix_byte(BYTE b) {
+  switch (b) {
+    case 0x26: case 0x2E: case 0x36: case 0x3E:  // segment override
+    case 0xF2: case 0xF3:  // REP
+    case WAIT_OPCODE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+unsigned instruction_cycles(const INSDEF* def, const BYTE* code, unsigned len, bool taken, int model) {
+  assert(def != NULL);
+  assert(code != NULL);
+  assert(len >= (unsigned) def->opcodes);
+  assert(model == CYCLES_8086 || model == CYCLES_286);
+
+  if (!available(def, model))
+    return 0;
+
+  const short* cost = (model == CYCLES_8086) ? def->cycles86 : def->cycles286;
+  unsigned cycles = 0;
+  unsigned i = 0;
+
+  while (i + def->opcodes < len && prefix_byte(code[i])) {
+    if (code[i] == WAIT_OPCODE)
+      cycles += WAIT_PREFIX;
+    else if (code[i] == 0xF2 || code[i] == 0xF3)
+      cycles += rep_prefix[model];
+    else if (model == CYCLES_8086)
+      cycles += SEGMENT_OVERRIDE_8086;
+    i++;
+  }
+
+  if (has_modrm(def)) {
+    assert(i + def->opcodes < len);
+    const BYTE modrm = code[i + def->opcodes];
+    if (modrm >> 6 == 3)
+      cycles += cost[0];
+    else
+      cycles += cost[1] + ea_cycles(modrm, model);
+  }
+  else if (!taken && cost[1])
+    cycles += cost[1];
+  else
+    cycles += cost[0];
+
+  return cycles;
+}
+
+unsigned direct_jump_cycles(int model) {
+  assert(model == CYCLES_8086 || model == CYCLES_286);
+  return (model == CYCLES_8086) ? 15 : 9;
+}
+
+#ifdef UNIT_TEST
+
+#include "CuTest.h"
+#include "token.h"
+
+// First table entry for the operation with the opcode.
+static const INSDEF* form(int op, BYTE opcode1) {
+  for (const INSDEF* def = first_instruc(); def; def = next_instruc(def)) {
+    if (def->op == op && def->opcode1 == opcode1)
+      return def;
+  }
+  return NULL;
+}
+
+static void test_ea_cycles(CuTest* tc) {
+  CuAssertIntEquals(tc, 0, ea_cycles(0xC3, CYCLES_8086));  // BX
+  CuAssertIntEquals(tc, 6, ea_cycles(0x06, CYCLES_8086));  // [disp]
+  CuAssertIntEquals(tc, 5, ea_cycles(0x07, CYCLES_8086));  // [BX]
+  CuAssertIntEquals(tc, 7, ea_cycles(0x00, CYCLES_8086));  // [BX+SI]
+  CuAssertIntEquals(tc, 8, ea_cycles(0x01, CYCLES_8086));  // [BX+DI]
+  CuAssertIntEquals(tc, 9, ea_cycles(0x46, CYCLES_8086));  // [BP+disp8]
+  CuAssertIntEquals(tc, 11, ea_cycles(0x43, CYCLES_8086)); // [BP+DI+disp8]
+  CuAssertIntEquals(tc, 12, ea_cycles(0x82, CYCLES_8086)); // [BP+SI+disp16]
+
+  CuAssertIntEquals(tc, 0, ea_cycles(0x06, CYCLES_286));
+  CuAssertIntEquals(tc, 0, ea_cycles(0x00, CYCLES_286));
+  CuAssertIntEquals(tc, 0, ea_cycles(0x46, CYCLES_286));
+  CuAssertIntEquals(tc, 1, ea_cycles(0x43, CYCLES_286));
+}
+
+static void test_instruction_cycles(CuTest* tc) {
+  const INSDEF* add = form(TOK_ADD, 0x03);
+  CuAssertPtrNotNull(tc, add);
+
+  const BYTE add_reg[] = { 0x03, 0xC3 };        // ADD AX, BX
+  const BYTE add_mem[] = { 0x03, 0x07 };        // ADD AX, [BX]
+  const BYTE add_es[] = { 0x26, 0x03, 0x07 };   // ADD AX, [ES:BX]
+  CuAssertIntEquals(tc, 3, instruction_cycles(add, add_reg, 2, false, CYCLES_8086));
+  CuAssertIntEquals(tc, 2, instruction_cycles(add, add_reg, 2, false, CYCLES_286));
+  CuAssertIntEquals(tc, 14, instruction_cycles(add, add_mem, 2, false, CYCLES_8086));
+  CuAssertIntEquals(tc, 7, instruction_cycles(add, add_mem, 2, false, CYCLES_286));
+  CuAssertIntEquals(tc, 16, instruction_cycles(add, add_es, 3, false, CYCLES_8086));
+  CuAssertIntEquals(tc, 7, instruction_cycles(add, add_es, 3, false, CYCLES_286));
+
+  const INSDEF* jz = form(TOK_JZ, 0x74);
+  CuAssertPtrNotNull(tc, jz);
+  const BYTE jz_back[] = { 0x74, 0xFE };
+  CuAssertIntEquals(tc, 16, instruction_cycles(jz, jz_back, 2, true, CYCLES_8086));
+  CuAssertIntEquals(tc, 4, instruction_cycles(jz, jz_back, 2, false, CYCLES_8086));
+  CuAssertIntEquals(tc, 9, instruction_cycles(jz, jz_back, 2, true, CYCLES_286));
+  CuAssertIntEquals(tc, 3, instruction_cycles(jz, jz_back, 2, false, CYCLES_286));
+
+  const INSDEF* movsb = form(TOK_MOVSB, 0xA4);
+  CuAssertPtrNotNull(tc, movsb);
+  const BYTE rep_movsb[] = { 0xF3, 0xA4 };
+  CuAssertIntEquals(tc, 27, instruction_cycles(movsb, rep_movsb, 2, false, CYCLES_8086));
+  CuAssertIntEquals(tc, 10, instruction_cycles(movsb, rep_movsb, 2, false, CYCLES_286));
+  CuAssertIntEquals(tc, 18, instruction_cycles(movsb, rep_movsb + 1, 1, false, CYCLES_8086));
+
+  const INSDEF* fld = form(TOK_FLD, 0xDD);
+  CuAssertPtrNotNull(tc, fld);
+  const BYTE fld_mem[] = { WAIT_OPCODE, 0xDD, 0x07 };  // FLD QWORD [BX]
+  CuAssertIntEquals(tc, 54, instruction_cycles(fld, fld_mem, 3, false, CYCLES_8086));
+  CuAssertIntEquals(tc, 49, instruction_cycles(fld, fld_mem, 3, false, CYCLES_286));
+
+  const INSDEF* wait = form(TOK_WAIT, WAIT_OPCODE);
+  CuAssertPtrNotNull(tc, wait);
+  const BYTE wait_code[] = { WAIT_OPCODE };
+  CuAssertIntEquals(tc, 3, instruction_cycles(wait, wait_code, 1, false, CYCLES_8086));
+
+  const INSDEF* enter = form(TOK_ENTER, 0xC8);
+  CuAssertPtrNotNull(tc, enter);
+  const BYTE enter_code[] = { 0xC8, 0x08, 0x00, 0x00 };
+  CuAssertIntEquals(tc, 0, instruction_cycles(enter, enter_code, 4, false, CYCLES_8086));
+  CuAssertIntEquals(tc, 11, instruction_cycles(enter, enter_code, 4, false, CYCLES_286));
+
+  CuAssertIntEquals(tc, 15, direct_jump_cycles(CYCLES_8086));
+  CuAssertIntEquals(tc, 9, direct_jump_cycles(CYCLES_286));
+}
+
+// Every entry has a cost on each processor it runs on, in the column its operands use.
+static void test_table_cycles(CuTest* tc) {
+  for (const INSDEF* def = first_instruc(); def; def = next_instruc(def)) {
+    for (int model = CYCLES_8086; model < CYCLE_MODELS; model++) {
+      if (!available(def, model))
+        continue;
+      const short* cost = (model == CYCLES_8086) ? def->cycles86 : def->cycles286;
+      if (def->modrm == MMC)
+        CuAssertTrue(tc, cost[1] > 0);
+      else if (!has_modrm(def) && def->op != TOK_LOCK)
+        CuAssertTrue(tc, cost[0] > 0);
+    }
+  }
+}
+
+CuSuite* cycles_test_suite(void) {
+  CuSuite* suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_ea_cycles);
+  SUITE_ADD_TEST(suite, test_instruction_cycles);
+  SUITE_ADD_TEST(suite, test_table_cycles);
+  return suite;
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,26 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Static estimates of 8086 and 80286 instruction clocks.
+
+#ifndef CYCLES_H
+#define CYCLES_H
+
+#include <stdbool.h>
+#include "instable.h"
+
+enum cycle_model { CYCLES_8086, CYCLES_286, CYCLE_MODELS };
+
+// Clocks of the effective address calculation of a ModR/M byte.
+unsigned ea_cycles(BYTE modrm, int model);
+
+// Estimated clocks of an encoded instruction of the table entry, from its
+// first prefix byte: WAIT, REP and segment override prefixes, the entry's
+// register or memory cost, and any effective address. A repeated string
+// instruction is counted once through. A conditional transfer costs as taken
+// or not. 0 if the entry is not an instruction of the processor.
+unsigned instruction_cycles(const INSDEF*, const BYTE* code, unsigned len, bool taken, int model);
+
+// A direct JMP SHORT or NEAR, which has no table entry.
+unsigned direct_jump_cycles(int model);
+
+#endif // CYCLES_H
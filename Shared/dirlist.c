@@ -0,0 +1,93 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Directory listing for batch processing.
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <dirent.h>
+#endif
+#include "dirlist.h"
+#include "utils.h"
+
+static bool has_extension(const char* name, const char* ext) {
+  size_t len = strlen(name);
+  size_t ext_len = strlen(ext);
+  return len > ext_len && _stricmp(name + len - ext_len, ext) == 0;
+}
+
+static char* join_path(const char* dir, const char* name) {
+  size_t len = strlen(dir);
+  char* path = emalloc(len + 1 + strlen(name) + 1);
+  strcpy(path, dir);
+  if (len > 0 && dir[len - 1] != '/' && dir[len - 1] != '\\')
+    strcat(path, "/");
+  strcat(path, name);
+  return path;
+}
+
+static int compare_strings(const void* p, const void* q) {
+  return strcmp(*(char* const *)p, *(char* const *)q);
+}
+
+bool is_directory(const char* path) {
+  struct stat st;
+  return stat(path, &st) == 0 && (st.st_mode & S_IFMT) == S_IFDIR;
+}
+
+#ifdef _WIN32
+
+static void append_directory(STRINGLIST* list, const char* dir, const char* ext) {
+  if (!is_directory(dir))
+    fatal("cannot read directory: %s\n", dir);
+  char* pattern = join_path(dir, "*");
+  struct _finddata_t data;
+  intptr_t h = _findfirst(pattern, &data);
+  efree(pattern);
+  if (h == -1)
+    return;
+  do {
+    if (!(data.attrib & _A_SUBDIR) && has_extension(data.name, ext))
+      append_string_pointer(list, join_path(dir, data.name));
+  } while (_findnext(h, &data) == 0);
+  _findclose(h);
+}
+
+#else
+
+static void append_directory(STRINGLIST* list, const char* dir, const char* ext) {
+  DIR* d = opendir(dir);
+  if (d == NULL)
+    fatal("cannot read directory: %s\n", dir);
+  for (struct dirent* e = readdir(d); e; e = readdir(d)) {
+    if (!has_extension(e->d_name, ext))
+      continue;
+    char* path = join_path(dir, e->d_name);
+    if (is_directory(path))
+      efree(path);
+    else
+      append_string_pointer(list, path);
+  }
+  closedir(d);
+}
+
+#endif
+
+void append_files(STRINGLIST* list, const char* path, const char* ext) {
+  assert(list != NULL);
+  assert(path != NULL);
+  assert(ext != NULL);
+
+  if (!is_directory(path)) {
+    append_string(list, path);
+    return;
+  }
+
+  unsigned first = list->used;
+  append_directory(list, path, ext);
+  qsort(list->strings + first, list->used - first, sizeof list->strings[0], compare_strings);
+}
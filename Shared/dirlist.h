@@ -0,0 +1,17 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Directory listing for batch processing.
+
+#ifndef DIRLIST_H
+#define DIRLIST_H
+
+#include <stdbool.h>
+#include "stringlist.h"
+
+bool is_directory(const char* path);
+
+// If path is a directory, append the paths of the files in it having the
+// given extension, in name order; otherwise append path itself.
+void append_files(STRINGLIST*, const char* path, const char* ext);
+
+#endif // DIRLIST_H
@@ -753,3 +753,48 @@ static void print_disp(const struct dis_mem * m) {
     putchar('0');
   fputs(buf, stdout);
 }
+
+#ifdef UNIT_TEST
+
+#include "CuTest.h"
+
+// Decode a loop of typical 8086 code repeatedly.
+static void bench_decode_instruction(CuBench* bc) {
+  static const BYTE code[] = {
+    0x55,                               // push bp
+    0x8B, 0xEC,                         // mov bp, sp
+    0xB8, 0x34, 0x12,                   // mov ax, 1234h
+    0x03, 0x40, 0x04,                   // add ax, [bx+si+4]
+    0xC7, 0x06, 0x34, 0x12, 0x05, 0x00, // mov [word 1234h], 5
+    0xF3, 0xA4,                         // rep movsb
+    0xE8, 0x00, 0x00,                   // call near
+    0xCD, 0x21,                         // int 21h
+    0x75, 0xEB,                         // jnz short
+    0xC3,                               // ret
+  };
+  DECODER* decoder = build_decoder();
+  DECODED dec;
+  unsigned i = 0;
+
+  CuBenchStart(bc);
+  for (long n = 0; n < bc->n; n++) {
+    int err = decode_instruction(decoder, code + i, sizeof code - i, &dec);
+    assert(err == DECODE_ERR_NONE);
+    (void) err;
+    i += dec.len;
+    if (i >= sizeof code)
+      i = 0;
+  }
+  CuBenchStop(bc);
+
+  bc->sink = i;
+  delete_decoder(decoder);
+}
+
+CuBenchSuite* disassemble_bench_suite(void) {
+  CuBenchSuite* suite = CuBenchSuiteNew();
+  SUITE_ADD_BENCH(suite, bench_decode_instruction);
+  return suite;
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,93 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Build-time generator of the instruction matching tables.
+// Writes a header listing, for each opcode token, the contiguous range of
+// instable entries which are candidates for it, in table order, with the
+// operand flag bit each candidate requires of each operand.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "instable.h"
+#include "opclass.h"
+#include "token.h"
+#include "utils.h"
+
+#define OPCODES (LAST_OPCODE_TOKEN - FIRST_OPCODE_TOKEN + 1)
+
+static unsigned count_entries(void) {
+  unsigned i = 1;
+  while (instable[i].op != TOK_NONE)
+    i++;
+  // including the end marker
+  return i + 1;
+}
+
+static void write_candidates(FILE* fp, unsigned entries, unsigned first[OPCODES], unsigned count[OPCODES]) {
+  unsigned n = 0;
+
+  fprintf(fp, "static const struct candidate {\n"
+              "  unsigned short index;\n"
+              "  QWORD mask[3];\n"
+              "} candidates[] = {\n");
+  for (int op = FIRST_OPCODE_TOKEN; op <= LAST_OPCODE_TOKEN; op++) {
+    const int k = op - FIRST_OPCODE_TOKEN;
+    first[k] = n;
+    count[k] = 0;
+    for (unsigned i = 1; i + 1 < entries; i++) {
+      const INSDEF* p = &instable[i];
+      if (p->op != op)
+        continue;
+      if (p->oper1 >= 64 || p->oper2 >= 64 || p->oper3 >= 64)
+        fatal("operand flag does not fit in mask: instable[%u]\n", i);
+      fprintf(fp, "  { %4u, { 0x%011llXull, 0x%011llXull, 0x%011llXull } }, // %s %s %s %s\n",
+              i, FLAG_BIT(p->oper1), FLAG_BIT(p->oper2), FLAG_BIT(p->oper3), token_name(op),
+              operand_flag_name(p->oper1), operand_flag_name(p->oper2), operand_flag_name(p->oper3));
+      count[k]++;
+      n++;
+    }
+  }
+  if (n == 0)
+    fatal("no instructions in table\n");
+  fprintf(fp, "};\n\n");
+}
+
+static void write_ranges(FILE* fp, const unsigned first[OPCODES], const unsigned count[OPCODES]) {
+  fprintf(fp, "// indexed by token - FIRST_OPCODE_TOKEN\n"
+              "static const struct candidate_range {\n"
+              "  unsigned short first;\n"
+              "  unsigned short count;\n"
+              "} candidate_ranges[%d] = {\n", OPCODES);
+  for (int k = 0; k < OPCODES; k++)
+    fprintf(fp, "  { %4u, %2u }, // %s\n", first[k], count[k], token_name(FIRST_OPCODE_TOKEN + k));
+  fprintf(fp, "};\n");
+}
+
+int main(int argc, char* argv[]) {
+  progname = "geninstab";
+
+  if (argc != 2) {
+    fprintf(stderr, "usage: geninstab output-header\n");
+    return EXIT_FAILURE;
+  }
+
+  const unsigned entries = count_entries();
+  unsigned first[OPCODES], count[OPCODES];
+
+  FILE* fp = fopen(argv[1], "w");
+  if (fp == NULL)
+    fatal("cannot open %s\n", argv[1]);
+
+  fprintf(fp, "// Generated by geninstab from insdefs.c: do not edit.\n\n"
+              "#ifndef INSMATCH_H\n"
+              "#define INSMATCH_H\n\n"
+              "// entries in instable, including the initial and final TOK_NONE\n"
+              "#define INSTABLE_ENTRIES (%u)\n\n", entries);
+  write_candidates(fp, entries, first, count);
+  write_ranges(fp, first, count);
+  fprintf(fp, "\n#endif // INSMATCH_H\n");
+
+  if (fclose(fp) != 0)
+    fatal("error writing %s\n", argv[1]);
+
+  return EXIT_SUCCESS;
+}
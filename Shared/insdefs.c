@@ -0,0 +1,635 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Instruction table definitions.
+// Matching tables are generated from these at build time by geninstab.
+// Clock columns: 8086 and 286, each register (or taken) then memory (or not taken).
+
+#include "instable.h"
+#include "token.h"
+
+const INSDEF instable[] = {
+  // index 0 = not an instruction
+  { TOK_NONE },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_AAA,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x37, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_AAD,     OF_NONE,  OF_NONE,  OF_NONE,  2, NOPR, 0xD5, 0x0A, 0,  RMN, 0,  0,  0,  0, P86,   {  60,   0 }, {  14,   0 } },
+  { TOK_AAM,     OF_NONE,  OF_NONE,  OF_NONE,  2, NOPR, 0xD4, 0x0A, 0,  RMN, 0,  0,  0,  0, P86,   {  83,   0 }, {  16,   0 } },
+  { TOK_AAS,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x3F, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   4,   0 }, {   3,   0 } },
+
+  { TOK_ADC,     OF_AL,    OF_IMM,   OF_NONE,  1, NOPR, 0x14, 0x00, 0,  RMN, 0,  0,  1,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_ADC,     OF_AX,    OF_IMM,   OF_NONE,  1, NOPR, 0x15, 0x00, 0,  RMN, 0,  0,  2,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_ADC,     OF_REG8,  OF_RM,    OF_NONE,  1, NOPR, 0x12, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   7 } },
+  { TOK_ADC,     OF_RM,    OF_REG8,  OF_NONE,  1, NOPR, 0x10, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+  { TOK_ADC,     OF_REG16, OF_RM,    OF_NONE,  1, NOPR, 0x13, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   7 } },
+  { TOK_ADC,     OF_RM,    OF_REG16, OF_NONE,  1, NOPR, 0x11, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+  { TOK_ADC,     OF_RM8,   OF_IMM,   OF_NONE,  1, NOPR, 0x80, 0x00, 0,  RMC, 2,  0,  1,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_ADC,     OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0x83, 0x00, 0,  RMC, 2,  0,  1,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_ADC,     OF_RM16,  OF_IMM,   OF_NONE,  1, NOPR, 0x81, 0x00, 0,  RMC, 2,  0,  2,  0, P86,   {   4,  17 }, {   3,   7 } },
+
+  { TOK_ADD,     OF_AL,    OF_IMM,   OF_NONE,  1, NOPR, 0x04, 0x00, 0,  RMN, 0,  0,  1,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_ADD,     OF_AX,    OF_IMM,   OF_NONE,  1, NOPR, 0x05, 0x00, 0,  RMN, 0,  0,  2,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_ADD,     OF_RM8,   OF_IMM,   OF_NONE,  1, NOPR, 0x80, 0x00, 0,  RMC, 0,  0,  1,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_ADD,     OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0x83, 0x00, 0,  RMC, 0,  0,  1,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_ADD,     OF_RM16,  OF_IMM,   OF_NONE,  1, NOPR, 0x81, 0x00, 0,  RMC, 0,  0,  2,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_ADD,     OF_REG8,  OF_RM,    OF_NONE,  1, NOPR, 0x02, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   7 } },
+  { TOK_ADD,     OF_RM,    OF_REG8,  OF_NONE,  1, NOPR, 0x00, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+  { TOK_ADD,     OF_REG16, OF_RM,    OF_NONE,  1, NOPR, 0x03, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   7 } },
+  { TOK_ADD,     OF_RM,    OF_REG16, OF_NONE,  1, NOPR, 0x01, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_AND,     OF_AL,    OF_IMM,   OF_NONE,  1, NOPR, 0x24, 0x00, 0,  RMN, 0,  0,  1,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_AND,     OF_AX,    OF_IMM,   OF_NONE,  1, NOPR, 0x25, 0x00, 0,  RMN, 0,  0,  2,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_AND,     OF_RM8,   OF_IMM,   OF_NONE,  1, NOPR, 0x80, 0x00, 0,  RMC, 4,  0,  1,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_AND,     OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0x83, 0x00, 0,  RMC, 4,  0,  1,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_AND,     OF_RM16,  OF_IMM,   OF_NONE,  1, NOPR, 0x81, 0x00, 0,  RMC, 4,  0,  2,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_AND,     OF_REG8,  OF_RM,    OF_NONE,  1, NOPR, 0x22, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   7 } },
+  { TOK_AND,     OF_RM,    OF_REG8,  OF_NONE,  1, NOPR, 0x20, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+  { TOK_AND,     OF_REG16, OF_RM,    OF_NONE,  1, NOPR, 0x23, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   7 } },
+  { TOK_AND,     OF_RM,    OF_REG16, OF_NONE,  1, NOPR, 0x21, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+
+  { TOK_ARPL,    OF_RM16,  OF_REG16, OF_NONE,  1, NOPR, 0x63, 0x00, 0,  RMR, 0,  0,  0,  0, P286P, {   0,   0 }, {  10,  11 } },
+
+  { TOK_BOUND,   OF_REG16, OF_RM16,  OF_NONE,  1, NOPR, 0x62, 0x00, 0,  RRM, 0,  0,  0,  0, P286N, {   0,   0 }, {   0,  13 } },
+
+  { TOK_CALL,    OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0xE8, 0x00, 0,  RMN, 0,  2,  0,  0, P86,   {  19,   0 }, {   9,   0 } },
+  { TOK_CALL,    OF_RM16,  OF_NONE,  OF_NONE,  1, NOPR, 0xFF, 0x00, 0,  RMC, 2,  0,  0,  0, P86,   {  16,  21 }, {   9,  13 } },
+  { TOK_CALL,    OF_RM32,  OF_NONE,  OF_NONE,  1, NOPR, 0xFF, 0x00, 0,  RMC, 3,  0,  0,  0, P86,   {   0,  37 }, {   0,  18 } },
+  { TOK_CALL,    OF_FAR,   OF_NONE,  OF_NONE,  1, NOPR, 0x9A, 0x00, 0,  RMN, 0,  4,  0,  0, P86,   {  28,   0 }, {  15,   0 } },
+
+  { TOK_CBW,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x98, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   2,   0 }, {   2,   0 } },
+  { TOK_CLC,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xF8, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   2,   0 }, {   2,   0 } },
+  { TOK_CLD,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xFC, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   2,   0 }, {   2,   0 } },
+  { TOK_CLI,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xFA, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   2,   0 }, {   3,   0 } },
+  { TOK_CMC,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xF5, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   2,   0 }, {   2,   0 } },
+
+  { TOK_CLTS,    OF_NONE,  OF_NONE,  OF_NONE,  2, NOPR, 0x0F, 0x06, 0,  RMN, 0,  0,  0,  0, P286P, {   0,   0 }, {   2,   0 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_CMP,     OF_AL,    OF_IMM,   OF_NONE,  1, NOPR, 0x3C, 0x00, 0,  RMN, 0,  0,  1,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_CMP,     OF_AX,    OF_IMM,   OF_NONE,  1, NOPR, 0x3D, 0x00, 0,  RMN, 0,  0,  2,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_CMP,     OF_RM8,   OF_IMM,   OF_NONE,  1, NOPR, 0x80, 0x00, 0,  RMC, 7,  0,  1,  0, P86,   {   4,  10 }, {   3,   6 } },
+  { TOK_CMP,     OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0x83, 0x00, 0,  RMC, 7,  0,  1,  0, P86,   {   4,  10 }, {   3,   6 } },
+  { TOK_CMP,     OF_RM16,  OF_IMM,   OF_NONE,  1, NOPR, 0x81, 0x00, 0,  RMC, 7,  0,  2,  0, P86,   {   4,  10 }, {   3,   6 } },
+  { TOK_CMP,     OF_REG8,  OF_RM,    OF_NONE,  1, NOPR, 0x3A, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   6 } },
+  { TOK_CMP,     OF_RM,    OF_REG8,  OF_NONE,  1, NOPR, 0x38, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   6 } },
+  { TOK_CMP,     OF_REG16, OF_RM,    OF_NONE,  1, NOPR, 0x3B, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   6 } },
+  { TOK_CMP,     OF_RM,    OF_REG16, OF_NONE,  1, NOPR, 0x39, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   6 } },
+
+  { TOK_CMPSB,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xA6, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  22,   0 }, {   8,   0 } },
+  { TOK_CMPSW,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xA7, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  22,   0 }, {   8,   0 } },
+  { TOK_CMPS,    OF_SI8,   OF_DI,    OF_NONE,  1, NOPR, 0xA6, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  22,   0 }, {   8,   0 } },
+  { TOK_CMPS,    OF_SI,    OF_DI8,   OF_NONE,  1, NOPR, 0xA6, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  22,   0 }, {   8,   0 } },
+  { TOK_CMPS,    OF_SI16,  OF_DI,    OF_NONE,  1, NOPR, 0xA7, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  22,   0 }, {   8,   0 } },
+  { TOK_CMPS,    OF_SI,    OF_DI16,  OF_NONE,  1, NOPR, 0xA7, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  22,   0 }, {   8,   0 } },
+
+  { TOK_CWD,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x99, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   5,   0 }, {   2,   0 } },
+  { TOK_DAA,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x27, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_DAS,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x2F, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   4,   0 }, {   3,   0 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_DEC,     OF_REG16, OF_NONE,  OF_NONE,  1, NOPR, 0x48, 0x00, 1,  RMN, 0,  0,  0,  0, P86,   {   2,   0 }, {   2,   0 } },
+  { TOK_DEC,     OF_RM8,   OF_NONE,  OF_NONE,  1, NOPR, 0xFE, 0x00, 0,  RMC, 1,  0,  0,  0, P86,   {   3,  15 }, {   2,   7 } },
+  { TOK_DEC,     OF_RM16,  OF_NONE,  OF_NONE,  1, NOPR, 0xFF, 0x00, 0,  RMC, 1,  0,  0,  0, P86,   {   3,  15 }, {   2,   7 } },
+
+  { TOK_DIV,     OF_RM8,   OF_NONE,  OF_NONE,  1, NOPR, 0xF6, 0x00, 0,  RMC, 6,  0,  0,  0, P86,   {  85,  91 }, {  14,  17 } },
+  { TOK_DIV,     OF_RM16,  OF_NONE,  OF_NONE,  1, NOPR, 0xF7, 0x00, 0,  RMC, 6,  0,  0,  0, P86,   { 153, 159 }, {  22,  25 } },
+
+  { TOK_ENTER,   OF_IMM,   OF_IMM8U, OF_NONE,  1, NOPR, 0xC8, 0x00, 0,  RMN, 0,  2,  1,  0, P286N, {   0,   0 }, {  11,   0 } },
+
+  { TOK_FABS,    OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xE1, 0,  CCC, 0,  0,  0,  0, P87,   {  14,   0 }, {  14,   0 } },
+
+  { TOK_FADD,    OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  STK, 0,  0,  0,  0, P87,   {  85,   0 }, {  85,   0 } },
+  { TOK_FADD,    OF_STT,   OF_STI,   OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  SSI, 0,  0,  0,  0, P87,   {  85,   0 }, {  85,   0 } },
+  { TOK_FADD,    OF_STI,   OF_STT,   OF_NONE,  1, WAIT, 0xDC, 0x00, 0,  SIS, 0,  0,  0,  0, P87,   {  85,   0 }, {  85,   0 } },
+  { TOK_FADD,    OF_STT,   OF_STT,   OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  SSC, 0,  0,  0,  0, P87,   {  85,   0 }, {  85,   0 } },
+  { TOK_FADD,    OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  MMC, 0,  0,  0,  0, P87,   {   0, 105 }, {   0, 105 } },
+  { TOK_FADD,    OF_MEM64, OF_NONE,  OF_NONE,  1, WAIT, 0xDC, 0x00, 0,  MMC, 0,  0,  0,  0, P87,   {   0, 110 }, {   0, 110 } },
+
+  { TOK_FADDP,   OF_STI,   OF_STT,   OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  SIS, 0,  0,  0,  0, P87,   {  90,   0 }, {  90,   0 } },
+  { TOK_FADDP,   OF_STT,   OF_STT,   OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  SSC, 0,  0,  0,  0, P87,   {  90,   0 }, {  90,   0 } },
+  { TOK_FADDP,   OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  STK, 0,  0,  0,  0, P87,   {  90,   0 }, {  90,   0 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_FBLD,    OF_MEM80, OF_NONE,  OF_NONE,  1, WAIT, 0xDF, 0x00, 0,  MMC, 4,  0,  0,  0, P87,   {   0, 300 }, {   0, 300 } },
+  { TOK_FBSTP,   OF_MEM80, OF_NONE,  OF_NONE,  1, WAIT, 0xDF, 0x00, 0,  MMC, 6,  0,  0,  0, P87,   {   0, 530 }, {   0, 530 } },
+  { TOK_FCHS,    OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xE0, 0,  CCC, 0,  0,  0,  0, P87,   {  15,   0 }, {  15,   0 } },
+  { TOK_FCLEX,   OF_NONE,  OF_NONE,  OF_NONE,  1, W286, 0xDB, 0xE2, 0,  CCC, 0,  0,  0,  0, P87,   {   5,   0 }, {   5,   0 } },
+  { TOK_FNCLEX,  OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xDB, 0xE2, 0,  CCC, 0,  0,  0,  0, P87,   {   5,   0 }, {   5,   0 } },
+
+  { TOK_FCOM,    OF_STI,   OF_NONE,  OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  SIC, 2,  0,  0,  0, P87,   {  45,   0 }, {  45,   0 } },
+  { TOK_FCOM,    OF_STT,   OF_NONE,  OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  STC, 2,  0,  0,  0, P87,   {  45,   0 }, {  45,   0 } },
+  { TOK_FCOM,    OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  STK, 2,  0,  0,  0, P87,   {  45,   0 }, {  45,   0 } },
+  { TOK_FCOM,    OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  MMC, 2,  0,  0,  0, P87,   {   0,  65 }, {   0,  65 } },
+  { TOK_FCOM,    OF_MEM64, OF_NONE,  OF_NONE,  1, WAIT, 0xDC, 0x00, 0,  MMC, 2,  0,  0,  0, P87,   {   0,  70 }, {   0,  70 } },
+
+  { TOK_FCOMP,   OF_STI,   OF_NONE,  OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  SIC, 3,  0,  0,  0, P87,   {  47,   0 }, {  47,   0 } },
+  { TOK_FCOMP,   OF_STT,   OF_NONE,  OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  STC, 3,  0,  0,  0, P87,   {  47,   0 }, {  47,   0 } },
+  { TOK_FCOMP,   OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  MMC, 3,  0,  0,  0, P87,   {   0,  68 }, {   0,  68 } },
+  { TOK_FCOMP,   OF_MEM64, OF_NONE,  OF_NONE,  1, WAIT, 0xDC, 0x00, 0,  MMC, 3,  0,  0,  0, P87,   {   0,  72 }, {   0,  72 } },
+  { TOK_FCOMP,   OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  STK, 3,  0,  0,  0, P87,   {  47,   0 }, {  47,   0 } },
+
+  { TOK_FCOMPP,  OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  STK, 3,  0,  0,  0, P87,   {  50,   0 }, {  50,   0 } },
+
+  { TOK_FDECSTP, OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xF6, 0,  CCC, 0,  0,  0,  0, P87,   {   9,   0 }, {   9,   0 } },
+  { TOK_FDISI,   OF_NONE,  OF_NONE,  OF_NONE,  1, W286, 0xDB, 0xE1, 0,  CCC, 0,  0,  0,  0, P87,   {   5,   0 }, {   5,   0 } },
+  { TOK_FNDISI,  OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xDB, 0xE1, 0,  CCC, 0,  0,  0,  0, P87,   {   5,   0 }, {   5,   0 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_FDIV,    OF_STT,   OF_STI,   OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  SSI, 6,  0,  0,  0, P87,   { 198,   0 }, { 198,   0 } },
+  { TOK_FDIV,    OF_STI,   OF_STT,   OF_NONE,  1, WAIT, 0xDC, 0x00, 0,  SIS, 7,  0,  0,  0, P87,   { 198,   0 }, { 198,   0 } },
+  { TOK_FDIV,    OF_STT,   OF_STT,   OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  SSC, 6,  0,  0,  0, P87,   { 198,   0 }, { 198,   0 } },
+  { TOK_FDIV,    OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  MMC, 6,  0,  0,  0, P87,   {   0, 220 }, {   0, 220 } },
+  { TOK_FDIV,    OF_MEM64, OF_NONE,  OF_NONE,  1, WAIT, 0xDC, 0x00, 0,  MMC, 6,  0,  0,  0, P87,   {   0, 225 }, {   0, 225 } },
+  { TOK_FDIVP,   OF_STI,   OF_STT,   OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  SIS, 7,  0,  0,  0, P87,   { 202,   0 }, { 202,   0 } },
+  { TOK_FDIVP,   OF_STT,   OF_STT,   OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  SSC, 7,  0,  0,  0, P87,   { 202,   0 }, { 202,   0 } },
+  { TOK_FDIV,    OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  STK, 7,  0,  0,  0, P87,   { 198,   0 }, { 198,   0 } },
+  { TOK_FDIVP,   OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  STK, 7,  0,  0,  0, P87,   { 202,   0 }, { 202,   0 } },
+
+  { TOK_FDIVR,   OF_STT,   OF_STI,   OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  SSI, 7,  0,  0,  0, P87,   { 199,   0 }, { 199,   0 } },
+  { TOK_FDIVR,   OF_STI,   OF_STT,   OF_NONE,  1, WAIT, 0xDC, 0x00, 0,  SIS, 6,  0,  0,  0, P87,   { 199,   0 }, { 199,   0 } },
+  { TOK_FDIVR,   OF_STT,   OF_STT,   OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  SSC, 7,  0,  0,  0, P87,   { 199,   0 }, { 199,   0 } },
+  { TOK_FDIVR,   OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  MMC, 7,  0,  0,  0, P87,   {   0, 221 }, {   0, 221 } },
+  { TOK_FDIVR,   OF_MEM64, OF_NONE,  OF_NONE,  1, WAIT, 0xDC, 0x00, 0,  MMC, 7,  0,  0,  0, P87,   {   0, 226 }, {   0, 226 } },
+  { TOK_FDIVRP,  OF_STI,   OF_STT,   OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  SIS, 6,  0,  0,  0, P87,   { 203,   0 }, { 203,   0 } },
+  { TOK_FDIVRP,  OF_STT,   OF_STT,   OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  SSC, 6,  0,  0,  0, P87,   { 203,   0 }, { 203,   0 } },
+  { TOK_FDIVR,   OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  STK, 6,  0,  0,  0, P87,   { 199,   0 }, { 199,   0 } },
+  { TOK_FDIVRP,  OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  STK, 6,  0,  0,  0, P87,   { 203,   0 }, { 203,   0 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_FENI,    OF_NONE,  OF_NONE,  OF_NONE,  1, W286, 0xDB, 0xE0, 0,  CCC, 0,  0,  0,  0, P87,   {   5,   0 }, {   5,   0 } },
+  { TOK_FNENI,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xDB, 0xE0, 0,  CCC, 0,  0,  0,  0, P87,   {   5,   0 }, {   5,   0 } },
+
+  { TOK_FFREE,   OF_STI,   OF_NONE,  OF_NONE,  1, WAIT, 0xDD, 0x00, 0,  SIC, 0,  0,  0,  0, P87,   {  11,   0 }, {  11,   0 } },
+  { TOK_FFREE,   OF_STT,   OF_NONE,  OF_NONE,  1, WAIT, 0xDD, 0x00, 0,  STC, 0,  0,  0,  0, P87,   {  11,   0 }, {  11,   0 } },
+  { TOK_FFREE,   OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDD, 0x00, 0,  STK, 0,  0,  0,  0, P87,   {  11,   0 }, {  11,   0 } },
+
+  { TOK_FIADD,   OF_MEM16, OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  MMC, 0,  0,  0,  0, P87,   {   0, 120 }, {   0, 120 } },
+  { TOK_FIADD,   OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xDA, 0x00, 0,  MMC, 0,  0,  0,  0, P87,   {   0, 125 }, {   0, 125 } },
+
+  { TOK_FICOM,   OF_MEM16, OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  MMC, 2,  0,  0,  0, P87,   {   0,  80 }, {   0,  80 } },
+  { TOK_FICOM,   OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xDA, 0x00, 0,  MMC, 2,  0,  0,  0, P87,   {   0,  85 }, {   0,  85 } },
+
+  { TOK_FICOMP,  OF_MEM16, OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  MMC, 3,  0,  0,  0, P87,   {   0,  82 }, {   0,  82 } },
+  { TOK_FICOMP,  OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xDA, 0x00, 0,  MMC, 3,  0,  0,  0, P87,   {   0,  87 }, {   0,  87 } },
+
+  { TOK_FIDIV,   OF_MEM16, OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  MMC, 6,  0,  0,  0, P87,   {   0, 230 }, {   0, 230 } },
+  { TOK_FIDIV,   OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xDA, 0x00, 0,  MMC, 6,  0,  0,  0, P87,   {   0, 236 }, {   0, 236 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_FIDIVR,  OF_MEM16, OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  MMC, 7,  0,  0,  0, P87,   {   0, 230 }, {   0, 230 } },
+  { TOK_FIDIVR,  OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xDA, 0x00, 0,  MMC, 7,  0,  0,  0, P87,   {   0, 237 }, {   0, 237 } },
+
+  { TOK_FILD,    OF_MEM16, OF_NONE,  OF_NONE,  1, WAIT, 0xDF, 0x00, 0,  MMC, 0,  0,  0,  0, P87,   {   0,  50 }, {   0,  50 } },
+  { TOK_FILD,    OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xDB, 0x00, 0,  MMC, 0,  0,  0,  0, P87,   {   0,  56 }, {   0,  56 } },
+  { TOK_FILD,    OF_MEM64, OF_NONE,  OF_NONE,  1, WAIT, 0xDF, 0x00, 0,  MMC, 5,  0,  0,  0, P87,   {   0,  64 }, {   0,  64 } },
+
+  { TOK_FIMUL,   OF_MEM16, OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  MMC, 1,  0,  0,  0, P87,   {   0, 130 }, {   0, 130 } },
+  { TOK_FIMUL,   OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xDA, 0x00, 0,  MMC, 1,  0,  0,  0, P87,   {   0, 136 }, {   0, 136 } },
+
+  { TOK_FINCSTP, OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xF7, 0,  CCC, 0,  0,  0,  0, P87,   {   9,   0 }, {   9,   0 } },
+  { TOK_FINIT,   OF_NONE,  OF_NONE,  OF_NONE,  1, W286, 0xDB, 0xE3, 0,  CCC, 0,  0,  0,  0, P87,   {   5,   0 }, {   5,   0 } },
+  { TOK_FNINIT,  OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xDB, 0xE3, 0,  CCC, 0,  0,  0,  0, P87,   {   5,   0 }, {   5,   0 } },
+
+  { TOK_FIST,    OF_MEM16, OF_NONE,  OF_NONE,  1, WAIT, 0xDF, 0x00, 0,  MMC, 2,  0,  0,  0, P87,   {   0,  86 }, {   0,  86 } },
+  { TOK_FIST,    OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xDB, 0x00, 0,  MMC, 2,  0,  0,  0, P87,   {   0,  88 }, {   0,  88 } },
+  { TOK_FISTP,   OF_MEM16, OF_NONE,  OF_NONE,  1, WAIT, 0xDF, 0x00, 0,  MMC, 3,  0,  0,  0, P87,   {   0,  88 }, {   0,  88 } },
+  { TOK_FISTP,   OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xDB, 0x00, 0,  MMC, 3,  0,  0,  0, P87,   {   0,  90 }, {   0,  90 } },
+  { TOK_FISTP,   OF_MEM64, OF_NONE,  OF_NONE,  1, WAIT, 0xDF, 0x00, 0,  MMC, 7,  0,  0,  0, P87,   {   0, 100 }, {   0, 100 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_FISUB,   OF_MEM16, OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  MMC, 4,  0,  0,  0, P87,   {   0, 125 }, {   0, 125 } },
+  { TOK_FISUB,   OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xDA, 0x00, 0,  MMC, 4,  0,  0,  0, P87,   {   0, 129 }, {   0, 129 } },
+
+  { TOK_FISUBR,  OF_MEM16, OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  MMC, 5,  0,  0,  0, P87,   {   0, 125 }, {   0, 125 } },
+  { TOK_FISUBR,  OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xDA, 0x00, 0,  MMC, 5,  0,  0,  0, P87,   {   0, 129 }, {   0, 129 } },
+
+  { TOK_FLD,     OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0x00, 0,  MMC, 0,  0,  0,  0, P87,   {   0,  43 }, {   0,  43 } },
+  { TOK_FLD,     OF_MEM64, OF_NONE,  OF_NONE,  1, WAIT, 0xDD, 0x00, 0,  MMC, 0,  0,  0,  0, P87,   {   0,  46 }, {   0,  46 } },
+  { TOK_FLD,     OF_MEM80, OF_NONE,  OF_NONE,  1, WAIT, 0xDB, 0x00, 0,  MMC, 5,  0,  0,  0, P87,   {   0,  57 }, {   0,  57 } },
+  { TOK_FLD,     OF_STI,   OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0x00, 0,  SIC, 0,  0,  0,  0, P87,   {  20,   0 }, {  20,   0 } },
+  { TOK_FLD,     OF_STT,   OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0x00, 0,  STC, 0,  0,  0,  0, P87,   {  20,   0 }, {  20,   0 } },
+  { TOK_FLD,     OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0x00, 0,  STK, 0,  0,  0,  0, P87,   {  20,   0 }, {  20,   0 } },
+
+  { TOK_FLDCW,   OF_MEM16, OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0x00, 0,  MMC, 5,  0,  0,  0, P87,   {   0,  10 }, {   0,  10 } },
+  { TOK_FLDENV,  OF_MEM,   OF_NONE,  OF_NONE,  1, WAI2, 0xD9, 0x00, 0,  MMC, 4,  0,  0,  0, P87,   {   0,  40 }, {   0,  40 } },
+  { TOK_FLDLG2,  OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xEC, 0,  CCC, 0,  0,  0,  0, P87,   {  21,   0 }, {  21,   0 } },
+  { TOK_FLDLN2,  OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xED, 0,  CCC, 0,  0,  0,  0, P87,   {  20,   0 }, {  20,   0 } },
+  { TOK_FLDL2E,  OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xEA, 0,  CCC, 0,  0,  0,  0, P87,   {  18,   0 }, {  18,   0 } },
+  { TOK_FLDL2T,  OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xE9, 0,  CCC, 0,  0,  0,  0, P87,   {  19,   0 }, {  19,   0 } },
+  { TOK_FLDPI,   OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xEB, 0,  CCC, 0,  0,  0,  0, P87,   {  19,   0 }, {  19,   0 } },
+  { TOK_FLDZ,    OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xEE, 0,  CCC, 0,  0,  0,  0, P87,   {  14,   0 }, {  14,   0 } },
+  { TOK_FLD1,    OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xE8, 0,  CCC, 0,  0,  0,  0, P87,   {  18,   0 }, {  18,   0 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_FMUL,    OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  MMC, 1,  0,  0,  0, P87,   {   0, 118 }, {   0, 118 } },
+  { TOK_FMUL,    OF_MEM64, OF_NONE,  OF_NONE,  1, WAIT, 0xDC, 0x00, 0,  MMC, 1,  0,  0,  0, P87,   {   0, 161 }, {   0, 161 } },
+  { TOK_FMUL,    OF_STT,   OF_STI,   OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  SSI, 1,  0,  0,  0, P87,   { 130,   0 }, { 130,   0 } },
+  { TOK_FMUL,    OF_STT,   OF_STT,   OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  SSC, 1,  0,  0,  0, P87,   { 130,   0 }, { 130,   0 } },
+  { TOK_FMUL,    OF_STI,   OF_STT,   OF_NONE,  1, WAIT, 0xDC, 0x00, 0,  SIS, 1,  0,  0,  0, P87,   { 130,   0 }, { 130,   0 } },
+  { TOK_FMULP,   OF_STI,   OF_STT,   OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  SIS, 1,  0,  0,  0, P87,   { 134,   0 }, { 134,   0 } },
+  { TOK_FMULP,   OF_STT,   OF_STT,   OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  SSC, 1,  0,  0,  0, P87,   { 134,   0 }, { 134,   0 } },
+  { TOK_FMUL,    OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  STK, 1,  0,  0,  0, P87,   { 130,   0 }, { 130,   0 } },
+  { TOK_FMULP,   OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  STK, 1,  0,  0,  0, P87,   { 134,   0 }, { 134,   0 } },
+
+  { TOK_FNOP,    OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xD0, 0,  CCC, 0,  0,  0,  0, P87,   {  13,   0 }, {  13,   0 } },
+  { TOK_FPATAN,  OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xF3, 0,  CCC, 0,  0,  0,  0, P87,   { 650,   0 }, { 650,   0 } },
+  { TOK_FPREM,   OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xF8, 0,  CCC, 0,  0,  0,  0, P87,   { 125,   0 }, { 125,   0 } },
+  { TOK_FPTAN,   OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xF2, 0,  CCC, 0,  0,  0,  0, P87,   { 450,   0 }, { 450,   0 } },
+  { TOK_FRNDINT, OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xFC, 0,  CCC, 0,  0,  0,  0, P87,   {  45,   0 }, {  45,   0 } },
+
+  { TOK_FRSTOR,  OF_MEM,   OF_NONE,  OF_NONE,  1, WAI2, 0xDD, 0x00, 0,  MMC, 4,  0,  0,  0, P87,   {   0, 210 }, {   0, 210 } },
+
+  // FNSAVE to be found before FSAVE when decoding, when the WAIT has been decoded explicitly
+  { TOK_FNSAVE,  OF_MEM,   OF_NONE,  OF_NONE,  1, NOPR, 0xDD, 0x00, 0,  MMC, 6,  0,  0,  0, P87,   {   0, 205 }, {   0, 205 } },
+  { TOK_FSAVE,   OF_MEM,   OF_NONE,  OF_NONE,  1, WAI2, 0xDD, 0x00, 0,  MMC, 6,  0,  0,  0, P87,   {   0, 205 }, {   0, 205 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_FSCALE,  OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xFD, 0,  CCC, 0,  0,  0,  0, P87,   {  35,   0 }, {  35,   0 } },
+  { TOK_FSETPM,  OF_NONE,  OF_NONE,  OF_NONE,  1, W286, 0xDB, 0xE4, 0,  CCC, 0,  0,  0,  0, P287,  {   0,   0 }, {   2,   0 } },
+  { TOK_FSQRT,   OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xFA, 0,  CCC, 0,  0,  0,  0, P87,   { 183,   0 }, { 183,   0 } },
+
+  { TOK_FST,     OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0x00, 0,  MMC, 2,  0,  0,  0, P87,   {   0,  87 }, {   0,  87 } },
+  { TOK_FST,     OF_MEM64, OF_NONE,  OF_NONE,  1, WAIT, 0xDD, 0x00, 0,  MMC, 2,  0,  0,  0, P87,   {   0, 100 }, {   0, 100 } },
+  { TOK_FST,     OF_STI,   OF_NONE,  OF_NONE,  1, WAIT, 0xDD, 0x00, 0,  SIC, 2,  0,  0,  0, P87,   {  18,   0 }, {  18,   0 } },
+  { TOK_FST,     OF_STT,   OF_NONE,  OF_NONE,  1, WAIT, 0xDD, 0x00, 0,  STC, 2,  0,  0,  0, P87,   {  18,   0 }, {  18,   0 } },
+  { TOK_FSTP,    OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0x00, 0,  MMC, 3,  0,  0,  0, P87,   {   0,  89 }, {   0,  89 } },
+  { TOK_FSTP,    OF_MEM64, OF_NONE,  OF_NONE,  1, WAIT, 0xDD, 0x00, 0,  MMC, 3,  0,  0,  0, P87,   {   0, 102 }, {   0, 102 } },
+  { TOK_FSTP,    OF_MEM80, OF_NONE,  OF_NONE,  1, WAIT, 0xDB, 0x00, 0,  MMC, 7,  0,  0,  0, P87,   {   0,  55 }, {   0,  55 } },
+  { TOK_FSTP,    OF_STI,   OF_NONE,  OF_NONE,  1, WAIT, 0xDD, 0x00, 0,  SIC, 3,  0,  0,  0, P87,   {  20,   0 }, {  20,   0 } },
+  { TOK_FSTP,    OF_STT,   OF_NONE,  OF_NONE,  1, WAIT, 0xDD, 0x00, 0,  STC, 3,  0,  0,  0, P87,   {  20,   0 }, {  20,   0 } },
+  { TOK_FST,     OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDD, 0x00, 0,  STK, 2,  0,  0,  0, P87,   {  18,   0 }, {  18,   0 } },
+  { TOK_FSTP,    OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDD, 0x00, 0,  STK, 3,  0,  0,  0, P87,   {  20,   0 }, {  20,   0 } },
+
+  { TOK_FSTCW,   OF_MEM16, OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0x00, 0,  MMC, 7,  0,  0,  0, P87,   {   0,  15 }, {   0,  15 } },
+  { TOK_FNSTCW,  OF_MEM16, OF_NONE,  OF_NONE,  1, NOPR, 0xD9, 0x00, 0,  MMC, 7,  0,  0,  0, P87,   {   0,  15 }, {   0,  15 } },
+
+  // no-wait form first so it is found first in decoding
+  // so FSTENV is decoded as explicit WAIT then FNSTENV
+  { TOK_FNSTENV, OF_MEM,   OF_NONE,  OF_NONE,  1, NOPR, 0xD9, 0x00, 0,  MMC, 6,  0,  0,  0, P87,   {   0,  45 }, {   0,  45 } },
+  { TOK_FSTENV,  OF_MEM,   OF_NONE,  OF_NONE,  1, WAI2, 0xD9, 0x00, 0,  MMC, 6,  0,  0,  0, P87,   {   0,  45 }, {   0,  45 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_FSTSW,   OF_MEM16, OF_NONE,  OF_NONE,  1, WAIT, 0xDD, 0x00, 0,  MMC, 7,  0,  0,  0, P87,   {   0,  15 }, {   0,  15 } },
+  { TOK_FNSTSW,  OF_MEM16, OF_NONE,  OF_NONE,  1, NOPR, 0xDD, 0x00, 0,  MMC, 7,  0,  0,  0, P87,   {   0,  15 }, {   0,  15 } },
+
+  { TOK_FSUB,    OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  STK, 5,  0,  0,  0, P87,   {  85,   0 }, {  85,   0 } },
+  { TOK_FSUB,    OF_STT,   OF_STI,   OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  SSI, 4,  0,  0,  0, P87,   {  85,   0 }, {  85,   0 } },
+  { TOK_FSUB,    OF_STI,   OF_STT,   OF_NONE,  1, WAIT, 0xDC, 0x00, 0,  SIS, 5,  0,  0,  0, P87,   {  85,   0 }, {  85,   0 } },
+  { TOK_FSUB,    OF_STT,   OF_STT,   OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  SSC, 4,  0,  0,  0, P87,   {  85,   0 }, {  85,   0 } },
+  { TOK_FSUB,    OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  MMC, 4,  0,  0,  0, P87,   {   0, 105 }, {   0, 105 } },
+  { TOK_FSUB,    OF_MEM64, OF_NONE,  OF_NONE,  1, WAIT, 0xDC, 0x00, 0,  MMC, 4,  0,  0,  0, P87,   {   0, 110 }, {   0, 110 } },
+  { TOK_FSUBP,   OF_STI,   OF_STT,   OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  SIS, 5,  0,  0,  0, P87,   {  90,   0 }, {  90,   0 } },
+  { TOK_FSUBP,   OF_STT,   OF_STT,   OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  SSC, 5,  0,  0,  0, P87,   {  90,   0 }, {  90,   0 } },
+  { TOK_FSUBP,   OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  STK, 5,  0,  0,  0, P87,   {  90,   0 }, {  90,   0 } },
+
+  { TOK_FSUBR,   OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  STK, 4,  0,  0,  0, P87,   {  87,   0 }, {  87,   0 } },
+  { TOK_FSUBR,   OF_STT,   OF_STI,   OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  SSI, 5,  0,  0,  0, P87,   {  87,   0 }, {  87,   0 } },
+  { TOK_FSUBR,   OF_STI,   OF_STT,   OF_NONE,  1, WAIT, 0xDC, 0x00, 0,  SIS, 4,  0,  0,  0, P87,   {  87,   0 }, {  87,   0 } },
+  { TOK_FSUBR,   OF_STT,   OF_STT,   OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  SSC, 5,  0,  0,  0, P87,   {  87,   0 }, {  87,   0 } },
+  { TOK_FSUBR,   OF_MEM32, OF_NONE,  OF_NONE,  1, WAIT, 0xD8, 0x00, 0,  MMC, 5,  0,  0,  0, P87,   {   0, 105 }, {   0, 105 } },
+  { TOK_FSUBR,   OF_MEM64, OF_NONE,  OF_NONE,  1, WAIT, 0xDC, 0x00, 0,  MMC, 5,  0,  0,  0, P87,   {   0, 110 }, {   0, 110 } },
+  { TOK_FSUBRP,  OF_STI,   OF_STT,   OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  SIS, 4,  0,  0,  0, P87,   {  90,   0 }, {  90,   0 } },
+  { TOK_FSUBRP,  OF_STT,   OF_STT,   OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  SSC, 4,  0,  0,  0, P87,   {  90,   0 }, {  90,   0 } },
+  { TOK_FSUBRP,  OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xDE, 0x00, 0,  STK, 4,  0,  0,  0, P87,   {  90,   0 }, {  90,   0 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_FTST,    OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xE4, 0,  CCC, 0,  0,  0,  0, P87,   {  42,   0 }, {  42,   0 } },
+  { TOK_FWAIT,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x9B, 0x00, 0,  RMN, 0,  0,  0,  0, P87,   {   3,   0 }, {   3,   0 } },
+  { TOK_FXAM,    OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xE5, 0,  CCC, 0,  0,  0,  0, P87,   {  17,   0 }, {  17,   0 } },
+
+  { TOK_FXCH,    OF_STI,   OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0x00, 0,  SIC, 1,  0,  0,  0, P87,   {  12,   0 }, {  12,   0 } },
+  { TOK_FXCH,    OF_STT,   OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0x00, 0,  STC, 1,  0,  0,  0, P87,   {  12,   0 }, {  12,   0 } },
+  { TOK_FXCH,    OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0x00, 0,  STK, 1,  0,  0,  0, P87,   {  12,   0 }, {  12,   0 } },
+
+  { TOK_FXTRACT, OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xF4, 0,  CCC, 0,  0,  0,  0, P87,   {  50,   0 }, {  50,   0 } },
+  { TOK_FYL2X,   OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xF1, 0,  CCC, 0,  0,  0,  0, P87,   { 950,   0 }, { 950,   0 } },
+  { TOK_FYL2XP1, OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xF9, 0,  CCC, 0,  0,  0,  0, P87,   { 850,   0 }, { 850,   0 } },
+  { TOK_F2XM1,   OF_NONE,  OF_NONE,  OF_NONE,  1, WAIT, 0xD9, 0xF0, 0,  CCC, 0,  0,  0,  0, P87,   { 500,   0 }, { 500,   0 } },
+
+  { TOK_HLT,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xF4, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   2,   0 }, {   2,   0 } },
+
+  { TOK_IDIV,    OF_RM8,   OF_NONE,  OF_NONE,  1, NOPR, 0xF6, 0x00, 0,  RMC, 7,  0,  0,  0, P86,   { 107, 113 }, {  17,  20 } },
+  { TOK_IDIV,    OF_RM16,  OF_NONE,  OF_NONE,  1, NOPR, 0xF7, 0x00, 0,  RMC, 7,  0,  0,  0, P86,   { 175, 181 }, {  25,  28 } },
+
+  { TOK_IMUL,    OF_RM8,   OF_NONE,  OF_NONE,  1, NOPR, 0xF6, 0x00, 0,  RMC, 5,  0,  0,  0, P86,   {  89,  95 }, {  13,  16 } },
+  { TOK_IMUL,    OF_RM16,  OF_NONE,  OF_NONE,  1, NOPR, 0xF7, 0x00, 0,  RMC, 5,  0,  0,  0, P86,   { 141, 147 }, {  21,  24 } },
+  { TOK_IMUL,    OF_REG16, OF_IMM8,  OF_NONE,  1, NOPR, 0x6B, 0x00, 0,  REG, 0,  0,  1,  0, P286N, {   0,   0 }, {  21,  24 } },
+  { TOK_IMUL,    OF_REG16, OF_RM16,  OF_IMM8,  1, NOPR, 0x6B, 0x00, 0,  RRM, 0,  0,  0,  1, P286N, {   0,   0 }, {  21,  24 } },
+  { TOK_IMUL,    OF_REG16, OF_RM16,  OF_IMM,   1, NOPR, 0x69, 0x00, 0,  RRM, 0,  0,  0,  2, P286N, {   0,   0 }, {  21,  24 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_IN,      OF_AL,    OF_IMM,   OF_NONE,  1, NOPR, 0xE4, 0x00, 0,  RMN, 0,  0,  1,  0, P86,   {  10,   0 }, {   5,   0 } },
+  { TOK_IN,      OF_AX,    OF_IMM,   OF_NONE,  1, NOPR, 0xE5, 0x00, 0,  RMN, 0,  0,  1,  0, P86,   {  10,   0 }, {   5,   0 } },
+  { TOK_IN,      OF_AL,    OF_DX,    OF_NONE,  1, NOPR, 0xEC, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   8,   0 }, {   5,   0 } },
+  { TOK_IN,      OF_AX,    OF_DX,    OF_NONE,  1, NOPR, 0xED, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   8,   0 }, {   5,   0 } },
+
+  { TOK_INC,     OF_REG16, OF_NONE,  OF_NONE,  1, NOPR, 0x40, 0x00, 1,  RMN, 0,  0,  0,  0, P86,   {   2,   0 }, {   2,   0 } },
+  { TOK_INC,     OF_RM8,   OF_NONE,  OF_NONE,  1, NOPR, 0xFE, 0x00, 0,  RMC, 0,  0,  0,  0, P86,   {   3,  15 }, {   2,   7 } },
+  { TOK_INC,     OF_RM16,  OF_NONE,  OF_NONE,  1, NOPR, 0xFF, 0x00, 0,  RMC, 0,  0,  0,  0, P86,   {   3,  15 }, {   2,   7 } },
+
+  { TOK_INSB,    OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x6C, 0x00, 0,  RMN, 0,  0,  0,  0, P286N, {   0,   0 }, {   5,   0 } },
+  { TOK_INSW,    OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x6D, 0x00, 0,  RMN, 0,  0,  0,  0, P286N, {   0,   0 }, {   5,   0 } },
+  { TOK_INS,     OF_DI8,   OF_DX,    OF_NONE,  1, NOPR, 0x6C, 0x00, 0,  RMN, 0,  0,  0,  0, P286N, {   0,   0 }, {   5,   0 } },
+  { TOK_INS,     OF_DI16,  OF_DX,    OF_NONE,  1, NOPR, 0x6D, 0x00, 0,  RMN, 0,  0,  0,  0, P286N, {   0,   0 }, {   5,   0 } },
+
+  { TOK_INT3,    OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xCC, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  52,   0 }, {  25,   0 } },
+  { TOK_INT,     OF_3,     OF_NONE,  OF_NONE,  1, NOPR, 0xCC, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  52,   0 }, {  25,   0 } },
+  { TOK_INTO,    OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xCE, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  53,   4 }, {  26,   3 } },
+  { TOK_INT,     OF_IMM,   OF_NONE,  OF_NONE,  1, NOPR, 0xCD, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  51,   0 }, {  25,   0 } },
+  { TOK_IRET,    OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xCF, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  24,   0 }, {  19,   0 } },
+  { TOK_IRETW,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xCF, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  24,   0 }, {  19,   0 } },
+
+  { TOK_JMP,     OF_RM16,  OF_NONE,  OF_NONE,  1, NOPR, 0xFF, 0x00, 0,  RMC, 4,  0,  0,  0, P86,   {  11,  18 }, {   9,  13 } },
+  { TOK_JMP,     OF_RM32,  OF_NONE,  OF_NONE,  1, NOPR, 0xFF, 0x00, 0,  RMC, 5,  0,  0,  0, P86,   {   0,  24 }, {   0,  17 } },
+  { TOK_JMP,     OF_FAR,   OF_NONE,  OF_NONE,  1, NOPR, 0xEA, 0x00, 0,  RMN, 0,  4,  0,  0, P86,   {  15,   0 }, {  13,   0 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_JA,      OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x77, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JAE,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x73, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JB,      OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x72, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JBE,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x76, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JC,      OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x72, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JCXZ,    OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0xE3, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  18,   6 }, {  10,   4 } },
+  { TOK_JE,      OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x74, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JG,      OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x7F, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JGE,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x7D, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JL,      OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x7C, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JLE,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x7E, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JNA,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x76, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JNAE,    OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x72, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JNB,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x73, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JNBE,    OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x77, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JNC,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x73, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JNE,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x75, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JNG,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x7E, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JNGE,    OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x7C, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JNL,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x7D, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JNLE,    OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x7F, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JNO,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x71, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JNP,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x7B, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JNS,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x79, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JNZ,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x75, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JO,      OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x70, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JP,      OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x7A, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JPE,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x7A, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JPO,     OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x7B, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JS,      OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x78, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+  { TOK_JZ,      OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0x74, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  16,   4 }, {   9,   3 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_LAHF,    OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x9F, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   4,   0 }, {   2,   0 } },
+
+  { TOK_LAR,     OF_REG16, OF_RM,    OF_NONE,  2, NOPR, 0x0F, 0x02, 0,  RRM, 0,  0,  0,  0, P286P, {   0,   0 }, {  14,  16 } },
+
+  // Optimize LEA r16, [addr] to MOV r16, OFFSET addr
+  { TOK_LEA,     OF_REG16, OF_INDIR, OF_NONE,  1, NOPR, 0xB8, 0x00, 1,  RMN, 0,  0,  0,  0, P86,   {   4,   0 }, {   2,   0 } },
+  { TOK_LEA,     OF_REG16, OF_MEM,   OF_NONE,  1, NOPR, 0x8D, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   0,   2 }, {   0,   3 } },
+
+  { TOK_LEAVE,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xC9, 0x00, 0,  RMN, 0,  0,  0,  0, P286N, {   0,   0 }, {   5,   0 } },
+
+  { TOK_LGDT,    OF_MEM48, OF_NONE,  OF_NONE,  2, NOPR, 0x0F, 0x01, 0,  RMC, 2,  0,  0,  0, P286P, {   0,   0 }, {   0,  11 } },
+  { TOK_LIDT,    OF_MEM48, OF_NONE,  OF_NONE,  2, NOPR, 0x0F, 0x01, 0,  RMC, 3,  0,  0,  0, P286P, {   0,   0 }, {   0,  12 } },
+  { TOK_LLDT,    OF_RM16,  OF_NONE,  OF_NONE,  2, NOPR, 0x0F, 0x00, 0,  RMC, 2,  0,  0,  0, P286P, {   0,   0 }, {  17,  19 } },
+  { TOK_LMSW,    OF_RM16,  OF_NONE,  OF_NONE,  2, NOPR, 0x0F, 0x01, 0,  RMC, 6,  0,  0,  0, P286P, {   0,   0 }, {   3,   6 } },
+  { TOK_LSL,     OF_REG16, OF_RM,    OF_NONE,  2, NOPR, 0x0F, 0x03, 0,  RRM, 0,  0,  0,  0, P286P, {   0,   0 }, {  14,  16 } },
+  { TOK_LTR,     OF_RM16,  OF_NONE,  OF_NONE,  2, NOPR, 0x0F, 0x00, 0,  RMC, 3,  0,  0,  0, P286P, {   0,   0 }, {  17,  19 } },
+
+  { TOK_LOCK,    OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xF0, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   2,   0 }, {   0,   0 } },
+
+  { TOK_LODSB,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xAC, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  12,   0 }, {   5,   0 } },
+  { TOK_LODSW,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xAD, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  12,   0 }, {   5,   0 } },
+  { TOK_LODS,    OF_SI8,   OF_NONE,  OF_NONE,  1, NOPR, 0xAC, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  12,   0 }, {   5,   0 } },
+  { TOK_LODS,    OF_SI16,  OF_NONE,  OF_NONE,  1, NOPR, 0xAD, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  12,   0 }, {   5,   0 } },
+
+  { TOK_LOOP,    OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0xE2, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  17,   5 }, {  10,   4 } },
+  { TOK_LOOPE,   OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0xE1, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  18,   6 }, {  10,   4 } },
+  { TOK_LOOPZ,   OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0xE1, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  18,   6 }, {  10,   4 } },
+  { TOK_LOOPNE,  OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0xE0, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  19,   5 }, {  10,   4 } },
+  { TOK_LOOPNZ,  OF_JUMP,  OF_NONE,  OF_NONE,  1, NOPR, 0xE0, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  19,   5 }, {  10,   4 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_MOV,     OF_AL,    OF_INDIR, OF_NONE,  1, NOPR, 0xA0, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  10,   0 }, {   5,   0 } },
+  { TOK_MOV,     OF_AX,    OF_INDIR, OF_NONE,  1, NOPR, 0xA1, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  10,   0 }, {   5,   0 } },
+  { TOK_MOV,     OF_INDIR, OF_AL,    OF_NONE,  1, NOPR, 0xA2, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  10,   0 }, {   3,   0 } },
+  { TOK_MOV,     OF_INDIR, OF_AX,    OF_NONE,  1, NOPR, 0xA3, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  10,   0 }, {   3,   0 } },
+  { TOK_MOV,     OF_REG8,  OF_IMM,   OF_NONE,  1, NOPR, 0xB0, 0x00, 1,  RMN, 0,  0,  1,  0, P86,   {   4,   0 }, {   2,   0 } },
+  { TOK_MOV,     OF_REG16, OF_IMM,   OF_NONE,  1, NOPR, 0xB8, 0x00, 1,  RMN, 0,  0,  2,  0, P86,   {   4,   0 }, {   2,   0 } },
+  { TOK_MOV,     OF_REG8,  OF_RM,    OF_NONE,  1, NOPR, 0x8A, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   2,   8 }, {   2,   5 } },
+  { TOK_MOV,     OF_RM,    OF_REG8,  OF_NONE,  1, NOPR, 0x88, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   2,   9 }, {   2,   3 } },
+  { TOK_MOV,     OF_REG16, OF_RM,    OF_NONE,  1, NOPR, 0x8B, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   2,   8 }, {   2,   5 } },
+  { TOK_MOV,     OF_RM,    OF_REG16, OF_NONE,  1, NOPR, 0x89, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   2,   9 }, {   2,   3 } },
+  { TOK_MOV,     OF_RM,    OF_SREG,  OF_NONE,  1, NOPR, 0x8C, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   2,   9 }, {   2,   3 } },
+  { TOK_MOV,     OF_SREG,  OF_RM,    OF_NONE,  1, NOPR, 0x8E, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   2,   8 }, {   2,   5 } },
+  { TOK_MOV,     OF_RM8,   OF_IMM,   OF_NONE,  1, NOPR, 0xC6, 0x00, 0,  RMC, 0,  0,  1,  0, P86,   {   4,  10 }, {   2,   3 } },
+  { TOK_MOV,     OF_RM16,  OF_IMM,   OF_NONE,  1, NOPR, 0xC7, 0x00, 0,  RMC, 0,  0,  2,  0, P86,   {   4,  10 }, {   2,   3 } },
+
+  { TOK_MOVSB,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xA4, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  18,   0 }, {   5,   0 } },
+  { TOK_MOVSW,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xA5, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  18,   0 }, {   5,   0 } },
+  { TOK_MOVS,    OF_DI8,   OF_SI,    OF_NONE,  1, NOPR, 0xA4, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  18,   0 }, {   5,   0 } },
+  { TOK_MOVS,    OF_DI,    OF_SI8,   OF_NONE,  1, NOPR, 0xA4, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  18,   0 }, {   5,   0 } },
+  { TOK_MOVS,    OF_DI16,  OF_SI,    OF_NONE,  1, NOPR, 0xA5, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  18,   0 }, {   5,   0 } },
+  { TOK_MOVS,    OF_DI,    OF_SI16,  OF_NONE,  1, NOPR, 0xA5, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  18,   0 }, {   5,   0 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_MUL,     OF_RM8,   OF_NONE,  OF_NONE,  1, NOPR, 0xF6, 0x00, 0,  RMC, 4,  0,  0,  0, P86,   {  74,  80 }, {  13,  16 } },
+  { TOK_MUL,     OF_RM16,  OF_NONE,  OF_NONE,  1, NOPR, 0xF7, 0x00, 0,  RMC, 4,  0,  0,  0, P86,   { 126, 132 }, {  21,  24 } },
+
+  { TOK_NEG,     OF_RM8,   OF_NONE,  OF_NONE,  1, NOPR, 0xF6, 0x00, 0,  RMC, 3,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+  { TOK_NEG,     OF_RM16,  OF_NONE,  OF_NONE,  1, NOPR, 0xF7, 0x00, 0,  RMC, 3,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+
+  { TOK_NOP,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x90, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   3,   0 }, {   3,   0 } },
+
+  { TOK_NOT,     OF_RM8,   OF_NONE,  OF_NONE,  1, NOPR, 0xF6, 0x00, 0,  RMC, 2,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+  { TOK_NOT,     OF_RM16,  OF_NONE,  OF_NONE,  1, NOPR, 0xF7, 0x00, 0,  RMC, 2,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+
+  { TOK_OR,      OF_AL,    OF_IMM,   OF_NONE,  1, NOPR, 0x0C, 0x00, 0,  RMN, 0,  0,  1,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_OR,      OF_AX,    OF_IMM,   OF_NONE,  1, NOPR, 0x0D, 0x00, 0,  RMN, 0,  0,  2,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_OR,      OF_RM8,   OF_IMM,   OF_NONE,  1, NOPR, 0x80, 0x00, 0,  RMC, 1,  0,  1,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_OR,      OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0x83, 0x00, 0,  RMC, 1,  0,  1,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_OR,      OF_RM16,  OF_IMM,   OF_NONE,  1, NOPR, 0x81, 0x00, 0,  RMC, 1,  0,  2,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_OR,      OF_REG8,  OF_RM,    OF_NONE,  1, NOPR, 0x0A, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   7 } },
+  { TOK_OR,      OF_RM,    OF_REG8,  OF_NONE,  1, NOPR, 0x08, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+  { TOK_OR,      OF_REG16, OF_RM,    OF_NONE,  1, NOPR, 0x0B, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   7 } },
+  { TOK_OR,      OF_RM,    OF_REG16, OF_NONE,  1, NOPR, 0x09, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_OUT,     OF_IMM,   OF_AL,    OF_NONE,  1, NOPR, 0xE6, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  10,   0 }, {   3,   0 } },
+  { TOK_OUT,     OF_IMM,   OF_AX,    OF_NONE,  1, NOPR, 0xE7, 0x00, 0,  RMN, 0,  1,  0,  0, P86,   {  10,   0 }, {   3,   0 } },
+  { TOK_OUT,     OF_DX,    OF_AL,    OF_NONE,  1, NOPR, 0xEE, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   8,   0 }, {   3,   0 } },
+  { TOK_OUT,     OF_DX,    OF_AX,    OF_NONE,  1, NOPR, 0xEF, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   8,   0 }, {   3,   0 } },
+
+  { TOK_OUTSB,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x6E, 0x00, 0,  RMN, 0,  0,  0,  0, P286N, {   0,   0 }, {   5,   0 } },
+  { TOK_OUTSW,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x6F, 0x00, 0,  RMN, 0,  0,  0,  0, P286N, {   0,   0 }, {   5,   0 } },
+  { TOK_OUTS,    OF_DX,    OF_SI8,   OF_NONE,  1, NOPR, 0x6E, 0x00, 0,  RMN, 0,  0,  0,  0, P286N, {   0,   0 }, {   5,   0 } },
+  { TOK_OUTS,    OF_DX,    OF_SI16,  OF_NONE,  1, NOPR, 0x6F, 0x00, 0,  RMN, 0,  0,  0,  0, P286N, {   0,   0 }, {   5,   0 } },
+
+  { TOK_POP,     OF_MEM16, OF_NONE,  OF_NONE,  1, NOPR, 0x8F, 0x00, 0,  RMC, 0,  0,  0,  0, P86,   {   0,  17 }, {   0,   5 } },
+  { TOK_POP,     OF_REG16, OF_NONE,  OF_NONE,  1, NOPR, 0x58, 0x00, 1,  RMN, 0,  0,  0,  0, P86,   {   8,   0 }, {   5,   0 } },
+  { TOK_POPA,    OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x61, 0x00, 0,  RMN, 0,  0,  0,  0, P286N, {   0,   0 }, {  19,   0 } },
+  { TOK_POPAW,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x61, 0x00, 0,  RMN, 0,  0,  0,  0, P286N, {   0,   0 }, {  19,   0 } },
+  { TOK_POPF,    OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x9D, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   8,   0 }, {   5,   0 } },
+  { TOK_POPFW,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x9D, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   8,   0 }, {   5,   0 } },
+  { TOK_POP,     OF_ES,    OF_NONE,  OF_NONE,  1, NOPR, 0x07, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   8,   0 }, {   5,   0 } },
+  { TOK_POP,     OF_SS,    OF_NONE,  OF_NONE,  1, NOPR, 0x17, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   8,   0 }, {   5,   0 } },
+  { TOK_POP,     OF_DS,    OF_NONE,  OF_NONE,  1, NOPR, 0x1F, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   8,   0 }, {   5,   0 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_PUSH,    OF_MEM16, OF_NONE,  OF_NONE,  1, NOPR, 0xFF, 0x00, 0,  RMC, 6,  0,  0,  0, P86,   {   0,  16 }, {   0,   5 } },
+  { TOK_PUSH,    OF_REG16, OF_NONE,  OF_NONE,  1, NOPR, 0x50, 0x00, 1,  RMN, 0,  0,  0,  0, P86,   {  11,   0 }, {   3,   0 } },
+  { TOK_PUSH,    OF_IMM8,  OF_NONE,  OF_NONE,  1, NOPR, 0x6A, 0x00, 0,  RMN, 0,  1,  0,  0, P286N, {   0,   0 }, {   3,   0 } },
+  { TOK_PUSH,    OF_IMM,   OF_NONE,  OF_NONE,  1, NOPR, 0x68, 0x00, 0,  RMN, 0,  2,  0,  0, P286N, {   0,   0 }, {   3,   0 } },
+  { TOK_PUSHA,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x60, 0x00, 0,  RMN, 0,  0,  0,  0, P286N, {   0,   0 }, {  17,   0 } },
+  { TOK_PUSHAW,  OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x60, 0x00, 0,  RMN, 0,  0,  0,  0, P286N, {   0,   0 }, {  17,   0 } },
+  { TOK_PUSHF,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x9C, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  10,   0 }, {   3,   0 } },
+  { TOK_PUSHFW,  OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x9C, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  10,   0 }, {   3,   0 } },
+  { TOK_PUSH,    OF_ES,    OF_NONE,  OF_NONE,  1, NOPR, 0x06, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  10,   0 }, {   3,   0 } },
+  { TOK_PUSH,    OF_CS,    OF_NONE,  OF_NONE,  1, NOPR, 0x0E, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  10,   0 }, {   3,   0 } },
+  { TOK_PUSH,    OF_SS,    OF_NONE,  OF_NONE,  1, NOPR, 0x16, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  10,   0 }, {   3,   0 } },
+  { TOK_PUSH,    OF_DS,    OF_NONE,  OF_NONE,  1, NOPR, 0x1E, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  10,   0 }, {   3,   0 } },
+
+  { TOK_RCL,     OF_RM8,   OF_1,     OF_NONE,  1, NOPR, 0xD0, 0x00, 0,  RMC, 2,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_RCL,     OF_RM8,   OF_CL,    OF_NONE,  1, NOPR, 0xD2, 0x00, 0,  RMC, 2,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_RCL,     OF_RM16,  OF_1,     OF_NONE,  1, NOPR, 0xD1, 0x00, 0,  RMC, 2,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_RCL,     OF_RM16,  OF_CL,    OF_NONE,  1, NOPR, 0xD3, 0x00, 0,  RMC, 2,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_RCL,     OF_RM8,   OF_IMM8,  OF_NONE,  1, NOPR, 0xC0, 0x00, 0,  RMC, 2,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+  { TOK_RCL,     OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0xC1, 0x00, 0,  RMC, 2,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_RCR,     OF_RM8,   OF_1,     OF_NONE,  1, NOPR, 0xD0, 0x00, 0,  RMC, 3,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_RCR,     OF_RM8,   OF_CL,    OF_NONE,  1, NOPR, 0xD2, 0x00, 0,  RMC, 3,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_RCR,     OF_RM16,  OF_1,     OF_NONE,  1, NOPR, 0xD1, 0x00, 0,  RMC, 3,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_RCR,     OF_RM16,  OF_CL,    OF_NONE,  1, NOPR, 0xD3, 0x00, 0,  RMC, 3,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_RCR,     OF_RM8,   OF_IMM8,  OF_NONE,  1, NOPR, 0xC0, 0x00, 0,  RMC, 3,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+  { TOK_RCR,     OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0xC1, 0x00, 0,  RMC, 3,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+
+  { TOK_RET,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xC3, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  20,   0 }, {  13,   0 } },
+  { TOK_RET,     OF_IMM,   OF_NONE,  OF_NONE,  1, NOPR, 0xC2, 0x00, 0,  RMN, 0,  2,  0,  0, P86,   {  24,   0 }, {  13,   0 } },
+  { TOK_RETN,    OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xC3, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  20,   0 }, {  13,   0 } },
+  { TOK_RETN,    OF_IMM,   OF_NONE,  OF_NONE,  1, NOPR, 0xC2, 0x00, 0,  RMN, 0,  2,  0,  0, P86,   {  24,   0 }, {  13,   0 } },
+  { TOK_RETF,    OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xCB, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  32,   0 }, {  17,   0 } },
+  { TOK_RETF,    OF_IMM,   OF_NONE,  OF_NONE,  1, NOPR, 0xCA, 0x00, 0,  RMN, 0,  2,  0,  0, P86,   {  31,   0 }, {  17,   0 } },
+
+  { TOK_ROL,     OF_RM8,   OF_1,     OF_NONE,  1, NOPR, 0xD0, 0x00, 0,  RMC, 0,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_ROL,     OF_RM8,   OF_CL,    OF_NONE,  1, NOPR, 0xD2, 0x00, 0,  RMC, 0,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_ROL,     OF_RM16,  OF_1,     OF_NONE,  1, NOPR, 0xD1, 0x00, 0,  RMC, 0,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_ROL,     OF_RM16,  OF_CL,    OF_NONE,  1, NOPR, 0xD3, 0x00, 0,  RMC, 0,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_ROL,     OF_RM8,   OF_IMM8,  OF_NONE,  1, NOPR, 0xC0, 0x00, 0,  RMC, 0,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+  { TOK_ROL,     OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0xC1, 0x00, 0,  RMC, 0,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+
+  { TOK_ROR,     OF_RM8,   OF_1,     OF_NONE,  1, NOPR, 0xD0, 0x00, 0,  RMC, 1,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_ROR,     OF_RM8,   OF_CL,    OF_NONE,  1, NOPR, 0xD2, 0x00, 0,  RMC, 1,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_ROR,     OF_RM16,  OF_1,     OF_NONE,  1, NOPR, 0xD1, 0x00, 0,  RMC, 1,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_ROR,     OF_RM16,  OF_CL,    OF_NONE,  1, NOPR, 0xD3, 0x00, 0,  RMC, 1,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_ROR,     OF_RM8,   OF_IMM8,  OF_NONE,  1, NOPR, 0xC0, 0x00, 0,  RMC, 1,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+  { TOK_ROR,     OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0xC1, 0x00, 0,  RMC, 1,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_SAHF,    OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x9E, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   4,   0 }, {   2,   0 } },
+
+  { TOK_SAL,     OF_RM8,   OF_1,     OF_NONE,  1, NOPR, 0xD0, 0x00, 0,  RMC, 4,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_SAL,     OF_RM8,   OF_CL,    OF_NONE,  1, NOPR, 0xD2, 0x00, 0,  RMC, 4,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_SAL,     OF_RM16,  OF_1,     OF_NONE,  1, NOPR, 0xD1, 0x00, 0,  RMC, 4,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_SAL,     OF_RM16,  OF_CL,    OF_NONE,  1, NOPR, 0xD3, 0x00, 0,  RMC, 4,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_SAL,     OF_RM8,   OF_IMM8,  OF_NONE,  1, NOPR, 0xC0, 0x00, 0,  RMC, 4,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+  { TOK_SAL,     OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0xC1, 0x00, 0,  RMC, 4,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+
+  { TOK_SAR,     OF_RM8,   OF_1,     OF_NONE,  1, NOPR, 0xD0, 0x00, 0,  RMC, 7,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_SAR,     OF_RM8,   OF_CL,    OF_NONE,  1, NOPR, 0xD2, 0x00, 0,  RMC, 7,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_SAR,     OF_RM16,  OF_1,     OF_NONE,  1, NOPR, 0xD1, 0x00, 0,  RMC, 7,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_SAR,     OF_RM16,  OF_CL,    OF_NONE,  1, NOPR, 0xD3, 0x00, 0,  RMC, 7,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_SAR,     OF_RM8,   OF_IMM8,  OF_NONE,  1, NOPR, 0xC0, 0x00, 0,  RMC, 7,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+  { TOK_SAR,     OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0xC1, 0x00, 0,  RMC, 7,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+
+  { TOK_SBB,     OF_AL,    OF_IMM,   OF_NONE,  1, NOPR, 0x1C, 0x00, 0,  RMN, 0,  0,  1,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_SBB,     OF_AX,    OF_IMM,   OF_NONE,  1, NOPR, 0x1D, 0x00, 0,  RMN, 0,  0,  2,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_SBB,     OF_RM8,   OF_IMM,   OF_NONE,  1, NOPR, 0x80, 0x00, 0,  RMC, 3,  0,  1,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_SBB,     OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0x83, 0x00, 0,  RMC, 3,  0,  1,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_SBB,     OF_RM16,  OF_IMM,   OF_NONE,  1, NOPR, 0x81, 0x00, 0,  RMC, 3,  0,  2,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_SBB,     OF_REG8,  OF_RM,    OF_NONE,  1, NOPR, 0x1A, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   7 } },
+  { TOK_SBB,     OF_RM,    OF_REG8,  OF_NONE,  1, NOPR, 0x18, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+  { TOK_SBB,     OF_REG16, OF_RM,    OF_NONE,  1, NOPR, 0x1B, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   7 } },
+  { TOK_SBB,     OF_RM,    OF_REG16, OF_NONE,  1, NOPR, 0x19, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_SCASB,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xAE, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  15,   0 }, {   7,   0 } },
+  { TOK_SCASW,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xAF, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  15,   0 }, {   7,   0 } },
+  { TOK_SCAS,    OF_DI8,   OF_NONE,  OF_NONE,  1, NOPR, 0xAE, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  15,   0 }, {   7,   0 } },
+  { TOK_SCAS,    OF_DI16,  OF_NONE,  OF_NONE,  1, NOPR, 0xAF, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  15,   0 }, {   7,   0 } },
+
+  { TOK_SHL,     OF_RM8,   OF_1,     OF_NONE,  1, NOPR, 0xD0, 0x00, 0,  RMC, 4,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_SHL,     OF_RM8,   OF_CL,    OF_NONE,  1, NOPR, 0xD2, 0x00, 0,  RMC, 4,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_SHL,     OF_RM16,  OF_1,     OF_NONE,  1, NOPR, 0xD1, 0x00, 0,  RMC, 4,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_SHL,     OF_RM16,  OF_CL,    OF_NONE,  1, NOPR, 0xD3, 0x00, 0,  RMC, 4,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_SHL,     OF_RM8,   OF_IMM8,  OF_NONE,  1, NOPR, 0xC0, 0x00, 0,  RMC, 4,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+  { TOK_SHL,     OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0xC1, 0x00, 0,  RMC, 4,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+
+  { TOK_SGDT,    OF_MEM48, OF_NONE,  OF_NONE,  2, NOPR, 0x0F, 0x01, 0,  RMC, 0,  0,  0,  0, P286P, {   0,   0 }, {   0,  11 } },
+  { TOK_SIDT,    OF_MEM48, OF_NONE,  OF_NONE,  2, NOPR, 0x0F, 0x01, 0,  RMC, 1,  0,  0,  0, P286P, {   0,   0 }, {   0,  12 } },
+  { TOK_SLDT,    OF_RM16,  OF_NONE,  OF_NONE,  2, NOPR, 0x0F, 0x00, 0,  RMC, 0,  0,  0,  0, P286P, {   0,   0 }, {   2,   3 } },
+  { TOK_SMSW,    OF_RM16,  OF_NONE,  OF_NONE,  2, NOPR, 0x0F, 0x01, 0,  RMC, 4,  0,  0,  0, P286P, {   0,   0 }, {   2,   3 } },
+  { TOK_STR,     OF_RM16,  OF_NONE,  OF_NONE,  2, NOPR, 0x0F, 0x00, 0,  RMC, 1,  0,  0,  0, P286P, {   0,   0 }, {   2,   3 } },
+
+  { TOK_SHR,     OF_RM8,   OF_1,     OF_NONE,  1, NOPR, 0xD0, 0x00, 0,  RMC, 5,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_SHR,     OF_RM8,   OF_CL,    OF_NONE,  1, NOPR, 0xD2, 0x00, 0,  RMC, 5,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_SHR,     OF_RM16,  OF_1,     OF_NONE,  1, NOPR, 0xD1, 0x00, 0,  RMC, 5,  0,  0,  0, P86,   {   2,  15 }, {   2,   7 } },
+  { TOK_SHR,     OF_RM16,  OF_CL,    OF_NONE,  1, NOPR, 0xD3, 0x00, 0,  RMC, 5,  0,  0,  0, P86,   {  12,  24 }, {   6,   9 } },
+  { TOK_SHR,     OF_RM8,   OF_IMM8,  OF_NONE,  1, NOPR, 0xC0, 0x00, 0,  RMC, 5,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+  { TOK_SHR,     OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0xC1, 0x00, 0,  RMC, 5,  0,  1,  0, P286N, {   0,   0 }, {   6,   9 } },
+
+  { TOK_STC,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xF9, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   2,   0 }, {   2,   0 } },
+  { TOK_STD,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xFD, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   2,   0 }, {   2,   0 } },
+  { TOK_STI,     OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xFB, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   2,   0 }, {   2,   0 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_STOSB,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xAA, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  11,   0 }, {   3,   0 } },
+  { TOK_STOSW,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xAB, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  11,   0 }, {   3,   0 } },
+  { TOK_STOS,    OF_DI8,   OF_NONE,  OF_NONE,  1, NOPR, 0xAA, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  11,   0 }, {   3,   0 } },
+  { TOK_STOS,    OF_DI16,  OF_NONE,  OF_NONE,  1, NOPR, 0xAB, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  11,   0 }, {   3,   0 } },
+
+  { TOK_SUB,     OF_AL,    OF_IMM,   OF_NONE,  1, NOPR, 0x2C, 0x00, 0,  RMN, 0,  0,  1,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_SUB,     OF_AX,    OF_IMM,   OF_NONE,  1, NOPR, 0x2D, 0x00, 0,  RMN, 0,  0,  2,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_SUB,     OF_RM8,   OF_IMM,   OF_NONE,  1, NOPR, 0x80, 0x00, 0,  RMC, 5,  0,  1,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_SUB,     OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0x83, 0x00, 0,  RMC, 5,  0,  1,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_SUB,     OF_RM16,  OF_IMM,   OF_NONE,  1, NOPR, 0x81, 0x00, 0,  RMC, 5,  0,  2,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_SUB,     OF_REG8,  OF_RM,    OF_NONE,  1, NOPR, 0x2A, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   7 } },
+  { TOK_SUB,     OF_RM,    OF_REG8,  OF_NONE,  1, NOPR, 0x28, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+  { TOK_SUB,     OF_REG16, OF_RM,    OF_NONE,  1, NOPR, 0x2B, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   7 } },
+  { TOK_SUB,     OF_RM,    OF_REG16, OF_NONE,  1, NOPR, 0x29, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+
+  { TOK_TEST,    OF_AL,    OF_IMM,   OF_NONE,  1, NOPR, 0xA8, 0x00, 0,  RMN, 0,  0,  1,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_TEST,    OF_AX,    OF_IMM,   OF_NONE,  1, NOPR, 0xA9, 0x00, 0,  RMN, 0,  0,  2,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_TEST,    OF_RM8,   OF_IMM,   OF_NONE,  1, NOPR, 0xF6, 0x00, 0,  RMC, 0,  0,  1,  0, P86,   {   5,  11 }, {   3,   6 } },
+  { TOK_TEST,    OF_RM16,  OF_IMM,   OF_NONE,  1, NOPR, 0xF7, 0x00, 0,  RMC, 0,  0,  2,  0, P86,   {   5,  11 }, {   3,   6 } },
+  { TOK_TEST,    OF_REG8,  OF_RM,    OF_NONE,  1, NOPR, 0x84, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   6 } },
+  { TOK_TEST,    OF_REG16, OF_RM,    OF_NONE,  1, NOPR, 0x85, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   6 } },
+  { TOK_TEST,    OF_RM,    OF_REG8,  OF_NONE,  1, NOPR, 0x84, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   6 } },
+  { TOK_TEST,    OF_RM,    OF_REG16, OF_NONE,  1, NOPR, 0x85, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   6 } },
+
+  { TOK_VERR,    OF_RM16,  OF_NONE,  OF_NONE,  2, NOPR, 0x0F, 0x00, 0,  RMC, 4,  0,  0,  0, P286P, {   0,   0 }, {  14,  16 } },
+  { TOK_VERW,    OF_RM16,  OF_NONE,  OF_NONE,  2, NOPR, 0x0F, 0x00, 0,  RMC, 5,  0,  0,  0, P286P, {   0,   0 }, {  14,  16 } },
+
+//  instruc      oper1     oper2     oper3     opcodes             +opc R/M reg im1 im2 im3 cpu     8086 r, m  286 r, m
+  { TOK_WAIT,    OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0x9B, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {   3,   0 }, {   3,   0 } },
+  { TOK_XLATB,   OF_NONE,  OF_NONE,  OF_NONE,  1, NOPR, 0xD7, 0x00, 0,  RMN, 0,  0,  0,  0, P86,   {  11,   0 }, {   5,   0 } },
+
+  { TOK_XCHG,    OF_AX,    OF_REG16, OF_NONE,  1, NOPR, 0x90, 0x00, 2,  RMN, 0,  0,  0,  0, P86,   {   3,   0 }, {   3,   0 } },
+  { TOK_XCHG,    OF_REG16, OF_AX,    OF_NONE,  1, NOPR, 0x90, 0x00, 1,  RMN, 0,  0,  0,  0, P86,   {   3,   0 }, {   3,   0 } },
+  { TOK_XCHG,    OF_REG8,  OF_RM,    OF_NONE,  1, NOPR, 0x86, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   4,  17 }, {   3,   5 } },
+  { TOK_XCHG,    OF_RM,    OF_REG8,  OF_NONE,  1, NOPR, 0x86, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   4,  17 }, {   3,   5 } },
+  { TOK_XCHG,    OF_REG16, OF_RM,    OF_NONE,  1, NOPR, 0x87, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   4,  17 }, {   3,   5 } },
+  { TOK_XCHG,    OF_RM,    OF_REG16, OF_NONE,  1, NOPR, 0x87, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   4,  17 }, {   3,   5 } },
+
+  { TOK_XOR,     OF_AL,    OF_IMM,   OF_NONE,  1, NOPR, 0x34, 0x00, 0,  RMN, 0,  0,  1,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_XOR,     OF_AX,    OF_IMM,   OF_NONE,  1, NOPR, 0x35, 0x00, 0,  RMN, 0,  0,  2,  0, P86,   {   4,   0 }, {   3,   0 } },
+  { TOK_XOR,     OF_RM8,   OF_IMM,   OF_NONE,  1, NOPR, 0x80, 0x00, 0,  RMC, 6,  0,  1,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_XOR,     OF_RM16,  OF_IMM8,  OF_NONE,  1, NOPR, 0x83, 0x00, 0,  RMC, 6,  0,  1,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_XOR,     OF_RM16,  OF_IMM,   OF_NONE,  1, NOPR, 0x81, 0x00, 0,  RMC, 6,  0,  2,  0, P86,   {   4,  17 }, {   3,   7 } },
+  { TOK_XOR,     OF_REG8,  OF_RM,    OF_NONE,  1, NOPR, 0x32, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   7 } },
+  { TOK_XOR,     OF_RM,    OF_REG8,  OF_NONE,  1, NOPR, 0x30, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+  { TOK_XOR,     OF_REG16, OF_RM,    OF_NONE,  1, NOPR, 0x33, 0x00, 0,  RRM, 0,  0,  0,  0, P86,   {   3,   9 }, {   2,   7 } },
+  { TOK_XOR,     OF_RM,    OF_REG16, OF_NONE,  1, NOPR, 0x31, 0x00, 0,  RMR, 0,  0,  0,  0, P86,   {   3,  16 }, {   2,   7 } },
+
+// end marker
+  { TOK_NONE }
+};
@@ -62,6 +62,12 @@ typedef struct {
   char imm2;        // number of immediate bytes in second operand
   char imm3;        // number of immediate bytes in third operand
   char cpu;         // processor (ISA)
+  // Typical clocks on the 8086 (with 8087) and the 80286 (with 80287), excluding
+  // prefixes and effective address calculation: see cycles.h.
+  // [0] register or no operand, or a conditional transfer taken;
+  // [1] memory operand, or a conditional transfer not taken.
+  short cycles86[2];
+  short cycles286[2];
 } INSDEF;
 
 extern const INSDEF instable[];
@@ -76,7 +82,15 @@ BOOL opcode_lea(int opcode);
 const INSDEF* first_instruc(void);
 const INSDEF* next_instruc(const INSDEF*);
 
+// Flat indexing of table entries, e.g. for per-form counters.
+unsigned instable_entries(void);
+const INSDEF* instable_entry(unsigned);
+int instable_index(const INSDEF*);
+
 const INSDEF* find_instruc(int operation, const OPERAND_CLASS* operand1, const OPERAND_CLASS* operand2, const OPERAND_CLASS* operand3);
+// The next entry after def for the same operation that the operands match,
+// in table order; NULL if none.
+const INSDEF* find_next_instruc(const INSDEF* def, const OPERAND_CLASS* operand1, const OPERAND_CLASS* operand2, const OPERAND_CLASS* operand3);
 
 void print_insdef(const INSDEF*);
 
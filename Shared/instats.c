@@ -0,0 +1,317 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Decoded instruction statistics.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "instats.h"
+#include "instable.h"
+#include "opclass.h"
+#include "token.h"
+
+#define SPECIAL_FORMS (sizeof ((INSTATS*)0)->special / sizeof ((INSTATS*)0)->special[0])
+
+INSTATS* new_instats(void) {
+  INSTATS* st = ecalloc(sizeof *st);
+  st->forms = instable_entries() + SPECIAL_FORMS;
+  st->form_count = ecalloc(st->forms * sizeof st->form_count[0]);
+  st->form_bytes = ecalloc(st->forms * sizeof st->form_bytes[0]);
+  return st;
+}
+
+void delete_instats(INSTATS* st) {
+  if (st) {
+    efree(st->form_count);
+    efree(st->form_bytes);
+    efree(st);
+  }
+}
+
+static unsigned form_index(INSTATS* st, const INSDEF* def) {
+  int i = instable_index(def);
+  if (i >= 0)
+    return i;
+
+  // the SHORT and NEAR JMP encodings are defined by the decoder
+  assert(def->op == TOK_JMP);
+  unsigned special = (def->opcode1 == NEAR_JMP);
+  st->special[special] = def;
+  return instable_entries() + special;
+}
+
+static int addressing_mode(const DECODED* dec) {
+  if (dec->def->modrm == RMN)
+    return MODE_NONE;
+
+  const RM_OPERAND* rm = NULL;
+  if (dec->oper1.type == OT_MEM)
+    rm = &dec->oper1;
+  else if (dec->oper2.type == OT_MEM)
+    rm = &dec->oper2;
+  if (rm == NULL)
+    return MODE_REG;
+
+  const struct dis_mem * m = &rm->val.mem;
+  if (m->base_reg == NO_REG && m->index_reg == NO_REG)
+    return MODE_DIRECT;
+  switch (m->disp_size) {
+    case 0: return MODE_INDIR;
+    case 1: return MODE_DISP8;
+  }
+  return MODE_DISP16;
+}
+
+void count_instruction(INSTATS* st, const DECODED* dec) {
+  assert(st != NULL);
+  assert(dec != NULL && dec->def != NULL && dec->len > 0);
+
+  unsigned form = form_index(st, dec->def);
+  assert(form < st->forms);
+
+  st->instructions++;
+  st->bytes += dec->len;
+  st->form_count[form]++;
+  st->form_bytes[form] += dec->len;
+  if (dec->rep)
+    st->prefix[dec->rep]++;
+  if (dec->sreg_override)
+    st->prefix[dec->sreg_override]++;
+  st->mode[addressing_mode(dec)]++;
+  st->length[dec->len < MAX_STATS_LENGTH ? dec->len : MAX_STATS_LENGTH]++;
+}
+
+void count_undecoded(INSTATS* st, unsigned bytes) {
+  assert(st != NULL);
+  st->undecoded += bytes;
+}
+
+// Reporting
+
+typedef struct {
+  unsigned key;
+  unsigned long count;
+  unsigned long bytes;
+} ROW;
+
+// by bytes, then count, descending; then key ascending
+static int compare_rows(const void* p, const void* q) {
+  const ROW* r = p;
+  const ROW* s = q;
+
+  if (r->bytes != s->bytes)
+    return r->bytes < s->bytes ? 1 : -1;
+  if (r->count != s->count)
+    return r->count < s->count ? 1 : -1;
+  return (r->key > s->key) - (r->key < s->key);
+}
+
+static const INSDEF* form_def(const INSTATS* st, unsigned form) {
+  unsigned entries = instable_entries();
+  return (form < entries) ? instable_entry(form) : st->special[form - entries];
+}
+
+static const char* flag_name(int flag) {
+  const char* name = operand_flag_name(flag);
+  return strncmp(name, "OF_", 3) == 0 ? name + 3 : name;
+}
+
+static void form_name(char* buf, const INSDEF* def) {
+  char* p = buf + sprintf(buf, "%s", token_name(def->op));
+  if (def->oper1 != OF_NONE)
+    p += sprintf(p, " %s", flag_name(def->oper1));
+  if (def->oper2 != OF_NONE)
+    p += sprintf(p, ",%s", flag_name(def->oper2));
+  if (def->oper3 != OF_NONE)
+    p += sprintf(p, ",%s", flag_name(def->oper3));
+  p += sprintf(p, " [%02X", def->opcode1);
+  if (def->opcodes == 2)
+    p += sprintf(p, " %02X", def->opcode2);
+  if (def->modrm == RMC)
+    p += sprintf(p, " /%d", def->reg);
+  strcpy(p, "]");
+}
+
+static const char* prefix_name(unsigned byte) {
+  switch (byte) {
+    case 0xF2: return "REPNE";
+    case 0xF3: return "REP/REPE";
+    case 0x26: return "ES:";
+    case 0x2E: return "CS:";
+    case 0x36: return "SS:";
+    case 0x3E: return "DS:";
+  }
+  return "?";
+}
+
+static const char* const mode_names[MODES] = {
+  "none", "reg", "[disp16]", "[base/index]", "[base/index+disp8]", "[base/index+disp16]"
+};
+
+static void print_row(bool csv, const char* section, const char* item, unsigned long count, unsigned long bytes) {
+  if (csv)
+    printf("%s,\"%s\",%lu,%lu\n", section, item, count, bytes);
+  else
+    printf("  %-32s %10lu %10lu\n", item, count, bytes);
+}
+
+static void print_heading(bool csv, const char* heading) {
+  if (!csv)
+    printf("\n%-34s %10s %10s\n", heading, "COUNT", "BYTES");
+}
+
+static void print_mnemonics(const INSTATS*, bool csv);
+static void print_forms(const INSTATS*, bool csv);
+
+void print_instats(const INSTATS* st, bool csv) {
+  assert(st != NULL);
+
+  if (csv) {
+    puts("section,item,count,bytes");
+    print_row(csv, "total", "instructions", st->instructions, st->bytes);
+    print_row(csv, "total", "undecoded", 0, st->undecoded);
+  }
+  else {
+    printf("Instructions:    %lu\n", st->instructions);
+    printf("Bytes:           %lu\n", st->bytes);
+    if (st->instructions)
+      printf("Average length:  %.2f\n", (double) st->bytes / st->instructions);
+    printf("Undecoded bytes: %lu\n", st->undecoded);
+  }
+
+  print_mnemonics(st, csv);
+  print_forms(st, csv);
+
+  print_heading(csv, "PREFIX");
+  for (unsigned i = 0; i < 0x100; i++) {
+    if (st->prefix[i])
+      print_row(csv, "prefix", prefix_name(i), st->prefix[i], st->prefix[i]);
+  }
+
+  print_heading(csv, "MODR/M MODE");
+  for (unsigned i = 0; i < MODES; i++) {
+    if (st->mode[i])
+      print_row(csv, "mode", mode_names[i], st->mode[i], 0);
+  }
+
+  print_heading(csv, "LENGTH");
+  for (unsigned i = 1; i <= MAX_STATS_LENGTH; i++) {
+    if (st->length[i]) {
+      char item[8];
+      sprintf(item, "%u", i);
+      print_row(csv, "length", item, st->length[i], st->length[i] * i);
+    }
+  }
+}
+
+static void print_mnemonics(const INSTATS* st, bool csv) {
+  ROW rows[LAST_OPCODE_TOKEN - FIRST_OPCODE_TOKEN + 1];
+  const unsigned nrow = sizeof rows / sizeof rows[0];
+
+  for (unsigned i = 0; i < nrow; i++) {
+    rows[i].key = FIRST_OPCODE_TOKEN + i;
+    rows[i].count = 0;
+    rows[i].bytes = 0;
+  }
+  for (unsigned form = 0; form < st->forms; form++) {
+    if (st->form_count[form]) {
+      const INSDEF* def = form_def(st, form);
+      assert(def->op >= FIRST_OPCODE_TOKEN && def->op <= LAST_OPCODE_TOKEN);
+      ROW* row = &rows[def->op - FIRST_OPCODE_TOKEN];
+      row->count += st->form_count[form];
+      row->bytes += st->form_bytes[form];
+    }
+  }
+  qsort(rows, nrow, sizeof rows[0], compare_rows);
+
+  print_heading(csv, "MNEMONIC");
+  for (unsigned i = 0; i < nrow && rows[i].count; i++)
+    print_row(csv, "mnemonic", token_name(rows[i].key), rows[i].count, rows[i].bytes);
+}
+
+static void print_forms(const INSTATS* st, bool csv) {
+  ROW* rows = emalloc(st->forms * sizeof rows[0]);
+  unsigned nrow = 0;
+
+  for (unsigned form = 0; form < st->forms; form++) {
+    if (st->form_count[form]) {
+      rows[nrow].key = form;
+      rows[nrow].count = st->form_count[form];
+      rows[nrow].bytes = st->form_bytes[form];
+      nrow++;
+    }
+  }
+  qsort(rows, nrow, sizeof rows[0], compare_rows);
+
+  print_heading(csv, "FORM");
+  for (unsigned i = 0; i < nrow; i++) {
+    char name[64];
+    form_name(name, form_def(st, rows[i].key));
+    print_row(csv, "form", name, rows[i].count, rows[i].bytes);
+  }
+
+  efree(rows);
+}
+
+#ifdef UNIT_TEST
+
+#include "CuTest.h"
+
+static void count_bytes(CuTest* tc, const DECODER* decoder, INSTATS* st, const BYTE* code, unsigned len) {
+  DECODED dec;
+  CuAssertIntEquals(tc, DECODE_ERR_NONE, decode_instruction(decoder, code, len, &dec));
+  CuAssertIntEquals(tc, len, dec.len);
+  count_instruction(st, &dec);
+}
+
+static void test_count_instruction(CuTest* tc) {
+  static const BYTE rep_movsb[] = { 0xF3, 0xA4 };
+  static const BYTE mov_bp_disp8[] = { 0x8B, 0x46, 0xFE };
+  static const BYTE mov_cs_bx[] = { 0x2E, 0x8B, 0x07 };
+  static const BYTE short_jmp[] = { 0xEB, 0x00 };
+  DECODER* decoder = build_decoder();
+  INSTATS* st = new_instats();
+
+  count_bytes(tc, decoder, st, rep_movsb, sizeof rep_movsb);
+  count_bytes(tc, decoder, st, mov_bp_disp8, sizeof mov_bp_disp8);
+  count_bytes(tc, decoder, st, mov_cs_bx, sizeof mov_cs_bx);
+  count_bytes(tc, decoder, st, short_jmp, sizeof short_jmp);
+  count_bytes(tc, decoder, st, short_jmp, sizeof short_jmp);
+  count_undecoded(st, 3);
+
+  CuAssertIntEquals(tc, 5, st->instructions);
+  CuAssertIntEquals(tc, 12, st->bytes);
+  CuAssertIntEquals(tc, 3, st->undecoded);
+  CuAssertIntEquals(tc, 1, st->prefix[0xF3]);
+  CuAssertIntEquals(tc, 1, st->prefix[0x2E]);
+  CuAssertIntEquals(tc, 3, st->mode[MODE_NONE]);
+  CuAssertIntEquals(tc, 1, st->mode[MODE_DISP8]);
+  CuAssertIntEquals(tc, 1, st->mode[MODE_INDIR]);
+  CuAssertIntEquals(tc, 3, st->length[2]);
+  CuAssertIntEquals(tc, 2, st->length[3]);
+
+  // both MOVs use the same form; the SHORT JMP is counted after the table
+  const unsigned jmp = instable_entries();
+  CuAssertIntEquals(tc, 2, st->form_count[jmp]);
+  CuAssertIntEquals(tc, 4, st->form_bytes[jmp]);
+  unsigned mov_forms = 0;
+  for (unsigned i = 0; i < jmp; i++) {
+    if (st->form_count[i] && instable_entry(i)->op == TOK_MOV) {
+      CuAssertIntEquals(tc, 2, st->form_count[i]);
+      mov_forms++;
+    }
+  }
+  CuAssertIntEquals(tc, 1, mov_forms);
+
+  delete_instats(st);
+  delete_decoder(decoder);
+}
+
+CuSuite* instats_test_suite(void) {
+  CuSuite* suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_count_instruction);
+  return suite;
+}
+
+#endif // UNIT_TEST
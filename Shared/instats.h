@@ -0,0 +1,46 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Decoded instruction statistics.
+
+#ifndef INSTATS_H
+#define INSTATS_H
+
+#include <stdbool.h>
+#include "disassemble.h"
+
+// ModR/M addressing modes
+enum {
+  MODE_NONE,    // no ModR/M byte
+  MODE_REG,     // mod 11: register
+  MODE_DIRECT,  // mod 00, r/m 110: [disp16]
+  MODE_INDIR,   // mod 00: [base/index]
+  MODE_DISP8,   // mod 01: [base/index + disp8]
+  MODE_DISP16,  // mod 10: [base/index + disp16]
+  MODES
+};
+
+#define MAX_STATS_LENGTH (16)
+
+// Flat counters, forms indexed by instable position.
+typedef struct {
+  unsigned long instructions;
+  unsigned long bytes;
+  unsigned long undecoded;
+  unsigned forms;
+  unsigned long* form_count;
+  unsigned long* form_bytes;
+  const INSDEF* special[2]; // JMP forms that are not table entries
+  unsigned long prefix[0x100];
+  unsigned long mode[MODES];
+  unsigned long length[MAX_STATS_LENGTH + 1];
+} INSTATS;
+
+INSTATS* new_instats(void);
+void delete_instats(INSTATS*);
+
+void count_instruction(INSTATS*, const DECODED*);
+void count_undecoded(INSTATS*, unsigned bytes);
+
+void print_instats(const INSTATS*, bool csv);
+
+#endif // INSTATS_H
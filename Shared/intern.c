@@ -0,0 +1,232 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// String interning: stable integer IDs for identifiers.
+// Names are kept in an array indexed by ID, with an open-addressed hash
+// table of IDs. In a case-insensitive table each name is stored upper-cased
+// as well, so that a lookup folds only the name being looked up.
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <assert.h>
+#include "intern.h"
+#include "utils.h"
+
+typedef struct {
+  char* text;    // spelling when first interned
+  char* folded;  // upper case, or the same as text if case-sensitive
+  unsigned hash;
+} NAME;
+
+struct intern {
+  bool case_sensitive;
+  NAME* names;
+  unsigned allocated;
+  unsigned used;
+  NAME_ID* slots;  // NO_NAME if empty
+  unsigned nslots; // power of 2
+};
+
+#define INITIAL_SLOTS (256)
+
+// Aho, Sethi, Ullman, "Compilers: Principle, Techniques, and Tools" (1986) p. 436
+static unsigned hashpjw(const char* s, bool fold) {
+  unsigned h = 0;
+  for (const char* p = s; *p; p++) {
+    h = (h << 4) + (fold ? toupper(*p) : *p);
+    unsigned g = h & 0xf0000000;
+    if (g) {
+      h ^= (g >> 24);
+      h ^= g;
+    }
+  }
+  return h;
+}
+
+// hashpjw spreads poorly over the low bits, so scramble it for the slot.
+static unsigned first_slot(const INTERN* t, unsigned hash) {
+  return (hash * 2654435761u) & (t->nslots - 1);
+}
+
+static void init_slots(INTERN* t, unsigned nslots) {
+  t->nslots = nslots;
+  t->slots = tag_memory(emalloc(nslots * sizeof t->slots[0]), MEM_SYMBOLS);
+  for (unsigned i = 0; i < nslots; i++)
+    t->slots[i] = NO_NAME;
+}
+
+INTERN* new_intern(bool case_sensitive) {
+  INTERN* t = tag_memory(ecalloc(sizeof *t), MEM_SYMBOLS);
+  t->case_sensitive = case_sensitive;
+  init_slots(t, INITIAL_SLOTS);
+  return t;
+}
+
+void delete_intern(INTERN* t) {
+  if (t) {
+    for (unsigned i = 0; i < t->used; i++) {
+      if (t->names[i].folded != t->names[i].text)
+        efree(t->names[i].folded);
+      efree(t->names[i].text);
+    }
+    efree(t->names);
+    efree(t->slots);
+    efree(t);
+  }
+}
+
+static bool same_name(const INTERN* t, const NAME* n, const char* name) {
+  if (t->case_sensitive)
+    return strcmp(n->folded, name) == 0;
+  const char* p = n->folded;
+  for (; *p && *p == toupper(*name); p++, name++)
+    ;
+  return *p == '\0' && *name == '\0';
+}
+
+// Index of the slot holding the name, or of the empty slot where it belongs.
+static unsigned find_slot(const INTERN* t, const char* name, unsigned hash) {
+  unsigned i = first_slot(t, hash);
+  for (;;) {
+    const NAME_ID id = t->slots[i];
+    if (id == NO_NAME)
+      return i;
+    const NAME* n = &t->names[id];
+    if (n->hash == hash && same_name(t, n, name))
+      return i;
+    i = (i + 1) & (t->nslots - 1);
+  }
+}
+
+static void grow_slots(INTERN* t) {
+  NAME_ID* old = t->slots;
+  init_slots(t, 2 * t->nslots);
+  for (unsigned id = 0; id < t->used; id++) {
+    unsigned i = first_slot(t, t->names[id].hash);
+    while (t->slots[i] != NO_NAME)
+      i = (i + 1) & (t->nslots - 1);
+    t->slots[i] = id;
+  }
+  efree(old);
+}
+
+NAME_ID intern(INTERN* t, const char* name) {
+  assert(t != NULL);
+  assert(name != NULL);
+
+  const unsigned hash = hashpjw(name, !t->case_sensitive);
+  unsigned i = find_slot(t, name, hash);
+  if (t->slots[i] != NO_NAME)
+    return t->slots[i];
+
+  if (t->used == t->allocated) {
+    t->allocated = t->allocated ? 2 * t->allocated : 128;
+    t->names = tag_memory(erealloc(t->names, t->allocated * sizeof t->names[0]), MEM_SYMBOLS);
+  }
+  NAME* n = &t->names[t->used];
+  n->text = tag_memory(estrdup(name), MEM_SYMBOLS);
+  n->folded = n->text;
+  if (!t->case_sensitive) {
+    n->folded = tag_memory(estrdup(name), MEM_SYMBOLS);
+    for (char* p = n->folded; *p; p++)
+      *p = toupper(*p);
+  }
+  n->hash = hash;
+  const NAME_ID id = t->used++;
+  t->slots[i] = id;
+
+  // keep the table at most half full
+  if (2 * t->used > t->nslots)
+    grow_slots(t);
+
+  return id;
+}
+
+NAME_ID intern_find(const INTERN* t, const char* name) {
+  assert(t != NULL);
+  assert(name != NULL);
+
+  const unsigned hash = hashpjw(name, !t->case_sensitive);
+  return t->slots[find_slot(t, name, hash)];
+}
+
+unsigned interned_count(const INTERN* t) {
+  assert(t != NULL);
+  return t->used;
+}
+
+const char* interned_name(const INTERN* t, NAME_ID id) {
+  assert(t != NULL);
+  assert(id >= 0 && (unsigned) id < t->used);
+  return t->names[id].text;
+}
+
+unsigned interned_hash(const INTERN* t, NAME_ID id) {
+  assert(t != NULL);
+  assert(id >= 0 && (unsigned) id < t->used);
+  return t->names[id].hash;
+}
+
+#ifdef UNIT_TEST
+
+#include "CuTest.h"
+
+static void test_intern_case_insensitive(CuTest* tc) {
+  INTERN* t = new_intern(false);
+
+  CuAssertIntEquals(tc, NO_NAME, intern_find(t, "Fred"));
+  CuAssertIntEquals(tc, 0, intern(t, "Fred"));
+  CuAssertIntEquals(tc, 1, intern(t, "Sally"));
+  CuAssertIntEquals(tc, 0, intern(t, "FRED"));
+  CuAssertIntEquals(tc, 0, intern_find(t, "fred"));
+  CuAssertIntEquals(tc, 1, intern_find(t, "sALLY"));
+  CuAssertIntEquals(tc, NO_NAME, intern_find(t, "Fre"));
+  CuAssertIntEquals(tc, NO_NAME, intern_find(t, "Freda"));
+  CuAssertIntEquals(tc, 2, interned_count(t));
+  CuAssertStrEquals(tc, "Fred", interned_name(t, 0));
+  CuAssertStrEquals(tc, "Sally", interned_name(t, 1));
+  CuAssertTrue(tc, interned_hash(t, 0) == hashpjw("FRED", false));
+
+  delete_intern(t);
+}
+
+static void test_intern_case_sensitive(CuTest* tc) {
+  INTERN* t = new_intern(true);
+
+  CuAssertIntEquals(tc, 0, intern(t, "Fred"));
+  CuAssertIntEquals(tc, 1, intern(t, "FRED"));
+  CuAssertIntEquals(tc, 0, intern_find(t, "Fred"));
+  CuAssertIntEquals(tc, NO_NAME, intern_find(t, "fred"));
+  CuAssertStrEquals(tc, "FRED", interned_name(t, 1));
+  CuAssertTrue(tc, interned_hash(t, 0) == hashpjw("Fred", false));
+
+  delete_intern(t);
+}
+
+static void test_intern_grow(CuTest* tc) {
+  INTERN* t = new_intern(false);
+  char name[16];
+
+  for (unsigned i = 0; i < 10 * INITIAL_SLOTS; i++) {
+    sprintf(name, "L%u", i);
+    CuAssertIntEquals(tc, i, intern(t, name));
+  }
+  CuAssertIntEquals(tc, 10 * INITIAL_SLOTS, interned_count(t));
+  for (unsigned i = 0; i < 10 * INITIAL_SLOTS; i++) {
+    sprintf(name, "l%u", i);
+    CuAssertIntEquals(tc, i, intern_find(t, name));
+  }
+  CuAssertStrEquals(tc, "L1234", interned_name(t, 1234));
+
+  delete_intern(t);
+}
+
+CuSuite* intern_test_suite(void) {
+  CuSuite* suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_intern_case_insensitive);
+  SUITE_ADD_TEST(suite, test_intern_case_sensitive);
+  SUITE_ADD_TEST(suite, test_intern_grow);
+  return suite;
+}
+
+#endif // UNIT_TEST
@@ -0,0 +1,32 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// String interning: stable integer IDs for identifiers.
+
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stdbool.h>
+
+typedef int NAME_ID;
+
+#define NO_NAME (-1)
+
+typedef struct intern INTERN;
+
+// Names which differ only in case have the same ID unless case-sensitive.
+INTERN* new_intern(bool case_sensitive);
+void delete_intern(INTERN*);
+
+// ID of the name, adding it if new. IDs are allocated from 0 in order.
+NAME_ID intern(INTERN*, const char* name);
+// ID of the name, or NO_NAME if it has not been interned. Does not modify
+// the table, so may be called by several threads while none is interning.
+NAME_ID intern_find(const INTERN*, const char* name);
+
+unsigned interned_count(const INTERN*);
+// The spelling with which the name was first interned.
+const char* interned_name(const INTERN*, NAME_ID);
+// hashpjw of the case-folded name, computed once when interned.
+unsigned interned_hash(const INTERN*, NAME_ID);
+
+#endif // INTERN_H
@@ -7,15 +7,15 @@
 #include <ctype.h>
 #include <assert.h>
 #include "object.h"
+#include "profile.h"
 #include "reader.h"
 #include "utils.h"
 
 // Arbitrary signature for this type of object file.
 static const BYTE SIGNATURE[] = { 0x43, 0xD0, 0xAB, 0x1F };
 
-// Bytes indicating object file compatibility version.
-// Not used because this is an educational tool undergoing constant change.
-static const BYTE VERSION[] = { 0x00, 0x00 };
+// Object file format version, little-endian.
+static const BYTE VERSION[] = { OBJECT_FORMAT_VERSION & 0xff, OBJECT_FORMAT_VERSION >> 8 };
 
 // The kinds of object record: what kind of data follows the type byte.
 enum object_kind {
@@ -42,18 +42,18 @@ static const struct {
   /* OBJ_ORG */                  { "ORG",                  OK_WORD },
   /* OBJ_BEGIN_SEGMENT */        { "BEGIN_SEGMENT",        OK_SIGNAL },
   /* OBJ_END_SEGMENT */          { "END_SEGMENT",          OK_SIGNAL },
-  /* OBJ_ORDINAL */              { "ORDINAL",              OK_BYTE },
+  /* OBJ_ORDINAL */              { "ORDINAL",              OK_WORD },
   /* OBJ_NAME */                 { "NAME",                 OK_DATA },
-  /* OBJ_OPEN_SEGMENT */         { "OPEN_SEGMENT",         OK_BYTE },
-  /* OBJ_CLOSE_SEGMENT */        { "CLOSE_SEGMENT",        OK_BYTE },
+  /* OBJ_OPEN_SEGMENT */         { "OPEN_SEGMENT",         OK_WORD },
+  /* OBJ_CLOSE_SEGMENT */        { "CLOSE_SEGMENT",        OK_WORD },
   /* OBJ_BEGIN_GROUP */          { "BEGIN_GROUP",          OK_SIGNAL },
   /* OBJ_END_GROUP */            { "END_GROUP",            OK_SIGNAL },
-  /* OBJ_GROUP */                { "GROUP",                OK_BYTE },
+  /* OBJ_GROUP */                { "GROUP",                OK_WORD },
   /* OBJ_BEGIN_OFFSET */         { "BEGIN_OFFSET",         OK_SIGNAL },
   /* OBJ_END_OFFSET */           { "END_OFFSET",           OK_SIGNAL },
   /* OBJ_POS */                  { "POS",                  OK_WORD },
   /* OBJ_LEN1 */                 { "LEN1",                 OK_BYTE },
-  /* OBJ_SEGNO */                { "SEGNO",                OK_BYTE },
+  /* OBJ_SEGNO */                { "SEGNO",                OK_WORD },
   /* OBJ_PUBLIC */               { "PUBLIC",               OK_SIGNAL },
   /* OBJ_BEGIN_EXTRN_USE */      { "BEGIN_EXTRN_USE",      OK_SIGNAL },
   /* OBJ_END_EXTRN_USE */        { "END_EXTRN_USE",        OK_SIGNAL },
@@ -90,6 +90,26 @@ void clear_orec(OREC* rec) {
   }
 }
 
+BOOL same_orec(const OREC* a, const OREC* b) {
+  assert(a != NULL);
+  assert(b != NULL);
+  assert(a->type >= 0 && a->type < sizeof types / sizeof types[0]);
+
+  if (a->type != b->type)
+    return FALSE;
+
+  switch (types[a->type].kind) {
+    case OK_SIGNAL: return TRUE;
+    case OK_BYTE: return a->u.b == b->u.b;
+    case OK_WORD: return a->u.w == b->u.w;
+    case OK_DWORD: return a->u.d == b->u.d;
+    case OK_QWORD: return a->u.q == b->u.q;
+    case OK_DATA: return a->u.data.size == b->u.data.size &&
+                         memcmp(a->u.data.buf, b->u.data.buf, a->u.data.size) == 0;
+  }
+  return FALSE;
+}
+
 static BOOL printable(const BYTE*, unsigned len);
 
 void dump_orec(const OREC* rec) {
@@ -172,9 +192,10 @@ static OREC* next(OFILE* ofile) {
   assert(ofile->used <= ofile->allocated);
   if (ofile->used == ofile->allocated) {
     ofile->allocated = (ofile->allocated == 0) ? 128 : 2 * ofile->allocated;
-    ofile->recs = erealloc(ofile->recs, ofile->allocated * sizeof ofile->recs[0]);
+    ofile->recs = tag_memory(erealloc(ofile->recs, ofile->allocated * sizeof ofile->recs[0]), MEM_ORECS);
   }
   assert(ofile->used < ofile->allocated);
+  PROFILE_COUNT(PC_RECORDS);
   return ofile->recs + ofile->used++;
 }
 
@@ -267,11 +288,33 @@ void emit_object_data(OFILE* ofile, int type, const BYTE* buf, unsigned size) {
 
   OREC* p = next(ofile);
   p->type = type;
-  p->u.data.buf = emalloc(size);
+  p->u.data.buf = tag_memory(emalloc(size), MEM_ORECS);
   memcpy(p->u.data.buf, buf, size);
   p->u.data.size = size;
 }
 
+void append_object_records(OFILE* ofile, OFILE* from) {
+  assert(ofile != NULL);
+  assert(from != NULL);
+  assert(ofile != from);
+
+  if (from->used == 0)
+    return;
+
+  if (ofile->used + from->used > ofile->allocated) {
+    unsigned allocated = ofile->allocated ? ofile->allocated : 128;
+    while (allocated < ofile->used + from->used)
+      allocated *= 2;
+    ofile->recs = tag_memory(erealloc(ofile->recs, allocated * sizeof ofile->recs[0]), MEM_ORECS);
+    ofile->allocated = allocated;
+  }
+
+  // the data buffers now belong to ofile
+  memcpy(ofile->recs + ofile->used, from->recs, from->used * sizeof from->recs[0]);
+  ofile->used += from->used;
+  from->used = 0;
+}
+
 static void write_sig(FILE*);
 static void write_ver(FILE*);
 static void write_record(FILE*, const OREC*);
@@ -292,18 +335,36 @@ static void read_sig(READER*);
 static void read_ver(READER*);
 static void read_record(READER*, int type, OREC*);
 
-OFILE* load_object_file(const char* filename) {
-  READER* r = new_reader(filename);
-  OFILE* ofile = new_ofile();
+typedef struct {
+  READER* r;
+  OFILE* ofile;
+} LOADING;
+
+static void load_job(void* arg) {
+  LOADING* l = arg;
 
-  read_sig(r);
-  read_ver(r);
+  read_sig(l->r);
+  read_ver(l->r);
 
+  // only whole records are kept, for deleting after a failure
   int c;
-  while ((c = read_char(r)) != EOF)
-    read_record(r, c, next(ofile));
+  OREC rec;
+  while ((c = read_char(l->r)) != EOF) {
+    read_record(l->r, c, &rec);
+    *next(l->ofile) = rec;
+  }
+}
 
-  return ofile;
+OFILE* load_object_file(const char* filename) {
+  LOADING l = { new_reader(filename), new_ofile() };
+  // not leaving the file open if it is invalid
+  const bool ok = run_job(load_job, &l, error_stream());
+  delete_reader(l.r);
+  if (!ok) {
+    delete_ofile(l.ofile);
+    fail();
+  }
+  return l.ofile;
 }
 
 static void write_sig(FILE* fp) {
@@ -331,7 +392,8 @@ static void read_ver(READER* r) {
     fatal("error reading object file version: %s\n", r->filename);
 
   if (memcmp(buf, VERSION, sizeof VERSION) != 0)
-    fatal("incompatible object file version: %s\n", r->filename);
+    fatal("object format version %u, expected %u (assemble it again): %s\n",
+          buf[0] | (buf[1] << 8), OBJECT_FORMAT_VERSION, r->filename);
 }
 
 static void putnum(FILE*, QWORD val, unsigned size);
@@ -416,7 +478,7 @@ static void read_record(READER* r, int type, OREC* rec) {
       break;
     case OK_DATA:
       rec->u.data.size = getbyte(r);
-      rec->u.data.buf = getdata(r, rec->u.data.size);
+      rec->u.data.buf = tag_memory(getdata(r, rec->u.data.size), MEM_ORECS);
       break;
     default:
       fatal("internal error: %s: %d: unknown object record type: %d\n", __FILE__, __LINE__, rec->type);
@@ -435,8 +497,93 @@ static BYTE getbyte(READER* r) {
 static BYTE* getdata(READER* r, size_t sz) {
   BYTE* buf = emalloc(sz);
 
-  if (read_buf(r, buf, sz) != sz)
+  if (read_buf(r, buf, sz) != sz) {
+    efree(buf);
     fatal("unexpected end of file: %s\n", r->filename);
+  }
 
   return buf;
 }
+
+#ifdef UNIT_TEST
+
+#include "CuTest.h"
+
+// Load a module of a few thousand records like the assembler writes.
+static void bench_load_object_file(CuBench* bc) {
+  static const BYTE code[] = { 0x8B, 0x46, 0x04 };
+  const char* const filename = "bench_object.obj";
+  OFILE* ofile = new_ofile();
+
+  emit_object_signal(ofile, OBJ_BEGIN_SEGMENT);
+  emit_object_word(ofile, OBJ_ORDINAL, 1);
+  emit_object_data(ofile, OBJ_NAME, (const BYTE*) "CODE", 4);
+  emit_object_signal(ofile, OBJ_END_SEGMENT);
+  emit_object_word(ofile, OBJ_OPEN_SEGMENT, 1);
+  for (unsigned i = 0; i < 1000; i++) {
+    emit_object_data(ofile, OBJ_CODE, code, sizeof code);
+    emit_object_signal(ofile, OBJ_BEGIN_OFFSET);
+    emit_object_word(ofile, OBJ_POS, (WORD) (3 * i + 1));
+    emit_object_signal(ofile, OBJ_END_OFFSET);
+  }
+  emit_object_word(ofile, OBJ_CLOSE_SEGMENT, 1);
+  save_object_file(ofile, filename);
+  delete_ofile(ofile);
+
+  CuBenchStart(bc);
+  for (long i = 0; i < bc->n; i++)
+    delete_ofile(load_object_file(filename));
+  CuBenchStop(bc);
+
+  remove(filename);
+}
+
+static void load_job_of(void* filename) {
+  delete_ofile(load_object_file(filename));
+}
+
+// A file ending within a record fails to load, freeing the records read.
+static void test_load_truncated_object(CuTest* tc) {
+  const char* const filename = "truncated.obj";
+  OFILE* ofile = new_ofile();
+  emit_object_word(ofile, OBJ_OPEN_SEGMENT, 1);
+  emit_object_data(ofile, OBJ_CODE, (const BYTE*) "\x90\x90\xC3", 3);
+  save_object_file(ofile, filename);
+  delete_ofile(ofile);
+
+  // drop the last byte of the code
+  FILE* fp = fopen(filename, "rb");
+  CuAssertPtrNotNull(tc, fp);
+  BYTE buf[64];
+  const size_t size = fread(buf, 1, sizeof buf, fp);
+  fclose(fp);
+  fp = fopen(filename, "wb");
+  CuAssertPtrNotNull(tc, fp);
+  fwrite(buf, 1, size - 1, fp);
+  fclose(fp);
+
+  FILE* errors = tmpfile();
+  CuAssertPtrNotNull(tc, errors);
+  unsigned long mallocs, frees, mallocs_after, frees_after;
+  get_memory_counts(&mallocs, &frees);
+  CuAssertIntEquals(tc, false, run_job(load_job_of, (void*) filename, errors));
+  get_memory_counts(&mallocs_after, &frees_after);
+  CuAssertTrue(tc, mallocs_after - mallocs == frees_after - frees);
+
+  fclose(errors);
+  remove(filename);
+}
+
+CuSuite* object_test_suite(void) {
+  CuSuite* suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_load_truncated_object);
+  return suite;
+}
+
+CuBenchSuite* object_bench_suite(void) {
+  CuBenchSuite* suite = CuBenchSuiteNew();
+  SUITE_ADD_BENCH(suite, bench_load_object_file);
+  return suite;
+}
+
+#endif // UNIT_TEST
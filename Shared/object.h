@@ -78,6 +78,7 @@ typedef struct {
 } OREC;
 
 void dump_orec(const OREC*);
+BOOL same_orec(const OREC*, const OREC*);
 void print_orec(const OREC*);
 
 typedef struct {
@@ -101,6 +102,14 @@ void emit_object_dword(OFILE*, int type, DWORD);
 void emit_object_qword(OFILE*, int type, QWORD);
 void emit_object_data(OFILE*, int type, const BYTE*, unsigned size);
 
+// Move all the records of the second file to the end of the first.
+void append_object_records(OFILE*, OFILE*);
+
+// Incremented whenever the records or their encoding change, so that an
+// object file of an older format is rejected rather than misread.
+// 1: ordinal, segment and group numbers are words.
+#define OBJECT_FORMAT_VERSION (1)
+
 void save_object_file(const OFILE*, const char* filename);
 OFILE* load_object_file(const char* filename);
 
@@ -97,6 +97,17 @@ BOOL flag_matches(const OPERAND_CLASS* op, int flag) {
   return has_class_flag(op, flag);
 }
 
+QWORD class_mask(const OPERAND_CLASS* op) {
+  assert(op != NULL);
+
+  QWORD mask = (op->type == OT_NONE) ? FLAG_BIT(OF_NONE) : 0;
+  for (int i = 0; i < op->nflag; i++) {
+    if (op->flags[i] != OF_NONE)
+      mask |= FLAG_BIT(op->flags[i]);
+  }
+  return mask;
+}
+
 
 #ifdef UNIT_TEST
 
@@ -136,11 +147,30 @@ static void test_add_class_flag(CuTest* tc) {
   CuAssertIntEquals(tc, OF_RM16, op.flags[1]);
 }
 
+static void test_class_mask(CuTest* tc) {
+  OPERAND_CLASS op;
+
+  CuAssertTrue(tc, OF_STT < 64);
+
+  init_operand_class(&op);
+  op.type = OT_NONE;
+  CuAssertTrue(tc, class_mask(&op) == FLAG_BIT(OF_NONE));
+
+  op.type = OT_REG;
+  add_class_flag(&op, OF_AX);
+  add_class_flag(&op, OF_REG16);
+  CuAssertTrue(tc, class_mask(&op) == (FLAG_BIT(OF_AX) | FLAG_BIT(OF_REG16)));
+
+  for (int flag = OF_NONE; flag <= OF_STT; flag++)
+    CuAssertIntEquals(tc, flag_matches(&op, flag) != FALSE, (class_mask(&op) & FLAG_BIT(flag)) != 0);
+}
+
 CuSuite* operand_class_test_suite(void) {
   CuSuite* suite = CuSuiteNew();
   SUITE_ADD_TEST(suite, test_init_operand_class);
   SUITE_ADD_TEST(suite, test_operand_flag_name);
   SUITE_ADD_TEST(suite, test_add_class_flag);
+  SUITE_ADD_TEST(suite, test_class_mask);
   return suite;
 }
 
@@ -79,4 +79,10 @@ void add_class_flag(OPERAND_CLASS*, int flag);
 BOOL has_class_flag(const OPERAND_CLASS*, int flag);
 BOOL flag_matches(const OPERAND_CLASS*, int flag);
 
+// An operand class as a set of flag bits: a table operand flag f matches
+// the class if FLAG_BIT(f) is in the set, as flag_matches.
+#define FLAG_BIT(f) ((QWORD)1 << (f))
+
+QWORD class_mask(const OPERAND_CLASS*);
+
 #endif // OPCLASS_H
@@ -0,0 +1,218 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Phase profiler: time and event counts for each phase of a run.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <assert.h>
+#include "profile.h"
+#include "timer.h"
+#include "trace.h"
+#include "utils.h"
+
+THREAD_LOCAL unsigned long long profile_counts[PROFILE_COUNTERS];
+
+static const char* const counter_names[PROFILE_COUNTERS] = {
+  "Lines", "Lookups", "Records", "Fixups"
+};
+
+void add_profile_counts(const unsigned long long counts[PROFILE_COUNTERS]) {
+  for (int c = 0; c < PROFILE_COUNTERS; c++)
+    profile_counts[c] += counts[c];
+}
+
+#define PHASE_NAME_SIZE (32)
+
+typedef struct {
+  char name[PHASE_NAME_SIZE];
+  long long usec;
+  unsigned long long counts[PROFILE_COUNTERS];
+  size_t peak_bytes;  // live bytes at the highest point in the phase
+  size_t end_bytes;   // live bytes at the end of the phase
+} PHASE;
+
+struct profile {
+  PHASE* phases;
+  unsigned allocated;
+  unsigned used;
+  // the phase being timed, if running
+  BOOL running;
+  unsigned current;
+  TIMER timer;
+  unsigned long long start_counts[PROFILE_COUNTERS];
+};
+
+PROFILE* new_profile(void) {
+  PROFILE* p = emalloc(sizeof *p);
+  p->allocated = 16;
+  p->phases = emalloc(p->allocated * sizeof p->phases[0]);
+  p->used = 0;
+  p->running = FALSE;
+  p->current = 0;
+  return p;
+}
+
+void delete_profile(PROFILE* p) {
+  if (p) {
+    efree(p->phases);
+    efree(p);
+  }
+}
+
+static unsigned find_phase(PROFILE* p, const char* name) {
+  for (unsigned i = 0; i < p->used; i++) {
+    if (strcmp(p->phases[i].name, name) == 0)
+      return i;
+  }
+
+  if (p->used == p->allocated) {
+    p->allocated *= 2;
+    p->phases = erealloc(p->phases, p->allocated * sizeof p->phases[0]);
+  }
+  PHASE* phase = &p->phases[p->used];
+  strcpy(phase->name, name);
+  phase->usec = 0;
+  memset(phase->counts, 0, sizeof phase->counts);
+  phase->peak_bytes = 0;
+  phase->end_bytes = 0;
+  return p->used++;
+}
+
+void begin_phase(PROFILE* p, const char* fmt, ...) {
+  assert(p != NULL);
+  assert(fmt != NULL);
+
+  end_phase(p);
+
+  char name[PHASE_NAME_SIZE];
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(name, sizeof name, fmt, ap);
+  va_end(ap);
+
+  p->current = find_phase(p, name);
+  p->running = TRUE;
+  TRACE_BEGIN("%s", name);
+  memcpy(p->start_counts, profile_counts, sizeof p->start_counts);
+  mark_memory_peak();
+  start_timer(&p->timer);
+}
+
+void end_phase(PROFILE* p) {
+  assert(p != NULL);
+
+  if (!p->running)
+    return;
+
+  stop_timer(&p->timer);
+  PHASE* phase = &p->phases[p->current];
+  phase->usec += elapsed_usec(&p->timer);
+  for (int c = 0; c < PROFILE_COUNTERS; c++)
+    phase->counts[c] += profile_counts[c] - p->start_counts[c];
+  const size_t peak = memory_peak_since_mark();
+  if (peak > phase->peak_bytes)
+    phase->peak_bytes = peak;
+  MEMORY_USAGE usage;
+  get_memory_usage(&usage);
+  phase->end_bytes = usage.live_bytes;
+  p->running = FALSE;
+  TRACE_END();
+}
+
+long long profile_usec(const PROFILE* p) {
+  assert(p != NULL);
+  long long total = 0;
+  for (unsigned i = 0; i < p->used; i++)
+    total += p->phases[i].usec;
+  return total;
+}
+
+static void print_row(FILE* fp, const char* name, long long usec, const unsigned long long counts[PROFILE_COUNTERS]) {
+  fprintf(fp, "%-16s %12lld", name, usec);
+  for (int c = 0; c < PROFILE_COUNTERS; c++)
+    fprintf(fp, " %10llu", counts[c]);
+  putc('\n', fp);
+}
+
+void print_profile(const PROFILE* p, FILE* fp) {
+  assert(p != NULL);
+  assert(fp != NULL);
+
+  unsigned long long total[PROFILE_COUNTERS] = { 0 };
+
+  fprintf(fp, "%-16s %12s", "Phase", "Microseconds");
+  for (int c = 0; c < PROFILE_COUNTERS; c++)
+    fprintf(fp, " %10s", counter_names[c]);
+  putc('\n', fp);
+
+  for (unsigned i = 0; i < p->used; i++) {
+    const PHASE* phase = &p->phases[i];
+    print_row(fp, phase->name, phase->usec, phase->counts);
+    for (int c = 0; c < PROFILE_COUNTERS; c++)
+      total[c] += phase->counts[c];
+  }
+
+  print_row(fp, "total", profile_usec(p), total);
+}
+
+void print_memory_profile(const PROFILE* p, FILE* fp) {
+  assert(p != NULL);
+  assert(fp != NULL);
+
+  fprintf(fp, "%-16s %12s %12s\n", "Phase", "Peak bytes", "End bytes");
+  for (unsigned i = 0; i < p->used; i++) {
+    const PHASE* phase = &p->phases[i];
+    fprintf(fp, "%-16s %12zu %12zu\n", phase->name, phase->peak_bytes, phase->end_bytes);
+  }
+}
+
+#ifdef UNIT_TEST
+
+#include "CuTest.h"
+
+static void test_profile_phases(CuTest* tc) {
+  PROFILE* p = new_profile();
+
+  begin_phase(p, "load");
+  PROFILE_COUNT(PC_LINES);
+  PROFILE_COUNT(PC_LINES);
+  begin_phase(p, "resize %u", 1);
+  PROFILE_COUNT(PC_LOOKUPS);
+  end_phase(p);
+  PROFILE_COUNT(PC_LOOKUPS); // between phases: not attributed
+  begin_phase(p, "load");
+  PROFILE_COUNT(PC_LINES);
+  const unsigned long long worker[PROFILE_COUNTERS] = { 0, 0, 5, 2 };
+  add_profile_counts(worker);
+  end_phase(p);
+  end_phase(p);
+
+  CuAssertIntEquals(tc, 2, p->used);
+  CuAssertStrEquals(tc, "load", p->phases[0].name);
+  CuAssertStrEquals(tc, "resize 1", p->phases[1].name);
+  CuAssertIntEquals(tc, 3, (int)p->phases[0].counts[PC_LINES]);
+  CuAssertIntEquals(tc, 0, (int)p->phases[0].counts[PC_LOOKUPS]);
+  CuAssertIntEquals(tc, 5, (int)p->phases[0].counts[PC_RECORDS]);
+  CuAssertIntEquals(tc, 2, (int)p->phases[0].counts[PC_FIXUPS]);
+  CuAssertIntEquals(tc, 0, (int)p->phases[1].counts[PC_LINES]);
+  CuAssertIntEquals(tc, 1, (int)p->phases[1].counts[PC_LOOKUPS]);
+  CuAssertTrue(tc, profile_usec(p) >= 0);
+
+  begin_phase(p, "memory");
+  char* block = emalloc(1000);
+  efree(block);
+  end_phase(p);
+  CuAssertTrue(tc, p->phases[2].peak_bytes >= p->phases[2].end_bytes + 1000);
+
+  delete_profile(p);
+}
+
+CuSuite* profile_test_suite(void) {
+  CuSuite* suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_profile_phases);
+  return suite;
+}
+
+#endif // UNIT_TEST
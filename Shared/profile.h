@@ -0,0 +1,44 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Phase profiler: time and event counts for each phase of a run.
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+#include "utils.h"
+
+enum profile_counter {
+  PC_LINES,    // source lines lexed
+  PC_LOOKUPS,  // symbol table lookups
+  PC_RECORDS,  // object records emitted or loaded
+  PC_FIXUPS,   // fixups created or touched
+  PROFILE_COUNTERS
+};
+
+// Events counted on the current thread.
+extern THREAD_LOCAL unsigned long long profile_counts[PROFILE_COUNTERS];
+
+#define PROFILE_COUNT(c) (profile_counts[c]++)
+
+// Add counts gathered on a worker thread to those of the current thread.
+void add_profile_counts(const unsigned long long counts[PROFILE_COUNTERS]);
+
+typedef struct profile PROFILE;
+
+PROFILE* new_profile(void);
+void delete_profile(PROFILE*);
+
+// End the current phase, if any, and start timing the named phase.
+// Time and counts accumulate if a phase of the same name is begun again.
+// Each phase is also a span in any trace being written.
+void begin_phase(PROFILE*, const char* fmt, ...);
+void end_phase(PROFILE*);
+
+long long profile_usec(const PROFILE*);
+void print_profile(const PROFILE*, FILE*);
+
+// The peak and final live heap bytes of each phase.
+void print_memory_profile(const PROFILE*, FILE*);
+
+#endif // PROFILE_H
@@ -20,6 +20,14 @@ READER* new_reader(const char* filename) {
   return r;
 }
 
+void delete_reader(READER* r) {
+  if (r) {
+    fclose(r->fp);
+    efree(r->filename);
+    efree(r);
+  }
+}
+
 #ifdef USE_BUFFERED_READER
 
 int read_char(READER* r) {
@@ -19,6 +19,7 @@ typedef struct {
 } READER;
 
 READER* new_reader(const char* filename);
+void delete_reader(READER*);
 
 int read_char(READER*);
 size_t read_buf(READER*, BYTE* buffer, size_t buffer_size);
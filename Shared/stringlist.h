@@ -6,6 +6,7 @@
 // is to compile this code with my own C compiler one day.
 
 #ifndef STRINGLIST_H
+#define STRINGLIST_H
 
 typedef struct {
   char* * strings;
@@ -2,12 +2,22 @@
 // Copyright (c) 2024 Nigel Perks
 // Execution timer.
 
+#ifdef _WIN32
 #pragma warning (disable: 5105)
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
 
 #include <limits.h>
+#ifdef _WIN32
 #include <Windows.h>
+#else
+#include <time.h>
+#endif
 #include "timer.h"
 
+#ifdef _WIN32
+
 // https://learn.microsoft.com/en-us/windows/win32/sysinfo/acquiring-high-resolution-time-stamps
 
 void start_timer(TIMER* t) {
@@ -24,6 +34,39 @@ void stop_timer(TIMER* t) {
   t->stop = i.QuadPart;
 }
 
+long long timer_usec(void) {
+  const long long MILLION = 1000000;
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return count.QuadPart / freq.QuadPart * MILLION + count.QuadPart % freq.QuadPart * MILLION / freq.QuadPart;
+}
+
+#else
+
+#define BILLION (1000000000LL)
+
+static long long now_nsec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * BILLION + ts.tv_nsec;
+}
+
+void start_timer(TIMER* t) {
+  t->freq = BILLION;
+  t->start = now_nsec();
+}
+
+void stop_timer(TIMER* t) {
+  t->stop = now_nsec();
+}
+
+long long timer_usec(void) {
+  return now_nsec() / 1000;
+}
+
+#endif
+
 long long elapsed_usec(const TIMER* t) {
   const long long MILLION = 1000000;
   long long ticks = t->stop - t->start;
@@ -13,3 +13,6 @@ typedef struct {
 void start_timer(TIMER*);
 void stop_timer(TIMER*);
 long long elapsed_usec(const TIMER*);
+
+// Current time in microseconds, on a clock shared by all processes.
+long long timer_usec(void);
@@ -6,6 +6,9 @@
 #include <string.h>
 #include <ctype.h>
 #include <assert.h>
+#ifndef __STDC_NO_THREADS__
+#include <threads.h>
+#endif
 #include "token.h"
 
 BOOL token_is_directive(int tok) {
@@ -47,6 +50,7 @@ static const struct keyword keywords[] = {
   { TOK_EXTRN,    "EXTRN" },
   { TOK_GROUP,    "GROUP" },
   { TOK_IDEAL,    "IDEAL" },
+  { TOK_INCBIN,   "INCBIN" },
   { TOK_JUMPS,    "JUMPS" },
   { TOK_MODEL,    "MODEL" },
   { TOK_ORG,      "ORG" },
@@ -335,7 +339,7 @@ static int compare_keywords(const void* p, const void* q) {
   return _stricmp(lhs->name, rhs->name);
 }
 
-void init_keywords(void) {
+static void sort_keywords(void) {
   // check that the keywords list is in order for token_name() below
   // initialise keywords_sorted
   int t = keywords[0].token;
@@ -351,6 +355,17 @@ void init_keywords(void) {
   initialised = true;
 }
 
+// Safe to call on any thread, any number of times.
+void init_keywords(void) {
+#ifndef __STDC_NO_THREADS__
+  static once_flag once = ONCE_FLAG_INIT;
+  call_once(&once, sort_keywords);
+#else
+  if (!initialised)
+    sort_keywords();
+#endif
+}
+
 int identifier_token(const char* name) {
   if (!initialised)
     fatal("internal error: identifier_token lookup not initialised\n");
@@ -397,7 +412,7 @@ int register_token(const char* name, int *regno) {
 
 const char* token_name(int tok) {
   if (tok >= 32 && tok < 127) {
-    static char buf[4];
+    static THREAD_LOCAL char buf[4];
     buf[0] = '\'';
     buf[1] = tok;
     buf[2] = '\'';
@@ -525,4 +540,29 @@ CuSuite* token_test_suite(void) {
   return suite;
 }
 
+static void bench_identifier_token(CuBench* bc) {
+  // keywords in mixed case, and labels which are not keywords
+  static const char* const names[] = {
+    "mov", "PUSH", "Segment", "jnz", "DW", "assume", "Loop_1", "buffer", "ENDS", "int"
+  };
+  const unsigned count = sizeof names / sizeof names[0];
+  unsigned long labels = 0;
+
+  init_keywords();
+
+  CuBenchStart(bc);
+  for (long i = 0; i < bc->n; i++)
+    labels += identifier_token(names[i % count]) == TOK_LABEL;
+  CuBenchStop(bc);
+
+  bc->sink = labels;
+  assert(labels > 0 || bc->n < (long) count);
+}
+
+CuBenchSuite* token_bench_suite(void) {
+  CuBenchSuite* suite = CuBenchSuiteNew();
+  SUITE_ADD_BENCH(suite, bench_identifier_token);
+  return suite;
+}
+
 #endif // UNIT_TEST
@@ -46,6 +46,7 @@ enum {
   TOK_EXTRN,
   TOK_GROUP,
   TOK_IDEAL,
+  TOK_INCBIN,
   TOK_JUMPS,
   TOK_MODEL,
   TOK_ORG,
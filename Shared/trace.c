@@ -0,0 +1,270 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Trace events in Chrome trace-event JSON format, for a trace viewer.
+// The file is a JSON array of events: "B" and "E" events begin and end
+// a span on a thread, and "M" events name processes and threads.
+
+#include "trace.h"
+
+#ifdef TRACE_EVENTS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <assert.h>
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+#ifndef __STDC_NO_THREADS__
+#include <threads.h>
+#endif
+#include "timer.h"
+#include "utils.h"
+
+static FILE* trace_fp;
+static long trace_pid;
+static unsigned long trace_events;
+static unsigned trace_lanes;
+#ifndef __STDC_NO_THREADS__
+static mtx_t trace_mutex;
+#endif
+
+// lane of the current thread: 0 for the main thread
+static THREAD_LOCAL unsigned trace_lane;
+
+#define MAX_TRACE_NAME (256)
+
+static void lock(void) {
+#ifndef __STDC_NO_THREADS__
+  mtx_lock(&trace_mutex);
+#endif
+}
+
+static void unlock(void) {
+#ifndef __STDC_NO_THREADS__
+  mtx_unlock(&trace_mutex);
+#endif
+}
+
+static void write_string(const char* s) {
+  putc('"', trace_fp);
+  for (; *s; s++) {
+    const unsigned char c = *s;
+    if (c == '"' || c == '\\')
+      fprintf(trace_fp, "\\%c", c);
+    else if (c < ' ')
+      fprintf(trace_fp, "\\u%04x", c);
+    else
+      putc(c, trace_fp);
+  }
+  putc('"', trace_fp);
+}
+
+// Begin an event, leaving its object open for further fields.
+// Called with the lock held.
+static void start_event(char phase) {
+  fprintf(trace_fp, "%s\n{\"ph\":\"%c\",\"pid\":%ld,\"tid\":%u",
+          trace_events++ ? "," : "", phase, trace_pid, trace_lane);
+}
+
+// Called with the lock held.
+static void write_metadata(const char* what, const char* name) {
+  start_event('M');
+  fputs(",\"name\":", trace_fp);
+  write_string(what);
+  fputs(",\"args\":{\"name\":", trace_fp);
+  write_string(name);
+  fputs("}}", trace_fp);
+}
+
+void trace_open(const char* filename, const char* process_name) {
+  assert(filename != NULL);
+  assert(process_name != NULL);
+  assert(trace_fp == NULL);
+
+  trace_fp = efopen(filename, "w", "trace");
+#ifndef __STDC_NO_THREADS__
+  if (mtx_init(&trace_mutex, mtx_plain) != thrd_success)
+    fatal("cannot initialise trace\n");
+#endif
+  trace_pid = (long) getpid();
+  trace_events = 0;
+  trace_lanes = 0;
+  trace_lane = 0;
+
+  putc('[', trace_fp);
+  write_metadata("process_name", process_name);
+  write_metadata("thread_name", "main");
+}
+
+void trace_close(void) {
+  if (trace_fp == NULL)
+    return;
+  fputs("\n]\n", trace_fp);
+  if (fclose(trace_fp) != 0)
+    fatal("error writing trace\n");
+  trace_fp = NULL;
+#ifndef __STDC_NO_THREADS__
+  mtx_destroy(&trace_mutex);
+#endif
+}
+
+bool tracing(void) {
+  return trace_fp != NULL;
+}
+
+void trace_begin(const char* fmt, ...) {
+  assert(fmt != NULL);
+
+  if (trace_fp == NULL)
+    return;
+
+  char name[MAX_TRACE_NAME];
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(name, sizeof name, fmt, ap);
+  va_end(ap);
+
+  const long long ts = timer_usec();
+  lock();
+  start_event('B');
+  fprintf(trace_fp, ",\"ts\":%lld,\"name\":", ts);
+  write_string(name);
+  putc('}', trace_fp);
+  unlock();
+}
+
+void trace_end(void) {
+  if (trace_fp == NULL)
+    return;
+
+  const long long ts = timer_usec();
+  lock();
+  start_event('E');
+  fprintf(trace_fp, ",\"ts\":%lld}", ts);
+  unlock();
+}
+
+void trace_thread(const char* fmt, ...) {
+  assert(fmt != NULL);
+
+  if (trace_fp == NULL)
+    return;
+
+  char name[MAX_TRACE_NAME];
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(name, sizeof name, fmt, ap);
+  va_end(ap);
+
+  lock();
+  trace_lane = ++trace_lanes;
+  write_metadata("thread_name", name);
+  unlock();
+}
+
+void trace_merge(const char* filename) {
+  assert(filename != NULL);
+
+  if (trace_fp == NULL)
+    return;
+
+  // the other process may have failed before writing anything
+  FILE* fp = fopen(filename, "rb");
+  if (fp == NULL)
+    return;
+  const FileSize size = file_size(fp, filename);
+  char* text = (char*) read_file(fp, size);
+  fclose(fp);
+  remove(filename);
+
+  // the events lie between the brackets, which a failed process may not have closed
+  size_t first = 0;
+  size_t last = size;
+  while (first < size && text[first] != '[')
+    first++;
+  first++;
+  while (last > first && text[last - 1] != ']' && text[last - 1] != '}')
+    last--;
+  if (last > first && text[last - 1] == ']')
+    last--;
+  while (first < last && (text[first] == '\n' || text[first] == '\r' || text[first] == ' '))
+    first++;
+  while (last > first && (text[last - 1] == '\n' || text[last - 1] == '\r' || text[last - 1] == ' '))
+    last--;
+
+  if (last > first) {
+    lock();
+    fprintf(trace_fp, "%s\n", trace_events++ ? "," : "");
+    fwrite(text + first, 1, last - first, trace_fp);
+    unlock();
+  }
+
+  efree(text);
+}
+
+#ifdef UNIT_TEST
+
+#include "CuTest.h"
+
+static char* read_text(const char* filename) {
+  FILE* fp = efopen(filename, "rb", "reading");
+  const FileSize size = file_size(fp, filename);
+  char* text = emalloc(size + 1);
+  if (fread(text, 1, size, fp) != size)
+    fatal("error reading %s\n", filename);
+  text[size] = '\0';
+  fclose(fp);
+  return text;
+}
+
+static void test_trace(CuTest* tc) {
+  const char* const child = "trace_test_child.json";
+  const char* const parent = "trace_test.json";
+
+  trace_open(child, "child");
+  trace_begin("pass %d", 1);
+  trace_end();
+  trace_close();
+  CuAssertTrue(tc, !tracing());
+
+  trace_open(parent, "parent");
+  CuAssertTrue(tc, tracing());
+  trace_begin("job \"%s\"", "a\\b.asm");
+  trace_merge(child);
+  trace_end();
+  trace_close();
+
+  char* text = read_text(parent);
+  const size_t len = strlen(text);
+  CuAssertTrue(tc, len > 2);
+  CuAssertIntEquals(tc, '[', text[0]);
+  CuAssertStrEquals(tc, "]\n", text + len - 2);
+  CuAssertPtrNotNull(tc, strstr(text, "{\"ph\":\"M\""));
+  CuAssertPtrNotNull(tc, strstr(text, "\"args\":{\"name\":\"child\"}"));
+  CuAssertPtrNotNull(tc, strstr(text, "\"args\":{\"name\":\"parent\"}"));
+  CuAssertPtrNotNull(tc, strstr(text, "\"name\":\"pass 1\"}"));
+  CuAssertPtrNotNull(tc, strstr(text, "\"name\":\"job \\\"a\\\\b.asm\\\"\"}"));
+  // merged events are separated like the rest, with no stray brackets
+  CuAssertTrue(tc, strstr(text, "}\n{") == NULL);
+  CuAssertTrue(tc, strchr(text + 1, '[') == NULL);
+  CuAssertTrue(tc, strchr(text, ']') == text + len - 2);
+  efree(text);
+
+  remove(parent);
+  CuAssertTrue(tc, fopen(child, "rb") == NULL);
+}
+
+CuSuite* trace_test_suite(void) {
+  CuSuite* suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_trace);
+  return suite;
+}
+
+#endif // UNIT_TEST
+
+#endif // TRACE_EVENTS
@@ -0,0 +1,46 @@
+// Basic Assembler
+// Copyright (c) 2021-24 Nigel Perks
+// Trace events in Chrome trace-event JSON format, for a trace viewer.
+// Built only if TRACE_EVENTS is defined: otherwise the macros do nothing.
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#ifdef TRACE_EVENTS
+
+#include <stdbool.h>
+
+// Start writing events to the file, naming this process in the trace.
+void trace_open(const char* filename, const char* process_name);
+void trace_close(void);
+bool tracing(void);
+
+// Begin and end a span on the current thread. Spans nest.
+void trace_begin(const char* fmt, ...);
+void trace_end(void);
+
+// Give the current thread its own lane in the trace.
+void trace_thread(const char* fmt, ...);
+
+// Append the events of a trace written by another process, and delete its file.
+void trace_merge(const char* filename);
+
+#define TRACE_OPEN(filename, process_name) trace_open(filename, process_name)
+#define TRACE_CLOSE() trace_close()
+#define TRACE_BEGIN(...) trace_begin(__VA_ARGS__)
+#define TRACE_END() trace_end()
+#define TRACE_THREAD(...) trace_thread(__VA_ARGS__)
+#define TRACE_MERGE(filename) trace_merge(filename)
+
+#else
+
+#define TRACE_OPEN(filename, process_name) ((void)0)
+#define TRACE_CLOSE() ((void)0)
+#define TRACE_BEGIN(...) ((void)0)
+#define TRACE_END() ((void)0)
+#define TRACE_THREAD(...) ((void)0)
+#define TRACE_MERGE(filename) ((void)0)
+
+#endif // TRACE_EVENTS
+
+#endif // TRACE_H
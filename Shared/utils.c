@@ -4,64 +4,222 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdarg.h>
 #include <assert.h>
+#include <setjmp.h>
 #include "utils.h"
 
 const char* progname;
 
-void fatal(const char* fmt, ...) {
+// Errors and failures of a job are confined to it.
+static THREAD_LOCAL FILE* job_stream;
+static THREAD_LOCAL jmp_buf* job_failure;
+
+_Noreturn void fatal(const char* fmt, ...) {
   fflush(stdout);
+  FILE* fp = error_stream();
   va_list ap;
   if (progname)
-    fprintf(stderr, "%s: ", progname);
-  fprintf(stderr, "fatal: ");
+    fprintf(fp, "%s: ", progname);
+  fprintf(fp, "fatal: ");
   va_start(ap, fmt);
-  vfprintf(stderr, fmt, ap);
+  vfprintf(fp, fmt, ap);
   va_end(ap);
+  fail();
+}
+
+FILE* error_stream(void) {
+  return job_stream ? job_stream : stderr;
+}
+
+_Noreturn void fail(void) {
+  if (job_failure)
+    longjmp(*job_failure, 1);
   exit(EXIT_FAILURE);
 }
 
-static unsigned long malloc_count;
-static unsigned long free_count;
+bool run_job(void (*fn)(void*), void* arg, FILE* errors) {
+  assert(fn != NULL);
+
+  jmp_buf failure;
+  FILE* const outer_stream = job_stream;
+  jmp_buf* const outer_failure = job_failure;
+  volatile bool ok = false;
+
+  job_stream = errors;
+  job_failure = &failure;
+  if (setjmp(failure) == 0) {
+    fn(arg);
+    ok = true;
+  }
+  job_stream = outer_stream;
+  job_failure = outer_failure;
+  return ok;
+}
+
+// Allocation can happen on more than one thread.
+#ifndef __STDC_NO_ATOMICS__
+#include <stdatomic.h>
+typedef atomic_ulong COUNT;
+typedef atomic_size_t BYTES;
+#else
+typedef unsigned long COUNT;
+typedef size_t BYTES;
+#endif
+
+static COUNT malloc_count;
+static COUNT free_count;
+static BYTES live_bytes;
+static BYTES peak_bytes;
+static BYTES mark_peak_bytes;
+static BYTES category_live[MEM_CATEGORIES];
+static BYTES category_peak[MEM_CATEGORIES];
+
+static const char* const category_names[MEM_CATEGORIES] = {
+  "other", "symbols", "irecs", "object records", "segment data", "AST"
+};
+
+// Each block is preceded by its size and category.
+typedef union {
+  struct {
+    size_t size;
+    MEM_CATEGORY category;
+  } h;
+  max_align_t align;
+} HEADER;
+
+static void raise_peak(BYTES* peak, size_t live) {
+#ifndef __STDC_NO_ATOMICS__
+  size_t old = atomic_load(peak);
+  while (live > old && !atomic_compare_exchange_weak(peak, &old, live))
+    ;
+#else
+  if (live > *peak)
+    *peak = live;
+#endif
+}
+
+static void add_bytes(MEM_CATEGORY category, size_t size) {
+  const size_t live = (live_bytes += size);
+  raise_peak(&peak_bytes, live);
+  raise_peak(&mark_peak_bytes, live);
+  raise_peak(&category_peak[category], category_live[category] += size);
+}
+
+static void remove_bytes(MEM_CATEGORY category, size_t size) {
+  live_bytes -= size;
+  category_live[category] -= size;
+}
+
+static void* block(HEADER* h, size_t size, MEM_CATEGORY category) {
+  h->h.size = size;
+  h->h.category = category;
+  add_bytes(category, size);
+  return h + 1;
+}
+
+static HEADER* header(void* p) {
+  return (HEADER*)p - 1;
+}
 
 void get_memory_counts(unsigned long *mcount, unsigned long *fcount) {
   *mcount = malloc_count;
   *fcount = free_count;
 }
 
+void get_memory_usage(MEMORY_USAGE* usage) {
+  usage->malloc_count = malloc_count;
+  usage->free_count = free_count;
+  usage->live_bytes = live_bytes;
+  usage->peak_bytes = peak_bytes;
+  for (int i = 0; i < MEM_CATEGORIES; i++) {
+    usage->category_live[i] = category_live[i];
+    usage->category_peak[i] = category_peak[i];
+  }
+}
+
+const char* memory_category_name(MEM_CATEGORY category) {
+  assert(category >= 0 && category < MEM_CATEGORIES);
+  return category_names[category];
+}
+
+void print_memory_usage(FILE* fp) {
+  MEMORY_USAGE usage;
+  get_memory_usage(&usage);
+  fprintf(fp, "malloc: %10lu\n", usage.malloc_count);
+  fprintf(fp, "free:   %10lu\n", usage.free_count);
+  fprintf(fp, "live:   %10zu bytes\n", usage.live_bytes);
+  fprintf(fp, "peak:   %10zu bytes\n", usage.peak_bytes);
+  for (int i = 0; i < MEM_CATEGORIES; i++) {
+    if (usage.category_peak[i])
+      fprintf(fp, "  %-16s peak %10zu, live %10zu\n", category_names[i],
+              usage.category_peak[i], usage.category_live[i]);
+  }
+}
+
+void mark_memory_peak(void) {
+  mark_peak_bytes = live_bytes;
+}
+
+size_t memory_peak_since_mark(void) {
+  return mark_peak_bytes;
+}
+
+void* tag_memory(void* p, MEM_CATEGORY category) {
+  assert(category >= 0 && category < MEM_CATEGORIES);
+  if (p) {
+    HEADER* h = header(p);
+    if (h->h.category != category) {
+      // the block stays counted in the total
+      category_live[h->h.category] -= h->h.size;
+      h->h.category = category;
+      raise_peak(&category_peak[category], category_live[category] += h->h.size);
+    }
+  }
+  return p;
+}
+
 void* emalloc(size_t sz) {
-  void* p = malloc(sz);
-  if (p == NULL)
+  HEADER* h = malloc(sizeof *h + sz);
+  if (h == NULL)
     fatal("out of memory (emalloc)\n");
   malloc_count++;
-  return p;
+  return block(h, sz, MEM_OTHER);
 }
 
 void efree(void* p) {
   if (p) {
-    free(p);
+    HEADER* h = header(p);
+    remove_bytes(h->h.category, h->h.size);
+    free(h);
     free_count++;
   }
 }
 
 void* erealloc(void* p, size_t sz) {
-  if (p)
+  MEM_CATEGORY category = MEM_OTHER;
+  HEADER* h = NULL;
+  if (p) {
+    h = header(p);
+    category = h->h.category;
+    remove_bytes(category, h->h.size);
     free_count++;
-  p = realloc(p, sz);
-  if (p == NULL)
+  }
+  h = realloc(h, sizeof *h + sz);
+  if (h == NULL)
     fatal("out of memory (erealloc)\n");
   malloc_count++;
-  return p;
+  return block(h, sz, category);
 }
 
 void* ecalloc(size_t size) {
-  void* p = calloc(1, size);
-  if (p == NULL)
+  HEADER* h = calloc(1, sizeof *h + size);
+  if (h == NULL)
     fatal("out of memory (ecalloc)\n");
   malloc_count++;
-  return p;
+  return block(h, size, MEM_OTHER);
 }
 
 char* estrdup(const char* s) {
@@ -96,8 +254,10 @@ FILE* efopen(const char* filename, const char* mode, const char* action) {
 BYTE* read_file(FILE* fp, FileSize size) {
   BYTE* buf = emalloc(size);
   size_t count = fread(buf, 1, size, fp);
-  if (count != size)
+  if (count != size) {
+    efree(buf);
     fatal("file out of data: reading %lu bytes, got %lu bytes\n", size, count);
+  }
   return buf;
 }
 
@@ -165,6 +325,33 @@ void write_word_le(void* p, WORD w) {
   a[1] = (w >> 8) & 0xff;
 }
 
+// Offset of the first byte at which the buffers differ, or len if equal.
+// Equal stretches are skipped a machine word at a time.
+size_t first_difference(const BYTE* p, const BYTE* q, size_t len) {
+  size_t i = 0;
+
+  for (; len - i >= sizeof (QWORD); i += sizeof (QWORD)) {
+    QWORD a, b;
+    memcpy(&a, p + i, sizeof a);
+    memcpy(&b, q + i, sizeof b);
+    if (a != b)
+      break;
+  }
+
+  while (i < len && p[i] == q[i])
+    i++;
+
+  return i;
+}
+
+// Offset of the first byte at which the buffers agree, or len if none do.
+size_t first_agreement(const BYTE* p, const BYTE* q, size_t len) {
+  size_t i = 0;
+  while (i < len && p[i] != q[i])
+    i++;
+  return i;
+}
+
 VECTOR* new_vector(unsigned size) {
   VECTOR* vec = ecalloc(sizeof *vec + size * sizeof (vec->val[0]));
   vec->size = size;
@@ -235,6 +422,33 @@ static void test_endian(CuTest* tc) {
   CuAssertIntEquals(tc, VAL, read_word_le(buf + 4));
 }
 
+static void test_first_difference(CuTest* tc) {
+  BYTE a[40], b[40];
+
+  for (unsigned i = 0; i < sizeof a; i++)
+    a[i] = b[i] = (BYTE) i;
+
+  CuAssertIntEquals(tc, 0, first_difference(a, b, 0));
+  CuAssertIntEquals(tc, 40, first_difference(a, b, 40));
+  CuAssertIntEquals(tc, 3, first_difference(a, b, 3));
+
+  b[0] = 0xff;
+  CuAssertIntEquals(tc, 0, first_difference(a, b, 40));
+  b[0] = a[0];
+
+  b[21] = 0xff;
+  b[22] = 0xff;
+  CuAssertIntEquals(tc, 21, first_difference(a, b, 40));
+  CuAssertIntEquals(tc, 13, first_difference(a + 8, b + 8, 32));
+  CuAssertIntEquals(tc, 20, first_difference(a, b, 20));
+  CuAssertIntEquals(tc, 0, first_agreement(a, b, 40));
+  CuAssertIntEquals(tc, 2, first_agreement(a + 21, b + 21, 19));
+  CuAssertIntEquals(tc, 1, first_agreement(a + 21, b + 21, 1));
+
+  b[39] = 0xff;
+  CuAssertIntEquals(tc, 16, first_difference(a + 23, b + 23, 17));
+}
+
 static void test_p2aligned(CuTest* tc) {
   CuAssertLongLongEquals(tc, 0, p2aligned(0, 0));
   CuAssertLongLongEquals(tc, 0, p2aligned(0, 31));
@@ -255,12 +469,86 @@ static void test_p2aligned(CuTest* tc) {
   CuAssertLongLongEquals(tc, 2048, p2aligned(1025, 10));
 }
 
+static void test_memory_usage(CuTest* tc) {
+  MEMORY_USAGE before, after;
+
+  get_memory_usage(&before);
+  mark_memory_peak();
+
+  char* p = tag_memory(emalloc(100), MEM_SYMBOLS);
+  get_memory_usage(&after);
+  CuAssertIntEquals(tc, 100, (int)(after.live_bytes - before.live_bytes));
+  CuAssertIntEquals(tc, 100, (int)(after.category_live[MEM_SYMBOLS] - before.category_live[MEM_SYMBOLS]));
+  CuAssertIntEquals(tc, 0, (int)(after.category_live[MEM_OTHER] - before.category_live[MEM_OTHER]));
+
+  // the category stays with the block
+  p = erealloc(p, 300);
+  get_memory_usage(&after);
+  CuAssertIntEquals(tc, 300, (int)(after.live_bytes - before.live_bytes));
+  CuAssertIntEquals(tc, 300, (int)(after.category_live[MEM_SYMBOLS] - before.category_live[MEM_SYMBOLS]));
+  CuAssertTrue(tc, after.category_peak[MEM_SYMBOLS] >= after.category_live[MEM_SYMBOLS]);
+
+  char* q = ecalloc(50);
+  CuAssertTrue(tc, memory_peak_since_mark() >= before.live_bytes + 350);
+  CuAssertTrue(tc, after.peak_bytes >= after.live_bytes);
+
+  efree(q);
+  efree(p);
+  get_memory_usage(&after);
+  CuAssertIntEquals(tc, 0, (int)(after.live_bytes - before.live_bytes));
+  CuAssertIntEquals(tc, 0, (int)(after.category_live[MEM_SYMBOLS] - before.category_live[MEM_SYMBOLS]));
+  CuAssertIntEquals(tc, 3, (int)(after.malloc_count - before.malloc_count));
+  CuAssertIntEquals(tc, 3, (int)(after.free_count - before.free_count));
+
+  mark_memory_peak();
+  CuAssertIntEquals(tc, (int)after.live_bytes, (int)memory_peak_since_mark());
+  CuAssertStrEquals(tc, "symbols", memory_category_name(MEM_SYMBOLS));
+}
+
+// The value is changed between setjmp and longjmp, so it must be volatile
+// for its value after a failure to be defined.
+static void failing_job(void* arg) {
+  *(volatile int*)arg = 1;
+  fatal("job %d failed\n", 7);
+  *(volatile int*)arg = 2;
+}
+
+static void passing_job(void* arg) {
+  *(volatile int*)arg = 3;
+}
+
+static void test_run_job(CuTest* tc) {
+  FILE* errors = tmpfile();
+  CuAssertPtrNotNull(tc, errors);
+  const char* const saved_progname = progname;
+  progname = NULL;
+
+  volatile int n = 0;
+  CuAssertIntEquals(tc, false, run_job(failing_job, (void*) &n, errors));
+  CuAssertIntEquals(tc, 1, n);
+  CuAssertIntEquals(tc, true, run_job(passing_job, (void*) &n, errors));
+  CuAssertIntEquals(tc, 3, n);
+  CuAssertTrue(tc, error_stream() == stderr);
+
+  char buf[40];
+  rewind(errors);
+  CuAssertPtrNotNull(tc, fgets(buf, sizeof buf, errors));
+  CuAssertStrEquals(tc, "fatal: job 7 failed\n", buf);
+  CuAssertTrue(tc, fgets(buf, sizeof buf, errors) == NULL);
+
+  progname = saved_progname;
+  fclose(errors);
+}
+
 CuSuite* utils_test_suite(void) {
   CuSuite* suite = CuSuiteNew();
   SUITE_ADD_TEST(suite, test_sizes);
   SUITE_ADD_TEST(suite, test_estrdup);
   SUITE_ADD_TEST(suite, test_endian);
+  SUITE_ADD_TEST(suite, test_first_difference);
   SUITE_ADD_TEST(suite, test_p2aligned);
+  SUITE_ADD_TEST(suite, test_memory_usage);
+  SUITE_ADD_TEST(suite, test_run_job);
   return suite;
 }
 
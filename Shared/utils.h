@@ -7,6 +7,10 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#ifndef _WIN32
+#include <strings.h>
+#define _stricmp strcasecmp
+#endif
 
 extern const char* progname;
 
@@ -22,7 +26,24 @@ typedef unsigned long long QWORD;
 typedef signed char SBYTE;
 typedef signed short SWORD;
 
-void fatal(const char* fmt, ...);
+#ifdef __STDC_NO_THREADS__
+#define THREAD_LOCAL
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+// Report a fatal error on the error stream and fail.
+_Noreturn void fatal(const char* fmt, ...);
+
+// stderr, or the error stream of the job running on this thread.
+FILE* error_stream(void);
+// End the process with EXIT_FAILURE, or the job running on this thread.
+_Noreturn void fail(void);
+// Call fn(arg) as a job reporting errors on the given stream, or stderr if NULL.
+// False if the job failed: its allocations are not freed, so a function
+// holding allocations across a failure does the work as a nested job,
+// frees them, and fails in turn.
+bool run_job(void (*fn)(void*), void* arg, FILE* errors);
 
 void* emalloc(size_t);
 void* erealloc(void*, size_t);
@@ -36,6 +57,38 @@ typedef DWORD MemSize;
 
 void get_memory_counts(unsigned long *malloc_count, unsigned long *free_count);
 
+// Categories of allocation for reporting memory use.
+typedef enum {
+  MEM_OTHER,
+  MEM_SYMBOLS,
+  MEM_IRECS,
+  MEM_ORECS,
+  MEM_SEGMENTS,
+  MEM_AST,
+  MEM_CATEGORIES
+} MEM_CATEGORY;
+
+// Count a block from emalloc, ecalloc or erealloc under the category.
+// The category stays with the block when it is reallocated.
+void* tag_memory(void*, MEM_CATEGORY);
+
+typedef struct {
+  unsigned long malloc_count;
+  unsigned long free_count;
+  size_t live_bytes;
+  size_t peak_bytes;
+  size_t category_live[MEM_CATEGORIES];
+  size_t category_peak[MEM_CATEGORIES];
+} MEMORY_USAGE;
+
+void get_memory_usage(MEMORY_USAGE*);
+const char* memory_category_name(MEM_CATEGORY);
+void print_memory_usage(FILE*);
+
+// Highest number of live bytes since the last mark.
+void mark_memory_peak(void);
+size_t memory_peak_since_mark(void);
+
 #define MAX_FILESIZE ULONG_MAX
 
 typedef unsigned long FileSize;
@@ -50,6 +103,9 @@ void print_notabs(FILE*, const char*, unsigned tab_size);
 WORD read_word_le(void*);
 void write_word_le(void*, WORD);
 
+size_t first_difference(const BYTE*, const BYTE*, size_t len);
+size_t first_agreement(const BYTE*, const BYTE*, size_t len);
+
 typedef struct {
   unsigned size;
   unsigned long val[];